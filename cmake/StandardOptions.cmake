@@ -19,6 +19,22 @@ if(CCACHE_FOUND)
   set_property(GLOBAL PROPERTY RULE_LAUNCH_LINK ccache)
 endif()
 
+option(PROJECT_ENABLE_NATIVE "Compile for the instruction set of the building machine." OFF)
+if(PROJECT_ENABLE_NATIVE)
+  if(MSVC)
+    add_compile_options(/arch:AVX2)
+  else()
+    add_compile_options(-march=native)
+  endif()
+endif()
+
+option(PROJECT_ENABLE_SIMD_DISPATCH "Build the SIMD kernels for every x86-64 instruction set and pick one at runtime." ON)
+set(PROJECT_SIMD_DISPATCH OFF)
+if(PROJECT_ENABLE_SIMD_DISPATCH AND CMAKE_SYSTEM_PROCESSOR MATCHES "^(x86_64|AMD64|amd64)$")
+  set(PROJECT_SIMD_DISPATCH ON)
+  add_compile_definitions(LION_SIMD_DISPATCH)
+endif()
+
 option(PROJECT_ENABLE_ASAN "Enable Address Sanitize to detect memory error." OFF)
 if(PROJECT_ENABLE_ASAN)
     add_compile_options(-fsanitize=address)
@@ -10,27 +10,12 @@
 #define OUTCSV_FILENAME     "simdata/lab_240716_cpp/data.csv"
 #define OUTCURROPT_FILENAME "simdata/lab_240716_cpp/curropt.csv"
 
-FILE *csv_file;
 #ifndef NDEBUG
 FILE         *curropt_file = NULL;
 lion_vector_t currs;
 #endif
 
 extern "C" lion_status_t init_hook(lion_sim_t *sim) {
-  // data csv file
-  csv_file = fopen(OUTCSV_FILENAME, "w+");
-  if (csv_file == NULL) {
-    log_error("Failed to open output file");
-    return LION_STATUS_FAILURE;
-  }
-  fprintf(
-      csv_file,
-      "time,step,power,ambient_temperature,voltage,current,"
-      "open_circuit_voltage,internal_resistance,ehc,generated_heat,"
-      "internal_temperature,surface_temperature,kappa,soc_nominal,"
-      "capacity_nominal,soc_use,capacity_use\n"
-  );
-
 #ifndef NDEBUG
   // curropt file
   curropt_file = fopen(OUTCURROPT_FILENAME, "w+");
@@ -48,29 +33,6 @@ extern "C" lion_status_t init_hook(lion_sim_t *sim) {
 }
 
 extern "C" lion_status_t update_hook(lion_sim_t *sim) {
-  // Store current state in csv file
-  fprintf(
-      csv_file,
-      "%lf,%lu,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf\n",
-      sim->state.time,
-      sim->state.step,
-      sim->state.power,
-      sim->state.ambient_temperature,
-      sim->state.voltage,
-      sim->state.current,
-      sim->state.open_circuit_voltage,
-      sim->state.internal_resistance,
-      sim->state.ehc,
-      sim->state.generated_heat,
-      sim->state.internal_temperature,
-      sim->state.surface_temperature,
-      sim->state.kappa,
-      sim->state.soc_nominal,
-      sim->state.capacity_nominal,
-      sim->state.soc_use,
-      sim->state.capacity_use
-  );
-
 #ifndef NDEBUG
   // Check the objective function of the current optimization process
   struct lion_optimization_iter_params params = {
@@ -94,13 +56,63 @@ extern "C" lion_status_t update_hook(lion_sim_t *sim) {
 }
 
 extern "C" lion_status_t finished_hook(lion_sim_t *sim) {
-  fclose(csv_file);
 #ifndef NDEBUG
   fclose(curropt_file);
 #endif
   return LION_STATUS_SUCCESS;
 }
 
+// Recorded columns written to the output csv, in order
+static const lion_state_field_t OUTCSV_FIELDS[] = {
+  LION_STATE_TIME,
+  LION_STATE_POWER,
+  LION_STATE_AMBIENT_TEMPERATURE,
+  LION_STATE_VOLTAGE,
+  LION_STATE_CURRENT,
+  LION_STATE_OPEN_CIRCUIT_VOLTAGE,
+  LION_STATE_INTERNAL_RESISTANCE,
+  LION_STATE_EHC,
+  LION_STATE_GENERATED_HEAT,
+  LION_STATE_INTERNAL_TEMPERATURE,
+  LION_STATE_SURFACE_TEMPERATURE,
+  LION_STATE_KAPPA,
+  LION_STATE_SOC_NOMINAL,
+  LION_STATE_CAPACITY_NOMINAL,
+  LION_STATE_SOC_USE,
+  LION_STATE_CAPACITY_USE,
+};
+
+lion::Status write_csv(lion::Recorder const &recorder) {
+  FILE *csv_file = fopen(OUTCSV_FILENAME, "w+");
+  if (csv_file == NULL) {
+    log_error("Failed to open output file");
+    return lion::Status::FAILURE;
+  }
+  fprintf(
+      csv_file,
+      "time,step,power,ambient_temperature,voltage,current,"
+      "open_circuit_voltage,internal_resistance,ehc,generated_heat,"
+      "internal_temperature,surface_temperature,kappa,soc_nominal,"
+      "capacity_nominal,soc_use,capacity_use\n"
+  );
+
+  // Formatting only happens once the simulation is done
+  std::span<const uint64_t>            step = recorder.step();
+  std::vector<std::span<const double>> columns;
+  for (lion_state_field_t field : OUTCSV_FIELDS) {
+    columns.push_back(recorder.column(field));
+  }
+  for (size_t k = 0; k < recorder.size(); k++) {
+    fprintf(csv_file, "%lf,%lu", columns[0][k], step[k]);
+    for (size_t f = 1; f < columns.size(); f++) {
+      fprintf(csv_file, ",%lf", columns[f][k]);
+    }
+    fprintf(csv_file, "\n");
+  }
+  fclose(csv_file);
+  return lion::Status::SUCCESS;
+}
+
 lion::Status setup_paths(int argc, char *argv[], std::string *out_power, std::string *out_amb) {
   if (argc != 1) {
     // We assume the paths are passed as arguments
@@ -190,8 +202,12 @@ int main(int argc, char *argv[]) {
   std::vector<double> amb_temp = lion::vector_to_std<double>(&_amb_temp);
 
   log_info("Running simulation");
+  lion::Recorder recorder(sim, LION_STATE_ALL, power.size());
   sim.run(power, amb_temp);
 
+  log_info("Writing results");
+  write_csv(recorder);
+
   log_info("Cleaning up");
   LION_CALL(lion_vector_cleanup(sim, &_power), "Failed cleaning power vector");
   LION_CALL(lion_vector_cleanup(sim, &_amb_temp), "Failed cleaning ambient temperature vector");
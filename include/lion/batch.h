@@ -0,0 +1,192 @@
+/// @file
+/// @brief Lockstep simulation of many independent cells.
+#pragma once
+
+#include "params.h"
+#include "sim.h"
+#include "status.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @addtogroup types
+/// @{
+
+/// @brief Batch of independent cells simulated in lockstep.
+///
+/// The state of the batch is stored as a structure of arrays, where every array has one element
+/// per cell, so that each stage of a step is a contiguous loop over all the cells. Parameters can
+/// either be shared by every cell or given per cell. All the cells share the configuration, and
+/// thus the step size, tolerances and current solver.
+///
+/// Only a subset of the configurations of a sim is supported: the power input mode,
+/// LION_STEP_MODE_FIXED, LION_MODEL_BACKEND_ANALYTIC, and either LION_STEPPER_RK4,
+/// LION_STEPPER_EXACT or one of the native steppers. Any other setting makes lion_batch_new and
+/// lion_batch_step fail.
+typedef struct lion_batch {
+  lion_sim_config_t *conf;         ///< Hyperparameters and sim metadata, shared by every cell.
+  lion_params_t     *params;       ///< System parameters, either one shared or one per cell.
+  size_t             params_count; ///< Number of elements in params, either 1 or the number of cells.
+  size_t             count;        ///< Number of cells in the batch.
+  double             time;         ///< Simulation time.
+  uint64_t           step;         ///< Simulation step index.
+
+  // System inputs
+  double *power;               ///< Power being drawn from each cell.
+  double *ambient_temperature; ///< Ambient temperature around each cell.
+
+  // Electrical state
+  double *voltage;              ///< Voltage in the terminals of each cell.
+  double *current;              ///< Current drawn from each cell.
+  double *open_circuit_voltage; ///< Temperature aware open circuit voltage of each cell.
+  double *internal_resistance;  ///< Internal resistance of each cell.
+
+  // Degradation state
+  uint64_t *cycle;          ///< Number of cycles of each cell.
+  double   *soh;            ///< State of health of each cell.
+  uint64_t *_cycle_step;    ///< Step within the cycle of each cell.
+  double   *_soc_mean;      ///< Average state of charge of the cycle of each cell.
+  double   *_soc_max;       ///< Maximum state of charge of the cycle of each cell.
+  double   *_soc_min;       ///< Minimum state of charge of the cycle of each cell.
+  double   *_acc_discharge; ///< Accumulated discharge of each cell.
+
+  // Thermal state
+  double *ehc;                  ///< Entropic heat coefficient of each cell.
+  double *generated_heat;       ///< Heat generated by each cell.
+  double *internal_temperature; ///< Internal temperature of each cell.
+  double *surface_temperature;  ///< Surface temperature of each cell.
+
+  // Charge state
+  double *kappa;            ///< Electrolyte conductivity factor of each cell.
+  double *soc_nominal;      ///< Nominal state of charge of each cell.
+  double *capacity_nominal; ///< Nominal capacity of each cell.
+  double *soc_use;          ///< Usable state of charge of each cell.
+  double *capacity_use;     ///< Usable capacity of each cell.
+
+  // Next state placeholders
+  double *_next_soc_nominal;          ///< Placeholder for the next nominal state of charge.
+  double *_next_internal_temperature; ///< Placeholder for the next internal temperature.
+
+  // Solver scratch
+  double             *_rint_poly;     ///< Resistance polynomials at the usable SoC, LION_FUZZY_SETS_COUNT per cell.
+  lion_rint_packed_t *_rint_packed;   ///< Fuzzy sets of the polarization model, one per parameter set.
+  double             *_current_guess; ///< Current of the previous step, used to warm-start the solver.
+  uint8_t            *_active;        ///< Mask of the cells whose current has not converged yet.
+
+  void               *_block;   ///< Single allocation backing every array.
+  gsl_min_fminimizer *_sys_min; ///< Minimizer used as fallback for cells whose current does not converge.
+  log_Logger          logger;   ///< Logger of this batch.
+} lion_batch_t;
+
+/// @brief Single precision counterpart of lion_batch_t.
+///
+/// Every array of the state is stored in float, halving the memory of the batch, and goes through
+/// the single precision array kernels, with twice the lanes of the double ones. The scalar terms of
+/// the model are still evaluated in double, and tolerances of the current solver below the
+/// precision of a float are widened to it. Meant for screening large fleets, where a relative
+/// error around 1e-5 is acceptable. The fast math tiers of the configuration do not apply.
+typedef struct lion_batch_f32 {
+  lion_sim_config_t *conf;         ///< Hyperparameters and sim metadata, shared by every cell.
+  lion_params_t     *params;       ///< System parameters, either one shared or one per cell.
+  size_t             params_count; ///< Number of elements in params, either 1 or the number of cells.
+  size_t             count;        ///< Number of cells in the batch.
+  double             time;         ///< Simulation time.
+  uint64_t           step;         ///< Simulation step index.
+
+  // System inputs
+  float *power;               ///< Power being drawn from each cell.
+  float *ambient_temperature; ///< Ambient temperature around each cell.
+
+  // Electrical state
+  float *voltage;              ///< Voltage in the terminals of each cell.
+  float *current;              ///< Current drawn from each cell.
+  float *open_circuit_voltage; ///< Temperature aware open circuit voltage of each cell.
+  float *internal_resistance;  ///< Internal resistance of each cell.
+
+  // Degradation state
+  uint64_t *cycle;          ///< Number of cycles of each cell.
+  float    *soh;            ///< State of health of each cell.
+  uint64_t *_cycle_step;    ///< Step within the cycle of each cell.
+  float    *_soc_mean;      ///< Average state of charge of the cycle of each cell.
+  float    *_soc_max;       ///< Maximum state of charge of the cycle of each cell.
+  float    *_soc_min;       ///< Minimum state of charge of the cycle of each cell.
+  float    *_acc_discharge; ///< Accumulated discharge of each cell.
+
+  // Thermal state
+  float *ehc;                  ///< Entropic heat coefficient of each cell.
+  float *generated_heat;       ///< Heat generated by each cell.
+  float *internal_temperature; ///< Internal temperature of each cell.
+  float *surface_temperature;  ///< Surface temperature of each cell.
+
+  // Charge state
+  float *kappa;            ///< Electrolyte conductivity factor of each cell.
+  float *soc_nominal;      ///< Nominal state of charge of each cell.
+  float *capacity_nominal; ///< Nominal capacity of each cell.
+  float *soc_use;          ///< Usable state of charge of each cell.
+  float *capacity_use;     ///< Usable capacity of each cell.
+
+  // Next state placeholders
+  float *_next_soc_nominal;          ///< Placeholder for the next nominal state of charge.
+  float *_next_internal_temperature; ///< Placeholder for the next internal temperature.
+
+  // Solver scratch
+  float                  *_rint_poly;     ///< Resistance polynomials at the usable SoC, LION_FUZZY_SETS_COUNT per cell.
+  lion_rint_packed_f32_t *_rint_packed;   ///< Fuzzy sets of the polarization model, one per parameter set.
+  float                  *_current_guess; ///< Current of the previous step, used to warm-start the solver.
+  uint8_t                *_active;        ///< Mask of the cells whose current has not converged yet.
+
+  void               *_block;   ///< Single allocation backing every array.
+  gsl_min_fminimizer *_sys_min; ///< Minimizer used as fallback for cells whose current does not converge.
+  log_Logger          logger;   ///< Logger of this batch.
+} lion_batch_f32_t;
+
+/// @}
+
+/// @addtogroup functions
+/// @{
+
+/// @brief Create a new batch.
+///
+/// Fails if the configuration is not supported by batches, see lion_batch_t.
+///
+/// @param[in]  conf          Pointer to the configuration shared by every cell.
+/// @param[in]  params        Pointer to either one set of parameters or one per cell.
+/// @param[in]  params_count  Number of parameter sets, either 1 or count.
+/// @param[in]  count         Number of cells.
+/// @param[out] out           Pointer to where the batch will be created.
+lion_status_t lion_batch_new(lion_sim_config_t *conf, lion_params_t *params, size_t params_count, size_t count, lion_batch_t *out);
+
+/// Initialize the state of every cell of the batch from its initialization parameters.
+lion_status_t lion_batch_init(lion_batch_t *batch);
+
+/// @brief Step every cell of the batch in time.
+///
+/// @param[in]  batch                Batch to step forward.
+/// @param[in]  power                Power extracted from each cell, one element per cell.
+/// @param[in]  ambient_temperature  Ambient temperature around each cell, one element per cell.
+lion_status_t lion_batch_step(lion_batch_t *batch, const double *power, const double *ambient_temperature);
+
+/// Clean up the batch.
+lion_status_t lion_batch_cleanup(lion_batch_t *batch);
+
+/// Create a new single precision batch, see lion_batch_new.
+lion_status_t lion_batch_f32_new(lion_sim_config_t *conf, lion_params_t *params, size_t params_count, size_t count, lion_batch_f32_t *out);
+
+/// Initialize the state of every cell of the single precision batch, see lion_batch_init.
+lion_status_t lion_batch_f32_init(lion_batch_f32_t *batch);
+
+/// Step every cell of the single precision batch in time, see lion_batch_step.
+lion_status_t lion_batch_f32_step(lion_batch_f32_t *batch, const float *power, const float *ambient_temperature);
+
+/// Clean up the single precision batch.
+lion_status_t lion_batch_f32_cleanup(lion_batch_f32_t *batch);
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,90 @@
+/// @file
+/// @brief Per-step evaluation context of the cell model.
+#pragma once
+
+#include "params.h"
+#include "table.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @addtogroup types
+/// @{
+
+/// @brief Accuracy of the exponentials of the cell model.
+///
+/// The exponentials take nearly all the time of a model evaluation. The following tiers are currently supported:
+/// - LION_FAST_MATH_OFF  : libm, or a vectorized exp within 2 ulp of it.
+/// - LION_FAST_MATH_1E12 : range reduced polynomial, with a relative error below 1e-12.
+/// - LION_FAST_MATH_1E7  : range reduced polynomial, with a relative error below 1e-7.
+///
+/// The fast tiers apply to the open circuit voltage, the entropic heat coefficient, kappa and the fuzzy memberships of
+/// the resistance, both in sims and batches. Square roots are exact in every tier, since the hardware instruction is
+/// already cheaper than any approximation.
+typedef enum lion_fast_math {
+  LION_FAST_MATH_OFF,  ///< Full double precision.
+  LION_FAST_MATH_1E12, ///< Relative error below 1e-12.
+  LION_FAST_MATH_1E7,  ///< Relative error below 1e-7.
+} lion_fast_math_t;
+
+/// @brief Fuzzy sets and polynomials of the polarization resistance model, packed for SIMD.
+///
+/// Both kinds of membership are folded in a single form: e = exp(gauss d^2 + slope d) with
+/// d = I - center, which is the membership of a gaussian set and turns into 1 / (1 + e) for a
+/// sigmoid one. Every array holds one entry per fuzzy set, and the polynomials are stored by power,
+/// so that consecutive lanes go through different sets.
+typedef struct lion_rint_packed {
+  double center[LION_FUZZY_SETS_COUNT];                       ///< Mean of the gaussian sets, center of the sigmoid ones.
+  double gauss[LION_FUZZY_SETS_COUNT];                        ///< -1 / (2 sigma^2) for the gaussian sets, 0 otherwise.
+  double slope[LION_FUZZY_SETS_COUNT];                        ///< -a for the sigmoid sets, 0 otherwise.
+  double sigmoid[LION_FUZZY_SETS_COUNT];                      ///< 1 for the sigmoid sets, 0 otherwise.
+  double poly[LION_FUZZY_SETS_DEGREE][LION_FUZZY_SETS_COUNT]; ///< Polynomial coefficients, by increasing power.
+} lion_rint_packed_t;
+
+/// @brief Single precision counterpart of lion_rint_packed_t, used by lion_batch_f32_t.
+typedef struct lion_rint_packed_f32 {
+  float center[LION_FUZZY_SETS_COUNT];                       ///< Mean of the gaussian sets, center of the sigmoid ones.
+  float gauss[LION_FUZZY_SETS_COUNT];                        ///< -1 / (2 sigma^2) for the gaussian sets, 0 otherwise.
+  float slope[LION_FUZZY_SETS_COUNT];                        ///< -a for the sigmoid sets, 0 otherwise.
+  float sigmoid[LION_FUZZY_SETS_COUNT];                      ///< 1 for the sigmoid sets, 0 otherwise.
+  float poly[LION_FUZZY_SETS_DEGREE][LION_FUZZY_SETS_COUNT]; ///< Polynomial coefficients, by increasing power.
+} lion_rint_packed_f32_t;
+
+/// @brief Cached model values and derivatives for a single step.
+///
+/// Inputs are frozen during a step, so every transcendental term of the model is evaluated once
+/// when the step is prepared and then shared by the current solver, the ODE right-hand side and
+/// the Jacobian. Fields are filled in two stages: the state-dependent terms when the step is
+/// prepared, and the current-dependent terms once the current has been solved.
+typedef struct lion_eval {
+  // State-dependent terms
+  double                    kappa;                            ///< Electrolyte conductivity factor.
+  double                    kappa_grad;                       ///< Derivative of kappa with respect to the internal temperature.
+  double                    soc_use;                          ///< Usable state of charge.
+  double                    capacity_use;                     ///< Usable capacity.
+  double                    ehc;                              ///< Entropic heat coefficient.
+  double                    ref_open_circuit_voltage;         ///< Reference open circuit voltage.
+  double                    open_circuit_voltage;             ///< Temperature aware open circuit voltage.
+  double                    open_circuit_voltage_grad;        ///< Derivative of the open circuit voltage with respect to the usable SoC.
+  double                    rint_poly[LION_FUZZY_SETS_COUNT]; ///< Resistance polynomials of each fuzzy set evaluated at the usable SoC.
+  const lion_rint_packed_t *rint_packed;                      ///< Fuzzy sets of the polarization model, packed once by the owner of the parameters.
+  const lion_table_t       *rint_table;                       ///< Resistance table of the step, NULL when evaluated in closed form.
+  lion_fast_math_t          fast_math;                        ///< Accuracy of the exponentials of the step.
+  size_t                    table_row;                        ///< Row of the resistance table below the usable SoC.
+  double                    table_frac;                       ///< Position of the usable SoC between the row and the next one.
+
+  // Current-dependent terms
+  double current;                  ///< Solved current.
+  double internal_resistance;      ///< Model internal resistance at the solved current.
+  double internal_resistance_grad; ///< Derivative of the internal resistance with respect to the current.
+  double current_grad_voc;         ///< Derivative of the current with respect to the open circuit voltage.
+} lion_eval_t;
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
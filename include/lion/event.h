@@ -0,0 +1,87 @@
+/// @file
+/// @brief Threshold events on the state of a simulation.
+#pragma once
+
+#include "recorder.h"
+#include "sim.h"
+#include "status.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @addtogroup types
+/// @{
+
+/// @brief Direction of the threshold crossing which triggers an event.
+///
+/// The following directions are currently supported:
+/// - LION_EVENT_RISING  : the field goes from below the threshold to at or above it.
+/// - LION_EVENT_FALLING : the field goes from above the threshold to at or below it.
+/// - LION_EVENT_EITHER  : any of the above.
+typedef enum lion_event_direction {
+  LION_EVENT_RISING,  ///< Crossing upwards.
+  LION_EVENT_FALLING, ///< Crossing downwards.
+  LION_EVENT_EITHER,  ///< Crossing in any direction.
+} lion_event_direction_t;
+
+/// @brief Action taken when an event triggers.
+///
+/// The following actions are currently supported:
+/// - LION_EVENT_STOP         : cuts the step at the event and makes lion_sim_should_close true, so
+///                             that the running loops stop.
+/// - LION_EVENT_NOTIFY       : calls the hook of the event, or logs the event if it has none.
+/// - LION_EVENT_SWITCH_INPUT : cuts the step at the event and from then on replaces the input given
+///                             to each step, power or current depending on the input mode, with the
+///                             power field of the event.
+typedef enum lion_event_action {
+  LION_EVENT_STOP,         ///< Stop the simulation.
+  LION_EVENT_NOTIFY,       ///< Notify the hook.
+  LION_EVENT_SWITCH_INPUT, ///< Switch the power input.
+} lion_event_action_t;
+
+/// @brief Threshold event on a field of the state.
+///
+/// An event triggers when the field crosses its threshold during a step. The crossing is located
+/// within the step by root-finding on the field, with the states interpolated linearly over the
+/// step and the algebraic part of the state re-solved at each trial point. The fields after
+/// `hook` are filled by the simulation.
+struct lion_event {
+  const char            *name;                                 ///< Name of the event, used for logging.
+  lion_state_field_t     field;                                ///< Field of the state to watch, a single field.
+  double                 threshold;                            ///< Threshold of the field.
+  lion_event_direction_t direction;                            ///< Direction of the crossing.
+  lion_event_action_t    action;                               ///< Action taken when triggered.
+  double                 power;                                ///< Input to switch to with LION_EVENT_SWITCH_INPUT.
+  lion_status_t (*hook)(lion_sim_t *sim, lion_event_t *event); ///< Optional hook called when triggered.
+  uint64_t               triggered;                            ///< Number of times the event has triggered.
+  double                 time;                                 ///< Time of the last trigger.
+  double                 value;                                ///< Value of the field at the last trigger.
+  double                 _theta;                               ///< Position of the crossing within the current step.
+};
+
+/// @}
+
+/// @addtogroup functions
+/// @{
+
+/// @brief Add an event to a simulation.
+///
+/// The event is copied, so the events of the simulation must be read back through sim->events.
+/// Fails for fields which do not change within a step, namely the step index, the inputs, the
+/// cycle and the state of health, since their crossings cannot be located.
+/// @param[in]  sim    Simulation to watch.
+/// @param[in]  event  Event to add.
+lion_status_t lion_sim_add_event(lion_sim_t *sim, const lion_event_t *event);
+
+/// Remove every event from a simulation, as well as any input they switched.
+void lion_sim_clear_events(lion_sim_t *sim);
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
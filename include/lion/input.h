@@ -0,0 +1,91 @@
+/// @file
+/// @brief Inputs sampled at their own rate and resampled on the fly.
+#pragma once
+
+#include "sim.h"
+#include "status.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @addtogroup types
+/// @{
+
+/// @brief Interpolation between the samples of an input.
+///
+/// The following methods are currently supported:
+/// - LION_INTERP_ZOH    : zero-order hold, each sample holds until the next one.
+/// - LION_INTERP_LINEAR : linear interpolation between consecutive samples.
+typedef enum lion_interp {
+  LION_INTERP_ZOH,    ///< Zero-order hold.
+  LION_INTERP_LINEAR, ///< Linear interpolation.
+} lion_interp_t;
+
+/// @brief Input signal sampled at its native rate.
+///
+/// Samples are either evenly spaced, starting at start_time with a fixed period, or given with
+/// an explicit, strictly increasing timestamp each. The samples are borrowed and never copied,
+/// so they must outlive the input. Queries outside of the sampled range hold the first or last
+/// sample. A cursor is kept between queries so that reading the input at increasing times, as
+/// the simulation does, costs constant time per query.
+typedef struct lion_input {
+  const double *values;     ///< Value of each sample.
+  const double *timestamps; ///< Time of each sample, NULL for evenly spaced samples.
+  size_t        len;        ///< Number of samples.
+  double        start_time; ///< Time of the first sample of evenly spaced samples.
+  double        period;     ///< Time between evenly spaced samples.
+  lion_interp_t interp;     ///< Interpolation between samples.
+  size_t        _cursor;    ///< Index of the sample found by the last query.
+} lion_input_t;
+
+/// @}
+
+/// @addtogroup functions
+/// @{
+
+/// @brief Create an input from evenly spaced samples.
+///
+/// @param[in]  values      Value of each sample.
+/// @param[in]  len         Number of samples.
+/// @param[in]  start_time  Time of the first sample in seconds.
+/// @param[in]  period      Time between samples in seconds.
+/// @param[in]  interp      Interpolation between samples.
+/// @param[out] out         Pointer to where the input will be created.
+lion_status_t lion_input_fixed_rate(const double *values, size_t len, double start_time, double period, lion_interp_t interp, lion_input_t *out);
+
+/// @brief Create an input from timestamped samples.
+///
+/// @param[in]  timestamps  Time of each sample in seconds, strictly increasing.
+/// @param[in]  values      Value of each sample.
+/// @param[in]  len         Number of samples.
+/// @param[in]  interp      Interpolation between samples.
+/// @param[out] out         Pointer to where the input will be created.
+lion_status_t lion_input_timestamped(const double *timestamps, const double *values, size_t len, lion_interp_t interp, lion_input_t *out);
+
+/// Get the value of the input at some time.
+double lion_input_at(lion_input_t *input, double time);
+
+/// Get the time of the first sample of the input.
+double lion_input_start_time(const lion_input_t *input);
+
+/// Get the time of the last sample of the input.
+double lion_input_end_time(const lion_input_t *input);
+
+/// @brief Runs the simulation from inputs at their native rate.
+///
+/// Equivalent to lion_sim_run, but the inputs are resampled at each step of sim_step_seconds
+/// instead of being consumed one sample per step. The simulation covers the time span where
+/// both inputs are defined, reading them at the start of each step.
+/// @param[in]  sim                  Simulation to run.
+/// @param[in]  power                Power extracted from the cell.
+/// @param[in]  ambient_temperature  Ambient temperature around the cell.
+lion_status_t lion_sim_run_resampled(lion_sim_t *sim, lion_input_t *power, lion_input_t *ambient_temperature);
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
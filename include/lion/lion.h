@@ -2,8 +2,17 @@
 /// @brief Header with every definition.
 #pragma once
 
+#include "batch.h"
+#include "eval.h"
+#include "event.h"
+#include "input.h"
 #include "names.h"
 #include "params.h"
+#include "protocol.h"
+#include "recorder.h"
 #include "sim.h"
+#include "snapshot.h"
 #include "status.h"
+#include "sweep.h"
+#include "table.h"
 #include "vector.h"
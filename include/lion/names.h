@@ -22,6 +22,21 @@ const char *lion_gsl_errno_name(const int num);
 /// Get the name of a jacobian calculation method.
 const char *lion_jacobian_name(lion_jacobian_method_t jacobian);
 
+/// Get the name of the current solver.
+const char *lion_current_solver_name(lion_current_solver_t solver);
+
+/// Get the name of the step mode.
+const char *lion_step_mode_name(lion_step_mode_t mode);
+
+/// Get the name of the input mode.
+const char *lion_input_mode_name(lion_input_mode_t mode);
+
+/// Get the name of the model backend.
+const char *lion_model_backend_name(lion_model_backend_t backend);
+
+/// Get the name of the fast math tier.
+const char *lion_fast_math_name(lion_fast_math_t fast_math);
+
 /// Get the name of the internal resistance model.
 const char *lion_params_rint_get_name(lion_rint_model_t model);
 
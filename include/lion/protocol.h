@@ -0,0 +1,94 @@
+/// @file
+/// @brief Charge and discharge protocols run natively by a simulation.
+#pragma once
+
+#include "event.h"
+#include "recorder.h"
+#include "sim.h"
+#include "status.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @addtogroup types
+/// @{
+
+/// @brief Control applied during a segment of a protocol.
+///
+/// The following controls are currently supported, with positive currents and powers discharging
+/// the cell:
+/// - LION_SEGMENT_REST : no current is drawn.
+/// - LION_SEGMENT_CC   : constant current of `value`.
+/// - LION_SEGMENT_CP   : constant power of `value`.
+/// - LION_SEGMENT_CV   : constant voltage of `value`, the current being solved to hold the terminals at it.
+/// - LION_SEGMENT_CCCV : constant current of `value` until the terminals reach `voltage`, then constant
+///                       voltage at it. The current of the constant voltage phase is never larger than
+///                       `value`.
+///
+/// The control is discrete: the current or power of each step is set from the state at its start.
+typedef enum lion_segment_type {
+  LION_SEGMENT_REST, ///< Rest.
+  LION_SEGMENT_CC,   ///< Constant current.
+  LION_SEGMENT_CP,   ///< Constant power.
+  LION_SEGMENT_CV,   ///< Constant voltage.
+  LION_SEGMENT_CCCV, ///< Constant current followed by constant voltage.
+} lion_segment_type_t;
+
+/// @brief Segment of a protocol.
+///
+/// A segment ends at the first of the following transition conditions, of which it needs at least one:
+/// - It has lasted `duration` seconds, if positive.
+/// - The magnitude of the current falls to `taper` during constant voltage, if positive.
+/// - The field `until` reaches `until_threshold` in the direction `until_direction`, if `until` is set.
+///   With LION_EVENT_EITHER the field has to cross the threshold from the side it started the
+///   segment on.
+///
+/// The conditions are checked on the state after each step.
+typedef struct lion_segment {
+  lion_segment_type_t    type;            ///< Control applied.
+  double                 value;           ///< Current, power or voltage held by the control.
+  double                 voltage;         ///< Voltage limit of LION_SEGMENT_CCCV.
+  double                 taper;           ///< Current cutoff of the constant voltage control.
+  double                 duration;        ///< Maximum duration of the segment.
+  lion_state_field_t     until;           ///< Field of the state ending the segment, 0 for none.
+  double                 until_threshold; ///< Threshold of the field.
+  lion_event_direction_t until_direction; ///< Direction in which the field reaches the threshold.
+} lion_segment_t;
+
+/// @brief Program of segments run one after the other.
+///
+/// The segments are run in order, and the whole program `cycles` times. The fields after `cycles`
+/// are filled by the simulation and can be read from its hooks.
+typedef struct lion_protocol {
+  const lion_segment_t *segments;      ///< Segments of the program.
+  size_t                len;           ///< Number of segments.
+  uint64_t              cycles;        ///< Number of times the program is run.
+  size_t                segment;       ///< Index of the segment being run.
+  uint64_t              cycle;         ///< Index of the cycle being run.
+  double                segment_start; ///< Time at which the segment being run started.
+} lion_protocol_t;
+
+/// @}
+
+/// @addtogroup functions
+/// @{
+
+/// @brief Runs a protocol on a simulation.
+///
+/// The simulation is initialized the same way as with lion_sim_run, and stops early when an event
+/// closes it. The input mode of the configuration is ignored, each step being driven by the control
+/// of its segment.
+/// @param[in]  sim                  Simulation to run.
+/// @param[in]  protocol             Protocol to run.
+/// @param[in]  ambient_temperature  Ambient temperature around the cell.
+lion_status_t lion_sim_run_protocol(lion_sim_t *sim, lion_protocol_t *protocol, double ambient_temperature);
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
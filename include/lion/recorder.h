@@ -0,0 +1,83 @@
+/// @file
+/// @brief Recorder of the state of a simulation into typed columns.
+#pragma once
+
+#include "sim.h"
+#include "status.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @addtogroup types
+/// @{
+
+/// Fields of the simulation state which can be recorded, to be combined as a mask.
+typedef enum lion_state_field {
+  LION_STATE_TIME                     = 1 << 0,        ///< Simulation time.
+  LION_STATE_STEP                     = 1 << 1,        ///< Simulation step index.
+  LION_STATE_POWER                    = 1 << 2,        ///< Power being drawn from the cell.
+  LION_STATE_AMBIENT_TEMPERATURE      = 1 << 3,        ///< Ambient temperature around the cell.
+  LION_STATE_VOLTAGE                  = 1 << 4,        ///< Voltage in the terminals of the cell.
+  LION_STATE_CURRENT                  = 1 << 5,        ///< Current drawn from the cell.
+  LION_STATE_REF_OPEN_CIRCUIT_VOLTAGE = 1 << 6,        ///< Reference open circuit voltage of the cell.
+  LION_STATE_OPEN_CIRCUIT_VOLTAGE     = 1 << 7,        ///< Temperature aware open circuit voltage of the cell.
+  LION_STATE_INTERNAL_RESISTANCE      = 1 << 8,        ///< Internal resistance of the cell.
+  LION_STATE_CYCLE                    = 1 << 9,        ///< Number of cycles the battery has been through.
+  LION_STATE_SOH                      = 1 << 10,       ///< State of health of the cell.
+  LION_STATE_EHC                      = 1 << 11,       ///< Entropic heat coefficient.
+  LION_STATE_GENERATED_HEAT           = 1 << 12,       ///< Heat generated by the cell.
+  LION_STATE_INTERNAL_TEMPERATURE     = 1 << 13,       ///< Internal temperature of the cell.
+  LION_STATE_SURFACE_TEMPERATURE      = 1 << 14,       ///< Surface temperature of the cell.
+  LION_STATE_KAPPA                    = 1 << 15,       ///< Electrolyte conductivity factor.
+  LION_STATE_SOC_NOMINAL              = 1 << 16,       ///< Nominal state of charge.
+  LION_STATE_CAPACITY_NOMINAL         = 1 << 17,       ///< Nominal capacity.
+  LION_STATE_SOC_USE                  = 1 << 18,       ///< Usable state of charge considering temperature.
+  LION_STATE_CAPACITY_USE             = 1 << 19,       ///< Usable capacity considering temperature.
+  LION_STATE_ALL                      = (1 << 20) - 1, ///< Every field.
+} lion_state_field_t;
+
+/// @brief Recorder of the state of a simulation.
+///
+/// The selected fields are appended after every step into typed column buffers, without any
+/// formatting, which can then be read as plain arrays. The columns are preallocated with the
+/// given capacity and grow geometrically when it runs out, so they may move when growing.
+typedef struct lion_recorder {
+  uint32_t             fields;   ///< Mask of the recorded fields.
+  size_t               len;      ///< Number of recorded steps.
+  size_t               capacity; ///< Number of steps which fit in the columns without growing them.
+  lion_state_columns_t columns;  ///< Recorded columns, NULL for the fields which are not recorded.
+} lion_recorder_t;
+
+/// @}
+
+/// @addtogroup functions
+/// @{
+
+/// @brief Create a new recorder.
+///
+/// @param[in]  fields    Mask of lion_state_field_t values to record.
+/// @param[in]  capacity  Number of steps to preallocate, 0 to start with a small default.
+/// @param[out] out       Pointer to where the recorder will be created.
+lion_status_t lion_recorder_new(uint32_t fields, size_t capacity, lion_recorder_t *out);
+
+/// Grow the columns of the recorder so that they fit at least capacity steps.
+lion_status_t lion_recorder_reserve(lion_recorder_t *recorder, size_t capacity);
+
+/// Append a state to the recorder.
+lion_status_t lion_recorder_append(lion_recorder_t *recorder, const lion_sim_state_t *state);
+
+/// Discard every recorded step, keeping the allocated columns.
+void lion_recorder_clear(lion_recorder_t *recorder);
+
+/// Clean up the recorder.
+lion_status_t lion_recorder_cleanup(lion_recorder_t *recorder);
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
@@ -2,12 +2,15 @@
 /// @brief Simulation creation, configuration and running.
 #pragma once
 
+#include "eval.h"
 #include "params.h"
 #include "status.h"
+#include "table.h"
 #include "vector.h"
 
 #include <gsl/gsl_min.h>
 #include <gsl/gsl_odeiv2.h>
+#include <lionu/log.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <time.h>
@@ -23,7 +26,9 @@ extern "C" {
 
 // Forward declarations
 
-typedef struct lion_sim lion_sim_t;
+typedef struct lion_sim      lion_sim_t;
+typedef struct lion_recorder lion_recorder_t;
+typedef struct lion_event    lion_event_t;
 
 // Debug declarations
 
@@ -60,19 +65,27 @@ typedef enum lion_regime {
 /// @brief Stepper algorithm for the ode solver.
 ///
 /// The types of steppers allowed are those allowed by GSL, and considers
-/// both explicit and implicit solvers.
+/// both explicit and implicit solvers. The native steppers do not use GSL, and are
+/// specialized for the system with its inputs frozen over a step, so they only
+/// support LION_STEP_MODE_FIXED. The state of charge then changes linearly and the
+/// internal temperature relaxes exponentially, which LION_STEPPER_EXACT steps in
+/// closed form, exactly at any step size.
 typedef enum lion_stepper {
-  LION_STEPPER_RK2,     ///< Explicit Runge-Kutta (2, 3).
-  LION_STEPPER_RK4,     ///< Explicit Runge-Kutta 4.
-  LION_STEPPER_RKF45,   ///< Explicit Runge-Kutta-Fehlberg (4, 5).
-  LION_STEPPER_RKCK,    ///< Explicit Runge-Kutta Cash-Karp (4, 5).
-  LION_STEPPER_RK8PD,   ///< Explicit Runge-Kutta Prince-Dormand (8, 9).
-  LION_STEPPER_RK1IMP,  ///< Implicit Euler.
-  LION_STEPPER_RK2IMP,  ///< Implicit Runge-Kutta 2.
-  LION_STEPPER_RK4IMP,  ///< Implicit Runge-Kutta 4.
-  LION_STEPPER_BSIMP,   ///< Implicit Bulirsch-Stoer.
-  LION_STEPPER_MSADAMS, ///< Multistep Adams.
-  LION_STEPPER_MSBDF,   ///< Multistep backwards differentiation.
+  LION_STEPPER_RK2,         ///< Explicit Runge-Kutta (2, 3).
+  LION_STEPPER_RK4,         ///< Explicit Runge-Kutta 4.
+  LION_STEPPER_RKF45,       ///< Explicit Runge-Kutta-Fehlberg (4, 5).
+  LION_STEPPER_RKCK,        ///< Explicit Runge-Kutta Cash-Karp (4, 5).
+  LION_STEPPER_RK8PD,       ///< Explicit Runge-Kutta Prince-Dormand (8, 9).
+  LION_STEPPER_RK1IMP,      ///< Implicit Euler.
+  LION_STEPPER_RK2IMP,      ///< Implicit Runge-Kutta 2.
+  LION_STEPPER_RK4IMP,      ///< Implicit Runge-Kutta 4.
+  LION_STEPPER_BSIMP,       ///< Implicit Bulirsch-Stoer.
+  LION_STEPPER_MSADAMS,     ///< Multistep Adams.
+  LION_STEPPER_MSBDF,       ///< Multistep backwards differentiation.
+  LION_STEPPER_EXACT,       ///< Closed form of the fixed step system.
+  LION_STEPPER_NATIVE_RK2,  ///< Native explicit midpoint.
+  LION_STEPPER_NATIVE_HEUN, ///< Native Heun.
+  LION_STEPPER_NATIVE_RK4,  ///< Native Runge-Kutta 4.
 } lion_stepper_t;
 
 /// @brief Minimizer algorithm for the optimization problem.
@@ -84,16 +97,69 @@ typedef enum lion_minimizer {
   LION_MINIMIZER_QUADGOLDEN,    ///< Brent with safeguarded step-length.
 } lion_minimizer_t;
 
+/// @brief Solver for the current of each step.
+///
+/// At each step the current I is the solution of the fixed-point problem I = f(I), where f
+/// depends on the internal resistance model. The following solvers are currently supported:
+/// - LION_CURRENT_SOLVER_MINIMIZER : minimizes |I - f(I)|^2 over a fixed bracket using the GSL minimizer.
+/// - LION_CURRENT_SOLVER_NEWTON    : warm-started Newton iteration on I - f(I) using the analytical dR/dI.
+/// - LION_CURRENT_SOLVER_SECANT    : warm-started secant iteration on I - f(I), does not require dR/dI.
+///
+/// Both root finders fall back to the bracketed minimization if they fail to converge.
+typedef enum lion_current_solver {
+  LION_CURRENT_SOLVER_MINIMIZER, ///< Bracketed minimization.
+  LION_CURRENT_SOLVER_NEWTON,    ///< Newton root finding.
+  LION_CURRENT_SOLVER_SECANT,    ///< Secant root finding.
+} lion_current_solver_t;
+
 /// @brief Jacobian calculation method.
 ///
 /// The following methods for jacobian calculation are currently supported:
 /// - LION_JACOBIAN_ANALYTICAL : uses the analytical equations to calculate the jacobian.
 /// - LION_JACOBIAN_2POINT     : uses central differences to numerically calculate the jacobian.
+/// - LION_JACOBIAN_AUTODIFF   : evaluates templated versions of the models on forward mode dual numbers, which gives
+///                              exact derivatives, including the dependence of the current on the states, without a
+///                              hand written expression to keep in sync with the models.
 typedef enum lion_jacobian_method {
   LION_JACOBIAN_ANALYTICAL, ///< Analytical method.
   LION_JACOBIAN_2POINT,     ///< Central differences method.
+  LION_JACOBIAN_AUTODIFF,   ///< Forward mode automatic differentiation.
 } lion_jacobian_method_t;
 
+/// @brief Integration mode of each step.
+///
+/// The following modes are currently supported:
+/// - LION_STEP_MODE_FIXED    : takes a single step of the stepper per call, with the current frozen at its value at the
+///                             start of the step.
+/// - LION_STEP_MODE_ADAPTIVE : holds the inputs constant over the step and integrates it with the error controlled
+///                             evolution of GSL, re-solving the current at every evaluation of the system. The step
+///                             size of the stepper is carried between calls, so sim_step_seconds becomes the sampling
+///                             period of the inputs rather than the integration step.
+/// - LION_STEP_MODE_DAE      : treats the current as an algebraic variable and solves it together with the state of
+///                             charge and the internal temperature in a single Newton iteration per step, with the
+///                             implicit BDF formulas. The current then matches the input at the end of the step instead
+///                             of being frozen at its start. The stepper is not used in this mode.
+typedef enum lion_step_mode {
+  LION_STEP_MODE_FIXED,    ///< Single fixed step per call.
+  LION_STEP_MODE_ADAPTIVE, ///< Error controlled steps over piecewise constant inputs.
+  LION_STEP_MODE_DAE,      ///< Implicit steps of the states and the current together.
+} lion_step_mode_t;
+
+/// @brief Input prescribed at each step.
+///
+/// The following modes are currently supported:
+/// - LION_INPUT_MODE_POWER   : the power drawn from the cell is prescribed, and the current is solved from it at every
+///                             step. Steps are taken with lion_sim_step.
+/// - LION_INPUT_MODE_CURRENT : the current drawn from the cell is prescribed, and the voltage and power follow from the
+///                             open circuit voltage and internal resistance without solving anything. Steps are taken
+///                             with lion_sim_step_current.
+///
+/// The running functions read their input vectors as power or current accordingly.
+typedef enum lion_input_mode {
+  LION_INPUT_MODE_POWER,   ///< Power prescribed.
+  LION_INPUT_MODE_CURRENT, ///< Current prescribed.
+} lion_input_mode_t;
+
 /// @brief Simulation metaparameters and hyperparameters.
 ///
 /// These parameters are not associated to the runtime of the sim itself, but rather
@@ -105,15 +171,22 @@ typedef struct lion_sim_config {
 
   /* Simulation metadata */
 
-  lion_regime_t          sim_regime;       ///< Regime to simulate.
-  lion_stepper_t         sim_stepper;      ///< Stepper algorithm.
-  lion_minimizer_t       sim_minimizer;    ///< Minimizer algorithm.
-  lion_jacobian_method_t sim_jacobian;     ///< Jacobian method.
-  double                 sim_time_seconds; ///< Total simulation time in seconds.
-  double                 sim_step_seconds; ///< Time of each simulation step in seconds.
-  double                 sim_epsabs;       ///< Absolute epsilon for update.
-  double                 sim_epsrel;       ///< Relative epsilon for update.
-  uint64_t               sim_min_maxiter;  ///< Maximum iterations of each minimization problem.
+  lion_regime_t          sim_regime;            ///< Regime to simulate.
+  lion_stepper_t         sim_stepper;           ///< Stepper algorithm.
+  lion_minimizer_t       sim_minimizer;         ///< Minimizer algorithm.
+  lion_jacobian_method_t sim_jacobian;          ///< Jacobian method.
+  lion_current_solver_t  sim_current_solver;    ///< Current solver algorithm.
+  lion_step_mode_t       sim_step_mode;         ///< Integration mode of each step.
+  lion_input_mode_t      sim_input_mode;        ///< Input prescribed at each step.
+  lion_model_backend_t   sim_model_backend;     ///< Backend evaluating the cell model.
+  lion_fast_math_t       sim_fast_math;         ///< Accuracy of the exponentials of the cell model.
+  double                 sim_time_seconds;      ///< Total simulation time in seconds.
+  double                 sim_step_seconds;      ///< Time of each simulation step in seconds.
+  double                 sim_epsabs;            ///< Absolute epsilon for update.
+  double                 sim_epsrel;            ///< Relative epsilon for update.
+  uint64_t               sim_min_maxiter;       ///< Maximum iterations of each minimization problem.
+  uint64_t               sim_table_points;      ///< Points of each 1-D table with LION_MODEL_BACKEND_TABLE.
+  uint64_t               sim_table_rint_points; ///< Points along each axis of the resistance table with LION_MODEL_BACKEND_TABLE.
 
   /* Logging configuration */
 
@@ -168,38 +241,89 @@ typedef struct lion_sim_state {
   double _next_internal_temperature; ///< Placeholder for the next internal temperature.
 } lion_sim_state_t;
 
+/// @brief Column buffers for the state of several steps.
+///
+/// Each field points to a caller-owned contiguous array with one element per step. Fields left as
+/// NULL are not recorded, so only the requested columns cost anything.
+typedef struct lion_state_columns {
+  double   *time;                     ///< Simulation time.
+  uint64_t *step;                     ///< Simulation step index.
+  double   *power;                    ///< Power being drawn from the cell.
+  double   *ambient_temperature;      ///< Ambient temperature around the cell.
+  double   *voltage;                  ///< Voltage in the terminals of the cell.
+  double   *current;                  ///< Current drawn from the cell.
+  double   *ref_open_circuit_voltage; ///< Reference open circuit voltage of the cell.
+  double   *open_circuit_voltage;     ///< Temperature aware open circuit voltage of the cell.
+  double   *internal_resistance;      ///< Internal resistance of the cell.
+  uint64_t *cycle;                    ///< Number of cycles the battery has been through.
+  double   *soh;                      ///< State of health of the cell.
+  double   *ehc;                      ///< Entropic heat coefficient.
+  double   *generated_heat;           ///< Heat generated by the cell.
+  double   *internal_temperature;     ///< Internal temperature of the cell.
+  double   *surface_temperature;      ///< Surface temperature of the cell.
+  double   *kappa;                    ///< Electrolyte conductivity factor.
+  double   *soc_nominal;              ///< Nominal state of charge.
+  double   *capacity_nominal;         ///< Nominal capacity.
+  double   *soc_use;                  ///< Usable state of charge considering temperature.
+  double   *capacity_use;             ///< Usable capacity considering temperature.
+} lion_state_columns_t;
+
 /// @brief Inputs for the solver.
 ///
 /// Both the current state and the parameters of the system are passed at each iteration of the solver,
-/// to be used for the update function as well as the Jacobian calculation.
+/// to be used for the update function as well as the Jacobian calculation. The evaluation context
+/// holds the model terms of the current step, shared by the right-hand side and the Jacobian. In the
+/// adaptive step mode the context is re-evaluated at every trial state of the stepper.
 typedef struct lion_slv_inputs {
   lion_sim_state_t *sys_inputs; ///< System state.
   lion_params_t    *sys_params; ///< System parameters.
+  lion_eval_t      *sys_eval;   ///< Evaluation context of the current step.
+  lion_sim_t       *sys_sim;    ///< Simulation owning the inputs, used to re-solve the current.
 } lion_slv_inputs_t;
 
 /// @brief Simulation runtime, used for setup and simulation.
 ///
 /// This contains all the variables which will be used by the simulation, both during the setup
-/// and during the runtime on a step-by-step basis.
+/// and during the runtime on a step-by-step basis. Nothing is shared between simulations, so
+/// different simulations can be used concurrently from different threads.
 typedef struct lion_sim {
   lion_sim_config_t *conf;                         ///< Hyperparameters and sim metadata.
   lion_params_t     *params;                       ///< System parameters.
   lion_sim_state_t   state;                        ///< System state.
   lion_slv_inputs_t  inputs;                       ///< Inputs to the solver.
+  lion_eval_t        eval;                         ///< Evaluation context of the current step.
   lion_status_t (*init_hook)(lion_sim_t *sim);     ///< Hook called upon initialization.
   lion_status_t (*update_hook)(lion_sim_t *sim);   ///< Hook called on each update of the simulation.
   lion_status_t (*finished_hook)(lion_sim_t *sim); ///< Hook called when the simulation is finished.
+  lion_recorder_t  *recorder;                      ///< Optional recorder of the state after each step.
+  lion_event_t     *events;                        ///< Events watched after each step.
+  size_t            events_len;                    ///< Number of events.
+  size_t            _events_capacity;              ///< Number of events which fit without growing.
+  int               _should_close;                 ///< Whether a stop event has triggered.
+  int               _input_switched;               ///< Whether a switch event has replaced the power input.
+  double            _switched_power;               ///< Power replacing the input after a switch event.
+  lion_input_mode_t _input_mode;                   ///< Input prescribed in the current step.
 
   /* Data handles */
 
   gsl_odeiv2_system              sys;                   ///< Handle to the ode system.
-  gsl_odeiv2_driver             *driver;                ///< Driver for the ode system.
+  gsl_odeiv2_driver             *driver;                ///< Driver for the ode system, NULL with native steppers or LION_STEP_MODE_DAE.
   gsl_min_fminimizer            *sys_min;               ///< Handle to the minimizer.
-  const gsl_odeiv2_step_type    *step_type;             ///< Stepper used by the ode system.
+  const gsl_odeiv2_step_type    *step_type;             ///< Stepper used by the ode system, NULL with native steppers or LION_STEP_MODE_DAE.
   const gsl_min_fminimizer_type *minimizer;             ///< Minimizer used by the optimizer.
-
-  char  log_filename[FILENAME_MAX + _LION_LOGFILE_MAX]; ///< Name of the log file.
-  FILE *log_file;                                       ///< Handle to the log file.
+  double                         _exact_decay;          ///< Decay of the internal temperature over a step with LION_STEPPER_EXACT.
+  double                         _dae_prev[2];          ///< States before the last step with LION_STEP_MODE_DAE.
+  double                         _dae_h;                ///< Size of the last step with LION_STEP_MODE_DAE.
+  double                         _dae_current;          ///< Current solved at the end of the last step with LION_STEP_MODE_DAE.
+  uint64_t                       _dae_steps;            ///< Steps with LION_STEP_MODE_DAE since the history was dropped.
+  lion_table_t                  *table;                 ///< Tables of the model, NULL with LION_MODEL_BACKEND_ANALYTIC.
+  int                            _owns_table;           ///< Whether the tables were built by this simulation, rather than shared by the one it forked from.
+  lion_rint_packed_t             _rint_packed;          ///< Fuzzy sets of the polarization model, packed once from the parameters.
+  lion_params_init_t             _init;                 ///< Initial conditions of the run, those of the parameters unless re-armed with others.
+
+  char       log_filename[FILENAME_MAX + _LION_LOGFILE_MAX]; ///< Name of the log file.
+  FILE      *log_file;                                       ///< Handle to the log file.
+  log_Logger logger;                                         ///< Logger of this simulation, with its own level and file sink.
 
 #ifndef NDEBUG
   /* Internal debug information */
@@ -241,20 +365,72 @@ lion_status_t lion_sim_new(lion_sim_config_t *conf, lion_params_t *params, lion_
 /// Initialize the simulation.
 lion_status_t lion_sim_init(lion_sim_t *sim);
 
-/// Reset the simulation.
+/// Reset the state of the simulation and the step history of its driver.
 lion_status_t lion_sim_reset(lion_sim_t *sim);
 
+/// @brief Re-arm the simulation for a new run.
+///
+/// Resets the state and reuses the driver and minimizer allocated by lion_sim_init, resetting them
+/// instead of allocating new ones, and skips the startup information. Initializes the simulation if
+/// it was not initialized yet. The driver is only replaced if the stepper changed, so changes to the
+/// tolerances of the configuration need lion_sim_init. The model tables are rebuilt whenever
+/// parameters are passed, even the ones already in use, or their settings in the configuration
+/// changed, so changes made to the parameters in place need them to be passed again.
+/// @param[in]  sim     Simulation to re-arm.
+/// @param[in]  params  New parameters of the simulation, can be NULL to keep the current ones.
+/// @param[in]  init    Initial conditions of the new run, kept by the simulation while the parameters
+///                     are left untouched. NULL takes the ones of the parameters.
+lion_status_t lion_sim_rearm(lion_sim_t *sim, lion_params_t *params, const lion_params_init_t *init);
+
+/// @brief Fork the simulation into independent branches.
+///
+/// Each branch continues from the current state of the simulation with its own state, events,
+/// driver and minimizer, while the configuration, parameters, model tables and hooks are shared
+/// with the simulation, so it must outlive the branches, and neither be re-armed nor have those
+/// changed while they run. Branches do
+/// not log to file nor record, and can be stepped in parallel with each other. Each one must be
+/// cleaned up with lion_sim_cleanup.
+/// @param[in]  sim  Initialized simulation to fork.
+/// @param[in]  k    Number of branches.
+/// @param[out] out  Array of k simulations where the branches will be created.
+lion_status_t lion_sim_fork(lion_sim_t *sim, size_t k, lion_sim_t *out);
+
 /// @brief Step the simulation in time.
 ///
-/// Steps the simulation forward considering some power and ambient temperature values.
+/// Steps the simulation forward considering some power and ambient temperature values. Only valid in
+/// the LION_INPUT_MODE_POWER input mode.
 /// @param[in]  sim                  Simulation to step forward.
 /// @param[in]  power                Power extracted from the cell.
 /// @param[in]  ambient_temperature  Ambient temperature around the cell.
 lion_status_t lion_sim_step(lion_sim_t *sim, double power, double ambient_temperature);
 
+/// @brief Step the simulation in time with a prescribed current.
+///
+/// Same as lion_sim_step for simulations in the LION_INPUT_MODE_CURRENT input mode.
+/// @param[in]  sim                  Simulation to step forward.
+/// @param[in]  current              Current drawn from the cell.
+/// @param[in]  ambient_temperature  Ambient temperature around the cell.
+lion_status_t lion_sim_step_current(lion_sim_t *sim, double current, double ambient_temperature);
+
+/// @brief Step the simulation several times in time.
+///
+/// Equivalent to calling lion_sim_step once per element of the inputs, or lion_sim_step_current in
+/// the LION_INPUT_MODE_CURRENT input mode, storing the state after each step in the requested
+/// columns. Stops after the step where a stop event triggers, and takes no step at all if one
+/// already did. If a step fails, the columns hold the steps completed before it.
+/// @param[in]  sim                  Simulation to step forward.
+/// @param[in]  power                Power, or current, extracted from the cell at each step.
+/// @param[in]  ambient_temperature  Ambient temperature around the cell at each step.
+/// @param[in]  n                    Number of steps.
+/// @param[out] out                  Columns to write the state of each step to, can be NULL.
+/// @param[out] taken                Number of steps completed, and of rows written to out, can be NULL.
+lion_status_t lion_sim_step_n(
+    lion_sim_t *sim, const double *power, const double *ambient_temperature, size_t n, lion_state_columns_t *out, size_t *taken
+);
+
 /// @brief Runs the simulation.
 ///
-/// Runs the simulation considering a vector of values.
+/// Runs the simulation considering a vector of values, re-arming it with lion_sim_rearm first.
 /// @param[in]  sim                  Simulation to run.
 /// @param[in]  power                Power extracted from the cell at each time step.
 /// @param[in]  ambient_temperature  Ambient temperature around the cell at each time step.
@@ -263,7 +439,7 @@ lion_status_t lion_sim_run(lion_sim_t *sim, lion_vector_t *power, lion_vector_t
 /// Get the version of the simulator.
 lion_version_t lion_sim_get_version(lion_sim_t *sim);
 
-/// Check whether the simulation should close.
+/// Check whether the simulation should close, which happens once a stop event triggers.
 int lion_sim_should_close(lion_sim_t *sim);
 
 /// Get the max number of iterations.
@@ -0,0 +1,87 @@
+/// @file
+/// @brief Snapshots of a running simulation, to restore it later or in another simulation.
+#pragma once
+
+#include "sim.h"
+#include "status.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @addtogroup types
+/// @{
+
+/// @brief State of an event within a snapshot.
+typedef struct lion_snapshot_event {
+  uint64_t triggered; ///< Number of times the event had triggered.
+  double   time;      ///< Time of the last trigger.
+  double   value;     ///< Value of the field at the last trigger.
+} lion_snapshot_event_t;
+
+/// @brief Snapshot of a simulation.
+///
+/// Holds everything which evolves during a run: the state, the step size of the driver and the
+/// progress of the events. The configuration, parameters and events themselves belong to the
+/// simulation the snapshot is restored into. The history of the multistep steppers is kept opaque
+/// by GSL, so it is rebuilt from the restored state instead of being stored, while the history of
+/// LION_STEP_MODE_DAE is stored so that a restored simulation continues exactly.
+typedef struct lion_snapshot {
+  lion_sim_state_t       state;          ///< State of the simulation.
+  double                 step_size;      ///< Step size of the driver.
+  int                    should_close;   ///< Whether an event stopped the simulation.
+  int                    input_switched; ///< Whether an event switched the power input.
+  double                 switched_power; ///< Power input switched to by an event.
+  lion_input_mode_t      input_mode;     ///< Input prescribed in the last step.
+  double                 dae_prev[2];    ///< States before the last step with LION_STEP_MODE_DAE.
+  double                 dae_h;          ///< Size of the last step with LION_STEP_MODE_DAE.
+  double                 dae_current;    ///< Current solved at the end of the last step with LION_STEP_MODE_DAE.
+  uint64_t               dae_steps;      ///< Steps with LION_STEP_MODE_DAE since the history was dropped.
+  size_t                 events_len;     ///< Number of events.
+  lion_snapshot_event_t *events;         ///< State of each event, NULL without events.
+} lion_snapshot_t;
+
+/// @}
+
+/// @addtogroup functions
+/// @{
+
+/// @brief Take a snapshot of a simulation.
+///
+/// @param[in]  sim  Simulation to take the snapshot of.
+/// @param[out] out  Pointer to where the snapshot will be created, cleaned up with lion_snapshot_cleanup.
+lion_status_t lion_sim_snapshot(lion_sim_t *sim, lion_snapshot_t *out);
+
+/// @brief Restore a simulation from a snapshot.
+///
+/// The simulation is initialized first if it was not, and must have as many events as the
+/// simulation the snapshot was taken from. The driver is reset to the step size of the snapshot, and
+/// the history of LION_STEP_MODE_DAE is restored.
+/// @param[in]  sim       Simulation to restore.
+/// @param[in]  snapshot  Snapshot to restore.
+lion_status_t lion_sim_restore(lion_sim_t *sim, const lion_snapshot_t *snapshot);
+
+/// @brief Save a snapshot into a binary file.
+///
+/// The file is only meant to be loaded on the same platform and version of the library.
+/// @param[in]  snapshot  Snapshot to save.
+/// @param[in]  filename  Path of the file.
+lion_status_t lion_snapshot_save(const lion_snapshot_t *snapshot, const char *filename);
+
+/// @brief Load a snapshot from a binary file written by lion_snapshot_save.
+///
+/// @param[in]  filename  Path of the file.
+/// @param[out] out       Pointer to where the snapshot will be created, cleaned up with lion_snapshot_cleanup.
+lion_status_t lion_snapshot_load(const char *filename, lion_snapshot_t *out);
+
+/// Clean up a snapshot.
+lion_status_t lion_snapshot_cleanup(lion_snapshot_t *snapshot);
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,65 @@
+/// @file
+/// @brief Parallel runner for many independent simulations.
+#pragma once
+
+#include "params.h"
+#include "sim.h"
+#include "status.h"
+#include "vector.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @addtogroup types
+/// @{
+
+/// @brief Simulation to be run as part of a sweep.
+///
+/// Inputs are only read, so the same vectors can be shared by any number of jobs.
+typedef struct lion_sweep_job {
+  lion_sim_config_t   *conf;                       ///< Simulation configuration.
+  lion_params_t       *params;                     ///< System parameters.
+  const lion_vector_t *power;                      ///< Power extracted from the cell at each time step.
+  const lion_vector_t *ambient_temperature;        ///< Ambient temperature around the cell at each time step.
+  lion_status_t (*update_hook)(lion_sim_t *sim);   ///< Optional hook called on each update of the simulation.
+  lion_status_t (*finished_hook)(lion_sim_t *sim); ///< Optional hook called when the simulation is finished.
+} lion_sweep_job_t;
+
+/// @brief Outcome of a single job of a sweep.
+typedef struct lion_sweep_result {
+  lion_status_t    status; ///< Status of the job.
+  lion_sim_state_t state;  ///< State of the simulation after the last step.
+  size_t           worker; ///< Index of the worker thread which ran the job.
+} lion_sweep_result_t;
+
+/// @}
+
+/// @addtogroup functions
+/// @{
+
+/// @brief Run a list of simulations in parallel.
+///
+/// Jobs are split between the worker threads, and idle workers steal pending jobs from busy ones
+/// so that all the threads stay busy until the end of the sweep. Each job writes only to its own
+/// result, so no locking is needed to collect them. A worker sets up a simulation once and re-arms
+/// it for every following job with the same configuration, so configurations must not be changed
+/// while the sweep runs.
+/// @param[in]  jobs     Jobs to run.
+/// @param[in]  count    Number of jobs.
+/// @param[in]  threads  Number of worker threads, 0 uses one per available core.
+/// @param[out] results  Result of each job, must have room for count elements.
+/// @return Failure if the sweep could not be set up, the status of each job is stored in its result.
+lion_status_t lion_sweep_run(lion_sweep_job_t *jobs, size_t count, size_t threads, lion_sweep_result_t *results);
+
+/// Get the number of worker threads used by default.
+size_t lion_sweep_default_threads(void);
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,68 @@
+/// @file
+/// @brief Tabulated backend of the cell model.
+#pragma once
+
+#include "params.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @addtogroup types
+/// @{
+
+/// @brief Model backend used to evaluate the cell model.
+///
+/// The following backends are currently supported:
+/// - LION_MODEL_BACKEND_ANALYTIC : evaluates the closed form of every model.
+/// - LION_MODEL_BACKEND_TABLE    : samples the open circuit voltage, the entropic heat coefficient and kappa, with their
+///                                 gradients, on uniform 1-D grids, and the polarization resistance on a 2-D grid over
+///                                 the usable SoC and the current, when the sim is initialized. Evaluations then
+///                                 interpolate the tables, falling back to the closed form outside of them.
+typedef enum lion_model_backend {
+  LION_MODEL_BACKEND_ANALYTIC, ///< Closed form models.
+  LION_MODEL_BACKEND_TABLE,    ///< Interpolated tables built from the parameters.
+} lion_model_backend_t;
+
+/// @brief Tables of the cell model over uniform grids.
+///
+/// The tables live in the same allocation as the struct, right after it. The open circuit voltage and the entropic heat
+/// coefficient are interpolated with cubic Hermite splines on their value and gradient, kappa likewise over the
+/// internal temperature, and the resistance bilinearly. The errors are the largest ones found between the grid points
+/// when the tables are built.
+typedef struct lion_table {
+  size_t points;      ///< Points of each 1-D table.
+  size_t rint_points; ///< Points along each axis of the resistance table, 0 when it is not tabulated.
+
+  double soc_min;       ///< Lowest usable SoC of the tables.
+  double soc_max;       ///< Highest usable SoC of the tables.
+  double soc_scale;     ///< Inverse spacing of the SoC grid.
+  double temp_min;      ///< Lowest internal temperature of the tables.
+  double temp_max;      ///< Highest internal temperature of the tables.
+  double temp_scale;    ///< Inverse spacing of the temperature grid.
+  double rsoc_scale;    ///< Inverse spacing of the SoC axis of the resistance table.
+  double current_min;   ///< Lowest current of the resistance table.
+  double current_max;   ///< Highest current of the resistance table.
+  double current_scale; ///< Inverse spacing of the current axis of the resistance table.
+
+  double *voc;        ///< Reference open circuit voltage over the usable SoC.
+  double *voc_grad;   ///< Gradient of the reference open circuit voltage.
+  double *ehc;        ///< Entropic heat coefficient over the usable SoC.
+  double *ehc_grad;   ///< Gradient of the entropic heat coefficient.
+  double *kappa;      ///< Kappa over the internal temperature.
+  double *kappa_grad; ///< Gradient of kappa.
+  double *rint;       ///< Resistance over the usable SoC (rows) and the current (columns), NULL if not tabulated.
+
+  double voc_error;   ///< Largest error of the open circuit voltage.
+  double ehc_error;   ///< Largest error of the entropic heat coefficient.
+  double kappa_error; ///< Largest error of kappa.
+  double rint_error;  ///< Largest error of the resistance.
+} lion_table_t;
+
+/// @}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <lion/batch.h>
+#include <lionpp/sim.hpp>
+#include <lionpp/status.hpp>
+#include <span>
+#include <vector>
+
+namespace lion {
+
+class Batch {
+public:
+  Batch(SimConfig *conf, SimParams *params, size_t count);
+  Batch(SimConfig *conf, std::vector<lion_params_t> &params);
+  Batch(Batch const &)            = delete;
+  Batch &operator=(Batch const &) = delete;
+  ~Batch();
+
+  operator lion_batch_t *();
+
+  Status init();
+  Status step(std::vector<double> const &power, std::vector<double> const &amb_temp);
+  size_t size() const;
+
+  std::span<const double> current() const;
+  std::span<const double> voltage() const;
+  std::span<const double> soc() const;
+  std::span<const double> internal_temperature() const;
+  std::span<const double> soh() const;
+
+private:
+  lion_batch_t *handle;
+};
+
+// Single precision counterpart of Batch
+class BatchF32 {
+public:
+  BatchF32(SimConfig *conf, SimParams *params, size_t count);
+  BatchF32(SimConfig *conf, std::vector<lion_params_t> &params);
+  BatchF32(BatchF32 const &)            = delete;
+  BatchF32 &operator=(BatchF32 const &) = delete;
+  ~BatchF32();
+
+  operator lion_batch_f32_t *();
+
+  Status init();
+  Status step(std::vector<float> const &power, std::vector<float> const &amb_temp);
+  size_t size() const;
+
+  std::span<const float> current() const;
+  std::span<const float> voltage() const;
+  std::span<const float> soc() const;
+  std::span<const float> internal_temperature() const;
+  std::span<const float> soh() const;
+
+private:
+  lion_batch_f32_t *handle;
+};
+
+} // namespace lion
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <lion/input.h>
+#include <span>
+
+namespace lion {
+
+class Input {
+public:
+  static Input fixed_rate(std::span<const double> values, double start_time, double period, lion_interp_t interp = LION_INTERP_LINEAR);
+  static Input timestamped(std::span<const double> timestamps, std::span<const double> values, lion_interp_t interp = LION_INTERP_LINEAR);
+
+  operator lion_input_t *();
+
+  double at(double time);
+  double start_time() const;
+  double end_time() const;
+
+private:
+  Input() = default;
+
+  lion_input_t handle;
+};
+
+} // namespace lion
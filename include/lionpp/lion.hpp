@@ -1,5 +1,9 @@
 #pragma once
 
+#include "batch.hpp"
+#include "input.hpp"
+#include "recorder.hpp"
 #include "sim.hpp"
 #include "status.hpp"
+#include "sweep.hpp"
 #include "vector.hpp"
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <lion/recorder.h>
+#include <lionpp/sim.hpp>
+#include <span>
+
+namespace lion {
+
+class Recorder {
+public:
+  Recorder(Sim &sim, uint32_t fields, size_t capacity = 0);
+  Recorder(Recorder const &)            = delete;
+  Recorder &operator=(Recorder const &) = delete;
+  ~Recorder();
+
+  operator lion_recorder_t *();
+
+  size_t size() const;
+  void   clear();
+
+  std::span<const double>   column(lion_state_field_t field) const;
+  std::span<const uint64_t> step() const;
+  std::span<const uint64_t> cycle() const;
+
+private:
+  lion_sim_t     *sim;
+  lion_recorder_t handle;
+};
+
+} // namespace lion
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <lion/event.h>
+#include <lion/protocol.h>
 #include <lion/sim.h>
+#include <lion/snapshot.h>
+#include <lionpp/input.hpp>
 #include <lionpp/status.hpp>
+#include <memory>
+#include <span>
 #include <vector>
 
 namespace lion {
@@ -15,17 +21,21 @@ enum SimRegime {
 class SimStepper {
 public:
   enum Value {
-    RK2     = LION_STEPPER_RK2,
-    RK4     = LION_STEPPER_RK4,
-    RKF45   = LION_STEPPER_RKF45,
-    RKCK    = LION_STEPPER_RKCK,
-    RK8PD   = LION_STEPPER_RK8PD,
-    RK1IMP  = LION_STEPPER_RK1IMP,
-    RK2IMP  = LION_STEPPER_RK2IMP,
-    RK4IMP  = LION_STEPPER_RK4IMP,
-    BSIMP   = LION_STEPPER_BSIMP,
-    MSADAMS = LION_STEPPER_MSADAMS,
-    MSBDF   = LION_STEPPER_MSBDF,
+    RK2         = LION_STEPPER_RK2,
+    RK4         = LION_STEPPER_RK4,
+    RKF45       = LION_STEPPER_RKF45,
+    RKCK        = LION_STEPPER_RKCK,
+    RK8PD       = LION_STEPPER_RK8PD,
+    RK1IMP      = LION_STEPPER_RK1IMP,
+    RK2IMP      = LION_STEPPER_RK2IMP,
+    RK4IMP      = LION_STEPPER_RK4IMP,
+    BSIMP       = LION_STEPPER_BSIMP,
+    MSADAMS     = LION_STEPPER_MSADAMS,
+    MSBDF       = LION_STEPPER_MSBDF,
+    EXACT       = LION_STEPPER_EXACT,
+    NATIVE_RK2  = LION_STEPPER_NATIVE_RK2,
+    NATIVE_HEUN = LION_STEPPER_NATIVE_HEUN,
+    NATIVE_RK4  = LION_STEPPER_NATIVE_RK4,
   };
 
   SimStepper() = default;
@@ -48,6 +58,34 @@ enum SimMinimizer {
   QUADGOLDEN    = LION_MINIMIZER_QUADGOLDEN,
 };
 
+enum SimCurrentSolver {
+  MINIMIZER = LION_CURRENT_SOLVER_MINIMIZER,
+  NEWTON    = LION_CURRENT_SOLVER_NEWTON,
+  SECANT    = LION_CURRENT_SOLVER_SECANT,
+};
+
+enum SimStepMode {
+  FIXED    = LION_STEP_MODE_FIXED,
+  ADAPTIVE = LION_STEP_MODE_ADAPTIVE,
+  DAE      = LION_STEP_MODE_DAE,
+};
+
+enum SimInputMode {
+  POWER   = LION_INPUT_MODE_POWER,
+  CURRENT = LION_INPUT_MODE_CURRENT,
+};
+
+enum SimModelBackend {
+  ANALYTIC = LION_MODEL_BACKEND_ANALYTIC,
+  TABLE    = LION_MODEL_BACKEND_TABLE,
+};
+
+enum SimFastMath {
+  OFF       = LION_FAST_MATH_OFF,
+  TIER_1E12 = LION_FAST_MATH_1E12,
+  TIER_1E7  = LION_FAST_MATH_1E7,
+};
+
 class SimConfig {
 public:
   SimConfig();
@@ -90,12 +128,27 @@ public:
 
   operator lion_sim_t *();
 
+  Status   init();
+  Status   reset();
+  Status   rearm(SimParams *params = nullptr, lion_params_init_t const *init = nullptr);
   Status   step(double power, double amb_temp);
+  Status   step_current(double current, double amb_temp);
+  Status   step_n(std::span<const double> power, std::span<const double> amb_temp, lion_state_columns_t *out = nullptr, size_t *taken = nullptr);
   Status   run(std::vector<double> const &power, std::vector<double> const &amb_temp);
+  Status   run_resampled(Input &power, Input &amb_temp);
+  Status   run_protocol(lion_protocol_t &protocol, double amb_temp);
+  Status   snapshot(lion_snapshot_t &out);
+  Status   restore(lion_snapshot_t const &snapshot);
+  Status   add_event(lion_event_t const &event);
+  void     clear_events();
   bool     should_close() const;
   uint64_t max_iters() const;
 
+  std::vector<std::unique_ptr<Sim>> fork(size_t k);
+
 private:
+  explicit Sim(lion_sim_t *handle);
+
   lion_sim_t *handle;
 };
 
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <lion/sweep.h>
+#include <lionpp/sim.hpp>
+#include <lionpp/status.hpp>
+#include <vector>
+
+namespace lion {
+
+class Sweep {
+public:
+  Sweep();
+  Sweep(Sweep const &)            = delete;
+  Sweep &operator=(Sweep const &) = delete;
+  ~Sweep();
+
+  size_t add_input(std::vector<double> const &values);
+  size_t add_job(SimConfig *conf, SimParams *params, size_t power_input, size_t amb_temp_input);
+
+  Status run(size_t threads = 0);
+  size_t size() const;
+
+  std::vector<lion_sweep_result_t> const &results() const;
+
+private:
+  std::vector<lion_vector_t>       inputs;
+  std::vector<lion_sweep_job_t>    jobs;
+  std::vector<size_t>              job_inputs;
+  std::vector<lion_sweep_result_t> job_results;
+};
+
+} // namespace lion
@@ -10,6 +10,7 @@ typedef struct lion_mf_gaussian_params {
 } lion_mf_gaussian_params_t;
 
 double lion_mf_gaussian(double x, lion_mf_gaussian_params_t *params);
+double lion_mf_gaussian_grad(double x, lion_mf_gaussian_params_t *params);
 
 #ifdef __cplusplus
 }
@@ -20,8 +20,9 @@ extern "C" {
 #ifndef SOURCE_PATH_SIZE
   #define SOURCE_PATH_SIZE 0
 #endif
-#define LOG_VERSION  "0.1.0"
-#define __FILENAME__ (&__FILE__[SOURCE_PATH_SIZE])
+#define LOG_VERSION       "0.1.0"
+#define LOG_MAX_CALLBACKS 32
+#define __FILENAME__      (&__FILE__[SOURCE_PATH_SIZE])
 
 typedef struct {
   va_list     ap;
@@ -36,6 +37,20 @@ typedef struct {
 typedef void (*log_LogFn)(log_Event *ev);
 typedef void (*log_LockFn)(bool lock, void *udata);
 
+typedef struct {
+  log_LogFn fn;
+  void     *udata;
+  int       level;
+} log_Callback;
+
+typedef struct {
+  void        *udata;
+  log_LockFn   lock;
+  int          level;
+  bool         quiet;
+  log_Callback callbacks[LOG_MAX_CALLBACKS];
+} log_Logger;
+
 enum { LOG_TRACE, LOG_DEBUG, LOG_INFO, LOG_WARN, LOG_ERROR, LOG_FATAL };
 
 #define log_trace(...) log_log(LOG_TRACE, __FILENAME__, __LINE__, __VA_ARGS__)
@@ -52,6 +67,12 @@ void        log_set_quiet(bool enable);
 int         log_add_callback(log_LogFn fn, void *udata, int level);
 int         log_add_fp(FILE *fp, int level);
 
+void        log_logger_init(log_Logger *logger, int level);
+int         log_logger_add_callback(log_Logger *logger, log_LogFn fn, void *udata, int level);
+int         log_logger_add_fp(log_Logger *logger, FILE *fp, int level);
+log_Logger *log_get_logger(void);
+log_Logger *log_set_thread_logger(log_Logger *logger);
+
 void log_log(int level, const char *file, int line, const char *fmt, ...);
 
 #ifdef __cplusplus
@@ -1,7 +1,11 @@
 import lion_ffi
 
 from lion.sim import Sim, Params, Config, LogLvl, State
-from lion.sim_config import Regime, Stepper, Minimizer
+from lion.recorder import Recorder
+from lion.snapshot import Snapshot
+from lion.protocol import Protocol, Segment
+from lion.sim_config import Regime, Stepper, Minimizer, CurrentSolver, StepMode, InputMode, ModelBackend, FastMath, Interp
+from lion.sim_config import EventDirection, EventAction, SegmentType
 from lion.exceptions import LionException
 from lion.status import Status, ffi_call
 from lion.vector import Vector, Vectorizable
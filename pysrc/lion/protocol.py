@@ -0,0 +1,94 @@
+from dataclasses import dataclass
+
+import lion_ffi as _
+from lion._lion import ffi
+from lion._lion import lib as _lionl
+from lion.sim import Sim, STATE_COLUMNS
+from lion.sim_config import SegmentType, EventDirection
+from lion.status import ffi_call
+
+
+@dataclass
+class Segment:
+    """Segment of a protocol, ending at the first of its transition conditions
+
+    `value` is the current, power or voltage held by the segment, with positive
+    currents and powers discharging the cell. `voltage` is the limit of CCCV
+    segments, and `taper` the current cutoff of their constant voltage phase.
+    """
+
+    type: SegmentType
+    value: float = 0.0
+    voltage: float = 0.0
+    taper: float = 0.0
+    duration: float = 0.0
+    until: str | None = None
+    until_threshold: float = 0.0
+    until_direction: EventDirection = EventDirection.EITHER
+
+    @classmethod
+    def rest(cls, duration: float) -> "Segment":
+        return cls(SegmentType.REST, duration=duration)
+
+    @classmethod
+    def cc(cls, current: float, **kwargs) -> "Segment":
+        return cls(SegmentType.CC, value=current, **kwargs)
+
+    @classmethod
+    def cp(cls, power: float, **kwargs) -> "Segment":
+        return cls(SegmentType.CP, value=power, **kwargs)
+
+    @classmethod
+    def cv(cls, voltage: float, **kwargs) -> "Segment":
+        return cls(SegmentType.CV, value=voltage, **kwargs)
+
+    @classmethod
+    def cccv(cls, current: float, voltage: float, **kwargs) -> "Segment":
+        return cls(SegmentType.CCCV, value=current, voltage=voltage, **kwargs)
+
+
+class Protocol:
+    """Program of segments run natively by a sim, `cycles` times over"""
+
+    __slots__ = ("_cdata", "_segments", "segments")
+
+    def __init__(self, segments: list[Segment], cycles: int = 1):
+        self.segments = list(segments)
+        self._segments = ffi.new("lion_segment_t[]", len(self.segments))
+        for csegment, segment in zip(self._segments, self.segments):
+            if segment.until is not None and segment.until not in STATE_COLUMNS:
+                raise KeyError(f"State has no column '{segment.until}'")
+            csegment.type = segment.type.value
+            csegment.value = segment.value
+            csegment.voltage = segment.voltage
+            csegment.taper = segment.taper
+            csegment.duration = segment.duration
+            csegment.until = 0 if segment.until is None else getattr(_lionl, f"LION_STATE_{segment.until.upper()}")
+            csegment.until_threshold = segment.until_threshold
+            csegment.until_direction = segment.until_direction.value
+        self._cdata = ffi.new("lion_protocol_t *")
+        self._cdata.segments = self._segments
+        self._cdata.len = len(self.segments)
+        self._cdata.cycles = cycles
+
+    def run(self, sim: Sim, amb_temp: float):
+        ffi_call(
+            _lionl.lion_sim_run_protocol(sim._cdata, self._cdata, amb_temp),
+            "Failed running protocol",
+        )
+        sim._initialized = True
+
+    @property
+    def segment(self) -> int:
+        """Index of the segment being run"""
+        return self._cdata.segment
+
+    @property
+    def cycle(self) -> int:
+        """Index of the cycle being run"""
+        return self._cdata.cycle
+
+    @property
+    def segment_start(self) -> float:
+        """Time at which the segment being run started"""
+        return self._cdata.segment_start
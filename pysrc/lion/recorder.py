@@ -0,0 +1,72 @@
+import numpy as np
+
+import lion_ffi as _
+from lion._lion import ffi
+from lion._lion import lib as _lionl
+from lion.exceptions import LionException
+from lion.sim import Sim, STATE_COLUMNS
+from lion.status import ffi_call
+from lion_utils.logger import LOGGER
+
+
+class Recorder:
+    """Records the selected state fields of a sim after every step"""
+
+    __slots__ = ("_cdata", "_sim", "fields")
+
+    def __init__(
+        self,
+        sim: Sim,
+        fields: list[str] | None = None,
+        capacity: int = 0,
+    ):
+        LOGGER.debug("Creating lion.Recorder")
+        if fields is None:
+            fields = list(STATE_COLUMNS.keys())
+        mask = 0
+        for field in fields:
+            if field not in STATE_COLUMNS:
+                raise KeyError(f"State has no column '{field}'")
+            mask |= getattr(_lionl, f"LION_STATE_{field.upper()}")
+        self.fields = list(fields)
+        self._cdata = ffi.new("lion_recorder_t *")
+        ffi_call(
+            _lionl.lion_recorder_new(mask, capacity, self._cdata),
+            "Failed creating recorder",
+        )
+        self._sim = sim
+        sim._cdata.recorder = self._cdata
+
+    def __del__(self):
+        LOGGER.debug("Cleaning up lion.Recorder")
+        if self._sim._cdata.recorder == self._cdata:
+            self._sim._cdata.recorder = ffi.NULL
+        try:
+            ffi_call(
+                _lionl.lion_recorder_cleanup(self._cdata),
+                "Failed cleanup of recorder",
+            )
+        except LionException as e:
+            LOGGER.error(f"Recorder cleanup failed with exception '{e}'")
+
+    def __len__(self) -> int:
+        return self._cdata.len
+
+    def clear(self):
+        _lionl.lion_recorder_clear(self._cdata)
+
+    def column(self, field: str) -> np.ndarray:
+        """View of a recorded column without copying
+
+        The view is only valid until the next step, since recording may need to
+        move the column to grow it.
+        """
+        if field not in self.fields:
+            raise KeyError(f"Field '{field}' is not being recorded")
+        dtype = STATE_COLUMNS[field]
+        n = self._cdata.len
+        ptr = getattr(self._cdata.columns, field)
+        return np.frombuffer(ffi.buffer(ptr, n * np.dtype(dtype).itemsize), dtype=dtype)
+
+    def as_dict(self) -> dict[str, np.ndarray]:
+        return {field: self.column(field) for field in self.fields}
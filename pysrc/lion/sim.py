@@ -14,7 +14,8 @@ from lion import dtypes, models
 # from lion.models import ehc, init, ocv, rint, temp, vft
 from lion.exceptions import LionException
 from lion.status import Status, ffi_call
-from lion.sim_config import Stepper, Regime, Minimizer
+from lion.sim_config import Stepper, Regime, Minimizer, CurrentSolver, StepMode, InputMode, ModelBackend, FastMath, Interp
+from lion.sim_config import EventDirection, EventAction
 from lion.vector import Vector, Vectorizable
 from lion_utils.logger import LOGGER
 
@@ -43,6 +44,31 @@ def _generate_finished_pythoncb(sim: "Sim", func: Callable[["Sim"], Status]):
     return finished_pythoncb
 
 
+# Columns that `Sim.step_n` can record, with the type of their elements
+STATE_COLUMNS = {
+    "time": np.float64,
+    "step": np.uint64,
+    "power": np.float64,
+    "ambient_temperature": np.float64,
+    "voltage": np.float64,
+    "current": np.float64,
+    "ref_open_circuit_voltage": np.float64,
+    "open_circuit_voltage": np.float64,
+    "internal_resistance": np.float64,
+    "cycle": np.uint64,
+    "soh": np.float64,
+    "ehc": np.float64,
+    "generated_heat": np.float64,
+    "internal_temperature": np.float64,
+    "surface_temperature": np.float64,
+    "kappa": np.float64,
+    "soc_nominal": np.float64,
+    "capacity_nominal": np.float64,
+    "soc_use": np.float64,
+    "capacity_use": np.float64,
+}
+
+
 class LogLvl(Enum):
     TRACE = _lionl.LOG_TRACE
     DEBUG = _lionl.LOG_DEBUG
@@ -85,10 +111,17 @@ class Config:
         regime: Regime | None = None,
         stepper: Stepper | None = None,
         minimizer: Minimizer | None = None,
+        current_solver: CurrentSolver | None = None,
+        step_mode: StepMode | None = None,
+        input_mode: InputMode | None = None,
+        model_backend: ModelBackend | None = None,
+        fast_math: FastMath | None = None,
         step: float | None = None,
         epsabs: float | None = None,
         epsrel: float | None = None,
         min_maxiter: int | None = None,
+        table_points: int | None = None,
+        table_rint_points: int | None = None,
         log_stdlvl: LogLvl | None = None,
     ):
         self._cdata = ffi.new("lion_sim_config_t *", _lionl.lion_sim_config_default())
@@ -101,6 +134,16 @@ class Config:
             self.sim_stepper = stepper
         if minimizer is not None:
             self.sim_minimizer = minimizer
+        if current_solver is not None:
+            self.sim_current_solver = current_solver
+        if step_mode is not None:
+            self.sim_step_mode = step_mode
+        if input_mode is not None:
+            self.sim_input_mode = input_mode
+        if model_backend is not None:
+            self.sim_model_backend = model_backend
+        if fast_math is not None:
+            self.sim_fast_math = fast_math
         if step is not None:
             self.sim_step_seconds = step
         if epsabs is not None:
@@ -109,6 +152,10 @@ class Config:
             self.sim_epsrel = epsrel
         if min_maxiter is not None:
             self.sim_min_maxiter = min_maxiter
+        if table_points is not None:
+            self.sim_table_points = table_points
+        if table_rint_points is not None:
+            self.sim_table_rint_points = table_rint_points
 
         if log_stdlvl is not None:
             self.log_stdlvl = log_stdlvl
@@ -149,6 +196,46 @@ class Config:
     def sim_minimizer(self, new_minimizer: Minimizer):
         self._cdata.sim_minimizer = new_minimizer.value
 
+    @property
+    def sim_current_solver(self) -> CurrentSolver:
+        return CurrentSolver(self._cdata.sim_current_solver)
+
+    @sim_current_solver.setter
+    def sim_current_solver(self, new_solver: CurrentSolver):
+        self._cdata.sim_current_solver = new_solver.value
+
+    @property
+    def sim_step_mode(self) -> StepMode:
+        return StepMode(self._cdata.sim_step_mode)
+
+    @sim_step_mode.setter
+    def sim_step_mode(self, new_mode: StepMode):
+        self._cdata.sim_step_mode = new_mode.value
+
+    @property
+    def sim_input_mode(self) -> InputMode:
+        return InputMode(self._cdata.sim_input_mode)
+
+    @sim_input_mode.setter
+    def sim_input_mode(self, new_mode: InputMode):
+        self._cdata.sim_input_mode = new_mode.value
+
+    @property
+    def sim_model_backend(self) -> ModelBackend:
+        return ModelBackend(self._cdata.sim_model_backend)
+
+    @sim_model_backend.setter
+    def sim_model_backend(self, new_backend: ModelBackend):
+        self._cdata.sim_model_backend = new_backend.value
+
+    @property
+    def sim_fast_math(self) -> FastMath:
+        return FastMath(self._cdata.sim_fast_math)
+
+    @sim_fast_math.setter
+    def sim_fast_math(self, new_tier: FastMath):
+        self._cdata.sim_fast_math = new_tier.value
+
     @property
     def sim_step_seconds(self) -> float:
         return self._cdata.sim_step_seconds
@@ -181,6 +268,22 @@ class Config:
     def sim_min_maxiter(self, new_maxiter: int):
         self._cdata.sim_min_maxiter = new_maxiter
 
+    @property
+    def sim_table_points(self) -> int:
+        return self._cdata.sim_table_points
+
+    @sim_table_points.setter
+    def sim_table_points(self, new_points: int):
+        self._cdata.sim_table_points = new_points
+
+    @property
+    def sim_table_rint_points(self) -> int:
+        return self._cdata.sim_table_rint_points
+
+    @sim_table_rint_points.setter
+    def sim_table_rint_points(self, new_points: int):
+        self._cdata.sim_table_rint_points = new_points
+
     @property
     def log_stdlvl(self) -> LogLvl:
         return LogLvl(self._cdata.log_stdlvl)
@@ -196,10 +299,17 @@ class Config:
             regime=Regime[d["sim_regime"]],
             stepper=Stepper[d["sim_stepper"]],
             minimizer=Minimizer[d["sim_minimizer"]],
+            current_solver=CurrentSolver[d["sim_current_solver"]] if "sim_current_solver" in d else None,
+            step_mode=StepMode[d["sim_step_mode"]] if "sim_step_mode" in d else None,
+            input_mode=InputMode[d["sim_input_mode"]] if "sim_input_mode" in d else None,
+            model_backend=ModelBackend[d["sim_model_backend"]] if "sim_model_backend" in d else None,
+            fast_math=FastMath[d["sim_fast_math"]] if "sim_fast_math" in d else None,
             step=d["sim_step_seconds"],
             epsabs=d["sim_epsabs"],
             epsrel=d["sim_epsrel"],
             min_maxiter=d["sim_min_maxiter"],
+            table_points=d.get("sim_table_points"),
+            table_rint_points=d.get("sim_table_rint_points"),
             log_stdlvl=LogLvl[d["log_stdlvl"]],
         )
 
@@ -209,10 +319,17 @@ class Config:
             "sim_regime": self.sim_regime.name,
             "sim_stepper": self.sim_stepper.name,
             "sim_minimizer": self.sim_minimizer.name,
+            "sim_current_solver": self.sim_current_solver.name,
+            "sim_step_mode": self.sim_step_mode.name,
+            "sim_input_mode": self.sim_input_mode.name,
+            "sim_model_backend": self.sim_model_backend.name,
+            "sim_fast_math": self.sim_fast_math.name,
             "sim_step_seconds": self.sim_step_seconds,
             "sim_epsabs": self.sim_epsabs,
             "sim_epsrel": self.sim_epsrel,
             "sim_min_maxiter": self.sim_min_maxiter,
+            "sim_table_points": self.sim_table_points,
+            "sim_table_rint_points": self.sim_table_rint_points,
             "log_stdlvl": self.log_stdlvl.name,
         }
 
@@ -349,7 +466,7 @@ class State:
 class Sim:
     """Lion simulation to run"""
 
-    __slots__ = ("_cdata", "_initialized", "state", "config", "params")
+    __slots__ = ("_cdata", "_initialized", "_event_names", "state", "config", "params")
 
     def __init__(
         self,
@@ -362,6 +479,7 @@ class Sim:
         LOGGER.debug("Creating lion.Sim")
         self._cdata = ffi.new("lion_sim_t *")
         self._initialized = False
+        self._event_names = []
         if config is None:
             self.config = Config()
         else:
@@ -401,12 +519,114 @@ class Sim:
             "Failed resetting",
         )
 
+    def rearm(self, params: Params | None = None, init: models.Initial | None = None):
+        """Reset for a new run, reusing the driver and minimizer of the sim
+
+        Optionally swaps in new parameters and initial conditions. The initial
+        conditions are kept by the sim, so the parameters are left untouched.
+        Initializes the sim instead if it was not initialized yet.
+        """
+        if params is not None:
+            self.params = params
+        c_init = ffi.NULL
+        if init is not None:
+            c_init = ffi.new("lion_params_init_t *")
+            init.set_parameters(c_init)
+        ffi_call(
+            _lionl.lion_sim_rearm(
+                self._cdata,
+                self.params._cdata if params is not None else ffi.NULL,
+                c_init,
+            ),
+            "Failed re-arming",
+        )
+        self._initialized = True
+
+    def fork(self, k: int) -> list["Sim"]:
+        """Fork into k independent branches continuing from the current state
+
+        Branches share the config and params of this sim, and can be stepped from
+        different threads.
+        """
+        branches = []
+        for _ in range(k):
+            branch = Sim.__new__(Sim)
+            branch._cdata = ffi.new("lion_sim_t *")
+            branch._initialized = True
+            branch._event_names = self._event_names
+            branch.config = self.config
+            branch.params = self.params
+            branch.state = State(branch)
+            # Forked in place, since branches point into themselves
+            ffi_call(
+                _lionl.lion_sim_fork(self._cdata, 1, branch._cdata),
+                "Failed forking",
+            )
+            branches.append(branch)
+        return branches
+
     def step(self, power: float, amb_temp: float):
         if not self._initialized:
             LOGGER.warn("Auto-initializing before step")
             self.init()
         ffi_call(_lionl.lion_sim_step(self._cdata, power, amb_temp), "Failed stepping")
 
+    def step_current(self, current: float, amb_temp: float):
+        if not self._initialized:
+            LOGGER.warn("Auto-initializing before step")
+            self.init()
+        ffi_call(
+            _lionl.lion_sim_step_current(self._cdata, current, amb_temp),
+            "Failed stepping",
+        )
+
+    def step_n(
+        self,
+        power: np.ndarray | list[float],
+        amb_temp: np.ndarray | list[float],
+        fields: list[str] | None = None,
+    ) -> dict[str, np.ndarray]:
+        """Step once per input in a single call, returning the requested state columns
+
+        Stops after the step where a stop event triggers, so the columns only
+        hold the steps taken.
+        """
+        if not self._initialized:
+            LOGGER.warn("Auto-initializing before step")
+            self.init()
+        power = np.ascontiguousarray(power, dtype=np.float64)
+        amb_temp = np.ascontiguousarray(amb_temp, dtype=np.float64)
+        if power.ndim != 1 or power.shape != amb_temp.shape:
+            raise ValueError("Inputs must be one dimensional and of the same length")
+        if fields is None:
+            fields = list(STATE_COLUMNS.keys())
+
+        n = len(power)
+        columns = ffi.new("lion_state_columns_t *")
+        out = {}
+        for field in fields:
+            dtype = STATE_COLUMNS.get(field)
+            if dtype is None:
+                raise KeyError(f"State has no column '{field}'")
+            # The C side writes straight into the numpy buffers
+            out[field] = np.empty(n, dtype=dtype)
+            ctype = "uint64_t[]" if dtype is np.uint64 else "double[]"
+            setattr(columns, field, ffi.from_buffer(ctype, out[field]))
+
+        taken = ffi.new("size_t *")
+        ffi_call(
+            _lionl.lion_sim_step_n(
+                self._cdata,
+                ffi.from_buffer("double[]", power),
+                ffi.from_buffer("double[]", amb_temp),
+                n,
+                columns,
+                taken,
+            ),
+            "Failed stepping",
+        )
+        return {field: column[: taken[0]] for field, column in out.items()}
+
     def run(self, power: Vectorizable, amb_temp: Vectorizable):
         try:
             power = Vector.new(power, dtypes.FLOAT64)
@@ -421,6 +641,100 @@ class Sim:
                 f"Could not create `Vector` from type '{type(power).__name__}'"
             )
 
+    def run_resampled(
+        self,
+        power: np.ndarray | list[float],
+        amb_temp: np.ndarray | list[float],
+        period: float | None = None,
+        time: np.ndarray | list[float] | None = None,
+        start_time: float = 0.0,
+        interp: Interp = Interp.LINEAR,
+    ):
+        """Run from inputs at their native rate, resampled at each step
+
+        Inputs are either evenly spaced every `period` seconds from `start_time`, or
+        sampled at the given `time` of each sample. The arrays are read in place.
+        """
+        if (period is None) == (time is None):
+            raise ValueError("Exactly one of `period` and `time` must be given")
+        power = np.ascontiguousarray(power, dtype=np.float64)
+        amb_temp = np.ascontiguousarray(amb_temp, dtype=np.float64)
+        if power.ndim != 1 or power.shape != amb_temp.shape:
+            raise ValueError("Inputs must be one dimensional and of the same length")
+        if time is not None:
+            # Converted once so that both inputs borrow the same buffer
+            time = np.ascontiguousarray(time, dtype=np.float64)
+            if time.shape != power.shape:
+                raise ValueError("Timestamps must have the same length as the inputs")
+
+        inputs = []
+        for values in (power, amb_temp):
+            cinput = ffi.new("lion_input_t *")
+            if time is None:
+                status = _lionl.lion_input_fixed_rate(
+                    ffi.from_buffer("double[]", values), len(values), start_time, period, interp.value, cinput
+                )
+            else:
+                status = _lionl.lion_input_timestamped(
+                    ffi.from_buffer("double[]", time), ffi.from_buffer("double[]", values), len(values), interp.value, cinput
+                )
+            ffi_call(status, "Failed creating input")
+            inputs.append(cinput)
+
+        ffi_call(
+            _lionl.lion_sim_run_resampled(self._cdata, inputs[0], inputs[1]),
+            "Failed running",
+        )
+
+    def add_event(
+        self,
+        field: str,
+        threshold: float,
+        direction: EventDirection = EventDirection.EITHER,
+        action: EventAction = EventAction.STOP,
+        power: float = 0.0,
+        name: str | None = None,
+    ) -> int:
+        """Watch a state field for a threshold crossing, returning the index of the event"""
+        if field not in STATE_COLUMNS:
+            raise KeyError(f"State has no column '{field}'")
+        event = ffi.new("lion_event_t *")
+        if name is not None:
+            # The sim keeps the pointer, so the string must live as long as it
+            cname = ffi.new("char[]", name.encode())
+            self._event_names.append(cname)
+            event.name = cname
+        event.field = getattr(_lionl, f"LION_STATE_{field.upper()}")
+        event.threshold = threshold
+        event.direction = direction.value
+        event.action = action.value
+        event.power = power
+        ffi_call(_lionl.lion_sim_add_event(self._cdata, event), "Failed adding event")
+        return self._cdata.events_len - 1
+
+    def clear_events(self):
+        _lionl.lion_sim_clear_events(self._cdata)
+        self._event_names.clear()
+
+    @property
+    def events(self) -> list[dict]:
+        """Triggering information of every event"""
+        out = []
+        for i in range(self._cdata.events_len):
+            event = self._cdata.events[i]
+            out.append(
+                {
+                    "name": ffi.string(event.name).decode() if event.name != ffi.NULL else None,
+                    "triggered": event.triggered,
+                    "time": event.time,
+                    "value": event.value,
+                }
+            )
+        return out
+
+    def should_close(self) -> bool:
+        return bool(_lionl.lion_sim_should_close(self._cdata))
+
     @property
     def init_hook(self) -> None:
         raise NotImplementedError("Can't fetch C functions")
@@ -27,9 +27,66 @@ class Stepper(Enum):
     BSIMP = _lionl.LION_STEPPER_BSIMP
     MSADAMS = _lionl.LION_STEPPER_MSADAMS
     MSBDF = _lionl.LION_STEPPER_MSBDF
+    EXACT = _lionl.LION_STEPPER_EXACT
+    NATIVE_RK2 = _lionl.LION_STEPPER_NATIVE_RK2
+    NATIVE_HEUN = _lionl.LION_STEPPER_NATIVE_HEUN
+    NATIVE_RK4 = _lionl.LION_STEPPER_NATIVE_RK4
 
 
 class Minimizer(Enum):
     GOLDENSECTION = _lionl.LION_MINIMIZER_GOLDENSECTION
     BRENT = _lionl.LION_MINIMIZER_BRENT
     QUADGOLDEN = _lionl.LION_MINIMIZER_QUADGOLDEN
+
+
+class CurrentSolver(Enum):
+    MINIMIZER = _lionl.LION_CURRENT_SOLVER_MINIMIZER
+    NEWTON = _lionl.LION_CURRENT_SOLVER_NEWTON
+    SECANT = _lionl.LION_CURRENT_SOLVER_SECANT
+
+
+class StepMode(Enum):
+    FIXED = _lionl.LION_STEP_MODE_FIXED
+    ADAPTIVE = _lionl.LION_STEP_MODE_ADAPTIVE
+    DAE = _lionl.LION_STEP_MODE_DAE
+
+
+class InputMode(Enum):
+    POWER = _lionl.LION_INPUT_MODE_POWER
+    CURRENT = _lionl.LION_INPUT_MODE_CURRENT
+
+
+class ModelBackend(Enum):
+    ANALYTIC = _lionl.LION_MODEL_BACKEND_ANALYTIC
+    TABLE = _lionl.LION_MODEL_BACKEND_TABLE
+
+
+class FastMath(Enum):
+    OFF = _lionl.LION_FAST_MATH_OFF
+    TIER_1E12 = _lionl.LION_FAST_MATH_1E12
+    TIER_1E7 = _lionl.LION_FAST_MATH_1E7
+
+
+class Interp(Enum):
+    ZOH = _lionl.LION_INTERP_ZOH
+    LINEAR = _lionl.LION_INTERP_LINEAR
+
+
+class EventDirection(Enum):
+    RISING = _lionl.LION_EVENT_RISING
+    FALLING = _lionl.LION_EVENT_FALLING
+    EITHER = _lionl.LION_EVENT_EITHER
+
+
+class EventAction(Enum):
+    STOP = _lionl.LION_EVENT_STOP
+    NOTIFY = _lionl.LION_EVENT_NOTIFY
+    SWITCH_INPUT = _lionl.LION_EVENT_SWITCH_INPUT
+
+
+class SegmentType(Enum):
+    REST = _lionl.LION_SEGMENT_REST
+    CC = _lionl.LION_SEGMENT_CC
+    CP = _lionl.LION_SEGMENT_CP
+    CV = _lionl.LION_SEGMENT_CV
+    CCCV = _lionl.LION_SEGMENT_CCCV
@@ -0,0 +1,67 @@
+import os
+
+import lion_ffi as _
+from lion._lion import ffi
+from lion._lion import lib as _lionl
+from lion.exceptions import LionException
+from lion.sim import Sim
+from lion.status import ffi_call
+from lion_utils.logger import LOGGER
+
+
+class Snapshot:
+    """Snapshot of a running sim, to restore it later or into another sim"""
+
+    __slots__ = ("_cdata",)
+
+    def __init__(self):
+        self._cdata = ffi.new("lion_snapshot_t *")
+
+    @classmethod
+    def take(cls, sim: Sim) -> "Snapshot":
+        snapshot = cls()
+        ffi_call(
+            _lionl.lion_sim_snapshot(sim._cdata, snapshot._cdata),
+            "Failed taking snapshot",
+        )
+        return snapshot
+
+    @classmethod
+    def load(cls, path: str | os.PathLike) -> "Snapshot":
+        snapshot = cls()
+        ffi_call(
+            _lionl.lion_snapshot_load(os.fsencode(path), snapshot._cdata),
+            "Failed loading snapshot",
+        )
+        return snapshot
+
+    def __del__(self):
+        LOGGER.debug("Cleaning up lion.Snapshot")
+        try:
+            ffi_call(
+                _lionl.lion_snapshot_cleanup(self._cdata),
+                "Failed cleanup of snapshot",
+            )
+        except LionException as e:
+            LOGGER.error(f"Snapshot cleanup failed with exception '{e}'")
+
+    def save(self, path: str | os.PathLike):
+        ffi_call(
+            _lionl.lion_snapshot_save(self._cdata, os.fsencode(path)),
+            "Failed saving snapshot",
+        )
+
+    def restore(self, sim: Sim):
+        ffi_call(
+            _lionl.lion_sim_restore(sim._cdata, self._cdata),
+            "Failed restoring snapshot",
+        )
+        sim._initialized = True
+
+    @property
+    def time(self) -> float:
+        return self._cdata.state.time
+
+    @property
+    def step(self) -> int:
+        return self._cdata.state.step
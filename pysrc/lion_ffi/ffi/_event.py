@@ -0,0 +1,33 @@
+CTYPEDEF = """
+typedef enum lion_event_direction {
+  LION_EVENT_RISING,
+  LION_EVENT_FALLING,
+  LION_EVENT_EITHER,
+} lion_event_direction_t;
+
+typedef enum lion_event_action {
+  LION_EVENT_STOP,
+  LION_EVENT_NOTIFY,
+  LION_EVENT_SWITCH_INPUT,
+} lion_event_action_t;
+
+struct lion_event {
+  const char            *name;
+  lion_state_field_t     field;
+  double                 threshold;
+  lion_event_direction_t direction;
+  lion_event_action_t    action;
+  double                 power;
+  lion_status_t (*hook)(lion_sim_t *sim, lion_event_t *event);
+  uint64_t               triggered;
+  double                 time;
+  double                 value;
+  double                 _theta;
+};
+"""
+
+
+CDEF = """
+lion_status_t lion_sim_add_event(lion_sim_t *sim, const lion_event_t *event);
+void lion_sim_clear_events(lion_sim_t *sim);
+"""
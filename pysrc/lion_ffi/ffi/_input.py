@@ -0,0 +1,31 @@
+CTYPEDEF = """
+typedef enum lion_interp {
+  LION_INTERP_ZOH,
+  LION_INTERP_LINEAR,
+} lion_interp_t;
+
+typedef struct lion_input {
+  const double *values;
+  const double *timestamps;
+  size_t        len;
+  double        start_time;
+  double        period;
+  lion_interp_t interp;
+  size_t        _cursor;
+} lion_input_t;
+"""
+
+
+CDEF = """
+lion_status_t lion_input_fixed_rate(const double *values, size_t len,
+                                    double start_time, double period,
+                                    lion_interp_t interp, lion_input_t *out);
+lion_status_t lion_input_timestamped(const double *timestamps,
+                                     const double *values, size_t len,
+                                     lion_interp_t interp, lion_input_t *out);
+double lion_input_at(lion_input_t *input, double time);
+double lion_input_start_time(const lion_input_t *input);
+double lion_input_end_time(const lion_input_t *input);
+lion_status_t lion_sim_run_resampled(lion_sim_t *sim, lion_input_t *power,
+                                     lion_input_t *ambient_temperature);
+"""
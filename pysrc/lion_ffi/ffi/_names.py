@@ -8,5 +8,10 @@ const char *lion_stepper_name(lion_stepper_t stepper);
 const char *lion_minimizer_name(lion_minimizer_t minimizer);
 const char *lion_gsl_errno_name(const int num);
 const char *lion_jacobian_name(lion_jacobian_method_t jacobian);
+const char *lion_current_solver_name(lion_current_solver_t solver);
+const char *lion_step_mode_name(lion_step_mode_t mode);
+const char *lion_input_mode_name(lion_input_mode_t mode);
+const char *lion_model_backend_name(lion_model_backend_t backend);
+const char *lion_fast_math_name(lion_fast_math_t fast_math);
 const char *lion_params_rint_get_name(lion_rint_model_t model);
 """
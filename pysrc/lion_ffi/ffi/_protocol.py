@@ -0,0 +1,34 @@
+CTYPEDEF = """
+typedef enum lion_segment_type {
+  LION_SEGMENT_REST,
+  LION_SEGMENT_CC,
+  LION_SEGMENT_CP,
+  LION_SEGMENT_CV,
+  LION_SEGMENT_CCCV,
+} lion_segment_type_t;
+
+typedef struct lion_segment {
+  lion_segment_type_t    type;
+  double                 value;
+  double                 voltage;
+  double                 taper;
+  double                 duration;
+  lion_state_field_t     until;
+  double                 until_threshold;
+  lion_event_direction_t until_direction;
+} lion_segment_t;
+
+typedef struct lion_protocol {
+  const lion_segment_t *segments;
+  size_t                len;
+  uint64_t              cycles;
+  size_t                segment;
+  uint64_t              cycle;
+  double                segment_start;
+} lion_protocol_t;
+"""
+
+
+CDEF = """
+lion_status_t lion_sim_run_protocol(lion_sim_t *sim, lion_protocol_t *protocol, double ambient_temperature);
+"""
@@ -0,0 +1,44 @@
+CTYPEDEF = """
+typedef enum lion_state_field {
+  LION_STATE_TIME,
+  LION_STATE_STEP,
+  LION_STATE_POWER,
+  LION_STATE_AMBIENT_TEMPERATURE,
+  LION_STATE_VOLTAGE,
+  LION_STATE_CURRENT,
+  LION_STATE_REF_OPEN_CIRCUIT_VOLTAGE,
+  LION_STATE_OPEN_CIRCUIT_VOLTAGE,
+  LION_STATE_INTERNAL_RESISTANCE,
+  LION_STATE_CYCLE,
+  LION_STATE_SOH,
+  LION_STATE_EHC,
+  LION_STATE_GENERATED_HEAT,
+  LION_STATE_INTERNAL_TEMPERATURE,
+  LION_STATE_SURFACE_TEMPERATURE,
+  LION_STATE_KAPPA,
+  LION_STATE_SOC_NOMINAL,
+  LION_STATE_CAPACITY_NOMINAL,
+  LION_STATE_SOC_USE,
+  LION_STATE_CAPACITY_USE,
+  LION_STATE_ALL,
+  ...
+} lion_state_field_t;
+
+struct lion_recorder {
+  uint32_t             fields;
+  size_t               len;
+  size_t               capacity;
+  lion_state_columns_t columns;
+};
+"""
+
+
+CDEF = """
+lion_status_t lion_recorder_new(uint32_t fields, size_t capacity,
+                                lion_recorder_t *out);
+lion_status_t lion_recorder_reserve(lion_recorder_t *recorder, size_t capacity);
+lion_status_t lion_recorder_append(lion_recorder_t *recorder,
+                                   const lion_sim_state_t *state);
+void lion_recorder_clear(lion_recorder_t *recorder);
+lion_status_t lion_recorder_cleanup(lion_recorder_t *recorder);
+"""
@@ -1,5 +1,8 @@
 CTYPEDEF = """
 typedef struct lion_sim lion_sim_t;
+typedef struct lion_recorder lion_recorder_t;
+typedef struct lion_event lion_event_t;
+typedef struct lion_eval lion_eval_t;
 
 typedef enum lion_regime {
   LION_ONLYSF,
@@ -19,6 +22,10 @@ typedef enum lion_stepper {
   LION_STEPPER_BSIMP,
   LION_STEPPER_MSADAMS,
   LION_STEPPER_MSBDF,
+  LION_STEPPER_EXACT,
+  LION_STEPPER_NATIVE_RK2,
+  LION_STEPPER_NATIVE_HEUN,
+  LION_STEPPER_NATIVE_RK4,
 } lion_stepper_t;
 
 typedef enum lion_minimizer {
@@ -30,8 +37,37 @@ typedef enum lion_minimizer {
 typedef enum lion_jacobian_method {
   LION_JACOBIAN_ANALYTICAL,
   LION_JACOBIAN_2POINT,
+  LION_JACOBIAN_AUTODIFF,
 } lion_jacobian_method_t;
 
+typedef enum lion_current_solver {
+  LION_CURRENT_SOLVER_MINIMIZER,
+  LION_CURRENT_SOLVER_NEWTON,
+  LION_CURRENT_SOLVER_SECANT,
+} lion_current_solver_t;
+
+typedef enum lion_step_mode {
+  LION_STEP_MODE_FIXED,
+  LION_STEP_MODE_ADAPTIVE,
+  LION_STEP_MODE_DAE,
+} lion_step_mode_t;
+
+typedef enum lion_input_mode {
+  LION_INPUT_MODE_POWER,
+  LION_INPUT_MODE_CURRENT,
+} lion_input_mode_t;
+
+typedef enum lion_model_backend {
+  LION_MODEL_BACKEND_ANALYTIC,
+  LION_MODEL_BACKEND_TABLE,
+} lion_model_backend_t;
+
+typedef enum lion_fast_math {
+  LION_FAST_MATH_OFF,
+  LION_FAST_MATH_1E12,
+  LION_FAST_MATH_1E7,
+} lion_fast_math_t;
+
 extern "Python" lion_status_t init_pythoncb(lion_sim_t *);
 extern "Python" lion_status_t update_pythoncb(lion_sim_t *);
 extern "Python" lion_status_t finished_pythoncb(lion_sim_t *);
@@ -43,11 +79,18 @@ typedef struct lion_sim_config {
   lion_stepper_t     sim_stepper;
   lion_minimizer_t   sim_minimizer;
   lion_jacobian_method_t sim_jacobian;
+  lion_current_solver_t  sim_current_solver;
+  lion_step_mode_t       sim_step_mode;
+  lion_input_mode_t      sim_input_mode;
+  lion_model_backend_t   sim_model_backend;
+  lion_fast_math_t       sim_fast_math;
   double                 sim_time_seconds;
   double                 sim_step_seconds;
   double                 sim_epsabs;
   double                 sim_epsrel;
   uint64_t               sim_min_maxiter;
+  uint64_t               sim_table_points;
+  uint64_t               sim_table_rint_points;
 
   const char *log_dir;
   int         log_stdlvl;
@@ -84,9 +127,34 @@ typedef struct lion_sim_state {
   ...;
 } lion_sim_state_t;
 
+typedef struct lion_state_columns {
+  double   *time;
+  uint64_t *step;
+  double   *power;
+  double   *ambient_temperature;
+  double   *voltage;
+  double   *current;
+  double   *ref_open_circuit_voltage;
+  double   *open_circuit_voltage;
+  double   *internal_resistance;
+  uint64_t *cycle;
+  double   *soh;
+  double   *ehc;
+  double   *generated_heat;
+  double   *internal_temperature;
+  double   *surface_temperature;
+  double   *kappa;
+  double   *soc_nominal;
+  double   *capacity_nominal;
+  double   *soc_use;
+  double   *capacity_use;
+} lion_state_columns_t;
+
 typedef struct lion_slv_inputs {
   lion_sim_state_t *sys_inputs;
   lion_params_t    *sys_params;
+  lion_eval_t      *sys_eval;
+  lion_sim_t       *sys_sim;
 } lion_slv_inputs_t;
 
 typedef struct lion_sim {
@@ -97,6 +165,9 @@ typedef struct lion_sim {
   lion_status_t (*init_hook)(lion_sim_t *sim);
   lion_status_t (*update_hook)(lion_sim_t *sim);
   lion_status_t (*finished_hook)(lion_sim_t *sim);
+  lion_recorder_t *recorder;
+  lion_event_t    *events;
+  size_t           events_len;
   ...;
 } lion_sim_t;
 """
@@ -110,8 +181,15 @@ lion_status_t lion_sim_new(lion_sim_config_t *conf, lion_params_t *params,
                            lion_sim_t *out);
 lion_status_t lion_sim_init(lion_sim_t *sim);
 lion_status_t lion_sim_reset(lion_sim_t *sim);
+lion_status_t lion_sim_rearm(lion_sim_t *sim, lion_params_t *params, const lion_params_init_t *init);
+lion_status_t lion_sim_fork(lion_sim_t *sim, size_t k, lion_sim_t *out);
 lion_status_t lion_sim_step(lion_sim_t *sim, double power,
                             double ambient_temperature);
+lion_status_t lion_sim_step_current(lion_sim_t *sim, double current,
+                                    double ambient_temperature);
+lion_status_t lion_sim_step_n(lion_sim_t *sim, const double *power,
+                              const double *ambient_temperature, size_t n,
+                              lion_state_columns_t *out, size_t *taken);
 lion_status_t lion_sim_run(lion_sim_t *sim, lion_vector_t *power,
                            lion_vector_t *ambient_temperature);
 
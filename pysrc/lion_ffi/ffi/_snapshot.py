@@ -0,0 +1,31 @@
+CTYPEDEF = """
+typedef struct lion_snapshot_event {
+  uint64_t triggered;
+  double   time;
+  double   value;
+} lion_snapshot_event_t;
+
+typedef struct lion_snapshot {
+  lion_sim_state_t       state;
+  double                 step_size;
+  int                    should_close;
+  int                    input_switched;
+  double                 switched_power;
+  lion_input_mode_t      input_mode;
+  double                 dae_prev[2];
+  double                 dae_h;
+  double                 dae_current;
+  uint64_t               dae_steps;
+  size_t                 events_len;
+  lion_snapshot_event_t *events;
+} lion_snapshot_t;
+"""
+
+
+CDEF = """
+lion_status_t lion_sim_snapshot(lion_sim_t *sim, lion_snapshot_t *out);
+lion_status_t lion_sim_restore(lion_sim_t *sim, const lion_snapshot_t *snapshot);
+lion_status_t lion_snapshot_save(const lion_snapshot_t *snapshot, const char *filename);
+lion_status_t lion_snapshot_load(const char *filename, lion_snapshot_t *out);
+lion_status_t lion_snapshot_cleanup(lion_snapshot_t *snapshot);
+"""
@@ -17,7 +17,7 @@ from lion_ffi.config import (
     CLIB_RELEASE_PATH,
     INCLUDE_DIRS,
 )
-from lion_ffi.ffi import _sim, _params, _status, _vector, _names
+from lion_ffi.ffi import _sim, _params, _status, _vector, _names, _recorder, _input, _event, _snapshot, _protocol
 
 
 LIB_TYPEDEF = """
@@ -47,6 +47,11 @@ FFI_CDEF = f"""
 {_status.CTYPEDEF}
 {_params.CTYPEDEF}
 {_sim.CTYPEDEF}
+{_recorder.CTYPEDEF}
+{_input.CTYPEDEF}
+{_event.CTYPEDEF}
+{_snapshot.CTYPEDEF}
+{_protocol.CTYPEDEF}
 {_names.CTYPEDEF}
 {_vector.CTYPEDEF}
 
@@ -54,6 +59,11 @@ FFI_CDEF = f"""
 {_status.CDEF}
 {_params.CDEF}
 {_sim.CDEF}
+{_recorder.CDEF}
+{_input.CDEF}
+{_event.CDEF}
+{_snapshot.CDEF}
+{_protocol.CDEF}
 {_names.CDEF}
 {_vector.CDEF}
 """
@@ -0,0 +1,91 @@
+#include <lion/batch.h>
+#include <lionpp/batch.hpp>
+#include <stdexcept>
+
+namespace lion {
+
+Batch::Batch(SimConfig *conf, SimParams *params, size_t count) {
+  handle            = new lion_batch_t;
+  lion_status_t ret = lion_batch_new(conf->get_handle(), params->get_handle(), 1, count, handle);
+  if (ret != LION_STATUS_SUCCESS) {
+    delete handle;
+    throw std::runtime_error("Failed to create batch");
+  }
+}
+
+Batch::Batch(SimConfig *conf, std::vector<lion_params_t> &params) {
+  handle            = new lion_batch_t;
+  lion_status_t ret = lion_batch_new(conf->get_handle(), params.data(), params.size(), params.size(), handle);
+  if (ret != LION_STATUS_SUCCESS) {
+    delete handle;
+    throw std::runtime_error("Failed to create batch");
+  }
+}
+
+Batch::~Batch() {
+  lion_batch_cleanup(handle);
+  delete handle;
+}
+
+Batch::operator lion_batch_t *() { return handle; }
+
+Status Batch::init() { return static_cast<Status>(lion_batch_init(handle)); }
+
+Status Batch::step(std::vector<double> const &power, std::vector<double> const &amb_temp) {
+  if (power.size() != handle->count || amb_temp.size() != handle->count) {
+    return Status::FAILURE;
+  }
+  return static_cast<Status>(lion_batch_step(handle, power.data(), amb_temp.data()));
+}
+
+size_t Batch::size() const { return handle->count; }
+
+std::span<const double> Batch::current() const { return {handle->current, handle->count}; }
+std::span<const double> Batch::voltage() const { return {handle->voltage, handle->count}; }
+std::span<const double> Batch::soc() const { return {handle->soc_nominal, handle->count}; }
+std::span<const double> Batch::internal_temperature() const { return {handle->internal_temperature, handle->count}; }
+std::span<const double> Batch::soh() const { return {handle->soh, handle->count}; }
+
+BatchF32::BatchF32(SimConfig *conf, SimParams *params, size_t count) {
+  handle            = new lion_batch_f32_t;
+  lion_status_t ret = lion_batch_f32_new(conf->get_handle(), params->get_handle(), 1, count, handle);
+  if (ret != LION_STATUS_SUCCESS) {
+    delete handle;
+    throw std::runtime_error("Failed to create batch");
+  }
+}
+
+BatchF32::BatchF32(SimConfig *conf, std::vector<lion_params_t> &params) {
+  handle            = new lion_batch_f32_t;
+  lion_status_t ret = lion_batch_f32_new(conf->get_handle(), params.data(), params.size(), params.size(), handle);
+  if (ret != LION_STATUS_SUCCESS) {
+    delete handle;
+    throw std::runtime_error("Failed to create batch");
+  }
+}
+
+BatchF32::~BatchF32() {
+  lion_batch_f32_cleanup(handle);
+  delete handle;
+}
+
+BatchF32::operator lion_batch_f32_t *() { return handle; }
+
+Status BatchF32::init() { return static_cast<Status>(lion_batch_f32_init(handle)); }
+
+Status BatchF32::step(std::vector<float> const &power, std::vector<float> const &amb_temp) {
+  if (power.size() != handle->count || amb_temp.size() != handle->count) {
+    return Status::FAILURE;
+  }
+  return static_cast<Status>(lion_batch_f32_step(handle, power.data(), amb_temp.data()));
+}
+
+size_t BatchF32::size() const { return handle->count; }
+
+std::span<const float> BatchF32::current() const { return {handle->current, handle->count}; }
+std::span<const float> BatchF32::voltage() const { return {handle->voltage, handle->count}; }
+std::span<const float> BatchF32::soc() const { return {handle->soc_nominal, handle->count}; }
+std::span<const float> BatchF32::internal_temperature() const { return {handle->internal_temperature, handle->count}; }
+std::span<const float> BatchF32::soh() const { return {handle->soh, handle->count}; }
+
+} // namespace lion
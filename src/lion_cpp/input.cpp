@@ -0,0 +1,34 @@
+#include <lion/input.h>
+#include <lionpp/input.hpp>
+#include <stdexcept>
+
+namespace lion {
+
+Input Input::fixed_rate(std::span<const double> values, double start_time, double period, lion_interp_t interp) {
+  Input out;
+  if (lion_input_fixed_rate(values.data(), values.size(), start_time, period, interp, &out.handle) != LION_STATUS_SUCCESS) {
+    throw std::runtime_error("Failed to create input");
+  }
+  return out;
+}
+
+Input Input::timestamped(std::span<const double> timestamps, std::span<const double> values, lion_interp_t interp) {
+  if (timestamps.size() != values.size()) {
+    throw std::invalid_argument("Timestamps and values must have the same length");
+  }
+  Input out;
+  if (lion_input_timestamped(timestamps.data(), values.data(), values.size(), interp, &out.handle) != LION_STATUS_SUCCESS) {
+    throw std::runtime_error("Failed to create input");
+  }
+  return out;
+}
+
+Input::operator lion_input_t *() { return &handle; }
+
+double Input::at(double time) { return lion_input_at(&handle, time); }
+
+double Input::start_time() const { return lion_input_start_time(&handle); }
+
+double Input::end_time() const { return lion_input_end_time(&handle); }
+
+} // namespace lion
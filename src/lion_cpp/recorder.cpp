@@ -0,0 +1,108 @@
+#include <lion/recorder.h>
+#include <lionpp/recorder.hpp>
+#include <stdexcept>
+
+namespace lion {
+
+Recorder::Recorder(Sim &sim, uint32_t fields, size_t capacity) : sim(sim) {
+  lion_status_t ret = lion_recorder_new(fields, capacity, &handle);
+  if (ret != LION_STATUS_SUCCESS) {
+    throw std::runtime_error("Failed to create recorder");
+  }
+  this->sim->recorder = &handle;
+}
+
+Recorder::~Recorder() {
+  if (sim->recorder == &handle) {
+    sim->recorder = nullptr;
+  }
+  lion_recorder_cleanup(&handle);
+}
+
+Recorder::operator lion_recorder_t *() { return &handle; }
+
+size_t Recorder::size() const { return handle.len; }
+
+void Recorder::clear() { lion_recorder_clear(&handle); }
+
+std::span<const double> Recorder::column(lion_state_field_t field) const {
+  const double *data;
+  switch (field) {
+  case LION_STATE_TIME:
+    data = handle.columns.time;
+    break;
+  case LION_STATE_POWER:
+    data = handle.columns.power;
+    break;
+  case LION_STATE_AMBIENT_TEMPERATURE:
+    data = handle.columns.ambient_temperature;
+    break;
+  case LION_STATE_VOLTAGE:
+    data = handle.columns.voltage;
+    break;
+  case LION_STATE_CURRENT:
+    data = handle.columns.current;
+    break;
+  case LION_STATE_REF_OPEN_CIRCUIT_VOLTAGE:
+    data = handle.columns.ref_open_circuit_voltage;
+    break;
+  case LION_STATE_OPEN_CIRCUIT_VOLTAGE:
+    data = handle.columns.open_circuit_voltage;
+    break;
+  case LION_STATE_INTERNAL_RESISTANCE:
+    data = handle.columns.internal_resistance;
+    break;
+  case LION_STATE_SOH:
+    data = handle.columns.soh;
+    break;
+  case LION_STATE_EHC:
+    data = handle.columns.ehc;
+    break;
+  case LION_STATE_GENERATED_HEAT:
+    data = handle.columns.generated_heat;
+    break;
+  case LION_STATE_INTERNAL_TEMPERATURE:
+    data = handle.columns.internal_temperature;
+    break;
+  case LION_STATE_SURFACE_TEMPERATURE:
+    data = handle.columns.surface_temperature;
+    break;
+  case LION_STATE_KAPPA:
+    data = handle.columns.kappa;
+    break;
+  case LION_STATE_SOC_NOMINAL:
+    data = handle.columns.soc_nominal;
+    break;
+  case LION_STATE_CAPACITY_NOMINAL:
+    data = handle.columns.capacity_nominal;
+    break;
+  case LION_STATE_SOC_USE:
+    data = handle.columns.soc_use;
+    break;
+  case LION_STATE_CAPACITY_USE:
+    data = handle.columns.capacity_use;
+    break;
+  default:
+    throw std::invalid_argument("Field is not a floating point column");
+  }
+  if (data == nullptr) {
+    throw std::invalid_argument("Field is not being recorded");
+  }
+  return std::span<const double>(data, handle.len);
+}
+
+std::span<const uint64_t> Recorder::step() const {
+  if (handle.columns.step == nullptr) {
+    throw std::invalid_argument("Step is not being recorded");
+  }
+  return std::span<const uint64_t>(handle.columns.step, handle.len);
+}
+
+std::span<const uint64_t> Recorder::cycle() const {
+  if (handle.columns.cycle == nullptr) {
+    throw std::invalid_argument("Cycle is not being recorded");
+  }
+  return std::span<const uint64_t>(handle.columns.cycle, handle.len);
+}
+
+} // namespace lion
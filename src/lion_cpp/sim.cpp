@@ -1,4 +1,7 @@
+#include <lion/event.h>
+#include <lion/input.h>
 #include <lion/sim.h>
+#include <lion/snapshot.h>
 #include <lion/vector.h>
 #include <lionpp/sim.hpp>
 #include <stdexcept>
@@ -13,6 +16,8 @@ Sim::Sim(SimConfig *conf, SimParams *params) {
   }
 }
 
+Sim::Sim(lion_sim_t *handle) : handle(handle) {}
+
 Sim::~Sim() {
   lion_sim_cleanup(handle);
   delete handle;
@@ -20,8 +25,25 @@ Sim::~Sim() {
 
 Sim::operator lion_sim_t *() { return handle; }
 
+Status Sim::init() { return static_cast<Status>(lion_sim_init(handle)); }
+
+Status Sim::reset() { return static_cast<Status>(lion_sim_reset(handle)); }
+
+Status Sim::rearm(SimParams *params, lion_params_init_t const *init) {
+  return static_cast<Status>(lion_sim_rearm(handle, params != nullptr ? params->get_handle() : nullptr, init));
+}
+
 Status Sim::step(double power, double amb_temp) { return static_cast<Status>(lion_sim_step(handle, power, amb_temp)); }
 
+Status Sim::step_current(double current, double amb_temp) { return static_cast<Status>(lion_sim_step_current(handle, current, amb_temp)); }
+
+Status Sim::step_n(std::span<const double> power, std::span<const double> amb_temp, lion_state_columns_t *out, size_t *taken) {
+  if (power.size() != amb_temp.size()) {
+    return Status::FAILURE;
+  }
+  return static_cast<Status>(lion_sim_step_n(handle, power.data(), amb_temp.data(), power.size(), out, taken));
+}
+
 Status Sim::run(std::vector<double> const &power, std::vector<double> const &amb_temp) {
   lion_vector_t power_vec;
   lion_vector_t amb_vec;
@@ -40,6 +62,36 @@ Status Sim::run(std::vector<double> const &power, std::vector<double> const &amb
   return out;
 }
 
+Status Sim::run_resampled(Input &power, Input &amb_temp) { return static_cast<Status>(lion_sim_run_resampled(handle, power, amb_temp)); }
+
+Status Sim::run_protocol(lion_protocol_t &protocol, double amb_temp) {
+  return static_cast<Status>(lion_sim_run_protocol(handle, &protocol, amb_temp));
+}
+
+Status Sim::snapshot(lion_snapshot_t &out) { return static_cast<Status>(lion_sim_snapshot(handle, &out)); }
+
+Status Sim::restore(lion_snapshot_t const &snapshot) { return static_cast<Status>(lion_sim_restore(handle, &snapshot)); }
+
+Status Sim::add_event(lion_event_t const &event) { return static_cast<Status>(lion_sim_add_event(handle, &event)); }
+
+std::vector<std::unique_ptr<Sim>> Sim::fork(size_t k) {
+  // Branches point into themselves, so each one is forked in place instead of
+  // being moved after forking
+  std::vector<std::unique_ptr<Sim>> branches;
+  branches.reserve(k);
+  for (size_t i = 0; i < k; i++) {
+    lion_sim_t *branch = new lion_sim_t;
+    if (lion_sim_fork(handle, 1, branch) != LION_STATUS_SUCCESS) {
+      delete branch;
+      throw std::runtime_error("Failed to fork sim");
+    }
+    branches.emplace_back(new Sim(branch));
+  }
+  return branches;
+}
+
+void Sim::clear_events() { lion_sim_clear_events(handle); }
+
 bool Sim::should_close() const { return lion_sim_should_close(handle); }
 
 uint64_t Sim::max_iters() const { return lion_sim_max_iters(handle); }
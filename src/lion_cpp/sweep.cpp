@@ -0,0 +1,59 @@
+#include <lion/sweep.h>
+#include <lion/vector.h>
+#include <lionpp/sweep.hpp>
+#include <stdexcept>
+
+namespace lion {
+
+Sweep::Sweep() {}
+
+Sweep::~Sweep() {
+  for (auto &input : inputs) {
+    lion_vector_cleanup(NULL, &input);
+  }
+}
+
+size_t Sweep::add_input(std::vector<double> const &values) {
+  lion_vector_t vec;
+  lion_status_t ret = lion_vector_from_array(NULL, values.data(), values.size(), sizeof(double), &vec);
+  if (ret != LION_STATUS_SUCCESS) {
+    throw std::runtime_error("Failed to create sweep input");
+  }
+  inputs.push_back(vec);
+  return inputs.size() - 1;
+}
+
+size_t Sweep::add_job(SimConfig *conf, SimParams *params, size_t power_input, size_t amb_temp_input) {
+  if (power_input >= inputs.size() || amb_temp_input >= inputs.size()) {
+    throw std::out_of_range("Sweep input does not exist");
+  }
+  // Inputs are referenced by index until the sweep runs, since adding more
+  // inputs may reallocate the storage
+  lion_sweep_job_t job = {
+    .conf                = conf->get_handle(),
+    .params              = params->get_handle(),
+    .power               = nullptr,
+    .ambient_temperature = nullptr,
+    .update_hook         = nullptr,
+    .finished_hook       = nullptr,
+  };
+  jobs.push_back(job);
+  job_inputs.push_back(power_input);
+  job_inputs.push_back(amb_temp_input);
+  return jobs.size() - 1;
+}
+
+Status Sweep::run(size_t threads) {
+  for (size_t i = 0; i < jobs.size(); i++) {
+    jobs[i].power               = &inputs[job_inputs[2 * i]];
+    jobs[i].ambient_temperature = &inputs[job_inputs[2 * i + 1]];
+  }
+  job_results.resize(jobs.size());
+  return static_cast<Status>(lion_sweep_run(jobs.data(), jobs.size(), threads, job_results.data()));
+}
+
+size_t Sweep::size() const { return jobs.size(); }
+
+std::vector<lion_sweep_result_t> const &Sweep::results() const { return job_results; }
+
+} // namespace lion
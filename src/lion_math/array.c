@@ -0,0 +1,58 @@
+#include "array.h"
+
+#include "kernels/kernels.h"
+
+#include <lion/lion.h>
+#include <lion_utils/isa.h>
+
+// Indexed by lion_isa_t and lion_fast_math_t
+static const lion_kernels_t *const _kernels[LION_ISA_COUNT][LION_FAST_MATH_TIERS] = {
+    {&lion_kernels_scalar_off, &lion_kernels_scalar_1e12, &lion_kernels_scalar_1e7},
+#if defined(LION_SIMD_DISPATCH)
+    {&lion_kernels_avx2_off, &lion_kernels_avx2_1e12, &lion_kernels_avx2_1e7},
+    {&lion_kernels_avx512_off, &lion_kernels_avx512_1e12, &lion_kernels_avx512_1e7},
+#endif
+};
+
+// Indexed by lion_isa_t
+static const lion_kernels_f32_t *const _kernels_f32[LION_ISA_COUNT] = {
+    &lion_kernels_scalar_f32,
+#if defined(LION_SIMD_DISPATCH)
+    &lion_kernels_avx2_f32,
+    &lion_kernels_avx512_f32,
+#endif
+};
+
+const lion_kernels_t *lion_kernels(void) { return _kernels[lion_isa_active()][LION_FAST_MATH_OFF]; }
+
+const lion_kernels_t *lion_kernels_fast(lion_fast_math_t fast_math) { return _kernels[lion_isa_active()][fast_math]; }
+
+const lion_kernels_f32_t *lion_kernels_f32(void) { return _kernels_f32[lion_isa_active()]; }
+
+const char *lion_array_isa(void) { return lion_kernels()->name; }
+
+void lion_voc_n(const double *soc, size_t n, lion_params_t *params, double *out) { lion_kernels()->voc_n(soc, n, params, out); }
+
+void lion_voc_grad_n(const double *soc, size_t n, lion_params_t *params, double *out) { lion_kernels()->voc_grad_n(soc, n, params, out); }
+
+void lion_ehc_n(const double *soc, size_t n, lion_params_t *params, double *out) { lion_kernels()->ehc_n(soc, n, params, out); }
+
+void lion_kappa_n(const double *internal_temperature, size_t n, lion_params_t *params, double *out) {
+  lion_kernels()->kappa_n(internal_temperature, n, params, out);
+}
+
+void lion_current_n(const double *power, const double *open_circuit_voltage, const double *internal_resistance, size_t n, lion_params_t *params, double *out) {
+  lion_kernels()->current_n(power, open_circuit_voltage, internal_resistance, n, params, out);
+}
+
+void lion_generated_heat_n(
+    const double *current, const double *internal_temperature, const double *internal_resistance, const double *ehc, size_t n, lion_params_t *params, double *out
+) {
+  lion_kernels()->generated_heat_n(current, internal_temperature, internal_resistance, ehc, n, params, out);
+}
+
+void lion_internal_temperature_d_n(
+    const double *internal_temperature, const double *heat, const double *ambient_temperature, size_t n, lion_params_t *params, double *out
+) {
+  lion_kernels()->internal_temperature_d_n(internal_temperature, heat, ambient_temperature, n, params, out);
+}
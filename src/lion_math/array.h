@@ -0,0 +1,27 @@
+#pragma once
+
+#include <lion/params.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Array variants of the models, evaluating n inputs sharing the same
+// parameters per call. Outputs may alias any of the inputs
+const char *lion_array_isa(void);
+void        lion_voc_n(const double *soc, size_t n, lion_params_t *params, double *out);
+void        lion_voc_grad_n(const double *soc, size_t n, lion_params_t *params, double *out);
+void        lion_ehc_n(const double *soc, size_t n, lion_params_t *params, double *out);
+void        lion_kappa_n(const double *internal_temperature, size_t n, lion_params_t *params, double *out);
+void lion_current_n(const double *power, const double *open_circuit_voltage, const double *internal_resistance, size_t n, lion_params_t *params, double *out);
+void lion_generated_heat_n(
+    const double *current, const double *internal_temperature, const double *internal_resistance, const double *ehc, size_t n, lion_params_t *params, double *out
+);
+void lion_internal_temperature_d_n(
+    const double *internal_temperature, const double *heat, const double *ambient_temperature, size_t n, lion_params_t *params, double *out
+);
+
+#ifdef __cplusplus
+}
+#endif
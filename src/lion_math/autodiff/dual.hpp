@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace lion::ad {
+
+/// Forward mode dual number, carrying the value along with its derivatives in N
+/// directions. Plain doubles promote to constants, so the templated models are
+/// written once and evaluated on either
+template <std::size_t N> struct Dual {
+  double                v = 0.0;
+  std::array<double, N> d{};
+
+  constexpr Dual() = default;
+  constexpr Dual(double value) : v(value) {}
+
+  /// Independent variable along the direction i
+  static constexpr Dual variable(double value, std::size_t i) {
+    Dual x(value);
+    x.d[i] = 1.0;
+    return x;
+  }
+
+  constexpr Dual &operator+=(const Dual &o) {
+    v += o.v;
+    for (std::size_t i = 0; i < N; i++) {
+      d[i] += o.d[i];
+    }
+    return *this;
+  }
+
+  constexpr Dual &operator-=(const Dual &o) {
+    v -= o.v;
+    for (std::size_t i = 0; i < N; i++) {
+      d[i] -= o.d[i];
+    }
+    return *this;
+  }
+
+  constexpr Dual &operator*=(const Dual &o) {
+    for (std::size_t i = 0; i < N; i++) {
+      d[i] = d[i] * o.v + v * o.d[i];
+    }
+    v *= o.v;
+    return *this;
+  }
+
+  constexpr Dual &operator/=(const Dual &o) {
+    double inv = 1.0 / o.v;
+    v *= inv;
+    for (std::size_t i = 0; i < N; i++) {
+      d[i] = (d[i] - v * o.d[i]) * inv;
+    }
+    return *this;
+  }
+};
+
+// Derivative of a scalar function through the chain rule, given its value and
+// derivative at x.v
+template <std::size_t N> constexpr Dual<N> chain(double value, double grad, const Dual<N> &x) {
+  Dual<N> out(value);
+  for (std::size_t i = 0; i < N; i++) {
+    out.d[i] = grad * x.d[i];
+  }
+  return out;
+}
+
+template <std::size_t N> constexpr Dual<N> operator-(const Dual<N> &x) { return chain(-x.v, -1.0, x); }
+
+template <std::size_t N> constexpr Dual<N> operator+(Dual<N> a, const Dual<N> &b) { return a += b; }
+template <std::size_t N> constexpr Dual<N> operator-(Dual<N> a, const Dual<N> &b) { return a -= b; }
+template <std::size_t N> constexpr Dual<N> operator*(Dual<N> a, const Dual<N> &b) { return a *= b; }
+template <std::size_t N> constexpr Dual<N> operator/(Dual<N> a, const Dual<N> &b) { return a /= b; }
+
+template <std::size_t N> constexpr Dual<N> operator+(Dual<N> a, double b) { return a += Dual<N>(b); }
+template <std::size_t N> constexpr Dual<N> operator-(Dual<N> a, double b) { return a -= Dual<N>(b); }
+template <std::size_t N> constexpr Dual<N> operator*(Dual<N> a, double b) { return a *= Dual<N>(b); }
+template <std::size_t N> constexpr Dual<N> operator/(Dual<N> a, double b) { return a /= Dual<N>(b); }
+
+template <std::size_t N> constexpr Dual<N> operator+(double a, const Dual<N> &b) { return Dual<N>(a) += b; }
+template <std::size_t N> constexpr Dual<N> operator-(double a, const Dual<N> &b) { return Dual<N>(a) -= b; }
+template <std::size_t N> constexpr Dual<N> operator*(double a, const Dual<N> &b) { return Dual<N>(a) *= b; }
+template <std::size_t N> constexpr Dual<N> operator/(double a, const Dual<N> &b) { return Dual<N>(a) /= b; }
+
+template <std::size_t N> Dual<N> exp(const Dual<N> &x) {
+  double e = std::exp(x.v);
+  return chain(e, e, x);
+}
+
+template <std::size_t N> Dual<N> sqrt(const Dual<N> &x) {
+  double s = std::sqrt(x.v);
+  return chain(s, 0.5 / s, x);
+}
+
+// Value of a scalar, so that branches of the models compare plain values
+constexpr double value(double x) { return x; }
+template <std::size_t N> constexpr double value(const Dual<N> &x) { return x.v; }
+
+} // namespace lion::ad
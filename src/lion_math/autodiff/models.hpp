@@ -0,0 +1,129 @@
+#pragma once
+
+#include "dual.hpp"
+
+#include <cmath>
+#include <gsl/gsl_math.h>
+#include <lion/params.h>
+#include <lionu/fuzzy.h>
+
+/*
+   Templated versions of the models in lion_math, evaluated on either doubles
+   or dual numbers. They follow the C implementations term by term, so any
+   change to a model has to be mirrored here. test_jacobian_autodiff checks the
+   derivatives taken through them against differences of the C models
+*/
+
+namespace lion::models {
+
+using std::exp;
+using std::sqrt;
+
+template <typename S> S kappa(const S &internal_temperature, const lion_params_t *params) {
+  double right = params->vft.k1 / (params->vft.tref - params->vft.k2);
+  return exp(params->vft.k1 / (internal_temperature - params->vft.k2) - right);
+}
+
+template <typename S> S soc_usable(const S &soc, const S &kappa) { return 1.0 + (soc - 1.0) / kappa; }
+
+template <typename S> S capacity_usable(double capacity, const S &kappa) { return kappa * capacity; }
+
+template <typename S> S ehc(const S &soc, const lion_params_t *params) {
+  S      delta      = soc - params->ehc.mu;
+  double exp_den    = 2.0 * params->ehc.sigma * params->ehc.sigma;
+  S      first_term = exp(-(delta * delta) / exp_den) * (M_SQRT1_2 / (M_SQRTPI * params->ehc.sigma));
+
+  S second_term = params->ehc.l * exp(-params->ehc.kappa * soc);
+  return params->ehc.a * (first_term - second_term) + params->ehc.b;
+}
+
+template <typename S> S voc(const S &soc, const lion_params_t *params) {
+  S term1 = (params->ocv.v0 - params->ocv.vl) * exp(params->ocv.gamma * (soc - 1.0));
+  S term2 = params->ocv.alpha * params->ocv.vl * (soc - 1.0);
+  S term3 = (1.0 - params->ocv.alpha) * params->ocv.vl * (std::exp(-params->ocv.beta) - exp(-params->ocv.beta * sqrt(soc)));
+  return params->ocv.vl + term1 + term2 + term3;
+}
+
+template <typename S> S mf_gaussian(const S &x, const lion_mf_gaussian_params_t *params) {
+  S delta = x - params->mean;
+  return exp(-0.5 * delta * delta / (params->sigma * params->sigma));
+}
+
+template <typename S> S mf_sigmoid(const S &x, const lion_mf_sigmoid_params_t *params) {
+  return 1.0 / (1.0 + exp(-params->a * (x - params->c)));
+}
+
+template <typename S> S polyval(const S &x, const double *coeffs, int count) {
+  S res = 0.0;
+  S pow = 1.0;
+  for (int i = 0; i < count; i++) {
+    res += coeffs[i] * pow;
+    pow *= x;
+  }
+  return res;
+}
+
+/// State dependent terms of the model, as in lion_eval_prepare
+template <typename S> struct Eval {
+  S kappa;
+  S soc_use;
+  S capacity_use;
+  S ehc;
+  S open_circuit_voltage;
+};
+
+template <typename S>
+Eval<S> prepare(const S &soc_nominal, const S &internal_temperature, double capacity_nominal, const lion_params_t *params) {
+  Eval<S> eval;
+  eval.kappa                = kappa(internal_temperature, params);
+  eval.soc_use              = soc_usable(soc_nominal, eval.kappa);
+  eval.capacity_use         = capacity_usable(capacity_nominal, eval.kappa);
+  eval.ehc                  = ehc(eval.soc_use, params);
+  eval.open_circuit_voltage = voc(eval.soc_use, params) + eval.ehc * (internal_temperature - params->vft.tref);
+  return eval;
+}
+
+/// Internal resistance, as in lion_eval_resistance
+template <typename S> S resistance(const Eval<S> &eval, const S &current, const lion_params_t *params) {
+  switch (params->rint.model) {
+  case LION_RINT_MODEL_FIXED:
+    return S(params->rint.params.fixed.internal_resistance);
+  case LION_RINT_MODEL_POLARIZATION: {
+    const lion_params_rint_polarization_t *p = &params->rint.params.polarization;
+
+    S memberships[LION_FUZZY_SETS_COUNT] = {
+      mf_sigmoid(current, &p->c40),
+      mf_gaussian(current, &p->c20),
+      mf_gaussian(current, &p->c10),
+      mf_gaussian(current, &p->c4),
+      mf_gaussian(current, &p->d5),
+      mf_gaussian(current, &p->d10),
+      mf_gaussian(current, &p->d15),
+      mf_sigmoid(current, &p->d30),
+    };
+    S num = 0.0;
+    S den = 0.0;
+    for (int i = 0; i < LION_FUZZY_SETS_COUNT; i++) {
+      num += memberships[i] * polyval(eval.soc_use, p->poly[i], LION_FUZZY_SETS_DEGREE);
+      den += memberships[i];
+    }
+    return num / den;
+  }
+  default:
+    return S(-1.0);
+  }
+}
+
+template <typename S> S generated_heat(const S &current, const S &internal_temperature, const S &internal_resistance, const S &ehc) {
+  S qgen = internal_resistance * current * current - current * internal_temperature * ehc;
+  return (lion::ad::value(qgen) > 0.0) ? qgen : S(0.0);
+}
+
+template <typename S> S soc_d(const S &current, const S &capacity_use) { return -current / capacity_use; }
+
+template <typename S> S internal_temperature_d(const S &internal_temperature, const S &heat, double ambient_temperature, const lion_params_t *params) {
+  double rt = params->temp.rin + params->temp.rout;
+  return ((ambient_temperature - internal_temperature) / rt + heat) / params->temp.cp;
+}
+
+} // namespace lion::models
@@ -1,5 +1,6 @@
 #include "current.h"
 
+#include "eval.h"
 #include "internal_resistance.h"
 
 #include <gsl/gsl_errno.h>
@@ -35,19 +36,35 @@ double lion_current_grad_voc(double power, double open_circuit_voltage, double i
   return term1 - term2;
 }
 
+double lion_current_grad_rint(double power, double open_circuit_voltage, double internal_resistance, lion_params_t *params) {
+  double p   = power;
+  double voc = open_circuit_voltage;
+  double r   = internal_resistance;
+
+  double a     = voc / (2.0 * r);
+  double da_dr = -a / r;
+  double d     = gsl_pow_2(a) - p / r;
+  double dd_dr = 2.0 * a * da_dr + p / gsl_pow_2(r);
+  return da_dr - dd_dr / (2.0 * sqrt(d));
+}
+
 double lion_current_optimize_targetfn(double current, void *params) {
-  struct lion_optimization_iter_params *p            = params;
-  double                                rint         = lion_resistance(p->soc, current, p->params);
-  double                                pred_current = lion_current(p->power, p->voc, rint, p->params);
-  double                                val          = gsl_pow_2(fabs(current - pred_current));
+  struct lion_optimization_iter_params *p = params;
+  double                                rint;
+  if (p->eval != NULL) {
+    rint = lion_eval_resistance(p->eval, current, p->params, NULL);
+  } else {
+    rint = lion_resistance(p->soc, current, p->params);
+  }
+  double pred_current = lion_current(p->power, p->voc, rint, p->params);
+  double val          = gsl_pow_2(fabs(current - pred_current));
   return val;
 }
 
 double lion_current_optimize(
     gsl_min_fminimizer *s,
+    lion_eval_t        *eval,
     double              power,
-    double              soc,
-    double              open_circuit_voltage,
     double              initial_guess,
     double              epsabs,
     double              epsrel,
@@ -61,9 +78,10 @@ double lion_current_optimize(
   //   min ||I - f(I)||^2
   struct lion_optimization_iter_params opt_params = {
     .power  = power,
-    .voc    = open_circuit_voltage,
-    .soc    = soc,
+    .voc    = eval->open_circuit_voltage,
+    .soc    = eval->soc_use,
     .params = params,
+    .eval   = eval,
   };
 
   double opt_min = LION_CURRENT_OPTMIN;
@@ -92,3 +110,233 @@ double lion_current_optimize(
   }
   return initial_guess;
 }
+
+// Evaluates the residual g(I) = I - f(I, R(I)) and its derivative with respect
+// to I. Returns GSL_EDOM when the discriminant is negative at the given point,
+// which the solvers treat as an overshoot rather than an error
+static int lion_current_residual(double current, struct lion_optimization_iter_params *p, double *g, double *dg) {
+  double dr_di;
+  double rint = lion_eval_resistance(p->eval, current, p->params, (dg != NULL) ? &dr_di : NULL);
+  double d    = gsl_pow_2(p->voc / (2.0 * rint)) - p->power / rint;
+  if (!(d >= 0.0) || !(rint > 0.0)) {
+    return GSL_EDOM;
+  }
+  *g = current - ((p->voc / (2.0 * rint)) - sqrt(d));
+  if (dg != NULL) {
+    double df_dr = lion_current_grad_rint(p->power, p->voc, rint, p->params);
+    *dg          = 1.0 - df_dr * dr_di;
+  }
+  return GSL_SUCCESS;
+}
+
+// Both the last step and the residual, taken in amperes, have to be within the
+// tolerance. A step clamped onto the bracket or backtracked away stalls without
+// the residual vanishing, which is reported as GSL_ENOPROG so that the callers
+// do not take the bound for the current
+static inline int lion_current_test(double dx, double g, double x, double epsabs, double epsrel) {
+  double tol = epsabs + epsrel * fabs(x);
+  if (fabs(dx) >= tol) {
+    return GSL_CONTINUE;
+  }
+  return (fabs(g) < tol) ? GSL_SUCCESS : GSL_ENOPROG;
+}
+
+int lion_current_solve_newton(
+    lion_eval_t   *eval,
+    double         power,
+    double         initial_guess,
+    double         epsabs,
+    double         epsrel,
+    int            max_iter,
+    lion_params_t *params,
+    double        *out
+) {
+  // Solves I = f(I, R(I)) with Newton's method on g(I) = I - f(I, R(I)), using
+  // the analytic derivative g'(I) = 1 - df/dR * dR/dI. Steps that leave the
+  // bracket or land on a negative discriminant are halved back towards the
+  // last valid iterate
+  struct lion_optimization_iter_params opt_params = {
+    .power  = power,
+    .voc    = eval->open_circuit_voltage,
+    .soc    = eval->soc_use,
+    .params = params,
+    .eval   = eval,
+  };
+  if (max_iter <= 0) {
+    max_iter = LION_CURRENT_SOLVER_MAXITER;
+  }
+
+  double x = GSL_MIN(GSL_MAX(initial_guess, LION_CURRENT_OPTMIN), LION_CURRENT_OPTMAX);
+  double g, dg;
+  if (lion_current_residual(x, &opt_params, &g, &dg) != GSL_SUCCESS) {
+    // Retry from rest, which is feasible for any physically meaningful power
+    x = 0.0;
+    if (lion_current_residual(x, &opt_params, &g, &dg) != GSL_SUCCESS) {
+      return GSL_EDOM;
+    }
+  }
+
+  for (int iter = 0; iter < max_iter; iter++) {
+    if (dg == 0.0 || !isfinite(dg)) {
+      return GSL_EZERODIV;
+    }
+    double dx = -g / dg;
+
+    // Backtrack until the step lands inside the feasible region
+    double xn, gn, dgn;
+    int    status = GSL_EDOM;
+    for (int k = 0; k < LION_CURRENT_SOLVER_MAXBACKTRACK; k++) {
+      xn     = GSL_MIN(GSL_MAX(x + dx, LION_CURRENT_OPTMIN), LION_CURRENT_OPTMAX);
+      status = lion_current_residual(xn, &opt_params, &gn, &dgn);
+      if (status == GSL_SUCCESS) {
+        break;
+      }
+      dx *= 0.5;
+    }
+    if (status != GSL_SUCCESS) {
+      return status;
+    }
+
+    dx     = xn - x;
+    x      = xn;
+    g      = gn;
+    dg     = dgn;
+    status = lion_current_test(dx, g, x, epsabs, epsrel);
+    if (status == GSL_SUCCESS) {
+      *out = x;
+    }
+    if (status != GSL_CONTINUE) {
+      return status;
+    }
+  }
+  return GSL_EMAXITER;
+}
+
+int lion_current_solve_secant(
+    lion_eval_t   *eval,
+    double         power,
+    double         initial_guess,
+    double         epsabs,
+    double         epsrel,
+    int            max_iter,
+    lion_params_t *params,
+    double        *out
+) {
+  // Derivative-free variant of the Newton solver. The second starting point is
+  // one fixed-point iterate away from the initial guess
+  struct lion_optimization_iter_params opt_params = {
+    .power  = power,
+    .voc    = eval->open_circuit_voltage,
+    .soc    = eval->soc_use,
+    .params = params,
+    .eval   = eval,
+  };
+  if (max_iter <= 0) {
+    max_iter = LION_CURRENT_SOLVER_MAXITER;
+  }
+
+  double x0 = GSL_MIN(GSL_MAX(initial_guess, LION_CURRENT_OPTMIN), LION_CURRENT_OPTMAX);
+  double g0;
+  if (lion_current_residual(x0, &opt_params, &g0, NULL) != GSL_SUCCESS) {
+    x0 = 0.0;
+    if (lion_current_residual(x0, &opt_params, &g0, NULL) != GSL_SUCCESS) {
+      return GSL_EDOM;
+    }
+  }
+  if (g0 == 0.0) {
+    *out = x0;
+    return GSL_SUCCESS;
+  }
+
+  double x1 = x0 - g0;
+  double g1;
+  if (lion_current_residual(x1, &opt_params, &g1, NULL) != GSL_SUCCESS) {
+    return GSL_EDOM;
+  }
+
+  for (int iter = 0; iter < max_iter; iter++) {
+    double slope = (g1 - g0) / (x1 - x0);
+    if (slope == 0.0 || !isfinite(slope)) {
+      if (lion_current_test(x1 - x0, g1, x1, epsabs, epsrel) == GSL_SUCCESS) {
+        *out = x1;
+        return GSL_SUCCESS;
+      }
+      return GSL_EZERODIV;
+    }
+    double dx = -g1 / slope;
+
+    double xn, gn;
+    int    status = GSL_EDOM;
+    for (int k = 0; k < LION_CURRENT_SOLVER_MAXBACKTRACK; k++) {
+      xn     = GSL_MIN(GSL_MAX(x1 + dx, LION_CURRENT_OPTMIN), LION_CURRENT_OPTMAX);
+      status = lion_current_residual(xn, &opt_params, &gn, NULL);
+      if (status == GSL_SUCCESS) {
+        break;
+      }
+      dx *= 0.5;
+    }
+    if (status != GSL_SUCCESS) {
+      return status;
+    }
+
+    x0     = x1;
+    g0     = g1;
+    x1     = xn;
+    g1     = gn;
+    status = lion_current_test(x1 - x0, g1, x1, epsabs, epsrel);
+    if (status == GSL_SUCCESS) {
+      *out = x1;
+    }
+    if (status != GSL_CONTINUE) {
+      return status;
+    }
+  }
+  return GSL_EMAXITER;
+}
+
+int lion_current_solve_voltage(
+    lion_eval_t   *eval,
+    double         voltage,
+    double         initial_guess,
+    double         epsabs,
+    double         epsrel,
+    int            max_iter,
+    lion_params_t *params,
+    double        *out
+) {
+  // Solves the current holding the terminals at a given voltage, with Newton's
+  // method on g(I) = Voc - R(I) * I - V, whose derivative is
+  // g'(I) = -(R(I) + dR/dI * I). Iterates are kept within the bracket of the
+  // power driven solvers, and the residual is taken in amperes as the Newton
+  // step before it is clamped
+  if (max_iter <= 0) {
+    max_iter = LION_CURRENT_SOLVER_MAXITER;
+  }
+
+  double x = GSL_MIN(GSL_MAX(initial_guess, LION_CURRENT_OPTMIN), LION_CURRENT_OPTMAX);
+  for (int iter = 0; iter < max_iter; iter++) {
+    double dr_di;
+    double rint = lion_eval_resistance(eval, x, params, &dr_di);
+    if (!(rint > 0.0)) {
+      return GSL_EDOM;
+    }
+    double g  = eval->open_circuit_voltage - rint * x - voltage;
+    double dg = -(rint + dr_di * x);
+    if (dg == 0.0 || !isfinite(dg)) {
+      return GSL_EZERODIV;
+    }
+
+    double step   = -g / dg;
+    double xn     = GSL_MIN(GSL_MAX(x + step, LION_CURRENT_OPTMIN), LION_CURRENT_OPTMAX);
+    double dx     = xn - x;
+    x             = xn;
+    int    status = lion_current_test(dx, step, x, epsabs, epsrel);
+    if (status == GSL_SUCCESS) {
+      *out = x;
+    }
+    if (status != GSL_CONTINUE) {
+      return status;
+    }
+  }
+  return GSL_EMAXITER;
+}
@@ -1,11 +1,15 @@
 #pragma once
 
 #include <gsl/gsl_min.h>
+#include <lion/eval.h>
 #include <lion/params.h>
 
 #define LION_CURRENT_OPTMIN -1e3
 #define LION_CURRENT_OPTMAX 1e3
 
+#define LION_CURRENT_SOLVER_MAXITER      50
+#define LION_CURRENT_SOLVER_MAXBACKTRACK 30
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -15,22 +19,53 @@ struct lion_optimization_iter_params {
   double         voc;
   double         soc;
   lion_params_t *params;
+  lion_eval_t   *eval;
 };
 
 double lion_current(double power, double open_circuit_voltage, double internal_resistance, lion_params_t *params);
 double lion_current_grad_voc(double power, double open_circuit_voltage, double internal_resistance, lion_params_t *params);
+double lion_current_grad_rint(double power, double open_circuit_voltage, double internal_resistance, lion_params_t *params);
 double lion_current_optimize_targetfn(double current, void *params);
 double lion_current_optimize(
     gsl_min_fminimizer *s,
+    lion_eval_t        *eval,
     double              power,
-    double              soc,
-    double              open_circuit_voltage,
     double              initial_guess,
     double              epsabs,
     double              epsrel,
     int                 max_iter,
     lion_params_t      *params
 );
+int lion_current_solve_newton(
+    lion_eval_t   *eval,
+    double         power,
+    double         initial_guess,
+    double         epsabs,
+    double         epsrel,
+    int            max_iter,
+    lion_params_t *params,
+    double        *out
+);
+int lion_current_solve_secant(
+    lion_eval_t   *eval,
+    double         power,
+    double         initial_guess,
+    double         epsabs,
+    double         epsrel,
+    int            max_iter,
+    lion_params_t *params,
+    double        *out
+);
+int lion_current_solve_voltage(
+    lion_eval_t   *eval,
+    double         voltage,
+    double         initial_guess,
+    double         epsabs,
+    double         epsrel,
+    int            max_iter,
+    lion_params_t *params,
+    double        *out
+);
 #ifdef __cplusplus
 }
 #endif
@@ -2,6 +2,7 @@
 
 #include <lion/lion.h>
 #include <lion_utils/vendor/log.h>
+#include <math.h>
 
 double lion_internal_temperature_d(double internal_temperature, double heat, double ambient_temperature, lion_params_t *params) {
   double rt    = params->temp.rin + params->temp.rout;
@@ -14,6 +15,20 @@ double lion_internal_temperature_d(double internal_temperature, double heat, dou
   return diff;
 }
 
+double lion_internal_temperature_decay(double step, lion_params_t *params) {
+  double rt = params->temp.rin + params->temp.rout;
+  return exp(-step / (params->temp.cp * rt));
+}
+
+double lion_internal_temperature_exact(double internal_temperature, double heat, double ambient_temperature, double decay, lion_params_t *params) {
+  // With the heat and the ambient temperature held, the internal temperature
+  // relaxes exponentially towards the one where both balance, and decay is
+  // the fraction of the distance to it left after the step
+  double rt          = params->temp.rin + params->temp.rout;
+  double equilibrium = ambient_temperature + rt * heat;
+  return equilibrium + (internal_temperature - equilibrium) * decay;
+}
+
 double lion_surface_temperature(double internal_temperature, double ambient_temperature, lion_params_t *params) {
   double rt = params->temp.rin + params->temp.rout;
 
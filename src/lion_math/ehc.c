@@ -13,3 +13,14 @@ double lion_ehc(double soc, lion_params_t *params) {
   double second_term = params->ehc.l * exp(-params->ehc.kappa * soc);
   return params->ehc.a * (first_term - second_term) + params->ehc.b;
 }
+
+double lion_ehc_grad(double soc, lion_params_t *params) {
+  // This function corresponds to dEHC/dSoC
+  double exp_num    = gsl_pow_2(soc - params->ehc.mu);
+  double exp_den    = 2.0 * gsl_pow_2(params->ehc.sigma);
+  double first_term = exp(-exp_num / exp_den) * M_SQRT1_2 / (M_SQRTPI * params->ehc.sigma);
+  double first_grad = -first_term * (soc - params->ehc.mu) / gsl_pow_2(params->ehc.sigma);
+
+  double second_grad = -params->ehc.kappa * params->ehc.l * exp(-params->ehc.kappa * soc);
+  return params->ehc.a * (first_grad - second_grad);
+}
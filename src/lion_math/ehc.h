@@ -7,6 +7,7 @@ extern "C" {
 #endif
 
 double lion_ehc(double soc, lion_params_t *params);
+double lion_ehc_grad(double soc, lion_params_t *params);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,97 @@
+#include "eval.h"
+
+#include "capacity.h"
+#include "current.h"
+#include "ehc.h"
+#include "internal_resistance.h"
+#include "kernels/kernels.h"
+#include "open_circuit.h"
+#include "table.h"
+
+#include <gsl/gsl_math.h>
+#include <lion/lion.h>
+#include <lion_utils/vendor/log.h>
+#include <math.h>
+
+void lion_eval_prepare(lion_eval_t *eval, const lion_rint_packed_t *packed, double soc_nominal, double internal_temperature, double capacity_nominal,
+                       lion_params_t *params) {
+  lion_eval_prepare_table(eval, NULL, packed, LION_FAST_MATH_OFF, soc_nominal, internal_temperature, capacity_nominal, params);
+}
+
+void lion_eval_prepare_table(lion_eval_t *eval, const lion_table_t *table, const lion_rint_packed_t *packed, lion_fast_math_t fast_math, double soc_nominal,
+                             double internal_temperature, double capacity_nominal, lion_params_t *params) {
+  // The closed form goes through the kernels of the tier with the fast math,
+  // one element at a time. kappa and its gradient share the same exponential
+  const lion_kernels_t *kernels = (table == NULL && fast_math != LION_FAST_MATH_OFF) ? lion_kernels_fast(fast_math) : NULL;
+  if (table != NULL) {
+    eval->kappa = lion_table_kappa(table, internal_temperature, params, &eval->kappa_grad);
+  } else {
+    if (kernels != NULL) {
+      kernels->kappa_n(&internal_temperature, 1, params, &eval->kappa);
+    } else {
+      eval->kappa = lion_kappa(internal_temperature, params);
+    }
+    eval->kappa_grad = -params->vft.k1 / gsl_pow_2(internal_temperature - params->vft.k2) * eval->kappa;
+  }
+
+  eval->soc_use      = lion_soc_usable(soc_nominal, eval->kappa, params);
+  eval->capacity_use = lion_capacity_usable(capacity_nominal, eval->kappa, params);
+  if (table != NULL) {
+    eval->ehc                      = lion_table_ehc(table, eval->soc_use, params);
+    eval->ref_open_circuit_voltage = lion_table_voc(table, eval->soc_use, params, &eval->open_circuit_voltage_grad);
+  } else if (kernels != NULL) {
+    kernels->ehc_n(&eval->soc_use, 1, params, &eval->ehc);
+    kernels->voc_n(&eval->soc_use, 1, params, &eval->ref_open_circuit_voltage);
+    kernels->voc_grad_n(&eval->soc_use, 1, params, &eval->open_circuit_voltage_grad);
+  } else {
+    eval->ehc                      = lion_ehc(eval->soc_use, params);
+    eval->ref_open_circuit_voltage = lion_voc_with_grad(eval->soc_use, params, &eval->open_circuit_voltage_grad);
+  }
+  double voc_delta           = eval->ehc * (internal_temperature - params->vft.tref);
+  eval->open_circuit_voltage = eval->ref_open_circuit_voltage + voc_delta;
+
+  // SoC does not change while solving for the current, so the polynomials of
+  // the polarization model are evaluated only once per step. They stay around
+  // for currents outside of the resistance table. The fuzzy sets only depend
+  // on the parameters, so the caller packs them once for every step
+  eval->rint_packed = packed;
+  eval->rint_table  = NULL;
+  eval->fast_math   = fast_math;
+  if (params->rint.model == LION_RINT_MODEL_POLARIZATION) {
+    lion_resistance_packed_polys(packed, eval->soc_use, eval->rint_poly);
+    if (table != NULL && lion_table_rint_row(table, eval->soc_use, &eval->table_row, &eval->table_frac)) {
+      eval->rint_table = table;
+    }
+  }
+}
+
+double lion_eval_resistance(const lion_eval_t *eval, double current, lion_params_t *params, double *grad) {
+  switch (params->rint.model) {
+  case LION_RINT_MODEL_FIXED:
+    if (grad != NULL) {
+      *grad = 0.0;
+    }
+    return params->rint.params.fixed.internal_resistance;
+  case LION_RINT_MODEL_POLARIZATION:
+    if (eval->rint_table != NULL) {
+      return lion_table_resistance(eval, current, params, grad);
+    }
+    return lion_kernels_fast(eval->fast_math)->resistance_packed(eval->rint_packed, eval->rint_poly, current, grad);
+  default:
+    logi_error("Internal resistance model not valid");
+    return -1.0;
+  }
+}
+
+void lion_eval_finish(lion_eval_t *eval, double power, double current, double soh, lion_params_t *params) {
+  eval->current             = current;
+  eval->internal_resistance = lion_eval_resistance(eval, current, params, &eval->internal_resistance_grad);
+  eval->current_grad_voc    = lion_current_grad_voc(power, eval->open_circuit_voltage, eval->internal_resistance / soh, params);
+}
+
+void lion_eval_finish_current(lion_eval_t *eval, double current, lion_params_t *params) {
+  // With the current prescribed it does not depend on the open circuit voltage
+  eval->current             = current;
+  eval->internal_resistance = lion_eval_resistance(eval, current, params, &eval->internal_resistance_grad);
+  eval->current_grad_voc    = 0.0;
+}
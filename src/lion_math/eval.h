@@ -0,0 +1,20 @@
+#pragma once
+
+#include <lion/eval.h>
+#include <lion/params.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void   lion_eval_prepare(lion_eval_t *eval, const lion_rint_packed_t *packed, double soc_nominal, double internal_temperature, double capacity_nominal,
+                         lion_params_t *params);
+void   lion_eval_prepare_table(lion_eval_t *eval, const lion_table_t *table, const lion_rint_packed_t *packed, lion_fast_math_t fast_math, double soc_nominal,
+                               double internal_temperature, double capacity_nominal, lion_params_t *params);
+double lion_eval_resistance(const lion_eval_t *eval, double current, lion_params_t *params, double *grad);
+void   lion_eval_finish(lion_eval_t *eval, double power, double current, double soh, lion_params_t *params);
+void   lion_eval_finish_current(lion_eval_t *eval, double current, lion_params_t *params);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,8 @@
 #include "internal_resistance.h"
 
+#include "kernels/kernels.h"
+
+#include <gsl/gsl_math.h>
 #include <lion/lion.h>
 #include <lion_utils/vendor/log.h>
 #include <lionu/fuzzy.h>
@@ -10,7 +13,14 @@ double lion_resistance_fixed(double soc, double current, lion_params_t *params)
   return p->internal_resistance;
 }
 
-double lion_resistance_polarization(double soc, double current, lion_params_t *params) {
+void lion_resistance_polarization_polys(double soc, lion_params_t *params, double *polys) {
+  lion_params_rint_polarization_t *p = &params->rint.params.polarization;
+  for (int i = 0; i < LION_FUZZY_SETS_COUNT; i++) {
+    polys[i] = lion_polyval_d(soc, p->poly[i], LION_FUZZY_SETS_DEGREE);
+  }
+}
+
+double lion_resistance_polarization_from_polys(const double *polys, double current, lion_params_t *params, double *grad) {
   lion_params_rint_polarization_t *p = &params->rint.params.polarization;
 
   // Evaluate memberships
@@ -29,9 +39,100 @@ double lion_resistance_polarization(double soc, double current, lion_params_t *p
   // Calculate resulting internal resistance
   double num = 0;
   for (int i = 0; i < LION_FUZZY_SETS_COUNT; i++) {
-    num += memberships[i] * lion_polyval_d(soc, p->poly[i], LION_FUZZY_SETS_DEGREE);
+    num += memberships[i] * polys[i];
+  }
+  double rint = num / memberships_sum;
+
+  if (grad != NULL) {
+    // R = sum(m_i * p_i) / sum(m_i), so dR/dI = sum(m_i' * (p_i - R)) / sum(m_i)
+    double memberships_grad[LION_FUZZY_SETS_COUNT] = {
+      lion_mf_sigmoid_grad(current, &p->c40),
+      lion_mf_gaussian_grad(current, &p->c20),
+      lion_mf_gaussian_grad(current, &p->c10),
+      lion_mf_gaussian_grad(current, &p->c4),
+      lion_mf_gaussian_grad(current, &p->d5),
+      lion_mf_gaussian_grad(current, &p->d10),
+      lion_mf_gaussian_grad(current, &p->d15),
+      lion_mf_sigmoid_grad(current, &p->d30),
+    };
+    double num_grad = 0;
+    for (int i = 0; i < LION_FUZZY_SETS_COUNT; i++) {
+      num_grad += memberships_grad[i] * (polys[i] - rint);
+    }
+    *grad = num_grad / memberships_sum;
+  }
+  return rint;
+}
+
+static void _pack_gaussian(lion_rint_packed_t *packed, int i, lion_mf_gaussian_params_t *set) {
+  packed->center[i]  = set->mean;
+  packed->gauss[i]   = -0.5 / gsl_pow_2(set->sigma);
+  packed->slope[i]   = 0.0;
+  packed->sigmoid[i] = 0.0;
+}
+
+static void _pack_sigmoid(lion_rint_packed_t *packed, int i, lion_mf_sigmoid_params_t *set) {
+  packed->center[i]  = set->c;
+  packed->gauss[i]   = 0.0;
+  packed->slope[i]   = -set->a;
+  packed->sigmoid[i] = 1.0;
+}
+
+void lion_resistance_pack(lion_params_t *params, lion_rint_packed_t *out) {
+  // Same order of the sets as lion_resistance_polarization_from_polys
+  lion_params_rint_polarization_t *p = &params->rint.params.polarization;
+  _pack_sigmoid(out, 0, &p->c40);
+  _pack_gaussian(out, 1, &p->c20);
+  _pack_gaussian(out, 2, &p->c10);
+  _pack_gaussian(out, 3, &p->c4);
+  _pack_gaussian(out, 4, &p->d5);
+  _pack_gaussian(out, 5, &p->d10);
+  _pack_gaussian(out, 6, &p->d15);
+  _pack_sigmoid(out, 7, &p->d30);
+  for (int i = 0; i < LION_FUZZY_SETS_COUNT; i++) {
+    for (int j = 0; j < LION_FUZZY_SETS_DEGREE; j++) {
+      out->poly[j][i] = p->poly[i][j];
+    }
+  }
+}
+
+void lion_resistance_pack_f32(lion_params_t *params, lion_rint_packed_f32_t *out) {
+  // Packed in double first, so that the sets are rounded only once
+  lion_rint_packed_t packed;
+  lion_resistance_pack(params, &packed);
+  for (int i = 0; i < LION_FUZZY_SETS_COUNT; i++) {
+    out->center[i]  = (float)packed.center[i];
+    out->gauss[i]   = (float)packed.gauss[i];
+    out->slope[i]   = (float)packed.slope[i];
+    out->sigmoid[i] = (float)packed.sigmoid[i];
+    for (int j = 0; j < LION_FUZZY_SETS_DEGREE; j++) {
+      out->poly[j][i] = (float)packed.poly[j][i];
+    }
   }
-  return num / memberships_sum;
+}
+
+void lion_resistance_packed_polys(const lion_rint_packed_t *packed, double soc, double *polys) { lion_kernels()->resistance_packed_polys(packed, soc, polys); }
+
+double lion_resistance_packed(const lion_rint_packed_t *packed, const double *polys, double current, double *grad) {
+  return lion_kernels()->resistance_packed(packed, polys, current, grad);
+}
+
+void lion_resistance_packed_n(const lion_rint_packed_t *packed, const double *polys, const double *current, size_t n, double *out, double *grad) {
+  lion_kernels()->resistance_packed_n(packed, polys, current, n, out, grad);
+}
+
+double lion_resistance_polarization(double soc, double current, lion_params_t *params) {
+  double polys[LION_FUZZY_SETS_COUNT];
+  lion_resistance_polarization_polys(soc, params, polys);
+  return lion_resistance_polarization_from_polys(polys, current, params, NULL);
+}
+
+double lion_resistance_polarization_grad_current(double soc, double current, lion_params_t *params) {
+  double polys[LION_FUZZY_SETS_COUNT];
+  double grad;
+  lion_resistance_polarization_polys(soc, params, polys);
+  lion_resistance_polarization_from_polys(polys, current, params, &grad);
+  return grad;
 }
 
 double lion_resistance(double soc, double current, lion_params_t *params) {
@@ -45,3 +146,15 @@ double lion_resistance(double soc, double current, lion_params_t *params) {
     return -1.0;
   }
 }
+
+double lion_resistance_grad_current(double soc, double current, lion_params_t *params) {
+  switch (params->rint.model) {
+  case LION_RINT_MODEL_FIXED:
+    return 0.0;
+  case LION_RINT_MODEL_POLARIZATION:
+    return lion_resistance_polarization_grad_current(soc, current, params);
+  default:
+    logi_error("Internal resistance model not valid");
+    return 0.0;
+  }
+}
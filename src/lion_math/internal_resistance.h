@@ -1,12 +1,25 @@
 #pragma once
 
+#include <lion/eval.h>
 #include <lion/params.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 double lion_resistance(double soc, double current, lion_params_t *params);
+double lion_resistance_grad_current(double soc, double current, lion_params_t *params);
+void   lion_resistance_polarization_polys(double soc, lion_params_t *params, double *polys);
+double lion_resistance_polarization_from_polys(const double *polys, double current, lion_params_t *params, double *grad);
+
+// Packed polarization model: every membership and the weighted sum of the
+// polynomials in a single SIMD pass, for one current or an array of them
+void   lion_resistance_pack(lion_params_t *params, lion_rint_packed_t *out);
+void   lion_resistance_packed_polys(const lion_rint_packed_t *packed, double soc, double *polys);
+double lion_resistance_packed(const lion_rint_packed_t *packed, const double *polys, double current, double *grad);
+void   lion_resistance_packed_n(const lion_rint_packed_t *packed, const double *polys, const double *current, size_t n, double *out, double *grad);
+void   lion_resistance_pack_f32(lion_params_t *params, lion_rint_packed_f32_t *out);
 
 #ifdef __cplusplus
 }
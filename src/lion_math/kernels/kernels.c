@@ -0,0 +1,299 @@
+// Built once per instruction set and fast math tier, each build defining
+// LION_SIMD_TARGET, LION_KERNELS_FAST_MATH, numbered as lion_fast_math_t, and
+// LION_KERNELS_TABLE, the name of its table, and once more per instruction set
+// in single precision, defining LION_KERNELS_F32. Everything here is static
+// but the table, so that no function built for a wider instruction set can be
+// picked by the linker for the others
+
+#include "../simd.h"
+#include "kernels.h"
+
+#include <lion/lion.h>
+#include <math.h>
+
+// The kernels are written over lion_vr_t, the vector of the precision of the
+// build. Constants are taken in double and rounded once when broadcast
+#if defined(LION_KERNELS_F32)
+typedef float                  lion_real_t;
+typedef lion_vf_t              lion_vr_t;
+typedef lion_rint_packed_f32_t lion_packed_t;
+typedef lion_kernels_f32_t     lion_kernels_vr_t;
+
+  #define LION_VR_WIDTH     LION_SIMD_WIDTH_F
+  #define lion_vr_set1(x)   lion_vf_set1((float)(x))
+  #define lion_vr_add       lion_vf_add
+  #define lion_vr_sub       lion_vf_sub
+  #define lion_vr_mul       lion_vf_mul
+  #define lion_vr_div       lion_vf_div
+  #define lion_vr_fmadd     lion_vf_fmadd
+  #define lion_vr_max       lion_vf_max
+  #define lion_vr_sqrt      lion_vf_sqrt
+  #define lion_vr_loadn     lion_vf_loadn
+  #define lion_vr_storen    lion_vf_storen
+  #define lion_vr_hsum      lion_vf_hsum
+  #define lion_vr_select    lion_vf_select
+  #define LION_KERNEL_EXP   lion_vf_exp
+#else
+typedef double             lion_real_t;
+typedef lion_vd_t          lion_vr_t;
+typedef lion_rint_packed_t lion_packed_t;
+typedef lion_kernels_t     lion_kernels_vr_t;
+
+  #define LION_VR_WIDTH     LION_SIMD_WIDTH
+  #define lion_vr_set1(x)   lion_vd_set1((double)(x))
+  #define lion_vr_add       lion_vd_add
+  #define lion_vr_sub       lion_vd_sub
+  #define lion_vr_mul       lion_vd_mul
+  #define lion_vr_div       lion_vd_div
+  #define lion_vr_fmadd     lion_vd_fmadd
+  #define lion_vr_max       lion_vd_max
+  #define lion_vr_sqrt      lion_vd_sqrt
+  #define lion_vr_loadn     lion_vd_loadn
+  #define lion_vr_storen    lion_vd_storen
+  #define lion_vr_hsum      lion_vd_hsum
+  #define lion_vr_select    lion_vd_select
+  #if LION_KERNELS_FAST_MATH == 1
+    #define LION_KERNEL_EXP lion_vd_exp_1e12
+  #elif LION_KERNELS_FAST_MATH == 2
+    #define LION_KERNEL_EXP lion_vd_exp_1e7
+  #else
+    #define LION_KERNEL_EXP lion_vd_exp
+  #endif
+#endif
+
+/*
+   Every kernel follows the scalar model term by term, with the constants that
+   only depend on the parameters hoisted out of the loop. The last iteration
+   masks out the lanes past n, so results do not depend on the position of an
+   element in the array
+*/
+
+static void _voc_n(const lion_real_t *soc, size_t n, lion_params_t *params, lion_real_t *out) {
+  lion_vr_t one    = lion_vr_set1(1.0);
+  lion_vr_t term0  = lion_vr_set1(params->ocv.vl);
+  lion_vr_t gamma  = lion_vr_set1(params->ocv.gamma);
+  lion_vr_t beta   = lion_vr_set1(-params->ocv.beta);
+  lion_vr_t coeff1 = lion_vr_set1(params->ocv.v0 - params->ocv.vl);
+  lion_vr_t coeff2 = lion_vr_set1(params->ocv.alpha * params->ocv.vl);
+  lion_vr_t coeff3 = lion_vr_set1((1.0 - params->ocv.alpha) * params->ocv.vl);
+  lion_vr_t left3  = lion_vr_set1(exp(-params->ocv.beta));
+
+  for (size_t i = 0; i < n; i += LION_VR_WIDTH) {
+    size_t m = n - i;
+
+    lion_vr_t s     = lion_vr_loadn(soc + i, m);
+    lion_vr_t delta = lion_vr_sub(s, one);
+    lion_vr_t term1 = lion_vr_mul(coeff1, LION_KERNEL_EXP(lion_vr_mul(gamma, delta)));
+    lion_vr_t term3 = lion_vr_sub(left3, LION_KERNEL_EXP(lion_vr_mul(beta, lion_vr_sqrt(s))));
+    lion_vr_t ocv   = lion_vr_fmadd(coeff2, delta, lion_vr_add(term0, term1));
+    lion_vr_storen(out + i, lion_vr_fmadd(coeff3, term3, ocv), m);
+  }
+}
+
+static void _voc_grad_n(const lion_real_t *soc, size_t n, lion_params_t *params, lion_real_t *out) {
+  lion_vr_t one    = lion_vr_set1(1.0);
+  lion_vr_t half   = lion_vr_set1(0.5);
+  lion_vr_t gamma  = lion_vr_set1(params->ocv.gamma);
+  lion_vr_t beta   = lion_vr_set1(-params->ocv.beta);
+  lion_vr_t coeff1 = lion_vr_set1(params->ocv.gamma * (params->ocv.v0 - params->ocv.vl));
+  lion_vr_t term2  = lion_vr_set1(params->ocv.alpha * params->ocv.vl);
+  lion_vr_t coeff3 = lion_vr_set1((1.0 - params->ocv.alpha) * params->ocv.vl * params->ocv.beta);
+
+  for (size_t i = 0; i < n; i += LION_VR_WIDTH) {
+    size_t m = n - i;
+
+    lion_vr_t s     = lion_vr_loadn(soc + i, m);
+    lion_vr_t root  = lion_vr_sqrt(s);
+    lion_vr_t term1 = lion_vr_mul(coeff1, LION_KERNEL_EXP(lion_vr_mul(gamma, lion_vr_sub(s, one))));
+    lion_vr_t term3 = lion_vr_div(lion_vr_mul(coeff3, LION_KERNEL_EXP(lion_vr_mul(beta, root))), root);
+    lion_vr_storen(out + i, lion_vr_fmadd(half, term3, lion_vr_add(term1, term2)), m);
+  }
+}
+
+static void _ehc_n(const lion_real_t *soc, size_t n, lion_params_t *params, lion_real_t *out) {
+  lion_vr_t mu     = lion_vr_set1(params->ehc.mu);
+  lion_vr_t kappa  = lion_vr_set1(-params->ehc.kappa);
+  lion_vr_t inv2s2 = lion_vr_set1(-1.0 / (2.0 * params->ehc.sigma * params->ehc.sigma));
+  lion_vr_t coeff1 = lion_vr_set1(params->ehc.a * M_SQRT1_2 / (M_SQRTPI * params->ehc.sigma));
+  lion_vr_t coeff2 = lion_vr_set1(-params->ehc.a * params->ehc.l);
+  lion_vr_t b      = lion_vr_set1(params->ehc.b);
+
+  for (size_t i = 0; i < n; i += LION_VR_WIDTH) {
+    size_t m = n - i;
+
+    lion_vr_t s     = lion_vr_loadn(soc + i, m);
+    lion_vr_t delta = lion_vr_sub(s, mu);
+    lion_vr_t term1 = LION_KERNEL_EXP(lion_vr_mul(lion_vr_mul(delta, delta), inv2s2));
+    lion_vr_t term2 = LION_KERNEL_EXP(lion_vr_mul(kappa, s));
+    lion_vr_storen(out + i, lion_vr_fmadd(coeff1, term1, lion_vr_fmadd(coeff2, term2, b)), m);
+  }
+}
+
+static void _kappa_n(const lion_real_t *internal_temperature, size_t n, lion_params_t *params, lion_real_t *out) {
+  lion_vr_t k1    = lion_vr_set1(params->vft.k1);
+  lion_vr_t k2    = lion_vr_set1(params->vft.k2);
+  lion_vr_t right = lion_vr_set1(params->vft.k1 / (params->vft.tref - params->vft.k2));
+
+  for (size_t i = 0; i < n; i += LION_VR_WIDTH) {
+    size_t m = n - i;
+
+    lion_vr_t left = lion_vr_div(k1, lion_vr_sub(lion_vr_loadn(internal_temperature + i, m), k2));
+    lion_vr_storen(out + i, LION_KERNEL_EXP(lion_vr_sub(left, right)), m);
+  }
+}
+
+static void _current_n(
+    const lion_real_t *power, const lion_real_t *open_circuit_voltage, const lion_real_t *internal_resistance, size_t n, lion_params_t *params, lion_real_t *out
+) {
+  // Unlike lion_current, a negative discriminant is not logged and yields NaN
+  lion_vr_t half = lion_vr_set1(0.5);
+
+  for (size_t i = 0; i < n; i += LION_VR_WIDTH) {
+    size_t m = n - i;
+
+    lion_vr_t r = lion_vr_loadn(internal_resistance + i, m);
+    lion_vr_t a = lion_vr_div(lion_vr_mul(half, lion_vr_loadn(open_circuit_voltage + i, m)), r);
+    lion_vr_t d = lion_vr_sub(lion_vr_mul(a, a), lion_vr_div(lion_vr_loadn(power + i, m), r));
+    lion_vr_storen(out + i, lion_vr_sub(a, lion_vr_sqrt(d)), m);
+  }
+}
+
+static void _generated_heat_n(
+    const lion_real_t *current,
+    const lion_real_t *internal_temperature,
+    const lion_real_t *internal_resistance,
+    const lion_real_t *ehc,
+    size_t n,
+    lion_params_t *params,
+    lion_real_t *out
+) {
+  lion_vr_t zero = lion_vr_set1(0.0);
+
+  for (size_t i = 0; i < n; i += LION_VR_WIDTH) {
+    size_t m = n - i;
+
+    lion_vr_t c        = lion_vr_loadn(current + i, m);
+    lion_vr_t ohmic    = lion_vr_mul(lion_vr_loadn(internal_resistance + i, m), c);
+    lion_vr_t entropic = lion_vr_mul(lion_vr_loadn(internal_temperature + i, m), lion_vr_loadn(ehc + i, m));
+    lion_vr_storen(out + i, lion_vr_max(lion_vr_mul(c, lion_vr_sub(ohmic, entropic)), zero), m);
+  }
+}
+
+static void _internal_temperature_d_n(
+    const lion_real_t *internal_temperature, const lion_real_t *heat, const lion_real_t *ambient_temperature, size_t n, lion_params_t *params, lion_real_t *out
+) {
+  lion_vr_t inv_rt = lion_vr_set1(1.0 / (params->temp.rin + params->temp.rout));
+  lion_vr_t inv_cp = lion_vr_set1(1.0 / params->temp.cp);
+
+  for (size_t i = 0; i < n; i += LION_VR_WIDTH) {
+    size_t m = n - i;
+
+    lion_vr_t delta = lion_vr_sub(lion_vr_loadn(ambient_temperature + i, m), lion_vr_loadn(internal_temperature + i, m));
+    lion_vr_t diff  = lion_vr_fmadd(delta, inv_rt, lion_vr_loadn(heat + i, m));
+    lion_vr_storen(out + i, lion_vr_mul(diff, inv_cp), m);
+  }
+}
+
+static void _resistance_packed_polys(const lion_packed_t *packed, lion_real_t soc, lion_real_t *polys) {
+  // Horner scheme, with the lanes going through the sets
+  lion_vr_t x = lion_vr_set1(soc);
+  for (size_t k = 0; k < LION_FUZZY_SETS_COUNT; k += LION_VR_WIDTH) {
+    size_t    m   = LION_FUZZY_SETS_COUNT - k;
+    lion_vr_t acc = lion_vr_loadn(packed->poly[LION_FUZZY_SETS_DEGREE - 1] + k, m);
+    for (int j = LION_FUZZY_SETS_DEGREE - 2; j >= 0; j--) {
+      acc = lion_vr_fmadd(acc, x, lion_vr_loadn(packed->poly[j] + k, m));
+    }
+    lion_vr_storen(polys + k, acc, m);
+  }
+}
+
+static inline void _packed_membership(lion_vr_t d, lion_vr_t gauss, lion_vr_t slope, lion_vr_t sigmoid, lion_vr_t *m, lion_vr_t *dm) {
+  // m' = m (2 gauss d + slope (m - 1)) covers both kinds of set
+  lion_vr_t one  = lion_vr_set1(1.0);
+  lion_vr_t e    = LION_KERNEL_EXP(lion_vr_mul(d, lion_vr_fmadd(gauss, d, slope)));
+  *m             = lion_vr_select(sigmoid, lion_vr_div(one, lion_vr_add(one, e)), e);
+  lion_vr_t rate = lion_vr_fmadd(lion_vr_add(gauss, gauss), d, lion_vr_mul(slope, lion_vr_sub(*m, one)));
+  *dm            = lion_vr_mul(*m, rate);
+}
+
+static lion_real_t _resistance_packed(const lion_packed_t *packed, const lion_real_t *polys, lion_real_t current, lion_real_t *grad) {
+  // R = sum(m_i p_i) / sum(m_i) and dR/dI = (sum(m_i' p_i) - R sum(m_i')) / sum(m_i)
+  lion_vr_t x    = lion_vr_set1(current);
+  lion_vr_t num  = lion_vr_set1(0.0);
+  lion_vr_t den  = lion_vr_set1(0.0);
+  lion_vr_t dnum = lion_vr_set1(0.0);
+  lion_vr_t dden = lion_vr_set1(0.0);
+  for (size_t k = 0; k < LION_FUZZY_SETS_COUNT; k += LION_VR_WIDTH) {
+    size_t m = LION_FUZZY_SETS_COUNT - k;
+
+    lion_vr_t d       = lion_vr_sub(x, lion_vr_loadn(packed->center + k, m));
+    lion_vr_t p       = lion_vr_loadn(polys + k, m);
+    lion_vr_t gauss   = lion_vr_loadn(packed->gauss + k, m);
+    lion_vr_t sigmoid = lion_vr_loadn(packed->sigmoid + k, m);
+    lion_vr_t mf, dmf;
+    _packed_membership(d, gauss, lion_vr_loadn(packed->slope + k, m), sigmoid, &mf, &dmf);
+#if LION_VR_WIDTH > LION_FUZZY_SETS_COUNT
+    // The lanes past the last set load zeros, which read as a flat gaussian of
+    // membership 1. Every actual set is either a sigmoid or has gauss < 0
+    lion_vr_t set = lion_vr_sub(sigmoid, gauss);
+    mf            = lion_vr_select(set, mf, lion_vr_set1(0.0));
+    dmf           = lion_vr_select(set, dmf, lion_vr_set1(0.0));
+#endif
+    num  = lion_vr_fmadd(mf, p, num);
+    den  = lion_vr_add(den, mf);
+    dnum = lion_vr_fmadd(dmf, p, dnum);
+    dden = lion_vr_add(dden, dmf);
+  }
+
+  lion_real_t sum  = lion_vr_hsum(den);
+  lion_real_t rint = lion_vr_hsum(num) / sum;
+  if (grad != NULL) {
+    *grad = (lion_vr_hsum(dnum) - rint * lion_vr_hsum(dden)) / sum;
+  }
+  return rint;
+}
+
+static void _resistance_packed_n(
+    const lion_packed_t *packed, const lion_real_t *polys, const lion_real_t *current, size_t n, lion_real_t *out, lion_real_t *grad
+) {
+  // The lanes go through the currents here, and the sets are broadcast
+  for (size_t i = 0; i < n; i += LION_VR_WIDTH) {
+    size_t m = n - i;
+
+    lion_vr_t x    = lion_vr_loadn(current + i, m);
+    lion_vr_t num  = lion_vr_set1(0.0);
+    lion_vr_t den  = lion_vr_set1(0.0);
+    lion_vr_t dnum = lion_vr_set1(0.0);
+    lion_vr_t dden = lion_vr_set1(0.0);
+    for (int k = 0; k < LION_FUZZY_SETS_COUNT; k++) {
+      lion_vr_t d = lion_vr_sub(x, lion_vr_set1(packed->center[k]));
+      lion_vr_t p = lion_vr_set1(polys[k]);
+      lion_vr_t mf, dmf;
+      _packed_membership(d, lion_vr_set1(packed->gauss[k]), lion_vr_set1(packed->slope[k]), lion_vr_set1(packed->sigmoid[k]), &mf, &dmf);
+      num  = lion_vr_fmadd(mf, p, num);
+      den  = lion_vr_add(den, mf);
+      dnum = lion_vr_fmadd(dmf, p, dnum);
+      dden = lion_vr_add(dden, dmf);
+    }
+
+    lion_vr_t rint = lion_vr_div(num, den);
+    lion_vr_storen(out + i, rint, m);
+    if (grad != NULL) {
+      lion_vr_storen(grad + i, lion_vr_div(lion_vr_sub(dnum, lion_vr_mul(rint, dden)), den), m);
+    }
+  }
+}
+
+const lion_kernels_vr_t LION_KERNELS_TABLE = {
+    .name                     = LION_SIMD_NAME,
+    .voc_n                    = _voc_n,
+    .voc_grad_n               = _voc_grad_n,
+    .ehc_n                    = _ehc_n,
+    .kappa_n                  = _kappa_n,
+    .current_n                = _current_n,
+    .generated_heat_n         = _generated_heat_n,
+    .internal_temperature_d_n = _internal_temperature_d_n,
+    .resistance_packed_polys  = _resistance_packed_polys,
+    .resistance_packed        = _resistance_packed,
+    .resistance_packed_n      = _resistance_packed_n,
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <lion/eval.h>
+#include <lion/params.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of fast math tiers, as in lion_fast_math_t
+#define LION_FAST_MATH_TIERS 3
+
+// SIMD kernels of one instruction set and fast math tier. kernels.c is built
+// once per combination into one of these tables, and lion_kernels returns the
+// one of the level picked at runtime
+typedef struct lion_kernels {
+  const char *name;
+  void (*voc_n)(const double *soc, size_t n, lion_params_t *params, double *out);
+  void (*voc_grad_n)(const double *soc, size_t n, lion_params_t *params, double *out);
+  void (*ehc_n)(const double *soc, size_t n, lion_params_t *params, double *out);
+  void (*kappa_n)(const double *internal_temperature, size_t n, lion_params_t *params, double *out);
+  void (*current_n)(const double *power, const double *open_circuit_voltage, const double *internal_resistance, size_t n, lion_params_t *params, double *out);
+  void (*generated_heat_n)(
+      const double *current, const double *internal_temperature, const double *internal_resistance, const double *ehc, size_t n, lion_params_t *params, double *out
+  );
+  void (*internal_temperature_d_n)(
+      const double *internal_temperature, const double *heat, const double *ambient_temperature, size_t n, lion_params_t *params, double *out
+  );
+  void (*resistance_packed_polys)(const lion_rint_packed_t *packed, double soc, double *polys);
+  double (*resistance_packed)(const lion_rint_packed_t *packed, const double *polys, double current, double *grad);
+  void (*resistance_packed_n)(const lion_rint_packed_t *packed, const double *polys, const double *current, size_t n, double *out, double *grad);
+} lion_kernels_t;
+
+// Single precision counterpart of lion_kernels_t, built once per instruction
+// set. The exponentials are already within the precision of a float, so there
+// are no fast math tiers
+typedef struct lion_kernels_f32 {
+  const char *name;
+  void (*voc_n)(const float *soc, size_t n, lion_params_t *params, float *out);
+  void (*voc_grad_n)(const float *soc, size_t n, lion_params_t *params, float *out);
+  void (*ehc_n)(const float *soc, size_t n, lion_params_t *params, float *out);
+  void (*kappa_n)(const float *internal_temperature, size_t n, lion_params_t *params, float *out);
+  void (*current_n)(const float *power, const float *open_circuit_voltage, const float *internal_resistance, size_t n, lion_params_t *params, float *out);
+  void (*generated_heat_n)(
+      const float *current, const float *internal_temperature, const float *internal_resistance, const float *ehc, size_t n, lion_params_t *params, float *out
+  );
+  void (*internal_temperature_d_n)(
+      const float *internal_temperature, const float *heat, const float *ambient_temperature, size_t n, lion_params_t *params, float *out
+  );
+  void (*resistance_packed_polys)(const lion_rint_packed_f32_t *packed, float soc, float *polys);
+  float (*resistance_packed)(const lion_rint_packed_f32_t *packed, const float *polys, float current, float *grad);
+  void (*resistance_packed_n)(const lion_rint_packed_f32_t *packed, const float *polys, const float *current, size_t n, float *out, float *grad);
+} lion_kernels_f32_t;
+
+extern const lion_kernels_t lion_kernels_scalar_off;
+extern const lion_kernels_t lion_kernels_scalar_1e12;
+extern const lion_kernels_t lion_kernels_scalar_1e7;
+extern const lion_kernels_f32_t lion_kernels_scalar_f32;
+#if defined(LION_SIMD_DISPATCH)
+extern const lion_kernels_t lion_kernels_avx2_off;
+extern const lion_kernels_t lion_kernels_avx2_1e12;
+extern const lion_kernels_t lion_kernels_avx2_1e7;
+extern const lion_kernels_f32_t lion_kernels_avx2_f32;
+extern const lion_kernels_t lion_kernels_avx512_off;
+extern const lion_kernels_t lion_kernels_avx512_1e12;
+extern const lion_kernels_t lion_kernels_avx512_1e7;
+extern const lion_kernels_f32_t lion_kernels_avx512_f32;
+#endif
+
+const lion_kernels_t     *lion_kernels(void);
+const lion_kernels_t     *lion_kernels_fast(lion_fast_math_t fast_math);
+const lion_kernels_f32_t *lion_kernels_f32(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -3,11 +3,14 @@
 #include <math.h>
 
 // TODO: Double check implementation of each model
+#include "array.h"
 #include "capacity.h"
 #include "current.h"
 #include "dynamics/dynamics.h"
 #include "ehc.h"
+#include "eval.h"
 #include "generated_heat.h"
 #include "internal_resistance.h"
 #include "open_circuit.h"
+#include "table.h"
 #include "voltage.h"
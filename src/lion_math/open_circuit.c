@@ -39,3 +39,22 @@ double lion_voc_grad(double soc, lion_params_t *params) {
 
   return term1 + term2 + term3;
 }
+
+double lion_voc_with_grad(double soc, lion_params_t *params, double *grad) {
+  // Same as lion_voc and lion_voc_grad, sharing the exponentials between both
+  double sqrt_soc  = sqrt(soc);
+  double exp_gamma = exp(params->ocv.gamma * (soc - 1.0));
+  double exp_beta  = exp(-params->ocv.beta * sqrt_soc);
+
+  double term0 = params->ocv.vl;
+  double term1 = (params->ocv.v0 - params->ocv.vl) * exp_gamma;
+  double term2 = params->ocv.alpha * params->ocv.vl * (soc - 1.0);
+  double term3 = (1.0 - params->ocv.alpha) * params->ocv.vl * (exp(-params->ocv.beta) - exp_beta);
+
+  double grad1 = params->ocv.gamma * term1;
+  double grad2 = params->ocv.alpha * params->ocv.vl;
+  double grad3 = (1.0 - params->ocv.alpha) * params->ocv.vl * params->ocv.beta * exp_beta / (2 * sqrt_soc);
+
+  *grad = grad1 + grad2 + grad3;
+  return term0 + term1 + term2 + term3;
+}
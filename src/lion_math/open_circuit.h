@@ -8,6 +8,7 @@ extern "C" {
 
 double lion_voc(double soc, lion_params_t *params);
 double lion_voc_grad(double soc, lion_params_t *params);
+double lion_voc_with_grad(double soc, lion_params_t *params, double *grad);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,380 @@
+#pragma once
+
+#include <gsl/gsl_math.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Same numbering as lion_isa_t
+#define LION_SIMD_TARGET_SCALAR 0
+#define LION_SIMD_TARGET_AVX2   1
+#define LION_SIMD_TARGET_AVX512 2
+
+// The kernels built for each instruction set pick their target before
+// including this header, and anything else goes by the flags of the build.
+// MSVC does not define __FMA__, but allows FMA along with AVX2
+#if !defined(LION_SIMD_TARGET)
+  #if defined(__AVX512F__)
+    #define LION_SIMD_TARGET LION_SIMD_TARGET_AVX512
+  #elif defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+    #define LION_SIMD_TARGET LION_SIMD_TARGET_AVX2
+  #else
+    #define LION_SIMD_TARGET LION_SIMD_TARGET_SCALAR
+  #endif
+#endif
+
+#if LION_SIMD_TARGET != LION_SIMD_TARGET_SCALAR
+  #include <immintrin.h>
+#endif
+
+/*
+   Thin layer over the vector registers of the target, so that the array
+   kernels are written once. The instruction set is picked at compile time:
+   AVX-512 with 8 lanes, AVX2 with FMA with 4 lanes, or plain doubles with a
+   single lane. Loads and stores take the number of elements left, masking
+   out the lanes past the end of the arrays, so every element goes through
+   the same arithmetic. select picks a where the flag is non-zero and b
+   elsewhere.
+
+   exp follows the Cephes double precision routine: the argument is reduced
+   to r = x - k ln2 with |r| <= ln2 / 2, exp(r) is taken from a rational
+   approximation and the result is scaled by 2^k. It stays within 2 ulp of
+   the libm one, and saturates outside of [-708, 709], which the models never
+   reach. Single lane builds use the libm one instead.
+
+   The fast math tiers share the reduction but take exp(r) from a polynomial,
+   the interpolant of exp at the Chebyshev nodes of the reduced range: of
+   degree 9 for exp_1e12 and 6 for exp_1e7, with relative errors below 2e-14
+   and 3e-9 over the range, leaving room for the rounding of the reduction.
+
+   lion_vf_t mirrors lion_vd_t in single precision, with twice the lanes. Its
+   exp follows the Cephes single precision routine in the same way, within
+   1 ulp of expf, and saturates outside of [-87, 88]. Single lane builds use
+   expf instead.
+*/
+
+#define LION_SIMD_EXP_MIN -708.0
+#define LION_SIMD_EXP_MAX 709.0
+
+#define LION_SIMD_EXPF_MIN -87.0f
+#define LION_SIMD_EXPF_MAX 88.0f
+
+#if LION_SIMD_TARGET == LION_SIMD_TARGET_AVX512
+
+  #define LION_SIMD_WIDTH 8
+  #define LION_SIMD_NAME  "avx512"
+
+typedef __m512d lion_vd_t;
+
+static inline lion_vd_t lion_vd_set1(double x) { return _mm512_set1_pd(x); }
+static inline lion_vd_t lion_vd_add(lion_vd_t a, lion_vd_t b) { return _mm512_add_pd(a, b); }
+static inline lion_vd_t lion_vd_sub(lion_vd_t a, lion_vd_t b) { return _mm512_sub_pd(a, b); }
+static inline lion_vd_t lion_vd_mul(lion_vd_t a, lion_vd_t b) { return _mm512_mul_pd(a, b); }
+static inline lion_vd_t lion_vd_div(lion_vd_t a, lion_vd_t b) { return _mm512_div_pd(a, b); }
+static inline lion_vd_t lion_vd_fmadd(lion_vd_t a, lion_vd_t b, lion_vd_t c) { return _mm512_fmadd_pd(a, b, c); }
+static inline lion_vd_t lion_vd_max(lion_vd_t a, lion_vd_t b) { return _mm512_max_pd(a, b); }
+static inline lion_vd_t lion_vd_min(lion_vd_t a, lion_vd_t b) { return _mm512_min_pd(a, b); }
+static inline lion_vd_t lion_vd_sqrt(lion_vd_t x) { return _mm512_sqrt_pd(x); }
+static inline lion_vd_t lion_vd_round(lion_vd_t x) { return _mm512_roundscale_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+static inline lion_vd_t lion_vd_ldexp(lion_vd_t x, lion_vd_t k) { return _mm512_scalef_pd(x, k); }
+
+static inline lion_vd_t lion_vd_loadn(const double *x, size_t count) {
+  if (count >= LION_SIMD_WIDTH) {
+    return _mm512_loadu_pd(x);
+  }
+  return _mm512_maskz_loadu_pd((__mmask8)((1u << count) - 1u), x);
+}
+
+static inline void lion_vd_storen(double *out, lion_vd_t x, size_t count) {
+  if (count >= LION_SIMD_WIDTH) {
+    _mm512_storeu_pd(out, x);
+    return;
+  }
+  _mm512_mask_storeu_pd(out, (__mmask8)((1u << count) - 1u), x);
+}
+
+static inline double lion_vd_hsum(lion_vd_t x) { return _mm512_reduce_add_pd(x); }
+
+static inline lion_vd_t lion_vd_select(lion_vd_t flag, lion_vd_t a, lion_vd_t b) {
+  return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(flag, _mm512_setzero_pd(), _CMP_NEQ_UQ), b, a);
+}
+
+  #define LION_SIMD_WIDTH_F 16
+
+typedef __m512 lion_vf_t;
+
+static inline lion_vf_t lion_vf_set1(float x) { return _mm512_set1_ps(x); }
+static inline lion_vf_t lion_vf_add(lion_vf_t a, lion_vf_t b) { return _mm512_add_ps(a, b); }
+static inline lion_vf_t lion_vf_sub(lion_vf_t a, lion_vf_t b) { return _mm512_sub_ps(a, b); }
+static inline lion_vf_t lion_vf_mul(lion_vf_t a, lion_vf_t b) { return _mm512_mul_ps(a, b); }
+static inline lion_vf_t lion_vf_div(lion_vf_t a, lion_vf_t b) { return _mm512_div_ps(a, b); }
+static inline lion_vf_t lion_vf_fmadd(lion_vf_t a, lion_vf_t b, lion_vf_t c) { return _mm512_fmadd_ps(a, b, c); }
+static inline lion_vf_t lion_vf_max(lion_vf_t a, lion_vf_t b) { return _mm512_max_ps(a, b); }
+static inline lion_vf_t lion_vf_min(lion_vf_t a, lion_vf_t b) { return _mm512_min_ps(a, b); }
+static inline lion_vf_t lion_vf_sqrt(lion_vf_t x) { return _mm512_sqrt_ps(x); }
+static inline lion_vf_t lion_vf_round(lion_vf_t x) { return _mm512_roundscale_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+static inline lion_vf_t lion_vf_ldexp(lion_vf_t x, lion_vf_t k) { return _mm512_scalef_ps(x, k); }
+
+static inline lion_vf_t lion_vf_loadn(const float *x, size_t count) {
+  if (count >= LION_SIMD_WIDTH_F) {
+    return _mm512_loadu_ps(x);
+  }
+  return _mm512_maskz_loadu_ps((__mmask16)((1u << count) - 1u), x);
+}
+
+static inline void lion_vf_storen(float *out, lion_vf_t x, size_t count) {
+  if (count >= LION_SIMD_WIDTH_F) {
+    _mm512_storeu_ps(out, x);
+    return;
+  }
+  _mm512_mask_storeu_ps(out, (__mmask16)((1u << count) - 1u), x);
+}
+
+static inline float lion_vf_hsum(lion_vf_t x) { return _mm512_reduce_add_ps(x); }
+
+static inline lion_vf_t lion_vf_select(lion_vf_t flag, lion_vf_t a, lion_vf_t b) {
+  return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(flag, _mm512_setzero_ps(), _CMP_NEQ_UQ), b, a);
+}
+
+#elif LION_SIMD_TARGET == LION_SIMD_TARGET_AVX2
+
+  #define LION_SIMD_WIDTH 4
+  #define LION_SIMD_NAME  "avx2"
+
+typedef __m256d lion_vd_t;
+
+static inline lion_vd_t lion_vd_set1(double x) { return _mm256_set1_pd(x); }
+static inline lion_vd_t lion_vd_add(lion_vd_t a, lion_vd_t b) { return _mm256_add_pd(a, b); }
+static inline lion_vd_t lion_vd_sub(lion_vd_t a, lion_vd_t b) { return _mm256_sub_pd(a, b); }
+static inline lion_vd_t lion_vd_mul(lion_vd_t a, lion_vd_t b) { return _mm256_mul_pd(a, b); }
+static inline lion_vd_t lion_vd_div(lion_vd_t a, lion_vd_t b) { return _mm256_div_pd(a, b); }
+static inline lion_vd_t lion_vd_fmadd(lion_vd_t a, lion_vd_t b, lion_vd_t c) { return _mm256_fmadd_pd(a, b, c); }
+static inline lion_vd_t lion_vd_max(lion_vd_t a, lion_vd_t b) { return _mm256_max_pd(a, b); }
+static inline lion_vd_t lion_vd_min(lion_vd_t a, lion_vd_t b) { return _mm256_min_pd(a, b); }
+static inline lion_vd_t lion_vd_sqrt(lion_vd_t x) { return _mm256_sqrt_pd(x); }
+static inline lion_vd_t lion_vd_round(lion_vd_t x) { return _mm256_round_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+static inline lion_vd_t lion_vd_ldexp(lion_vd_t x, lion_vd_t k) {
+  // Builds 2^k from its exponent bits, k being an integer within the normal range
+  __m128i k32  = _mm256_cvtpd_epi32(k);
+  __m256i bits = _mm256_slli_epi64(_mm256_cvtepi32_epi64(_mm_add_epi32(k32, _mm_set1_epi32(1023))), 52);
+  return _mm256_mul_pd(x, _mm256_castsi256_pd(bits));
+}
+
+static inline __m256i lion_vd_mask(size_t count) {
+  return _mm256_cmpgt_epi64(_mm256_set1_epi64x((long long)count), _mm256_setr_epi64x(0, 1, 2, 3));
+}
+
+static inline lion_vd_t lion_vd_loadn(const double *x, size_t count) {
+  if (count >= LION_SIMD_WIDTH) {
+    return _mm256_loadu_pd(x);
+  }
+  return _mm256_maskload_pd(x, lion_vd_mask(count));
+}
+
+static inline void lion_vd_storen(double *out, lion_vd_t x, size_t count) {
+  if (count >= LION_SIMD_WIDTH) {
+    _mm256_storeu_pd(out, x);
+    return;
+  }
+  _mm256_maskstore_pd(out, lion_vd_mask(count), x);
+}
+
+static inline double lion_vd_hsum(lion_vd_t x) {
+  __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+static inline lion_vd_t lion_vd_select(lion_vd_t flag, lion_vd_t a, lion_vd_t b) {
+  return _mm256_blendv_pd(b, a, _mm256_cmp_pd(flag, _mm256_setzero_pd(), _CMP_NEQ_UQ));
+}
+
+  #define LION_SIMD_WIDTH_F 8
+
+typedef __m256 lion_vf_t;
+
+static inline lion_vf_t lion_vf_set1(float x) { return _mm256_set1_ps(x); }
+static inline lion_vf_t lion_vf_add(lion_vf_t a, lion_vf_t b) { return _mm256_add_ps(a, b); }
+static inline lion_vf_t lion_vf_sub(lion_vf_t a, lion_vf_t b) { return _mm256_sub_ps(a, b); }
+static inline lion_vf_t lion_vf_mul(lion_vf_t a, lion_vf_t b) { return _mm256_mul_ps(a, b); }
+static inline lion_vf_t lion_vf_div(lion_vf_t a, lion_vf_t b) { return _mm256_div_ps(a, b); }
+static inline lion_vf_t lion_vf_fmadd(lion_vf_t a, lion_vf_t b, lion_vf_t c) { return _mm256_fmadd_ps(a, b, c); }
+static inline lion_vf_t lion_vf_max(lion_vf_t a, lion_vf_t b) { return _mm256_max_ps(a, b); }
+static inline lion_vf_t lion_vf_min(lion_vf_t a, lion_vf_t b) { return _mm256_min_ps(a, b); }
+static inline lion_vf_t lion_vf_sqrt(lion_vf_t x) { return _mm256_sqrt_ps(x); }
+static inline lion_vf_t lion_vf_round(lion_vf_t x) { return _mm256_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+static inline lion_vf_t lion_vf_ldexp(lion_vf_t x, lion_vf_t k) {
+  // Builds 2^k from its exponent bits, k being an integer within the normal range
+  __m256i bits = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(k), _mm256_set1_epi32(127)), 23);
+  return _mm256_mul_ps(x, _mm256_castsi256_ps(bits));
+}
+
+static inline __m256i lion_vf_mask(size_t count) {
+  return _mm256_cmpgt_epi32(_mm256_set1_epi32((int)count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+static inline lion_vf_t lion_vf_loadn(const float *x, size_t count) {
+  if (count >= LION_SIMD_WIDTH_F) {
+    return _mm256_loadu_ps(x);
+  }
+  return _mm256_maskload_ps(x, lion_vf_mask(count));
+}
+
+static inline void lion_vf_storen(float *out, lion_vf_t x, size_t count) {
+  if (count >= LION_SIMD_WIDTH_F) {
+    _mm256_storeu_ps(out, x);
+    return;
+  }
+  _mm256_maskstore_ps(out, lion_vf_mask(count), x);
+}
+
+static inline float lion_vf_hsum(lion_vf_t x) {
+  __m128 quad = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+  __m128 pair = _mm_add_ps(quad, _mm_movehl_ps(quad, quad));
+  return _mm_cvtss_f32(_mm_add_ss(pair, _mm_shuffle_ps(pair, pair, 1)));
+}
+
+static inline lion_vf_t lion_vf_select(lion_vf_t flag, lion_vf_t a, lion_vf_t b) {
+  return _mm256_blendv_ps(b, a, _mm256_cmp_ps(flag, _mm256_setzero_ps(), _CMP_NEQ_UQ));
+}
+
+#else
+
+  #define LION_SIMD_WIDTH 1
+  #define LION_SIMD_NAME  "scalar"
+
+typedef double lion_vd_t;
+
+static inline lion_vd_t lion_vd_set1(double x) { return x; }
+static inline lion_vd_t lion_vd_add(lion_vd_t a, lion_vd_t b) { return a + b; }
+static inline lion_vd_t lion_vd_sub(lion_vd_t a, lion_vd_t b) { return a - b; }
+static inline lion_vd_t lion_vd_mul(lion_vd_t a, lion_vd_t b) { return a * b; }
+static inline lion_vd_t lion_vd_div(lion_vd_t a, lion_vd_t b) { return a / b; }
+static inline lion_vd_t lion_vd_fmadd(lion_vd_t a, lion_vd_t b, lion_vd_t c) { return a * b + c; }
+static inline lion_vd_t lion_vd_max(lion_vd_t a, lion_vd_t b) { return (a > b) ? a : b; }
+static inline lion_vd_t lion_vd_min(lion_vd_t a, lion_vd_t b) { return (a < b) ? a : b; }
+static inline lion_vd_t lion_vd_sqrt(lion_vd_t x) { return sqrt(x); }
+static inline lion_vd_t lion_vd_loadn(const double *x, size_t count) { return *x; }
+static inline void      lion_vd_storen(double *out, lion_vd_t x, size_t count) { *out = x; }
+static inline double    lion_vd_hsum(lion_vd_t x) { return x; }
+static inline lion_vd_t lion_vd_select(lion_vd_t flag, lion_vd_t a, lion_vd_t b) { return (flag != 0.0) ? a : b; }
+
+static inline lion_vd_t lion_vd_round(lion_vd_t x) {
+  // Adding 1.5 * 2^52 drops the fraction, for any |x| below 2^51
+  return (x + 6755399441055744.0) - 6755399441055744.0;
+}
+
+static inline lion_vd_t lion_vd_ldexp(lion_vd_t x, lion_vd_t k) {
+  // Builds 2^k from its exponent bits, k being an integer within the normal range
+  uint64_t bits = (uint64_t)((int64_t)k + 1023) << 52;
+  double   scale;
+  memcpy(&scale, &bits, sizeof(scale));
+  return x * scale;
+}
+
+  #define LION_SIMD_WIDTH_F 1
+
+typedef float lion_vf_t;
+
+static inline lion_vf_t lion_vf_set1(float x) { return x; }
+static inline lion_vf_t lion_vf_add(lion_vf_t a, lion_vf_t b) { return a + b; }
+static inline lion_vf_t lion_vf_sub(lion_vf_t a, lion_vf_t b) { return a - b; }
+static inline lion_vf_t lion_vf_mul(lion_vf_t a, lion_vf_t b) { return a * b; }
+static inline lion_vf_t lion_vf_div(lion_vf_t a, lion_vf_t b) { return a / b; }
+static inline lion_vf_t lion_vf_fmadd(lion_vf_t a, lion_vf_t b, lion_vf_t c) { return a * b + c; }
+static inline lion_vf_t lion_vf_max(lion_vf_t a, lion_vf_t b) { return (a > b) ? a : b; }
+static inline lion_vf_t lion_vf_min(lion_vf_t a, lion_vf_t b) { return (a < b) ? a : b; }
+static inline lion_vf_t lion_vf_sqrt(lion_vf_t x) { return sqrtf(x); }
+static inline lion_vf_t lion_vf_loadn(const float *x, size_t count) { return *x; }
+static inline void      lion_vf_storen(float *out, lion_vf_t x, size_t count) { *out = x; }
+static inline float     lion_vf_hsum(lion_vf_t x) { return x; }
+static inline lion_vf_t lion_vf_select(lion_vf_t flag, lion_vf_t a, lion_vf_t b) { return (flag != 0.0f) ? a : b; }
+
+#endif
+
+static inline lion_vd_t lion_vd_exp_reduce(lion_vd_t x, lion_vd_t *k) {
+  // x = k ln2 + r with |r| <= ln2 / 2, where ln2 is split in two so that
+  // k ln2 is exact for every k in range
+  x           = lion_vd_min(lion_vd_max(x, lion_vd_set1(LION_SIMD_EXP_MIN)), lion_vd_set1(LION_SIMD_EXP_MAX));
+  *k          = lion_vd_round(lion_vd_mul(x, lion_vd_set1(M_LOG2E)));
+  lion_vd_t r = lion_vd_fmadd(*k, lion_vd_set1(-6.93145751953125e-1), x);
+  return lion_vd_fmadd(*k, lion_vd_set1(-1.42860682030941723212e-6), r);
+}
+
+#if LION_SIMD_WIDTH > 1
+
+static inline lion_vd_t lion_vd_exp(lion_vd_t x) {
+  lion_vd_t k;
+  lion_vd_t r = lion_vd_exp_reduce(x, &k);
+
+  // exp(r) = 1 + 2 r P(r^2) / (Q(r^2) - r P(r^2))
+  lion_vd_t r2 = lion_vd_mul(r, r);
+  lion_vd_t p  = lion_vd_fmadd(lion_vd_set1(1.26177193074810590878e-4), r2, lion_vd_set1(3.02994407707441961300e-2));
+  p            = lion_vd_mul(r, lion_vd_fmadd(p, r2, lion_vd_set1(9.99999999999999999910e-1)));
+  lion_vd_t q  = lion_vd_fmadd(lion_vd_set1(3.00198505138664455042e-6), r2, lion_vd_set1(2.52448340349684104192e-3));
+  q            = lion_vd_fmadd(q, r2, lion_vd_set1(2.27265548208155028766e-1));
+  q            = lion_vd_fmadd(q, r2, lion_vd_set1(2.00000000000000000009e0));
+  lion_vd_t e  = lion_vd_div(p, lion_vd_sub(q, p));
+  e            = lion_vd_fmadd(lion_vd_set1(2.0), e, lion_vd_set1(1.0));
+  return lion_vd_ldexp(e, k);
+}
+
+#else
+
+static inline lion_vd_t lion_vd_exp(lion_vd_t x) { return exp(x); }
+
+#endif
+
+static inline lion_vd_t lion_vd_exp_1e12(lion_vd_t x) {
+  lion_vd_t k;
+  lion_vd_t r = lion_vd_exp_reduce(x, &k);
+  lion_vd_t e = lion_vd_fmadd(lion_vd_set1(2.76337519456738385e-6), r, lion_vd_set1(2.48844666434176234e-5));
+  e           = lion_vd_fmadd(e, r, lion_vd_set1(1.98411876176720270e-4));
+  e           = lion_vd_fmadd(e, r, lion_vd_set1(1.38888017327317651e-3));
+  e           = lion_vd_fmadd(e, r, lion_vd_set1(8.33333337017231821e-3));
+  e           = lion_vd_fmadd(e, r, lion_vd_set1(4.16666670407075460e-2));
+  e           = lion_vd_fmadd(e, r, lion_vd_set1(1.66666666666048791e-1));
+  e           = lion_vd_fmadd(e, r, lion_vd_set1(4.99999999994379218e-1));
+  e           = lion_vd_fmadd(e, r, lion_vd_set1(1.00000000000000244e0));
+  e           = lion_vd_fmadd(e, r, lion_vd_set1(1.00000000000001354e0));
+  return lion_vd_ldexp(e, k);
+}
+
+static inline lion_vd_t lion_vd_exp_1e7(lion_vd_t x) {
+  lion_vd_t k;
+  lion_vd_t r = lion_vd_exp_reduce(x, &k);
+  lion_vd_t e = lion_vd_fmadd(lion_vd_set1(1.39411084388049874e-3), r, lion_vd_set1(8.37512639813225296e-3));
+  e           = lion_vd_fmadd(e, r, lion_vd_set1(4.16663528966968733e-2));
+  e           = lion_vd_fmadd(e, r, lion_vd_set1(1.66664155146536180e-1));
+  e           = lion_vd_fmadd(e, r, lion_vd_set1(5.00000004711778412e-1));
+  e           = lion_vd_fmadd(e, r, lion_vd_set1(1.00000003771621349e0));
+  e           = lion_vd_fmadd(e, r, lion_vd_set1(1.0));
+  return lion_vd_ldexp(e, k);
+}
+
+#if LION_SIMD_WIDTH_F > 1
+
+static inline lion_vf_t lion_vf_exp(lion_vf_t x) {
+  lion_vf_t k;
+  x           = lion_vf_min(lion_vf_max(x, lion_vf_set1(LION_SIMD_EXPF_MIN)), lion_vf_set1(LION_SIMD_EXPF_MAX));
+  k           = lion_vf_round(lion_vf_mul(x, lion_vf_set1((float)M_LOG2E)));
+  lion_vf_t r = lion_vf_fmadd(k, lion_vf_set1(-6.93359375e-1f), x);
+  r           = lion_vf_fmadd(k, lion_vf_set1(2.12194440e-4f), r);
+
+  // exp(r) = 1 + r + r^2 P(r)
+  lion_vf_t e = lion_vf_fmadd(lion_vf_set1(1.9875691500e-4f), r, lion_vf_set1(1.3981999507e-3f));
+  e           = lion_vf_fmadd(e, r, lion_vf_set1(8.3334519073e-3f));
+  e           = lion_vf_fmadd(e, r, lion_vf_set1(4.1665795894e-2f));
+  e           = lion_vf_fmadd(e, r, lion_vf_set1(1.6666665459e-1f));
+  e           = lion_vf_fmadd(e, r, lion_vf_set1(5.0000001201e-1f));
+  e           = lion_vf_fmadd(lion_vf_mul(e, r), r, lion_vf_add(r, lion_vf_set1(1.0f)));
+  return lion_vf_ldexp(e, k);
+}
+
+#else
+
+static inline lion_vf_t lion_vf_exp(lion_vf_t x) { return expf(x); }
+
+#endif
@@ -0,0 +1,227 @@
+#include "table.h"
+
+#include "array.h"
+#include "capacity.h"
+#include "ehc.h"
+#include "internal_resistance.h"
+#include "kernels/kernels.h"
+#include "open_circuit.h"
+
+#include <gsl/gsl_math.h>
+#include <lion/lion.h>
+#include <math.h>
+
+size_t lion_table_size(size_t points, size_t rint_points) {
+  return sizeof(lion_table_t) + (6 * points + rint_points * rint_points) * sizeof(double);
+}
+
+void lion_table_attach(lion_table_t *table) {
+  // The tables are laid out right after the struct, in the order of its fields
+  double *data      = (double *)(table + 1);
+  table->voc        = data;
+  table->voc_grad   = table->voc + table->points;
+  table->ehc        = table->voc_grad + table->points;
+  table->ehc_grad   = table->ehc + table->points;
+  table->kappa      = table->ehc_grad + table->points;
+  table->kappa_grad = table->kappa + table->points;
+  table->rint       = (table->rint_points > 0) ? table->kappa_grad + table->points : NULL;
+}
+
+static int _table_locate(double x, double min, double max, double scale, size_t n, size_t *i, double *t) {
+  // Written so that NaN fails the range check as well
+  if (!(x >= min && x <= max)) {
+    return 0;
+  }
+  double u = (x - min) * scale;
+  *i       = (size_t)u;
+  if (*i >= n - 1) {
+    *i = n - 2;
+  }
+  *t = u - (double)*i;
+  return 1;
+}
+
+static double _table_hermite(const double *values, const double *grads, size_t i, double t, double scale, double *grad) {
+  // Cubic Hermite spline on the interval, taking the gradients per unit of t
+  double y0 = values[i];
+  double y1 = values[i + 1];
+  double m0 = grads[i] / scale;
+  double m1 = grads[i + 1] / scale;
+  double t2 = t * t;
+  double t3 = t2 * t;
+
+  if (grad != NULL) {
+    double dydt = (6.0 * t2 - 6.0 * t) * (y0 - y1) + (3.0 * t2 - 4.0 * t + 1.0) * m0 + (3.0 * t2 - 2.0 * t) * m1;
+    *grad       = dydt * scale;
+  }
+  return (2.0 * t3 - 3.0 * t2 + 1.0) * y0 + (t3 - 2.0 * t2 + t) * m0 + (3.0 * t2 - 2.0 * t3) * y1 + (t3 - t2) * m1;
+}
+
+static void _table_current_range(lion_params_t *params, double *min, double *max) {
+  // Past a few widths of every fuzzy set the memberships, and therefore the
+  // resistance, are flat, so the table only spans the region where they move
+  lion_params_rint_polarization_t *p = &params->rint.params.polarization;
+
+  lion_mf_sigmoid_params_t  *sigmoids[]  = {&p->c40, &p->d30};
+  lion_mf_gaussian_params_t *gaussians[] = {&p->c20, &p->c10, &p->c4, &p->d5, &p->d10, &p->d15};
+
+  *min = INFINITY;
+  *max = -INFINITY;
+  for (size_t i = 0; i < sizeof(sigmoids) / sizeof(sigmoids[0]); i++) {
+    double width = LION_TABLE_RINT_WIDTHS / fabs(sigmoids[i]->a);
+    *min         = fmin(*min, sigmoids[i]->c - width);
+    *max         = fmax(*max, sigmoids[i]->c + width);
+  }
+  for (size_t i = 0; i < sizeof(gaussians) / sizeof(gaussians[0]); i++) {
+    double width = LION_TABLE_RINT_WIDTHS * gaussians[i]->sigma;
+    *min         = fmin(*min, gaussians[i]->mean - width);
+    *max         = fmax(*max, gaussians[i]->mean + width);
+  }
+}
+
+static double _table_rint_at(const lion_table_t *table, size_t row, double frac, size_t column, double t) {
+  const double *r0 = table->rint + row * table->rint_points;
+  const double *r1 = r0 + table->rint_points;
+  double        lo = (1.0 - frac) * r0[column] + frac * r1[column];
+  double        hi = (1.0 - frac) * r0[column + 1] + frac * r1[column + 1];
+  return (1.0 - t) * lo + t * hi;
+}
+
+void lion_table_build(lion_table_t *table, size_t points, size_t rint_points, lion_params_t *params) {
+  table->points      = points;
+  table->rint_points = rint_points;
+  lion_table_attach(table);
+
+  // Kappa diverges at the Vogel temperature, so the table stays clear of it
+  table->soc_min    = LION_TABLE_SOC_MIN;
+  table->soc_max    = LION_TABLE_SOC_MAX;
+  table->soc_scale  = (double)(points - 1) / (table->soc_max - table->soc_min);
+  table->temp_min   = fmax(LION_TABLE_TEMP_MIN, params->vft.k2 + 10.0);
+  table->temp_max   = fmax(LION_TABLE_TEMP_MAX, table->temp_min + 1.0);
+  table->temp_scale = (double)(points - 1) / (table->temp_max - table->temp_min);
+
+  // The grids are laid out where the gradients go, so that the values are
+  // sampled with the array kernels before the gradients overwrite them
+  double *socs         = table->ehc_grad;
+  double *temperatures = table->kappa_grad;
+  for (size_t i = 0; i < points; i++) {
+    socs[i]         = table->soc_min + (double)i / table->soc_scale;
+    temperatures[i] = table->temp_min + (double)i / table->temp_scale;
+  }
+  lion_voc_n(socs, points, params, table->voc);
+  lion_voc_grad_n(socs, points, params, table->voc_grad);
+  lion_ehc_n(socs, points, params, table->ehc);
+  lion_kappa_n(temperatures, points, params, table->kappa);
+  for (size_t i = 0; i < points; i++) {
+    table->ehc_grad[i]   = lion_ehc_grad(socs[i], params);
+    table->kappa_grad[i] = -params->vft.k1 / gsl_pow_2(temperatures[i] - params->vft.k2) * table->kappa[i];
+  }
+
+  // The splines are furthest from the models halfway between the points
+  table->voc_error   = 0.0;
+  table->ehc_error   = 0.0;
+  table->kappa_error = 0.0;
+  for (size_t i = 0; i + 1 < points; i++) {
+    double soc         = table->soc_min + ((double)i + 0.5) / table->soc_scale;
+    double temperature = table->temp_min + ((double)i + 0.5) / table->temp_scale;
+    double voc         = _table_hermite(table->voc, table->voc_grad, i, 0.5, table->soc_scale, NULL);
+    double ehc         = _table_hermite(table->ehc, table->ehc_grad, i, 0.5, table->soc_scale, NULL);
+    double kappa       = _table_hermite(table->kappa, table->kappa_grad, i, 0.5, table->temp_scale, NULL);
+    table->voc_error   = fmax(table->voc_error, fabs(voc - lion_voc(soc, params)));
+    table->ehc_error   = fmax(table->ehc_error, fabs(ehc - lion_ehc(soc, params)));
+    table->kappa_error = fmax(table->kappa_error, fabs(kappa - lion_kappa(temperature, params)));
+  }
+
+  table->rsoc_scale    = 0.0;
+  table->current_min   = 0.0;
+  table->current_max   = 0.0;
+  table->current_scale = 0.0;
+  table->rint_error    = 0.0;
+  if (table->rint == NULL) {
+    return;
+  }
+
+  _table_current_range(params, &table->current_min, &table->current_max);
+  table->rsoc_scale    = (double)(rint_points - 1) / (table->soc_max - table->soc_min);
+  table->current_scale = (double)(rint_points - 1) / (table->current_max - table->current_min);
+
+  // The currents of the grid are laid out in the last row, which is sampled
+  // last, so that every row goes through the packed kernel at once
+  lion_rint_packed_t packed;
+  double             polys[LION_FUZZY_SETS_COUNT];
+  double            *currents = table->rint + (rint_points - 1) * rint_points;
+  lion_resistance_pack(params, &packed);
+  for (size_t j = 0; j < rint_points; j++) {
+    currents[j] = table->current_min + (double)j / table->current_scale;
+  }
+  for (size_t i = 0; i < rint_points; i++) {
+    double soc = table->soc_min + (double)i / table->rsoc_scale;
+    lion_resistance_packed_polys(&packed, soc, polys);
+    lion_resistance_packed_n(&packed, polys, currents, rint_points, table->rint + i * rint_points, NULL);
+  }
+
+  // Bilinear interpolation is furthest from the model at the cell centers
+  for (size_t i = 0; i + 1 < rint_points; i++) {
+    double soc = table->soc_min + ((double)i + 0.5) / table->rsoc_scale;
+    lion_resistance_polarization_polys(soc, params, polys);
+    for (size_t j = 0; j + 1 < rint_points; j++) {
+      double current    = table->current_min + ((double)j + 0.5) / table->current_scale;
+      double rint       = _table_rint_at(table, i, 0.5, j, 0.5);
+      double exact      = lion_resistance_polarization_from_polys(polys, current, params, NULL);
+      table->rint_error = fmax(table->rint_error, fabs(rint - exact));
+    }
+  }
+}
+
+double lion_table_voc(const lion_table_t *table, double soc, lion_params_t *params, double *grad) {
+  size_t i;
+  double t;
+  if (!_table_locate(soc, table->soc_min, table->soc_max, table->soc_scale, table->points, &i, &t)) {
+    return lion_voc_with_grad(soc, params, grad);
+  }
+  return _table_hermite(table->voc, table->voc_grad, i, t, table->soc_scale, grad);
+}
+
+double lion_table_ehc(const lion_table_t *table, double soc, lion_params_t *params) {
+  size_t i;
+  double t;
+  if (!_table_locate(soc, table->soc_min, table->soc_max, table->soc_scale, table->points, &i, &t)) {
+    return lion_ehc(soc, params);
+  }
+  return _table_hermite(table->ehc, table->ehc_grad, i, t, table->soc_scale, NULL);
+}
+
+double lion_table_kappa(const lion_table_t *table, double internal_temperature, lion_params_t *params, double *grad) {
+  size_t i;
+  double t;
+  if (!_table_locate(internal_temperature, table->temp_min, table->temp_max, table->temp_scale, table->points, &i, &t)) {
+    if (grad != NULL) {
+      *grad = lion_kappa_grad(internal_temperature, params);
+    }
+    return lion_kappa(internal_temperature, params);
+  }
+  return _table_hermite(table->kappa, table->kappa_grad, i, t, table->temp_scale, grad);
+}
+
+int lion_table_rint_row(const lion_table_t *table, double soc, size_t *row, double *frac) {
+  if (table->rint == NULL) {
+    return 0;
+  }
+  return _table_locate(soc, table->soc_min, table->soc_max, table->rsoc_scale, table->rint_points, row, frac);
+}
+
+double lion_table_resistance(const lion_eval_t *eval, double current, lion_params_t *params, double *grad) {
+  const lion_table_t *table = eval->rint_table;
+
+  size_t j;
+  double t;
+  if (!_table_locate(current, table->current_min, table->current_max, table->current_scale, table->rint_points, &j, &t)) {
+    return lion_kernels_fast(eval->fast_math)->resistance_packed(eval->rint_packed, eval->rint_poly, current, grad);
+  }
+  if (grad != NULL) {
+    double left  = _table_rint_at(table, eval->table_row, eval->table_frac, j, 0.0);
+    double right = _table_rint_at(table, eval->table_row, eval->table_frac, j, 1.0);
+    *grad        = (right - left) * table->current_scale;
+  }
+  return _table_rint_at(table, eval->table_row, eval->table_frac, j, t);
+}
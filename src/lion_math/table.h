@@ -0,0 +1,37 @@
+#pragma once
+
+#include <lion/eval.h>
+#include <lion/params.h>
+#include <lion/table.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Range of the usable SoC covered by the tables. The gradient of the open
+// circuit voltage diverges at an empty cell, so the lowest SoCs stay in
+// closed form
+#define LION_TABLE_SOC_MIN 0.01
+#define LION_TABLE_SOC_MAX 1.0
+
+// Range of the internal temperature covered by the tables
+#define LION_TABLE_TEMP_MIN 233.15
+#define LION_TABLE_TEMP_MAX 353.15
+
+// Widths of each fuzzy set covered by the resistance table around its center
+#define LION_TABLE_RINT_WIDTHS 6.0
+
+size_t lion_table_size(size_t points, size_t rint_points);
+void   lion_table_attach(lion_table_t *table);
+void   lion_table_build(lion_table_t *table, size_t points, size_t rint_points, lion_params_t *params);
+
+double lion_table_voc(const lion_table_t *table, double soc, lion_params_t *params, double *grad);
+double lion_table_ehc(const lion_table_t *table, double soc, lion_params_t *params);
+double lion_table_kappa(const lion_table_t *table, double internal_temperature, lion_params_t *params, double *grad);
+int    lion_table_rint_row(const lion_table_t *table, double soc, size_t *row, double *frac);
+double lion_table_resistance(const lion_eval_t *eval, double current, lion_params_t *params, double *grad);
+
+#ifdef __cplusplus
+}
+#endif
@@ -10,3 +10,7 @@ double lion_voltage(double power, double open_circuit_voltage, double internal_r
 }
 
 double lion_voltage_from_current(double power, double current, lion_params_t *params) { return power / current; }
+
+double lion_voltage_from_rint(double current, double open_circuit_voltage, double internal_resistance, lion_params_t *params) {
+  return open_circuit_voltage - internal_resistance * current;
+}
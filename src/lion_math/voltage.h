@@ -8,6 +8,7 @@ extern "C" {
 
 double lion_voltage(double power, double open_circuit_voltage, double internal_resistance, lion_params_t *params);
 double lion_voltage_from_current(double power, double current, lion_params_t *params);
+double lion_voltage_from_rint(double current, double open_circuit_voltage, double internal_resistance, lion_params_t *params);
 
 #ifdef __cplusplus
 }
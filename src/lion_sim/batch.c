@@ -0,0 +1,14 @@
+// Double precision batch, see batch_impl.h
+
+#include <float.h>
+
+#define LION_BATCH_REAL              double
+#define LION_BATCH_T                 lion_batch_t
+#define LION_BATCH_FN(name)          lion_batch_##name
+#define LION_BATCH_KERNELS_T         lion_kernels_t
+#define LION_BATCH_KERNELS(batch)    lion_kernels_fast((batch)->conf->sim_fast_math)
+#define LION_BATCH_PACKED_T          lion_rint_packed_t
+#define LION_BATCH_PACK(params, out) lion_resistance_pack(params, out)
+#define LION_BATCH_EPSILON           DBL_EPSILON
+
+#include "batch_impl.h"
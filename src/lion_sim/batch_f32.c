@@ -0,0 +1,15 @@
+// Single precision batch, see batch_impl.h
+
+#include <float.h>
+
+#define LION_BATCH_F32
+#define LION_BATCH_REAL              float
+#define LION_BATCH_T                 lion_batch_f32_t
+#define LION_BATCH_FN(name)          lion_batch_f32_##name
+#define LION_BATCH_KERNELS_T         lion_kernels_f32_t
+#define LION_BATCH_KERNELS(batch)    lion_kernels_f32()
+#define LION_BATCH_PACKED_T          lion_rint_packed_f32_t
+#define LION_BATCH_PACK(params, out) lion_resistance_pack_f32(params, out)
+#define LION_BATCH_EPSILON           FLT_EPSILON
+
+#include "batch_impl.h"
@@ -0,0 +1,509 @@
+// Included once per precision, by batch.c in double and by batch_f32.c in
+// single precision, each defining first:
+//  - LION_BATCH_REAL, the type of the state arrays
+//  - LION_BATCH_T, the batch type, and LION_BATCH_FN(name), its functions
+//  - LION_BATCH_KERNELS_T and LION_BATCH_KERNELS(batch), the array kernels
+//  - LION_BATCH_PACKED_T and LION_BATCH_PACK, the packed fuzzy sets
+//  - LION_BATCH_EPSILON, the machine epsilon of LION_BATCH_REAL
+// The state is stored in LION_BATCH_REAL and goes through the array kernels
+// of the same precision, while the scalar terms of the model take it in
+// double and round their result once when it is stored
+
+#include "mem.h"
+#include "sim_run.h"
+#include "solver/kernels.h"
+
+#include <gsl/gsl_errno.h>
+#include <gsl/gsl_math.h>
+#include <inttypes.h>
+#include <lion/batch.h>
+#include <lion/lion.h>
+#include <lion_math/kernels/kernels.h>
+#include <lion_math/lion_math.h>
+#include <lion_utils/macros.h>
+#include <lion_utils/vendor/log.h>
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+typedef LION_BATCH_REAL lion_batch_real_t;
+
+#define LION_BATCH_PARAMS(batch, i) (&(batch)->params[((batch)->params_count == 1) ? 0 : (i)])
+#define LION_BATCH_PACKED(batch, i) (&(batch)->_rint_packed[((batch)->params_count == 1) ? 0 : (i)])
+
+// Number of real arrays of the batch, not counting the resistance polynomials
+#define LION_BATCH_REAL_ARRAYS 23
+
+// Tolerances of the current solver below a few ulps of the current are never
+// met, so they are widened to it
+#define LION_BATCH_EPSREL_MIN (16.0 * LION_BATCH_EPSILON)
+
+static const gsl_min_fminimizer_type *_batch_minimizer_type(lion_minimizer_t minimizer) {
+  switch (minimizer) {
+  case LION_MINIMIZER_GOLDENSECTION:
+    return gsl_min_fminimizer_goldensection;
+  case LION_MINIMIZER_BRENT:
+    return gsl_min_fminimizer_brent;
+  case LION_MINIMIZER_QUADGOLDEN:
+    return gsl_min_fminimizer_quad_golden;
+  default:
+    return NULL;
+  }
+}
+
+static lion_status_t _batch_check_config(const lion_sim_config_t *conf) {
+  // The batch always evaluates the analytic model and takes a single fixed
+  // step of a stepper it implements natively per call, so it rejects the rest
+  // of the configurations instead of silently diverging from a sim
+  if (conf->sim_input_mode != LION_INPUT_MODE_POWER) {
+    logi_error("Batches only support the power input mode");
+    return LION_STATUS_FAILURE;
+  }
+  if (conf->sim_step_mode != LION_STEP_MODE_FIXED) {
+    logi_error("Batches only support the fixed step mode, found %s", lion_step_mode_name(conf->sim_step_mode));
+    return LION_STATUS_FAILURE;
+  }
+  if (conf->sim_model_backend != LION_MODEL_BACKEND_ANALYTIC) {
+    logi_error("Batches only support the analytic model backend, found %s", lion_model_backend_name(conf->sim_model_backend));
+    return LION_STATUS_FAILURE;
+  }
+  switch (conf->sim_stepper) {
+  case LION_STEPPER_RK4:
+  case LION_STEPPER_EXACT:
+  case LION_STEPPER_NATIVE_RK2:
+  case LION_STEPPER_NATIVE_HEUN:
+  case LION_STEPPER_NATIVE_RK4:
+    return LION_STATUS_SUCCESS;
+  default:
+    logi_error("Batches do not support the %s stepper", lion_stepper_name(conf->sim_stepper));
+    return LION_STATUS_FAILURE;
+  }
+}
+
+lion_status_t LION_BATCH_FN(new)(lion_sim_config_t *conf, lion_params_t *params, size_t params_count, size_t count, LION_BATCH_T *out) {
+  if (count == 0) {
+    logi_error("Batch must contain at least one cell");
+    return LION_STATUS_FAILURE;
+  }
+  if (params_count != 1 && params_count != count) {
+    logi_error("Batch expects either 1 or %zu parameter sets, found %zu", count, params_count);
+    return LION_STATUS_FAILURE;
+  }
+  LION_CALL_I(_batch_check_config(conf), "Unsupported batch configuration");
+
+  lion_gsl_setup();
+  const gsl_min_fminimizer_type *min_type = _batch_minimizer_type(conf->sim_minimizer);
+  if (min_type == NULL) {
+    logi_error("Desired minimizer not implemented");
+    return LION_STATUS_FAILURE;
+  }
+
+  // Every array lives in a single block: the reals and the packed fuzzy sets
+  // first, then the 64 bit counters and finally the byte mask, so that every
+  // array stays aligned
+  size_t per_word = sizeof(uint64_t) / sizeof(lion_batch_real_t);
+  size_t packed   = sizeof(LION_BATCH_PACKED_T) / sizeof(lion_batch_real_t);
+  size_t reals    = count * (LION_BATCH_REAL_ARRAYS + LION_FUZZY_SETS_COUNT) + params_count * packed;
+  reals           = (reals + per_word - 1) / per_word * per_word;
+  size_t size     = reals * sizeof(lion_batch_real_t) + 2 * count * sizeof(uint64_t) + count * sizeof(uint8_t);
+  void  *block    = lion_calloc(NULL, 1, size);
+  if (block == NULL) {
+    logi_error("Failed allocating batch of %zu cells (%zu B)", count, size);
+    return LION_STATUS_FAILURE;
+  }
+
+  LION_BATCH_T batch = {
+    .conf         = conf,
+    .params       = params,
+    .params_count = params_count,
+    .count        = count,
+    .time         = 0.0,
+    .step         = 0,
+    ._block       = block,
+  };
+
+  lion_batch_real_t *d             = block;
+  batch.power                      = d + 0 * count;
+  batch.ambient_temperature        = d + 1 * count;
+  batch.voltage                    = d + 2 * count;
+  batch.current                    = d + 3 * count;
+  batch.open_circuit_voltage       = d + 4 * count;
+  batch.internal_resistance        = d + 5 * count;
+  batch.soh                        = d + 6 * count;
+  batch._soc_mean                  = d + 7 * count;
+  batch._soc_max                   = d + 8 * count;
+  batch._soc_min                   = d + 9 * count;
+  batch._acc_discharge             = d + 10 * count;
+  batch.ehc                        = d + 11 * count;
+  batch.generated_heat             = d + 12 * count;
+  batch.internal_temperature       = d + 13 * count;
+  batch.surface_temperature        = d + 14 * count;
+  batch.kappa                      = d + 15 * count;
+  batch.soc_nominal                = d + 16 * count;
+  batch.capacity_nominal           = d + 17 * count;
+  batch.soc_use                    = d + 18 * count;
+  batch.capacity_use               = d + 19 * count;
+  batch._next_soc_nominal          = d + 20 * count;
+  batch._next_internal_temperature = d + 21 * count;
+  batch._current_guess             = d + 22 * count;
+  batch._rint_poly                 = d + LION_BATCH_REAL_ARRAYS * count;
+  batch._rint_packed               = (LION_BATCH_PACKED_T *)(d + (LION_BATCH_REAL_ARRAYS + LION_FUZZY_SETS_COUNT) * count);
+
+  uint64_t *u       = (uint64_t *)(d + reals);
+  batch.cycle       = u;
+  batch._cycle_step = u + count;
+  batch._active     = (uint8_t *)(u + 2 * count);
+
+  batch._sys_min = gsl_min_fminimizer_alloc(min_type);
+  if (batch._sys_min == NULL) {
+    logi_error("Failed allocating batch minimizer");
+    lion_free(NULL, block);
+    return LION_STATUS_FAILURE;
+  }
+
+  log_logger_init(&batch.logger, conf->log_stdlvl);
+  *out = batch;
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t LION_BATCH_FN(init)(LION_BATCH_T *batch) {
+  for (size_t i = 0; i < batch->params_count; i++) {
+    if (batch->params[i].rint.model == LION_RINT_MODEL_POLARIZATION) {
+      LION_BATCH_PACK(&batch->params[i], &batch->_rint_packed[i]);
+    }
+  }
+  for (size_t i = 0; i < batch->count; i++) {
+    lion_params_t *params = LION_BATCH_PARAMS(batch, i);
+
+    batch->_next_soc_nominal[i]          = (lion_batch_real_t)params->init.soc;
+    batch->_next_internal_temperature[i] = (lion_batch_real_t)params->init.temp_in;
+    batch->soh[i]                        = (lion_batch_real_t)params->init.soh;
+    batch->current[i]                    = (lion_batch_real_t)params->init.current_guess;
+    batch->_acc_discharge[i]             = 0.0;
+    batch->_soc_mean[i]                  = 0.0;
+    batch->_soc_max[i]                   = 0.0;
+    batch->_soc_min[i]                   = 1.0;
+    batch->_cycle_step[i]                = 0;
+    batch->cycle[i]                      = 0;
+  }
+  batch->time = 0.0;
+  batch->step = 0;
+  return LION_STATUS_SUCCESS;
+}
+
+static inline double _batch_resistance(LION_BATCH_T *batch, size_t i, double current, double *grad) {
+  lion_params_t *params = LION_BATCH_PARAMS(batch, i);
+  if (params->rint.model == LION_RINT_MODEL_POLARIZATION) {
+    const LION_BATCH_KERNELS_T *kernels = LION_BATCH_KERNELS(batch);
+    const lion_batch_real_t    *polys   = &batch->_rint_poly[i * LION_FUZZY_SETS_COUNT];
+
+    lion_batch_real_t dr_di;
+    lion_batch_real_t r = kernels->resistance_packed(LION_BATCH_PACKED(batch, i), polys, (lion_batch_real_t)current, &dr_di);
+    *grad               = dr_di;
+    return r;
+  }
+  *grad = 0.0;
+  return lion_resistance(batch->soc_use[i], current, params);
+}
+
+static void _batch_prepare(LION_BATCH_T *batch) {
+  // With a single parameter set the transcendental terms of every cell go
+  // through the array kernels, otherwise each cell goes through them alone
+  const LION_BATCH_KERNELS_T *kernels = LION_BATCH_KERNELS(batch);
+  size_t                      n       = batch->count;
+  bool                        shared  = (batch->params_count == 1);
+  for (size_t i = 0; i < n; i++) {
+    lion_params_t *params      = LION_BATCH_PARAMS(batch, i);
+    batch->capacity_nominal[i] = (lion_batch_real_t)(batch->soh[i] * params->init.capacity);
+  }
+  if (shared) {
+    kernels->kappa_n(batch->internal_temperature, n, batch->params, batch->kappa);
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      kernels->kappa_n(&batch->internal_temperature[i], 1, LION_BATCH_PARAMS(batch, i), &batch->kappa[i]);
+    }
+  }
+  for (size_t i = 0; i < n; i++) {
+    lion_params_t *params  = LION_BATCH_PARAMS(batch, i);
+    batch->soc_use[i]      = (lion_batch_real_t)lion_soc_usable(batch->soc_nominal[i], batch->kappa[i], params);
+    batch->capacity_use[i] = (lion_batch_real_t)lion_capacity_usable(batch->capacity_nominal[i], batch->kappa[i], params);
+  }
+  if (shared) {
+    kernels->ehc_n(batch->soc_use, n, batch->params, batch->ehc);
+    kernels->voc_n(batch->soc_use, n, batch->params, batch->open_circuit_voltage);
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      lion_params_t *params = LION_BATCH_PARAMS(batch, i);
+      kernels->ehc_n(&batch->soc_use[i], 1, params, &batch->ehc[i]);
+      kernels->voc_n(&batch->soc_use[i], 1, params, &batch->open_circuit_voltage[i]);
+    }
+  }
+  for (size_t i = 0; i < n; i++) {
+    lion_params_t *params           = LION_BATCH_PARAMS(batch, i);
+    batch->open_circuit_voltage[i] += (lion_batch_real_t)(batch->ehc[i] * (batch->internal_temperature[i] - params->vft.tref));
+  }
+  for (size_t i = 0; i < n; i++) {
+    lion_params_t *params = LION_BATCH_PARAMS(batch, i);
+    if (params->rint.model == LION_RINT_MODEL_POLARIZATION) {
+      kernels->resistance_packed_polys(LION_BATCH_PACKED(batch, i), batch->soc_use[i], &batch->_rint_poly[i * LION_FUZZY_SETS_COUNT]);
+    }
+  }
+}
+
+static inline int _batch_residual(LION_BATCH_T *batch, size_t i, double x, double *g, double *dg) {
+  // Residual g(I) = I - f(I, R(I)) of a cell and its derivative, same as the
+  // one of the scalar root finders, GSL_EDOM on a negative discriminant
+  double dr_di;
+  double p = batch->power[i];
+  double v = batch->open_circuit_voltage[i];
+  double r = _batch_resistance(batch, i, x, &dr_di);
+  double a = v / (2.0 * r);
+  double d = gsl_pow_2(a) - p / r;
+  if (!(d >= 0.0) || !(r > 0.0)) {
+    return GSL_EDOM;
+  }
+  *g = x - (a - sqrt(d));
+  if (dg != NULL) {
+    *dg = 1.0 - lion_current_grad_rint(p, v, r, LION_BATCH_PARAMS(batch, i)) * dr_di;
+  }
+  return GSL_SUCCESS;
+}
+
+static size_t _batch_solve_current(LION_BATCH_T *batch) {
+  // Lockstep Newton iteration on g(I) = I - f(I, R(I)) for every cell, masking
+  // out cells as they converge. Steps are halved back into the feasible region
+  // like in the scalar solver, and a cell converges once both the step and the
+  // residual are within tolerance. Cells which start outside the feasible
+  // region, stall on the bracket or do not converge are returned to the caller
+  // for the fallback. Both root finder settings use Newton here, since dR/dI is
+  // cheap once the polynomials are cached
+  size_t n        = batch->count;
+  int    max_iter = (batch->conf->sim_min_maxiter > 0) ? (int)batch->conf->sim_min_maxiter : LION_CURRENT_SOLVER_MAXITER;
+  double epsabs   = batch->conf->sim_epsabs;
+  double epsrel   = GSL_MAX_DBL(batch->conf->sim_epsrel, LION_BATCH_EPSREL_MIN);
+
+  memcpy(batch->_current_guess, batch->current, n * sizeof(lion_batch_real_t));
+  memset(batch->_active, 1, n * sizeof(uint8_t));
+  if (batch->conf->sim_current_solver == LION_CURRENT_SOLVER_MINIMIZER) {
+    return n;
+  }
+
+  size_t active = n;
+  for (int iter = 0; iter < max_iter && active > 0; iter++) {
+    active = 0;
+    for (size_t i = 0; i < n; i++) {
+      if (batch->_active[i] != 1) {
+        continue;
+      }
+
+      double x = batch->current[i];
+      double g, dg;
+      if (_batch_residual(batch, i, x, &g, &dg) != GSL_SUCCESS || dg == 0.0 || !isfinite(dg)) {
+        batch->_active[i] = 2;
+        continue;
+      }
+
+      // Iterates are rounded to the precision of the batch before being
+      // evaluated, so that the residual is the one of the stored current
+      double dx     = -g / dg;
+      double xn     = x;
+      double gn     = g;
+      int    status = GSL_EDOM;
+      for (int k = 0; k < LION_CURRENT_SOLVER_MAXBACKTRACK; k++) {
+        xn     = (lion_batch_real_t)GSL_MIN(GSL_MAX(x + dx, LION_CURRENT_OPTMIN), LION_CURRENT_OPTMAX);
+        status = _batch_residual(batch, i, xn, &gn, NULL);
+        if (status == GSL_SUCCESS) {
+          break;
+        }
+        dx *= 0.5;
+      }
+      if (status != GSL_SUCCESS) {
+        batch->_active[i] = 2;
+        continue;
+      }
+
+      batch->current[i] = (lion_batch_real_t)xn;
+      double tol        = epsabs + epsrel * fabs(xn);
+      if (fabs(xn - x) >= tol) {
+        active++;
+      } else {
+        batch->_active[i] = (fabs(gn) < tol) ? 0 : 2;
+      }
+    }
+  }
+
+  size_t failed = 0;
+  for (size_t i = 0; i < n; i++) {
+    failed += (batch->_active[i] != 0);
+  }
+  return failed;
+}
+
+static void _batch_solve_current_fallback(LION_BATCH_T *batch) {
+  // The minimizer goes through the model in double in both precisions
+  lion_eval_t eval = {.rint_table = NULL, .fast_math = batch->conf->sim_fast_math};
+#if defined(LION_BATCH_F32)
+  // The packed sets of the batch are in single precision
+  lion_rint_packed_t packed;
+#endif
+  for (size_t i = 0; i < batch->count; i++) {
+    if (batch->_active[i] == 0) {
+      continue;
+    }
+    lion_params_t *params     = LION_BATCH_PARAMS(batch, i);
+    eval.soc_use              = batch->soc_use[i];
+    eval.open_circuit_voltage = batch->open_circuit_voltage[i];
+    if (params->rint.model == LION_RINT_MODEL_POLARIZATION) {
+#if defined(LION_BATCH_F32)
+      lion_resistance_pack(params, &packed);
+      lion_resistance_packed_polys(&packed, eval.soc_use, eval.rint_poly);
+      eval.rint_packed = &packed;
+#else
+      memcpy(eval.rint_poly, &batch->_rint_poly[i * LION_FUZZY_SETS_COUNT], sizeof(eval.rint_poly));
+      eval.rint_packed = LION_BATCH_PACKED(batch, i);
+#endif
+    }
+    batch->current[i] = (lion_batch_real_t)lion_current_optimize(
+        batch->_sys_min,
+        &eval,
+        batch->power[i],
+        batch->_current_guess[i],
+        batch->conf->sim_epsabs,
+        batch->conf->sim_epsrel,
+        batch->conf->sim_min_maxiter,
+        params
+    );
+  }
+}
+
+static void _batch_finish(LION_BATCH_T *batch) {
+  size_t n = batch->count;
+  for (size_t i = 0; i < n; i++) {
+    double dr_di;
+    batch->internal_resistance[i] = (lion_batch_real_t)(_batch_resistance(batch, i, batch->current[i], &dr_di) / batch->soh[i]);
+  }
+  if (batch->params_count == 1) {
+    LION_BATCH_KERNELS(batch)->generated_heat_n(
+        batch->current, batch->internal_temperature, batch->internal_resistance, batch->ehc, n, batch->params, batch->generated_heat
+    );
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      lion_params_t *params    = LION_BATCH_PARAMS(batch, i);
+      double         heat      = lion_generated_heat(batch->current[i], batch->internal_temperature[i], batch->internal_resistance[i], batch->ehc[i], params);
+      batch->generated_heat[i] = (lion_batch_real_t)heat;
+    }
+  }
+  for (size_t i = 0; i < n; i++) {
+    lion_params_t *params         = LION_BATCH_PARAMS(batch, i);
+    batch->voltage[i]             = (lion_batch_real_t)lion_voltage_from_current(batch->power[i], batch->current[i], params);
+    batch->surface_temperature[i] = (lion_batch_real_t)lion_surface_temperature(batch->internal_temperature[i], batch->ambient_temperature[i], params);
+  }
+}
+
+static void _batch_integrate(LION_BATCH_T *batch) {
+  // Inputs are frozen during the step, so the SoC derivative is constant and
+  // the temperature follows a linear ODE, integrated with the native kernel of
+  // the stepper, which for LION_STEPPER_RK4 is the same classic RK4
+  size_t         n       = batch->count;
+  double         h       = batch->conf->sim_step_seconds;
+  lion_stepper_t stepper = batch->conf->sim_stepper;
+  double         decay   = (stepper == LION_STEPPER_EXACT && batch->params_count == 1) ? lion_internal_temperature_decay(h, batch->params) : 0.0;
+  for (size_t i = 0; i < n; i++) {
+    lion_params_t *params = LION_BATCH_PARAMS(batch, i);
+
+    double soc                  = batch->soc_nominal[i] + h * lion_soc_d(batch->current[i], batch->capacity_use[i], params);
+    batch->_next_soc_nominal[i] = (lion_batch_real_t)soc;
+
+    double t  = batch->internal_temperature[i];
+    double q  = batch->generated_heat[i];
+    double ta = batch->ambient_temperature[i];
+    double a, b, next;
+    lion_slv_temperature_coefs(q, ta, params, &a, &b);
+    switch (stepper) {
+    case LION_STEPPER_EXACT:
+      next = lion_internal_temperature_exact(t, q, ta, (batch->params_count == 1) ? decay : lion_internal_temperature_decay(h, params), params);
+      break;
+    case LION_STEPPER_NATIVE_RK2:
+      next = lion_slv_kernel_rk2(t, a, b, h);
+      break;
+    case LION_STEPPER_NATIVE_HEUN:
+      next = lion_slv_kernel_heun(t, a, b, h);
+      break;
+    default:
+      next = lion_slv_kernel_rk4(t, a, b, h);
+      break;
+    }
+    batch->_next_internal_temperature[i] = (lion_batch_real_t)next;
+  }
+}
+
+static void _batch_degradation(LION_BATCH_T *batch) {
+  size_t n = batch->count;
+  double h = batch->conf->sim_step_seconds;
+  for (size_t i = 0; i < n; i++) {
+    double soc                = batch->soc_nominal[i];
+    double k                  = (double)batch->_cycle_step[i];
+    batch->_soc_mean[i]       = (lion_batch_real_t)((k * batch->_soc_mean[i] + soc) / (k + 1.0));
+    batch->_soc_max[i]        = (lion_batch_real_t)GSL_MAX_DBL(batch->_soc_max[i], soc);
+    batch->_soc_min[i]        = (lion_batch_real_t)GSL_MIN_DBL(batch->_soc_min[i], soc);
+    batch->_acc_discharge[i] += (lion_batch_real_t)GSL_MAX_DBL(batch->current[i] * h, 0.0);
+  }
+  for (size_t i = 0; i < n; i++) {
+    if (batch->_acc_discharge[i] >= batch->capacity_nominal[i]) {
+      // A cycle has been completed so we update the SoH
+      lion_params_t *params    = LION_BATCH_PARAMS(batch, i);
+      batch->_acc_discharge[i] = (lion_batch_real_t)fmod(batch->_acc_discharge[i], batch->capacity_nominal[i]);
+      batch->soh[i]            = (lion_batch_real_t)lion_soh_next(batch->soh[i], batch->_soc_mean[i], batch->_soc_max[i], batch->_soc_min[i], params);
+
+      // Restart placeholder values
+      batch->_soc_mean[i]   = 0.0;
+      batch->_soc_max[i]    = 0.0;
+      batch->_soc_min[i]    = 1.0;
+      batch->_cycle_step[i] = 0;
+
+      batch->cycle[i]++;
+    } else {
+      batch->_cycle_step[i]++;
+    }
+  }
+}
+
+static lion_status_t _batch_step(LION_BATCH_T *batch, const lion_batch_real_t *power, const lion_batch_real_t *ambient_temperature) {
+  // Same update logic as lion_sim_step, applied stage by stage to every cell
+  LION_CALL_I(_batch_check_config(batch->conf), "Unsupported batch configuration");
+  size_t n = batch->count;
+  memcpy(batch->soc_nominal, batch->_next_soc_nominal, n * sizeof(lion_batch_real_t));
+  memcpy(batch->internal_temperature, batch->_next_internal_temperature, n * sizeof(lion_batch_real_t));
+  memcpy(batch->power, power, n * sizeof(lion_batch_real_t));
+  memcpy(batch->ambient_temperature, ambient_temperature, n * sizeof(lion_batch_real_t));
+
+  _batch_prepare(batch);
+  size_t failed = _batch_solve_current(batch);
+  if (failed > 0) {
+    logi_debug("Current of %zu cells fell back to minimizer at step %" PRIu64, failed, batch->step);
+    _batch_solve_current_fallback(batch);
+  }
+  _batch_finish(batch);
+  _batch_integrate(batch);
+  _batch_degradation(batch);
+
+  batch->time += batch->conf->sim_step_seconds;
+  batch->step++;
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t LION_BATCH_FN(step)(LION_BATCH_T *batch, const lion_batch_real_t *power, const lion_batch_real_t *ambient_temperature) {
+  LION_RETURN_WITH_LOGGER_I(&batch->logger, _batch_step(batch, power, ambient_temperature));
+}
+
+lion_status_t LION_BATCH_FN(cleanup)(LION_BATCH_T *batch) {
+  if (batch->_sys_min != NULL) {
+    gsl_min_fminimizer_free(batch->_sys_min);
+    batch->_sys_min = NULL;
+  }
+  if (batch->_block != NULL) {
+    lion_free(NULL, batch->_block);
+    batch->_block = NULL;
+  }
+  return LION_STATUS_SUCCESS;
+}
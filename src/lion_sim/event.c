@@ -0,0 +1,300 @@
+#include "mem.h"
+#include "sim_run.h"
+#include "solver/dae.h"
+#include "solver/update.h"
+
+#include <gsl/gsl_odeiv2.h>
+#include <lion/event.h>
+#include <lion_utils/macros.h>
+#include <lion_utils/vendor/log.h>
+#include <math.h>
+#include <stdbool.h>
+
+// Capacity used for the first event added to a sim
+#define LION_EVENTS_DEFAULT_CAPACITY 4
+
+// Maximum iterations of the root finding which locates an event in a step
+#ifndef LION_EVENT_MAXITER
+  #define LION_EVENT_MAXITER 64
+#endif
+
+// Position within the step of an event which does not trigger in it
+#define _EVENT_NONE 2.0
+
+static lion_status_t _sim_add_event(lion_sim_t *sim, const lion_event_t *event) {
+  switch (event->field) {
+  case LION_STATE_STEP:
+  case LION_STATE_POWER:
+  case LION_STATE_AMBIENT_TEMPERATURE:
+  case LION_STATE_CYCLE:
+  case LION_STATE_SOH:
+    // Inputs are held over the step, and the step index and the degradation
+    // state are only updated once it ends, so they never cross within a step
+    logi_error("Events cannot watch fields which do not change within a step (got %#x)", (unsigned)event->field);
+    return LION_STATUS_FAILURE;
+  case LION_STATE_TIME:
+  case LION_STATE_VOLTAGE:
+  case LION_STATE_CURRENT:
+  case LION_STATE_REF_OPEN_CIRCUIT_VOLTAGE:
+  case LION_STATE_OPEN_CIRCUIT_VOLTAGE:
+  case LION_STATE_INTERNAL_RESISTANCE:
+  case LION_STATE_EHC:
+  case LION_STATE_GENERATED_HEAT:
+  case LION_STATE_INTERNAL_TEMPERATURE:
+  case LION_STATE_SURFACE_TEMPERATURE:
+  case LION_STATE_KAPPA:
+  case LION_STATE_SOC_NOMINAL:
+  case LION_STATE_CAPACITY_NOMINAL:
+  case LION_STATE_SOC_USE:
+  case LION_STATE_CAPACITY_USE:
+    break;
+  default:
+    logi_error("Events must watch a single field of the state (got %#x)", (unsigned)event->field);
+    return LION_STATUS_FAILURE;
+  }
+
+  if (sim->events_len == sim->_events_capacity) {
+    size_t        capacity = (sim->_events_capacity == 0) ? LION_EVENTS_DEFAULT_CAPACITY : 2 * sim->_events_capacity;
+    lion_event_t *events   = lion_realloc(NULL, sim->events, capacity * sizeof(lion_event_t));
+    if (events == NULL) {
+      logi_error("Failed allocating %zu events", capacity);
+      return LION_STATUS_FAILURE;
+    }
+    sim->events           = events;
+    sim->_events_capacity = capacity;
+  }
+
+  lion_event_t *added = &sim->events[sim->events_len++];
+  *added              = *event;
+  added->triggered    = 0;
+  added->time         = NAN;
+  added->value        = NAN;
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t lion_sim_add_event(lion_sim_t *sim, const lion_event_t *event) { LION_RETURN_WITH_LOGGER_I(&sim->logger, _sim_add_event(sim, event)); }
+
+void lion_sim_clear_events(lion_sim_t *sim) {
+  lion_free(NULL, sim->events);
+  sim->events           = NULL;
+  sim->events_len       = 0;
+  sim->_events_capacity = 0;
+  sim->_should_close    = 0;
+  sim->_input_switched  = 0;
+}
+
+void lion_sim_reset_events(lion_sim_t *sim) {
+  for (size_t i = 0; i < sim->events_len; i++) {
+    sim->events[i].triggered = 0;
+    sim->events[i].time      = NAN;
+    sim->events[i].value     = NAN;
+  }
+  sim->_should_close   = 0;
+  sim->_input_switched = 0;
+}
+
+double lion_state_field_value(const lion_sim_state_t *state, lion_state_field_t field) {
+  switch (field) {
+  case LION_STATE_TIME:
+    return state->time;
+  case LION_STATE_STEP:
+    return (double)state->step;
+  case LION_STATE_POWER:
+    return state->power;
+  case LION_STATE_AMBIENT_TEMPERATURE:
+    return state->ambient_temperature;
+  case LION_STATE_VOLTAGE:
+    return state->voltage;
+  case LION_STATE_CURRENT:
+    return state->current;
+  case LION_STATE_REF_OPEN_CIRCUIT_VOLTAGE:
+    return state->ref_open_circuit_voltage;
+  case LION_STATE_OPEN_CIRCUIT_VOLTAGE:
+    return state->open_circuit_voltage;
+  case LION_STATE_INTERNAL_RESISTANCE:
+    return state->internal_resistance;
+  case LION_STATE_CYCLE:
+    return (double)state->cycle;
+  case LION_STATE_SOH:
+    return state->soh;
+  case LION_STATE_EHC:
+    return state->ehc;
+  case LION_STATE_GENERATED_HEAT:
+    return state->generated_heat;
+  case LION_STATE_INTERNAL_TEMPERATURE:
+    return state->internal_temperature;
+  case LION_STATE_SURFACE_TEMPERATURE:
+    return state->surface_temperature;
+  case LION_STATE_KAPPA:
+    return state->kappa;
+  case LION_STATE_SOC_NOMINAL:
+    return state->soc_nominal;
+  case LION_STATE_CAPACITY_NOMINAL:
+    return state->capacity_nominal;
+  case LION_STATE_SOC_USE:
+    return state->soc_use;
+  case LION_STATE_CAPACITY_USE:
+    return state->capacity_use;
+  default:
+    return NAN;
+  }
+}
+
+static bool _event_crossed(const lion_event_t *event, double g0, double g1) {
+  // g is the distance of the field to the threshold at both ends of the step
+  bool rising  = g0 < 0.0 && g1 >= 0.0;
+  bool falling = g0 > 0.0 && g1 <= 0.0;
+  switch (event->direction) {
+  case LION_EVENT_RISING:
+    return rising;
+  case LION_EVENT_FALLING:
+    return falling;
+  case LION_EVENT_EITHER:
+  default:
+    return rising || falling;
+  }
+}
+
+// Evaluates the whole state at a fraction theta of the step, with the states
+// interpolated linearly between both ends of the step and the inputs held
+typedef struct _event_step {
+  lion_sim_t *sim;
+  double      t0;
+  double      h;
+  double      y0[2];
+  double      y1[2];
+} _event_step_t;
+
+static lion_status_t _event_state_at(_event_step_t *step, double theta, lion_sim_state_t *out) {
+  lion_eval_t eval;
+  *out                      = step->sim->state;
+  out->time                 = step->t0 + theta * step->h;
+  out->soc_nominal          = step->y0[0] + theta * (step->y1[0] - step->y0[0]);
+  out->internal_temperature = step->y0[1] + theta * (step->y1[1] - step->y0[1]);
+  return lion_slv_update_state(step->sim, out, &eval);
+}
+
+static lion_status_t _event_locate(_event_step_t *step, const lion_event_t *event, double g0, double g1, double *theta) {
+  // Illinois variant of regula falsi, which keeps the crossing bracketed and
+  // avoids the one-sided convergence of plain regula falsi
+  double a    = 0.0;
+  double b    = 1.0;
+  double fa   = g0;
+  double fb   = g1;
+  double c    = 1.0;
+  int    side = 0;
+  double tol  = step->sim->conf->sim_epsabs + step->sim->conf->sim_epsrel * fabs(event->threshold);
+  for (int i = 0; i < LION_EVENT_MAXITER; i++) {
+    c = (fb != fa) ? (a * fb - b * fa) / (fb - fa) : 0.5 * (a + b);
+    lion_sim_state_t state;
+    LION_CALL_I(_event_state_at(step, c, &state), "Failed evaluating state within step");
+    double fc = lion_state_field_value(&state, event->field) - event->threshold;
+    if (fabs(fc) <= tol || (b - a) * step->h <= 1e-12) {
+      break;
+    }
+    if ((fc > 0.0) == (fb > 0.0)) {
+      b  = c;
+      fb = fc;
+      if (side == -1) {
+        fa *= 0.5;
+      }
+      side = -1;
+    } else {
+      a  = c;
+      fa = fc;
+      if (side == 1) {
+        fb *= 0.5;
+      }
+      side = 1;
+    }
+  }
+  *theta = c;
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t lion_sim_process_events(lion_sim_t *sim, double t0) {
+  _event_step_t step = {
+    .sim = sim,
+    .t0  = t0,
+    .h   = sim->state.time - t0,
+    .y0  = {sim->state.soc_nominal, sim->state.internal_temperature},
+    .y1  = {sim->state._next_soc_nominal, sim->state._next_internal_temperature},
+  };
+
+  // sim->state holds the start of the step, apart from its time
+  lion_sim_state_t start = sim->state;
+  start.time             = t0;
+  lion_sim_state_t end;
+  LION_CALL_I(_event_state_at(&step, 1.0, &end), "Failed evaluating state at end of step");
+
+  // Locate every crossing, then only keep the ones up to the first event
+  // which cuts the step, since whatever comes after it never happens
+  double cut = 1.0;
+  for (size_t i = 0; i < sim->events_len; i++) {
+    lion_event_t *event = &sim->events[i];
+    double        g0    = lion_state_field_value(&start, event->field) - event->threshold;
+    double        g1    = lion_state_field_value(&end, event->field) - event->threshold;
+    event->_theta       = _EVENT_NONE;
+    if (!_event_crossed(event, g0, g1)) {
+      continue;
+    }
+    LION_CALL_I(_event_locate(&step, event, g0, g1, &event->_theta), "Failed locating event");
+    if (event->action != LION_EVENT_NOTIFY && event->_theta < cut) {
+      cut = event->_theta;
+    }
+  }
+
+  lion_event_t *stop = NULL;
+  for (size_t i = 0; i < sim->events_len; i++) {
+    lion_event_t *event = &sim->events[i];
+    if (event->_theta > cut) {
+      continue;
+    }
+    lion_sim_state_t state;
+    LION_CALL_I(_event_state_at(&step, event->_theta, &state), "Failed evaluating state at event");
+    event->triggered++;
+    event->time  = state.time;
+    event->value = lion_state_field_value(&state, event->field);
+    logi_debug("Event '%s' triggered at t = %f (value = %f)", event->name ? event->name : "", event->time, event->value);
+
+    switch (event->action) {
+    case LION_EVENT_STOP:
+      stop = event;
+      break;
+    case LION_EVENT_SWITCH_INPUT:
+      sim->_input_switched = 1;
+      sim->_switched_power = event->power;
+      break;
+    case LION_EVENT_NOTIFY:
+    default:
+      break;
+    }
+    if (event->hook != NULL) {
+      LION_CALLDF_I(event->hook(sim, event), "Failed calling event hook");
+    } else if (event->action == LION_EVENT_NOTIFY) {
+      logi_info("Event '%s' triggered at t = %f (value = %f)", event->name ? event->name : "", event->time, event->value);
+    }
+  }
+
+  if (cut < 1.0) {
+    // The step ends at the event, so the next one starts from there
+    lion_sim_state_t state;
+    LION_CALL_I(_event_state_at(&step, cut, &state), "Failed evaluating state at event");
+    if (stop != NULL) {
+      // The simulation finishes at the event, so its state is left there
+      sim->state = state;
+    }
+    sim->state._next_soc_nominal          = state.soc_nominal;
+    sim->state._next_internal_temperature = state.internal_temperature;
+    sim->state.time                       = state.time;
+    if (sim->driver != NULL) {
+      gsl_odeiv2_step_reset(sim->driver->s);
+    }
+    lion_dae_reset(sim);
+  }
+  if (stop != NULL) {
+    logi_info("Stopping at event '%s' (t = %f)", stop->name ? stop->name : "", stop->time);
+    sim->_should_close = 1;
+  }
+  return LION_STATUS_SUCCESS;
+}
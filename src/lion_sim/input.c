@@ -0,0 +1,170 @@
+#include "sim_run.h"
+
+#include <inttypes.h>
+#include <lion/input.h>
+#include <lion/lion.h>
+#include <lion_utils/macros.h>
+#include <lion_utils/vendor/log.h>
+#include <math.h>
+
+lion_status_t lion_input_fixed_rate(const double *values, size_t len, double start_time, double period, lion_interp_t interp, lion_input_t *out) {
+  if (values == NULL || len == 0) {
+    logi_error("Input has no samples");
+    return LION_STATUS_FAILURE;
+  }
+  if (!(period > 0.0) || !isfinite(period) || !isfinite(start_time)) {
+    logi_error("Invalid input sampling (start_time = %f, period = %f)", start_time, period);
+    return LION_STATUS_FAILURE;
+  }
+  lion_input_t input = {
+    .values     = values,
+    .timestamps = NULL,
+    .len        = len,
+    .start_time = start_time,
+    .period     = period,
+    .interp     = interp,
+    ._cursor    = 0,
+  };
+  *out = input;
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t lion_input_timestamped(const double *timestamps, const double *values, size_t len, lion_interp_t interp, lion_input_t *out) {
+  if (timestamps == NULL || values == NULL || len == 0) {
+    logi_error("Input has no samples");
+    return LION_STATUS_FAILURE;
+  }
+  for (size_t i = 1; i < len; i++) {
+    if (!(timestamps[i] > timestamps[i - 1])) {
+      logi_error("Input timestamps must be strictly increasing (sample %zu)", i);
+      return LION_STATUS_FAILURE;
+    }
+  }
+  lion_input_t input = {
+    .values     = values,
+    .timestamps = timestamps,
+    .len        = len,
+    .start_time = timestamps[0],
+    .period     = 0.0,
+    .interp     = interp,
+    ._cursor    = 0,
+  };
+  *out = input;
+  return LION_STATUS_SUCCESS;
+}
+
+double lion_input_start_time(const lion_input_t *input) { return input->start_time; }
+
+double lion_input_end_time(const lion_input_t *input) {
+  if (input->timestamps != NULL) {
+    return input->timestamps[input->len - 1];
+  }
+  return input->start_time + (double)(input->len - 1) * input->period;
+}
+
+double lion_input_at(lion_input_t *input, double time) {
+  size_t i;
+  double frac;
+  if (input->timestamps == NULL) {
+    double x = (time - input->start_time) / input->period;
+    // Times landing on a sample up to rounding, which is the common case when
+    // the step divides the period, must not fall back to the previous sample
+    double nearest = nearbyint(x);
+    if (fabs(x - nearest) < 1e-9 * fmax(1.0, nearest)) {
+      x = nearest;
+    }
+    if (x <= 0.0) {
+      return input->values[0];
+    }
+    if (x >= (double)(input->len - 1)) {
+      return input->values[input->len - 1];
+    }
+    i    = (size_t)x;
+    frac = x - (double)i;
+  } else {
+    const double *ts = input->timestamps;
+    if (time <= ts[0]) {
+      return input->values[0];
+    }
+    if (time >= ts[input->len - 1]) {
+      return input->values[input->len - 1];
+    }
+    // Queries are monotonic during a run, so the cursor only moves forward by
+    // a sample or so each time. Going backwards is still handled for arbitrary
+    // queries
+    i = input->_cursor;
+    while (i + 1 < input->len && ts[i + 1] <= time) {
+      i++;
+    }
+    while (i > 0 && ts[i] > time) {
+      i--;
+    }
+    input->_cursor = i;
+    frac           = (time - ts[i]) / (ts[i + 1] - ts[i]);
+  }
+
+  switch (input->interp) {
+  case LION_INTERP_LINEAR:
+    return input->values[i] + frac * (input->values[i + 1] - input->values[i]);
+  case LION_INTERP_ZOH:
+  default:
+    return input->values[i];
+  }
+}
+
+static lion_status_t _simulate_resampled(lion_sim_t *sim, lion_input_t *power, lion_input_t *amb_temp) {
+  double start = fmax(lion_input_start_time(power), lion_input_start_time(amb_temp));
+  double end   = fmin(lion_input_end_time(power), lion_input_end_time(amb_temp));
+  double step  = sim->conf->sim_step_seconds;
+  if (end < start) {
+    logi_error("Inputs do not overlap in time ([%f, %f])", start, end);
+    return LION_STATUS_FAILURE;
+  }
+
+  // Steps are sampled at multiples of the step from the start, instead of the
+  // time of the sim, so that rounding does not accumulate over long runs
+  uint64_t max_iters = (uint64_t)floor((end - start) / step * (1.0 + 1e-12));
+  logi_debug("Resampling inputs over [%f, %f] in %" PRIu64 " iterations", start, end, max_iters);
+
+  for (uint64_t i = 0; i < max_iters; i++) {
+    double t = start + (double)i * step;
+    if (lion_sim_step_input(sim, lion_input_at(power, t), lion_input_at(amb_temp, t)) != LION_STATUS_SUCCESS) {
+      logi_error("Failed at iteration %" PRIu64 " (t = %f)", i, t);
+      return LION_STATUS_FAILURE;
+    }
+    if (lion_sim_should_close(sim)) {
+      logi_info("Stopping simulation at iteration %" PRIu64 " of %" PRIu64, i, max_iters);
+      break;
+    }
+  }
+
+  logi_debug("Finished iterations");
+  if (sim->finished_hook != NULL) {
+    logi_debug("Found finished hook");
+    LION_CALLDF_I(sim->finished_hook(sim), "Failed calling finished hook");
+  }
+  return LION_STATUS_SUCCESS;
+}
+
+static lion_status_t _sim_run_resampled(lion_sim_t *sim, lion_input_t *power, lion_input_t *ambient_temperature) {
+  logi_info("Simulation start");
+#ifndef NDEBUG
+  if (sim->_idebug_heap_head == NULL)
+    LION_CALL_I(lion_sim_init_debug(sim), "Failed initializing debug information");
+#endif
+
+  if (power == NULL || ambient_temperature == NULL) {
+    logi_error("Null arguments were passed, skipping simulation running");
+    return LION_STATUS_SUCCESS;
+  }
+  logi_info("Initializing simulation");
+  LION_CALL_I(lion_sim_rearm(sim, NULL, NULL), "Failed initializing sim");
+
+  logi_debug("Running simulation");
+  LION_CALL_I(_simulate_resampled(sim, power, ambient_temperature), "Failed simulating system");
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t lion_sim_run_resampled(lion_sim_t *sim, lion_input_t *power, lion_input_t *ambient_temperature) {
+  LION_RETURN_WITH_LOGGER_I(&sim->logger, _sim_run_resampled(sim, power, ambient_temperature));
+}
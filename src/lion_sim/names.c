@@ -39,6 +39,14 @@ const char *lion_stepper_name(lion_stepper_t stepper) {
     return "LION_STEPPER_MSADAMS";
   case LION_STEPPER_MSBDF:
     return "LION_STEPPER_MSBDF";
+  case LION_STEPPER_EXACT:
+    return "LION_STEPPER_EXACT";
+  case LION_STEPPER_NATIVE_RK2:
+    return "LION_STEPPER_NATIVE_RK2";
+  case LION_STEPPER_NATIVE_HEUN:
+    return "LION_STEPPER_NATIVE_HEUN";
+  case LION_STEPPER_NATIVE_RK4:
+    return "LION_STEPPER_NATIVE_RK4";
   default:
     return "N/A";
   }
@@ -67,6 +75,74 @@ const char *lion_jacobian_name(lion_jacobian_method_t jacobian) {
     return "LION_JACOBIAN_ANALYTICAL";
   case LION_JACOBIAN_2POINT:
     return "LION_JACOBIAN_2POINT";
+  case LION_JACOBIAN_AUTODIFF:
+    return "LION_JACOBIAN_AUTODIFF";
+  default:
+    return "N/A";
+  }
+  return "Unexpected return";
+}
+
+const char *lion_current_solver_name(lion_current_solver_t solver) {
+  switch (solver) {
+  case LION_CURRENT_SOLVER_MINIMIZER:
+    return "LION_CURRENT_SOLVER_MINIMIZER";
+  case LION_CURRENT_SOLVER_NEWTON:
+    return "LION_CURRENT_SOLVER_NEWTON";
+  case LION_CURRENT_SOLVER_SECANT:
+    return "LION_CURRENT_SOLVER_SECANT";
+  default:
+    return "N/A";
+  }
+  return "Unexpected return";
+}
+
+const char *lion_step_mode_name(lion_step_mode_t mode) {
+  switch (mode) {
+  case LION_STEP_MODE_FIXED:
+    return "LION_STEP_MODE_FIXED";
+  case LION_STEP_MODE_ADAPTIVE:
+    return "LION_STEP_MODE_ADAPTIVE";
+  case LION_STEP_MODE_DAE:
+    return "LION_STEP_MODE_DAE";
+  default:
+    return "N/A";
+  }
+  return "Unexpected return";
+}
+
+const char *lion_input_mode_name(lion_input_mode_t mode) {
+  switch (mode) {
+  case LION_INPUT_MODE_POWER:
+    return "LION_INPUT_MODE_POWER";
+  case LION_INPUT_MODE_CURRENT:
+    return "LION_INPUT_MODE_CURRENT";
+  default:
+    return "N/A";
+  }
+  return "Unexpected return";
+}
+
+const char *lion_model_backend_name(lion_model_backend_t backend) {
+  switch (backend) {
+  case LION_MODEL_BACKEND_ANALYTIC:
+    return "LION_MODEL_BACKEND_ANALYTIC";
+  case LION_MODEL_BACKEND_TABLE:
+    return "LION_MODEL_BACKEND_TABLE";
+  default:
+    return "N/A";
+  }
+  return "Unexpected return";
+}
+
+const char *lion_fast_math_name(lion_fast_math_t fast_math) {
+  switch (fast_math) {
+  case LION_FAST_MATH_OFF:
+    return "LION_FAST_MATH_OFF";
+  case LION_FAST_MATH_1E12:
+    return "LION_FAST_MATH_1E12";
+  case LION_FAST_MATH_1E7:
+    return "LION_FAST_MATH_1E7";
   default:
     return "N/A";
   }
@@ -0,0 +1,247 @@
+#include "sim_run.h"
+
+#include <gsl/gsl_errno.h>
+#include <inttypes.h>
+#include <lion/lion.h>
+#include <lion/protocol.h>
+#include <lion_math/lion_math.h>
+#include <lion_utils/macros.h>
+#include <lion_utils/vendor/log.h>
+#include <math.h>
+#include <stdbool.h>
+
+// Fraction of a step by which a segment may fall short of its duration, so that
+// rounding in the time does not add a step to it
+#define _SEGMENT_DURATION_TOL 1e-9
+
+typedef struct _segment_run {
+  double start;            // Time at which the segment started
+  bool   constant_voltage; // Whether the current is being solved from the voltage
+  bool   until_started;    // Whether the side of the until condition has been taken
+  bool   until_above;      // Side of the until condition at the first step
+} _segment_run_t;
+
+static lion_status_t _protocol_check_segment(const lion_segment_t *segment, size_t i) {
+  if (!(segment->duration >= 0.0) || !isfinite(segment->duration) || !(segment->taper >= 0.0) || !isfinite(segment->taper)) {
+    logi_error("Segment %zu has an invalid duration or taper (duration = %f, taper = %f)", i, segment->duration, segment->taper);
+    return LION_STATUS_FAILURE;
+  }
+  if (segment->until != 0 && ((segment->until & (segment->until - 1)) != 0 || (segment->until & ~LION_STATE_ALL) != 0)) {
+    logi_error("Segment %zu must end on a single field of the state (got %#x)", i, (unsigned)segment->until);
+    return LION_STATUS_FAILURE;
+  }
+
+  bool tapers = false;
+  switch (segment->type) {
+  case LION_SEGMENT_REST:
+    break;
+  case LION_SEGMENT_CC:
+  case LION_SEGMENT_CP:
+    if (!isfinite(segment->value)) {
+      logi_error("Segment %zu has an invalid value (%f)", i, segment->value);
+      return LION_STATUS_FAILURE;
+    }
+    break;
+  case LION_SEGMENT_CV:
+    if (!(segment->value > 0.0) || !isfinite(segment->value)) {
+      logi_error("Segment %zu has an invalid voltage (%f)", i, segment->value);
+      return LION_STATUS_FAILURE;
+    }
+    tapers = true;
+    break;
+  case LION_SEGMENT_CCCV:
+    if (segment->value == 0.0 || !isfinite(segment->value) || !(segment->voltage > 0.0) || !isfinite(segment->voltage)) {
+      logi_error("Segment %zu has an invalid current or voltage (current = %f, voltage = %f)", i, segment->value, segment->voltage);
+      return LION_STATUS_FAILURE;
+    }
+    tapers = true;
+    break;
+  default:
+    logi_error("Segment %zu has an invalid type (%d)", i, segment->type);
+    return LION_STATUS_FAILURE;
+  }
+
+  if (!(segment->duration > 0.0) && segment->until == 0 && !(tapers && segment->taper > 0.0)) {
+    logi_error("Segment %zu has no condition to end on", i);
+    return LION_STATUS_FAILURE;
+  }
+  return LION_STATUS_SUCCESS;
+}
+
+static lion_status_t _protocol_check(const lion_protocol_t *protocol) {
+  if (protocol->segments == NULL || protocol->len == 0) {
+    logi_error("Protocol has no segments");
+    return LION_STATUS_FAILURE;
+  }
+  if (protocol->cycles == 0) {
+    logi_error("Protocol must run at least one cycle");
+    return LION_STATUS_FAILURE;
+  }
+  for (size_t i = 0; i < protocol->len; i++) {
+    LION_CALL_I(_protocol_check_segment(&protocol->segments[i], i), "Invalid protocol");
+  }
+  return LION_STATUS_SUCCESS;
+}
+
+static lion_status_t _segment_cv_current(lion_sim_t *sim, lion_eval_t *eval, double voltage, double *out) {
+  int status = lion_current_solve_voltage(
+      eval, voltage, sim->state.current, sim->conf->sim_epsabs, sim->conf->sim_epsrel, sim->conf->sim_min_maxiter, sim->params, out
+  );
+  if (status != GSL_SUCCESS) {
+    logi_error("Failed solving the current holding %f V (t = %f): %s", voltage, sim->state.time, lion_gsl_errno_name(status));
+    return LION_STATUS_FAILURE;
+  }
+  return LION_STATUS_SUCCESS;
+}
+
+static lion_status_t _segment_input(lion_sim_t *sim, const lion_segment_t *segment, _segment_run_t *run, lion_input_mode_t *mode, double *input) {
+  switch (segment->type) {
+  case LION_SEGMENT_REST:
+    *mode  = LION_INPUT_MODE_CURRENT;
+    *input = 0.0;
+    return LION_STATUS_SUCCESS;
+  case LION_SEGMENT_CC:
+    *mode  = LION_INPUT_MODE_CURRENT;
+    *input = segment->value;
+    return LION_STATUS_SUCCESS;
+  case LION_SEGMENT_CP:
+    *mode  = LION_INPUT_MODE_POWER;
+    *input = segment->value;
+    return LION_STATUS_SUCCESS;
+  default:
+    break;
+  }
+
+  // The voltage controls act on the state at the start of the step, which is
+  // where the step itself evaluates the terminal voltage
+  lion_eval_t eval;
+  lion_eval_prepare_table(
+      &eval, sim->table, &sim->_rint_packed, sim->conf->sim_fast_math, sim->state._next_soc_nominal, sim->state._next_internal_temperature,
+      sim->state.soh * sim->_init.capacity, sim->params
+  );
+  *mode = LION_INPUT_MODE_CURRENT;
+  if (segment->type == LION_SEGMENT_CV) {
+    return _segment_cv_current(sim, &eval, segment->value, input);
+  }
+
+  // Constant current until the voltage it gives passes the limit, which is
+  // above the open circuit voltage when charging and below it when discharging
+  if (!run->constant_voltage) {
+    double rint    = lion_eval_resistance(&eval, segment->value, sim->params, NULL);
+    double voltage = lion_voltage_from_rint(segment->value, eval.open_circuit_voltage, rint, sim->params);
+    if ((segment->value < 0.0) ? voltage < segment->voltage : voltage > segment->voltage) {
+      *input = segment->value;
+      return LION_STATUS_SUCCESS;
+    }
+    logi_debug("Switching to constant voltage at t = %f", sim->state.time);
+    run->constant_voltage = true;
+  }
+  LION_CALL_I(_segment_cv_current(sim, &eval, segment->voltage, input), "Failed solving constant voltage current");
+  if (fabs(*input) > fabs(segment->value)) {
+    *input = segment->value;
+  }
+  return LION_STATUS_SUCCESS;
+}
+
+static bool _segment_ended(lion_sim_t *sim, const lion_segment_t *segment, _segment_run_t *run) {
+  if (segment->duration > 0.0 && sim->state.time - run->start >= segment->duration - _SEGMENT_DURATION_TOL * sim->conf->sim_step_seconds) {
+    return true;
+  }
+  if (segment->taper > 0.0 && run->constant_voltage && fabs(sim->state.current) <= segment->taper) {
+    return true;
+  }
+  if (segment->until == 0) {
+    return false;
+  }
+
+  double value = lion_state_field_value(&sim->state, segment->until);
+  switch (segment->until_direction) {
+  case LION_EVENT_RISING:
+    return value >= segment->until_threshold;
+  case LION_EVENT_FALLING:
+    return value <= segment->until_threshold;
+  case LION_EVENT_EITHER:
+  default:
+    if (!run->until_started) {
+      run->until_started = true;
+      run->until_above   = value >= segment->until_threshold;
+      return false;
+    }
+    return (value >= segment->until_threshold) != run->until_above;
+  }
+}
+
+static lion_status_t _simulate_segment(lion_sim_t *sim, lion_protocol_t *protocol, double amb_temp) {
+  const lion_segment_t *segment = &protocol->segments[protocol->segment];
+  _segment_run_t        run     = {
+      .start            = sim->state.time,
+      .constant_voltage = segment->type == LION_SEGMENT_CV,
+      .until_started    = false,
+      .until_above      = false,
+  };
+  protocol->segment_start = run.start;
+  logi_debug("Starting segment %zu of cycle %" PRIu64 " at t = %f", protocol->segment, protocol->cycle, run.start);
+
+  do {
+    lion_input_mode_t mode;
+    double            input;
+    LION_CALL_I(_segment_input(sim, segment, &run, &mode, &input), "Failed setting the input of the segment");
+    if (lion_sim_step_prescribed(sim, mode, input, amb_temp) != LION_STATUS_SUCCESS) {
+      logi_error("Failed at step %" PRIu64 " (t = %f)", sim->state.step, sim->state.time);
+      return LION_STATUS_FAILURE;
+    }
+  } while (!lion_sim_should_close(sim) && !_segment_ended(sim, segment, &run));
+  return LION_STATUS_SUCCESS;
+}
+
+static lion_status_t _simulate_cycles(lion_sim_t *sim, lion_protocol_t *protocol, double amb_temp) {
+  for (protocol->cycle = 0; protocol->cycle < protocol->cycles; protocol->cycle++) {
+    for (protocol->segment = 0; protocol->segment < protocol->len; protocol->segment++) {
+      if (_simulate_segment(sim, protocol, amb_temp) != LION_STATUS_SUCCESS) {
+        logi_error("Failed at segment %zu of cycle %" PRIu64, protocol->segment, protocol->cycle);
+        return LION_STATUS_FAILURE;
+      }
+      if (lion_sim_should_close(sim)) {
+        logi_info("Stopping protocol at segment %zu of cycle %" PRIu64, protocol->segment, protocol->cycle);
+        return LION_STATUS_SUCCESS;
+      }
+    }
+  }
+  return LION_STATUS_SUCCESS;
+}
+
+static lion_status_t _simulate_protocol(lion_sim_t *sim, lion_protocol_t *protocol, double amb_temp) {
+  LION_CALL_I(_simulate_cycles(sim, protocol, amb_temp), "Failed running segments");
+
+  logi_debug("Finished protocol");
+  if (sim->finished_hook != NULL) {
+    logi_debug("Found finished hook");
+    LION_CALLDF_I(sim->finished_hook(sim), "Failed calling finished hook");
+  }
+  return LION_STATUS_SUCCESS;
+}
+
+static lion_status_t _sim_run_protocol(lion_sim_t *sim, lion_protocol_t *protocol, double ambient_temperature) {
+  logi_info("Simulation start");
+#ifndef NDEBUG
+  if (sim->_idebug_heap_head == NULL)
+    LION_CALL_I(lion_sim_init_debug(sim), "Failed initializing debug information");
+#endif
+
+  if (protocol == NULL) {
+    logi_error("Null arguments were passed, skipping simulation running");
+    return LION_STATUS_SUCCESS;
+  }
+  LION_CALL_I(_protocol_check(protocol), "Invalid protocol");
+
+  logi_info("Initializing simulation");
+  LION_CALL_I(lion_sim_rearm(sim, NULL, NULL), "Failed initializing sim");
+
+  logi_debug("Running protocol of %zu segments over %" PRIu64 " cycles", protocol->len, protocol->cycles);
+  LION_CALL_I(_simulate_protocol(sim, protocol, ambient_temperature), "Failed simulating protocol");
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t lion_sim_run_protocol(lion_sim_t *sim, lion_protocol_t *protocol, double ambient_temperature) {
+  LION_RETURN_WITH_LOGGER_I(&sim->logger, _sim_run_protocol(sim, protocol, ambient_temperature));
+}
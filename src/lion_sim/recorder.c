@@ -0,0 +1,146 @@
+#include "mem.h"
+#include "sim_run.h"
+
+#include <lion/recorder.h>
+#include <lion_utils/macros.h>
+#include <lion_utils/vendor/log.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+// Capacity used when the recorder is created without one
+#define LION_RECORDER_DEFAULT_CAPACITY 1024
+
+typedef struct _recorder_field {
+  uint32_t mask;
+  size_t   offset;
+  size_t   size;
+} _recorder_field_t;
+
+#define _RECORDER_FIELD(mask, field, type) {mask, offsetof(lion_state_columns_t, field), sizeof(type)}
+
+static const _recorder_field_t _RECORDER_FIELDS[] = {
+  _RECORDER_FIELD(LION_STATE_TIME, time, double),
+  _RECORDER_FIELD(LION_STATE_STEP, step, uint64_t),
+  _RECORDER_FIELD(LION_STATE_POWER, power, double),
+  _RECORDER_FIELD(LION_STATE_AMBIENT_TEMPERATURE, ambient_temperature, double),
+  _RECORDER_FIELD(LION_STATE_VOLTAGE, voltage, double),
+  _RECORDER_FIELD(LION_STATE_CURRENT, current, double),
+  _RECORDER_FIELD(LION_STATE_REF_OPEN_CIRCUIT_VOLTAGE, ref_open_circuit_voltage, double),
+  _RECORDER_FIELD(LION_STATE_OPEN_CIRCUIT_VOLTAGE, open_circuit_voltage, double),
+  _RECORDER_FIELD(LION_STATE_INTERNAL_RESISTANCE, internal_resistance, double),
+  _RECORDER_FIELD(LION_STATE_CYCLE, cycle, uint64_t),
+  _RECORDER_FIELD(LION_STATE_SOH, soh, double),
+  _RECORDER_FIELD(LION_STATE_EHC, ehc, double),
+  _RECORDER_FIELD(LION_STATE_GENERATED_HEAT, generated_heat, double),
+  _RECORDER_FIELD(LION_STATE_INTERNAL_TEMPERATURE, internal_temperature, double),
+  _RECORDER_FIELD(LION_STATE_SURFACE_TEMPERATURE, surface_temperature, double),
+  _RECORDER_FIELD(LION_STATE_KAPPA, kappa, double),
+  _RECORDER_FIELD(LION_STATE_SOC_NOMINAL, soc_nominal, double),
+  _RECORDER_FIELD(LION_STATE_CAPACITY_NOMINAL, capacity_nominal, double),
+  _RECORDER_FIELD(LION_STATE_SOC_USE, soc_use, double),
+  _RECORDER_FIELD(LION_STATE_CAPACITY_USE, capacity_use, double),
+};
+
+#define LION_RECORDER_FIELDS_COUNT (sizeof(_RECORDER_FIELDS) / sizeof(_RECORDER_FIELDS[0]))
+
+static inline void **_recorder_column(lion_recorder_t *recorder, const _recorder_field_t *field) {
+  return (void **)((char *)&recorder->columns + field->offset);
+}
+
+#define _STORE_COLUMN(out, state, field, i)                                                                                                          \
+  if ((out)->field != NULL) {                                                                                                                        \
+    (out)->field[i] = (state)->field;                                                                                                                \
+  }
+
+void lion_state_columns_store(const lion_sim_state_t *state, lion_state_columns_t *out, size_t i) {
+  _STORE_COLUMN(out, state, time, i);
+  _STORE_COLUMN(out, state, step, i);
+  _STORE_COLUMN(out, state, power, i);
+  _STORE_COLUMN(out, state, ambient_temperature, i);
+  _STORE_COLUMN(out, state, voltage, i);
+  _STORE_COLUMN(out, state, current, i);
+  _STORE_COLUMN(out, state, ref_open_circuit_voltage, i);
+  _STORE_COLUMN(out, state, open_circuit_voltage, i);
+  _STORE_COLUMN(out, state, internal_resistance, i);
+  _STORE_COLUMN(out, state, cycle, i);
+  _STORE_COLUMN(out, state, soh, i);
+  _STORE_COLUMN(out, state, ehc, i);
+  _STORE_COLUMN(out, state, generated_heat, i);
+  _STORE_COLUMN(out, state, internal_temperature, i);
+  _STORE_COLUMN(out, state, surface_temperature, i);
+  _STORE_COLUMN(out, state, kappa, i);
+  _STORE_COLUMN(out, state, soc_nominal, i);
+  _STORE_COLUMN(out, state, capacity_nominal, i);
+  _STORE_COLUMN(out, state, soc_use, i);
+  _STORE_COLUMN(out, state, capacity_use, i);
+}
+
+lion_status_t lion_recorder_new(uint32_t fields, size_t capacity, lion_recorder_t *out) {
+  if ((fields & ~(uint32_t)LION_STATE_ALL) != 0) {
+    logi_error("Unknown state fields in mask %#x", fields);
+    return LION_STATUS_FAILURE;
+  }
+  lion_recorder_t recorder = {
+    .fields   = fields,
+    .len      = 0,
+    .capacity = 0,
+    .columns  = {0},
+  };
+  if (capacity == 0) {
+    capacity = LION_RECORDER_DEFAULT_CAPACITY;
+  }
+  if (lion_recorder_reserve(&recorder, capacity) != LION_STATUS_SUCCESS) {
+    lion_recorder_cleanup(&recorder);
+    logi_error("Failed preallocating recorder for %zu steps", capacity);
+    return LION_STATUS_FAILURE;
+  }
+  *out = recorder;
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t lion_recorder_reserve(lion_recorder_t *recorder, size_t capacity) {
+  if (capacity <= recorder->capacity) {
+    return LION_STATUS_SUCCESS;
+  }
+  for (size_t f = 0; f < LION_RECORDER_FIELDS_COUNT; f++) {
+    const _recorder_field_t *field = &_RECORDER_FIELDS[f];
+    if ((recorder->fields & field->mask) == 0) {
+      continue;
+    }
+    void **column = _recorder_column(recorder, field);
+    void  *grown  = lion_realloc(NULL, *column, capacity * field->size);
+    if (grown == NULL) {
+      // Columns grown so far keep their new size, which is harmless since
+      // the capacity is left untouched
+      logi_error("Failed growing recorder to %zu steps", capacity);
+      return LION_STATUS_FAILURE;
+    }
+    *column = grown;
+  }
+  recorder->capacity = capacity;
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t lion_recorder_append(lion_recorder_t *recorder, const lion_sim_state_t *state) {
+  if (recorder->len == recorder->capacity) {
+    LION_CALL_I(lion_recorder_reserve(recorder, 2 * recorder->capacity + 1), "Failed growing recorder");
+  }
+  lion_state_columns_store(state, &recorder->columns, recorder->len);
+  recorder->len++;
+  return LION_STATUS_SUCCESS;
+}
+
+void lion_recorder_clear(lion_recorder_t *recorder) { recorder->len = 0; }
+
+lion_status_t lion_recorder_cleanup(lion_recorder_t *recorder) {
+  for (size_t f = 0; f < LION_RECORDER_FIELDS_COUNT; f++) {
+    void **column = _recorder_column(recorder, &_RECORDER_FIELDS[f]);
+    if (*column != NULL) {
+      lion_free(NULL, *column);
+      *column = NULL;
+    }
+  }
+  recorder->len      = 0;
+  recorder->capacity = 0;
+  return LION_STATUS_SUCCESS;
+}
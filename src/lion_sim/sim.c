@@ -1,16 +1,24 @@
 #include "mem.h"
 #include "sim_run.h"
+#include "solver/dae.h"
 #include "solver/sys.h"
 #include "solver/update.h"
 
+#include <errno.h>
 #include <gsl/gsl_errno.h>
 #include <gsl/gsl_odeiv2.h>
 #include <inttypes.h>
 #include <lion/lion.h>
+#include <lion_math/array.h>
 #include <lion_math/dynamics/soh.h>
+#include <lion_math/dynamics/temperature.h>
+#include <lion_math/internal_resistance.h>
+#include <lion_math/table.h>
 #include <lion_utils/macros.h>
+#include <lion_utils/thread.h>
 #include <lion_utils/vendor/log.h>
 #include <math.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -31,7 +39,6 @@
       current_time  = (int64_t)(ft64.QuadPart / 10000 - EPOCH_DIFF);                                                                                 \
     }
 #else
-  #include <errno.h>
   #include <sys/stat.h>
   #include <sys/time.h>
   #define CREATE_DIRECTORY(dirname)     mkdir(dirname, 0777)
@@ -44,18 +51,28 @@
     }
 #endif
 
+// Numbered names tried for a log file before giving up on logging to file
+#define LION_LOGFILE_ATTEMPTS 1024
+
 const lion_sim_config_t LION_SIM_CONFIG_DEFAULT = {
   // Metadata
   .sim_name = "Simulation",
 
   // Simulation parameters
-  .sim_stepper      = LION_STEPPER_RKF45,
-  .sim_minimizer    = LION_MINIMIZER_BRENT,
-  .sim_jacobian     = LION_JACOBIAN_ANALYTICAL,
-  .sim_time_seconds = 10.0,
-  .sim_step_seconds = 1e-3,
-  .sim_epsabs       = 1e-8,
-  .sim_epsrel       = 1e-8,
+  .sim_stepper           = LION_STEPPER_RKF45,
+  .sim_minimizer         = LION_MINIMIZER_BRENT,
+  .sim_jacobian          = LION_JACOBIAN_ANALYTICAL,
+  .sim_current_solver    = LION_CURRENT_SOLVER_NEWTON,
+  .sim_step_mode         = LION_STEP_MODE_FIXED,
+  .sim_input_mode        = LION_INPUT_MODE_POWER,
+  .sim_model_backend     = LION_MODEL_BACKEND_ANALYTIC,
+  .sim_fast_math         = LION_FAST_MATH_OFF,
+  .sim_time_seconds      = 10.0,
+  .sim_step_seconds      = 1e-3,
+  .sim_epsabs            = 1e-8,
+  .sim_epsrel            = 1e-8,
+  .sim_table_points      = 1024,
+  .sim_table_rint_points = 256,
 
   // Logging
   .log_dir     = NULL,
@@ -98,44 +115,55 @@ static lion_status_t create_directory(const char *dirname) {
   return LION_STATUS_SUCCESS;
 }
 
-lion_status_t lion_sim_new(lion_sim_config_t *conf, lion_params_t *params, lion_sim_t *out) {
-  lion_sim_t sim = {
-    .conf          = conf,
-    .params        = params,
-    .init_hook     = NULL,
-    .update_hook   = NULL,
-    .finished_hook = NULL,
+static lion_once_t _gsl_handler_once = LION_ONCE_INIT;
 
-    .driver    = NULL,
-    .sys_min   = NULL,
-    .step_type = NULL,
-    .minimizer = NULL,
+static void _disable_gsl_handler(void) { gsl_set_error_handler_off(); }
 
-#ifndef NDEBUG // Internal debug information
-    ._idebug_malloced_total = 0,
-#endif
-  };
+void lion_gsl_setup(void) {
+  // GSL only offers a process-wide error handler, so it is turned off once and
+  // every GSL error is instead handled through the returned status codes
+  lion_call_once(&_gsl_handler_once, _disable_gsl_handler);
+}
+
+static lion_status_t _sim_new(lion_sim_t *sim) {
+  lion_gsl_setup();
 
   // Logging setup
-  time_t     seconds = time(NULL);
-  struct tm *time    = localtime(&seconds);
-  log_set_level(sim.conf->log_stdlvl);
+  time_t    seconds = time(NULL);
+  struct tm time;
+#ifdef _WIN32
+  localtime_s(&time, &seconds);
+#else
+  localtime_r(&seconds, &time);
+#endif
 
-  if (sim.conf->log_dir == NULL) {
+  if (sim->conf->log_dir == NULL) {
     logi_warn("Log directory not specified, not logging to file");
   } else {
-    if (create_directory(sim.conf->log_dir) == LION_STATUS_SUCCESS) {
-      size_t log_dir_len = strnlen(sim.conf->log_dir, FILENAME_MAX);
-      strncpy(sim.log_filename, sim.conf->log_dir, log_dir_len);
-
-      sim.log_filename[strftime(sim.log_filename + log_dir_len, _LION_LOGFILE_MAX, "/%Y%m%d_%H%M%S.txt", time) + log_dir_len] = '\0';
-
-      sim.log_file = fopen(sim.log_filename, "w");
-      if (sim.log_file == NULL) {
+    if (create_directory(sim->conf->log_dir) == LION_STATUS_SUCCESS) {
+      size_t log_dir_len = strnlen(sim->conf->log_dir, FILENAME_MAX);
+      strncpy(sim->log_filename, sim->conf->log_dir, log_dir_len);
+      char  *name  = sim->log_filename + log_dir_len;
+      size_t stamp = strftime(name, _LION_LOGFILE_MAX, "/%Y%m%d_%H%M%S", &time);
+
+      // Sims created within the same second share the timestamp, so the file
+      // is created exclusively and numbered until a free name is found
+      for (unsigned int i = 0; i < LION_LOGFILE_ATTEMPTS && sim->log_file == NULL; i++) {
+        if (i == 0) {
+          snprintf(name + stamp, _LION_LOGFILE_MAX - stamp, ".txt");
+        } else {
+          snprintf(name + stamp, _LION_LOGFILE_MAX - stamp, "_%u.txt", i);
+        }
+        sim->log_file = fopen(sim->log_filename, "wx");
+        if (sim->log_file == NULL && errno != EEXIST) {
+          break;
+        }
+      }
+      if (sim->log_file == NULL) {
         logi_error("Failed to create log file, not logging to file");
       } else {
-        logi_info("Log file : '%s'", sim.log_filename);
-        log_add_fp_internal(sim.log_file, sim.conf->log_filelvl);
+        logi_info("Log file : '%s'", sim->log_filename);
+        log_logger_add_fp_internal(&sim->logger, sim->log_file, sim->conf->log_filelvl);
       }
     } else {
       logi_error("Failed to create log directory, not logging to file");
@@ -143,12 +171,38 @@ lion_status_t lion_sim_new(lion_sim_config_t *conf, lion_params_t *params, lion_
   }
 
 #ifndef NDEBUG
-  LION_CALL_I(lion_sim_init_debug(&sim), "Failed initializing debug information");
+  LION_CALL_I(lion_sim_init_debug(sim), "Failed initializing debug information");
 #endif
-  *out = sim;
   return LION_STATUS_SUCCESS;
 }
 
+lion_status_t lion_sim_new(lion_sim_config_t *conf, lion_params_t *params, lion_sim_t *out) {
+  lion_sim_t sim = {
+    .conf          = conf,
+    .params        = params,
+    .init_hook     = NULL,
+    .update_hook   = NULL,
+    .finished_hook = NULL,
+    .recorder      = NULL,
+    .events        = NULL,
+    .events_len    = 0,
+
+    .driver    = NULL,
+    .sys_min   = NULL,
+    .step_type = NULL,
+    .minimizer = NULL,
+    .table     = NULL,
+    .log_file  = NULL,
+
+#ifndef NDEBUG // Internal debug information
+    ._idebug_malloced_total = 0,
+#endif
+  };
+  *out = sim;
+  log_logger_init(&out->logger, conf->log_stdlvl);
+  LION_RETURN_WITH_LOGGER_I(&out->logger, _sim_new(out));
+}
+
 static void lion_sim_log_startup_info(lion_sim_t *sim) {
 #ifndef NDEBUG
   logi_warn("!!! RUNNING IN DEBUG MODE !!!");
@@ -173,6 +227,12 @@ static void lion_sim_log_startup_info(lion_sim_t *sim) {
   logi_info(" * Stepper                        : %s", lion_stepper_name(sim->conf->sim_stepper));
   logi_info(" * Minimizer                      : %s", lion_minimizer_name(sim->conf->sim_minimizer));
   logi_info(" * Jacobian                       : %s", lion_jacobian_name(sim->conf->sim_jacobian));
+  logi_info(" * Current solver                 : %s", lion_current_solver_name(sim->conf->sim_current_solver));
+  logi_info(" * Step mode                      : %s", lion_step_mode_name(sim->conf->sim_step_mode));
+  logi_info(" * Input mode                     : %s", lion_input_mode_name(sim->conf->sim_input_mode));
+  logi_info(" * Model backend                  : %s", lion_model_backend_name(sim->conf->sim_model_backend));
+  logi_info(" * Fast math                      : %s", lion_fast_math_name(sim->conf->sim_fast_math));
+  logi_info(" * SIMD kernels                   : %s", lion_array_isa());
   logi_info(" * Total simulation time          : %f s", sim->conf->sim_time_seconds);
   logi_info(" * Simulation step time           : %f s", sim->conf->sim_step_seconds);
   logi_info(" * Absolute epsilon               : %f", sim->conf->sim_epsabs);
@@ -194,11 +254,11 @@ static void lion_sim_log_startup_info(lion_sim_t *sim) {
     logi_info(" * Finished hook                  : NO");
   }
   logi_info(" * Initialization parameters");
-  logi_info(" |-> State of charge              : %f %%", 100.0 * sim->params->init.soc);
-  logi_info(" |-> State of health              : %f %%", 100.0 * sim->params->init.soh);
-  logi_info(" |-> Internal temperature         : %f K", sim->params->init.temp_in);
-  logi_info(" |-> Nominal capacity             : %f C (%f Ah)", sim->params->init.capacity, sim->params->init.capacity / 3600.0);
-  logi_info(" |-> Current guess                : %f A", sim->params->init.current_guess);
+  logi_info(" |-> State of charge              : %f %%", 100.0 * sim->_init.soc);
+  logi_info(" |-> State of health              : %f %%", 100.0 * sim->_init.soh);
+  logi_info(" |-> Internal temperature         : %f K", sim->_init.temp_in);
+  logi_info(" |-> Nominal capacity             : %f C (%f Ah)", sim->_init.capacity, sim->_init.capacity / 3600.0);
+  logi_info(" |-> Current guess                : %f A", sim->_init.current_guess);
   logi_info(" * Entropic heat coefficient parameters");
   logi_info(" |-> a                            : %f V/K", sim->params->ehc.a);
   logi_info(" |-> b                            : %f V/K", sim->params->ehc.b);
@@ -231,6 +291,11 @@ static void lion_sim_log_startup_info(lion_sim_t *sim) {
 }
 
 lion_status_t _init_simulation_stepper(lion_sim_t *sim) {
+  if (sim->conf->sim_step_mode == LION_STEP_MODE_DAE) {
+    // The DAE step mode has its own implicit integrator
+    sim->step_type = NULL;
+    return LION_STATUS_SUCCESS;
+  }
   switch (sim->conf->sim_stepper) {
   case LION_STEPPER_RK2:
     sim->step_type = gsl_odeiv2_step_rk2;
@@ -265,6 +330,19 @@ lion_status_t _init_simulation_stepper(lion_sim_t *sim) {
   case LION_STEPPER_MSBDF:
     sim->step_type = gsl_odeiv2_step_msbdf;
     break;
+  case LION_STEPPER_EXACT:
+  case LION_STEPPER_NATIVE_RK2:
+  case LION_STEPPER_NATIVE_HEUN:
+  case LION_STEPPER_NATIVE_RK4:
+    // Stepped in place without a GSL driver. The exact stepper only needs the
+    // decay of the temperature over a step
+    if (sim->conf->sim_step_mode == LION_STEP_MODE_ADAPTIVE) {
+      logi_error("Native steppers do not support the adaptive step mode");
+      return LION_STATUS_FAILURE;
+    }
+    sim->step_type    = NULL;
+    sim->_exact_decay = lion_internal_temperature_decay(sim->conf->sim_step_seconds, sim->params);
+    break;
   default:
     logi_error("Desired step type not implemented");
     return LION_STATUS_FAILURE;
@@ -287,7 +365,19 @@ lion_status_t _init_simulation_minimizer(lion_sim_t *sim) {
     logi_error("Desired minimizer not implemented");
     return LION_STATUS_FAILURE;
   }
+  if (sim->sys_min != NULL) {
+    // The minimizer is set up from scratch on every solve, so it only needs
+    // replacing if its type changed
+    if (sim->sys_min->type == sim->minimizer) {
+      return LION_STATUS_SUCCESS;
+    }
+    gsl_min_fminimizer_free(sim->sys_min);
+  }
   sim->sys_min = gsl_min_fminimizer_alloc(sim->minimizer);
+  if (sim->sys_min == NULL) {
+    logi_error("Failed allocating minimizer");
+    return LION_STATUS_FAILURE;
+  }
   logi_info("Using minimizer %s", gsl_min_fminimizer_name(sim->sys_min));
   return LION_STATUS_SUCCESS;
 }
@@ -296,17 +386,20 @@ lion_status_t _init_initial_state(lion_sim_t *sim) {
   logi_debug("Setting up initial conditions");
   // The current is set at first because it is used as an initial guess
   // for the optimization problem
-  sim->state._next_soc_nominal          = sim->params->init.soc;
-  sim->state._next_internal_temperature = sim->params->init.temp_in;
+  sim->state._next_soc_nominal          = sim->_init.soc;
+  sim->state._next_internal_temperature = sim->_init.temp_in;
   sim->state._acc_discharge             = 0.0;
   sim->state._soc_mean                  = 0.0;
   sim->state._soc_max                   = 0.0;
   sim->state._soc_min                   = 1.0;
-  sim->state.soh                        = sim->params->init.soh;
-  sim->state.current                    = sim->params->init.current_guess;
+  sim->state.soh                        = sim->_init.soh;
+  sim->state.current                    = sim->_init.current_guess;
   sim->state.time                       = 0.0;
   sim->state.step                       = 0;
   sim->state.cycle                      = 0;
+  sim->_input_mode                      = sim->conf->sim_input_mode;
+  lion_dae_reset(sim);
+  lion_sim_reset_events(sim);
   return LION_STATUS_SUCCESS;
 }
 
@@ -314,7 +407,22 @@ lion_status_t _init_ode_system(lion_sim_t *sim) {
   logi_debug("Setting up GSL inputs");
   sim->inputs.sys_inputs = &sim->state;
   sim->inputs.sys_params = sim->params;
+  sim->inputs.sys_eval   = &sim->eval;
+  sim->inputs.sys_sim    = sim;
   logi_debug("Creating GSL system");
+  void *function;
+  switch (sim->conf->sim_step_mode) {
+  case LION_STEP_MODE_FIXED:
+  case LION_STEP_MODE_DAE:
+    function = &lion_slv_system_continuous;
+    break;
+  case LION_STEP_MODE_ADAPTIVE:
+    function = &lion_slv_system_adaptive;
+    break;
+  default:
+    logi_error("Desired step mode not implemented");
+    return LION_STATUS_FAILURE;
+  }
   void *jac;
   switch (sim->conf->sim_jacobian) {
   case LION_JACOBIAN_ANALYTICAL:
@@ -323,12 +431,15 @@ lion_status_t _init_ode_system(lion_sim_t *sim) {
   case LION_JACOBIAN_2POINT:
     jac = &lion_slv_jac_2point;
     break;
+  case LION_JACOBIAN_AUTODIFF:
+    jac = &lion_slv_jac_autodiff;
+    break;
   default:
     jac = NULL;
     break;
   }
   gsl_odeiv2_system sys = {
-    .function  = &lion_slv_system_continuous,
+    .function  = function,
     .jacobian  = jac,
     .dimension = LION_SLV_DIMENSION,
     .params    = &sim->inputs,
@@ -338,17 +449,98 @@ lion_status_t _init_ode_system(lion_sim_t *sim) {
 }
 
 lion_status_t _init_ode_driver(lion_sim_t *sim) {
+  if (sim->driver != NULL) {
+    gsl_odeiv2_driver_free(sim->driver);
+    sim->driver = NULL;
+  }
+  if (sim->step_type == NULL) {
+    logi_debug("Stepper does not use a GSL driver");
+    return LION_STATUS_SUCCESS;
+  }
   sim->driver = gsl_odeiv2_driver_alloc_y_new(&sim->sys, sim->step_type, sim->conf->sim_step_seconds, sim->conf->sim_epsabs, sim->conf->sim_epsrel);
+  if (sim->driver == NULL) {
+    logi_error("Failed allocating ode driver");
+    return LION_STATUS_FAILURE;
+  }
   return LION_STATUS_SUCCESS;
 }
 
-lion_status_t lion_sim_init(lion_sim_t *sim) {
+static bool _model_table_stale(const lion_sim_t *sim) {
+  // Besides the parameters, the tables only depend on the backend and the
+  // sizes set in the configuration
+  if (sim->conf->sim_model_backend != LION_MODEL_BACKEND_TABLE) {
+    return sim->table != NULL;
+  }
+  if (sim->table == NULL) {
+    return true;
+  }
+  uint64_t rint_points = (sim->params->rint.model == LION_RINT_MODEL_POLARIZATION) ? sim->conf->sim_table_rint_points : 0;
+  return sim->table->points != sim->conf->sim_table_points || sim->table->rint_points != rint_points;
+}
+
+lion_status_t _init_model_table(lion_sim_t *sim) {
+  // Tables are sampled from the parameters, so they are built anew whenever
+  // those may have changed, and so are the packed fuzzy sets every step of
+  // the polarization model goes through
+  if (sim->params->rint.model == LION_RINT_MODEL_POLARIZATION) {
+    lion_resistance_pack(sim->params, &sim->_rint_packed);
+  }
+  if (sim->table != NULL) {
+    // Tables shared by the sim this one forked from are left to it
+    if (sim->_owns_table) {
+      lion_free(NULL, sim->table);
+    }
+    sim->table       = NULL;
+    sim->_owns_table = 0;
+  }
+
+  switch (sim->conf->sim_model_backend) {
+  case LION_MODEL_BACKEND_ANALYTIC:
+    return LION_STATUS_SUCCESS;
+  case LION_MODEL_BACKEND_TABLE:
+    break;
+  default:
+    logi_error("Desired model backend not implemented");
+    return LION_STATUS_FAILURE;
+  }
+
+  size_t points      = (size_t)sim->conf->sim_table_points;
+  size_t rint_points = 0;
+  if (sim->params->rint.model == LION_RINT_MODEL_POLARIZATION) {
+    rint_points = (size_t)sim->conf->sim_table_rint_points;
+  }
+  if (points < 2 || (sim->params->rint.model == LION_RINT_MODEL_POLARIZATION && rint_points < 2)) {
+    logi_error("Model tables need at least 2 points along each axis");
+    return LION_STATUS_FAILURE;
+  }
+
+  sim->table = lion_malloc(NULL, lion_table_size(points, rint_points));
+  if (sim->table == NULL) {
+    logi_error("Failed allocating model tables");
+    return LION_STATUS_FAILURE;
+  }
+  sim->_owns_table = 1;
+  lion_table_build(sim->table, points, rint_points, sim->params);
+  logi_debug("Built model tables with %zu points (%zu x %zu for the resistance)", points, rint_points, rint_points);
+  logi_debug(" * Open circuit voltage error     : %e V", sim->table->voc_error);
+  logi_debug(" * Entropic heat coefficient error: %e V/K", sim->table->ehc_error);
+  logi_debug(" * Kappa error                    : %e", sim->table->kappa_error);
+  logi_debug(" * Resistance error               : %e Ohm", sim->table->rint_error);
+  return LION_STATUS_SUCCESS;
+}
+
+static lion_status_t _sim_init(lion_sim_t *sim, const lion_params_init_t *init) {
+  sim->_init = (init != NULL) ? *init : sim->params->init;
+
   logi_debug("Configuring simulation stepper");
   LION_CALL_I(_init_simulation_stepper(sim), "Failed initializing simulation stepper");
 
   logi_debug("Configuring optimization minimizer");
   LION_CALL_I(_init_simulation_minimizer(sim), "Failed initializing simulation minimizer");
 
+  logi_info("Configuring model backend");
+  LION_CALL_I(_init_model_table(sim), "Failed initializing model backend");
+
   logi_info("Configuring initial state");
   LION_CALL_I(_init_initial_state(sim), "Failed initializing initial state");
 
@@ -372,37 +564,247 @@ lion_status_t lion_sim_init(lion_sim_t *sim) {
   return LION_STATUS_SUCCESS;
 }
 
-lion_status_t lion_sim_reset(lion_sim_t *sim) {
+lion_status_t lion_sim_init(lion_sim_t *sim) { LION_RETURN_WITH_LOGGER_I(&sim->logger, _sim_init(sim, NULL)); }
+
+static lion_status_t _reset_ode_driver(lion_sim_t *sim) {
+  // Drops the step history of the driver, which multistep and implicit
+  // steppers carry over, and restores the initial step size for the
+  // adaptive step mode
+  if (sim->driver != NULL) {
+    LION_GSL_VCALL_I(gsl_odeiv2_driver_reset_hstart(sim->driver, sim->conf->sim_step_seconds), "Failed resetting ode driver");
+  }
+  return LION_STATUS_SUCCESS;
+}
+
+static lion_status_t _sim_reset(lion_sim_t *sim) {
   logi_debug("Resetting simulator");
   LION_CALL_I(_init_initial_state(sim), "Failed resetting initial state");
+  LION_CALL_I(_reset_ode_driver(sim), "Failed resetting ode driver");
   return LION_STATUS_SUCCESS;
 }
 
-lion_status_t lion_sim_step(lion_sim_t *sim, double power, double ambient_temperature) {
+lion_status_t lion_sim_reset(lion_sim_t *sim) { LION_RETURN_WITH_LOGGER_I(&sim->logger, _sim_reset(sim)); }
+
+static lion_status_t _sim_rearm(lion_sim_t *sim, lion_params_t *params, const lion_params_init_t *init) {
+  if (params != NULL) {
+    sim->params = params;
+  }
+  if (sim->sys_min == NULL) {
+    logi_debug("Simulation not initialized, initializing it instead of re-arming");
+    LION_CALL_I(_sim_init(sim, init), "Failed initializing sim");
+    return LION_STATUS_SUCCESS;
+  }
+  sim->_init = (init != NULL) ? *init : sim->params->init;
+
+  logi_debug("Re-arming simulation");
+  LION_CALL_I(_init_simulation_stepper(sim), "Failed initializing simulation stepper");
+  LION_CALL_I(_init_simulation_minimizer(sim), "Failed initializing simulation minimizer");
+  if (params != NULL || _model_table_stale(sim)) {
+    // Parameters passed again may have been edited in place, so they are
+    // always sampled anew
+    LION_CALL_I(_init_model_table(sim), "Failed initializing model backend");
+  }
+  LION_CALL_I(_init_initial_state(sim), "Failed initializing initial state");
+  LION_CALL_I(_init_ode_system(sim), "Failed initializing ode system");
+  if (sim->driver == NULL || sim->driver->s->type != sim->step_type) {
+    LION_CALL_I(_init_ode_driver(sim), "Failed initializing ode driver");
+  } else {
+    LION_CALL_I(_reset_ode_driver(sim), "Failed resetting ode driver");
+  }
+
+  if (sim->init_hook != NULL) {
+    logi_debug("Found init hook");
+    LION_CALLDF_I(sim->init_hook(sim), "Failed calling init hook");
+  }
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t lion_sim_rearm(lion_sim_t *sim, lion_params_t *params, const lion_params_init_t *init) {
+  LION_RETURN_WITH_LOGGER_I(&sim->logger, _sim_rearm(sim, params, init));
+}
+
+static lion_status_t _sim_fork_one(lion_sim_t *sim, lion_sim_t *out) {
+  // Configuration, parameters, model tables and hooks are only read while
+  // stepping, so the branch points to the ones of the sim. Everything written
+  // to while stepping is copied or allocated anew
+  lion_sim_t fork = {
+    .conf            = sim->conf,
+    .params          = sim->params,
+    .state           = sim->state,
+    .init_hook       = sim->init_hook,
+    .update_hook     = sim->update_hook,
+    .finished_hook   = sim->finished_hook,
+    .recorder        = NULL,
+    .events          = NULL,
+    .events_len      = 0,
+    ._should_close   = sim->_should_close,
+    ._input_switched = sim->_input_switched,
+    ._switched_power = sim->_switched_power,
+    ._input_mode     = sim->_input_mode,
+
+    .driver    = NULL,
+    .sys_min   = NULL,
+    .step_type    = sim->step_type,
+    .minimizer    = sim->minimizer,
+    ._exact_decay = sim->_exact_decay,
+    ._dae_prev    = {sim->_dae_prev[0], sim->_dae_prev[1]},
+    ._dae_h       = sim->_dae_h,
+    ._dae_current = sim->_dae_current,
+    ._dae_steps   = sim->_dae_steps,
+    .table        = sim->table,
+    ._owns_table  = 0,
+    ._rint_packed = sim->_rint_packed,
+    ._init        = sim->_init,
+    .log_file     = NULL,
+
+#ifndef NDEBUG
+    ._idebug_malloced_total = 0,
+#endif
+  };
+  *out = fork;
+  log_logger_init(&out->logger, sim->conf->log_stdlvl);
+#ifndef NDEBUG
+  LION_CALL_I(lion_sim_init_debug(out), "Failed initializing debug information");
+#endif
+
+  if (sim->events_len > 0) {
+    out->events = lion_malloc(NULL, sim->events_len * sizeof(lion_event_t));
+    if (out->events == NULL) {
+      logi_error("Failed allocating %zu events", sim->events_len);
+      return LION_STATUS_FAILURE;
+    }
+    memcpy(out->events, sim->events, sim->events_len * sizeof(lion_event_t));
+    out->events_len       = sim->events_len;
+    out->_events_capacity = sim->events_len;
+  }
+
+  out->sys_min = gsl_min_fminimizer_alloc(sim->minimizer);
+  if (out->sys_min == NULL) {
+    logi_error("Failed allocating minimizer");
+    return LION_STATUS_FAILURE;
+  }
+  LION_CALL_I(_init_ode_system(out), "Failed initializing ode system");
+  if (sim->step_type == NULL) {
+    return LION_STATUS_SUCCESS;
+  }
+  out->driver = gsl_odeiv2_driver_alloc_y_new(&out->sys, sim->step_type, sim->driver->h, sim->conf->sim_epsabs, sim->conf->sim_epsrel);
+  if (out->driver == NULL) {
+    logi_error("Failed allocating ode driver");
+    return LION_STATUS_FAILURE;
+  }
+  return LION_STATUS_SUCCESS;
+}
+
+static lion_status_t _sim_fork(lion_sim_t *sim, size_t k, lion_sim_t *out) {
+  if (sim->sys_min == NULL) {
+    logi_error("Only initialized simulations can be forked");
+    return LION_STATUS_FAILURE;
+  }
+  logi_debug("Forking simulation into %zu branches at t = %f", k, sim->state.time);
+  for (size_t i = 0; i < k; i++) {
+    if (_sim_fork_one(sim, &out[i]) != LION_STATUS_SUCCESS) {
+      logi_error("Failed forking branch %zu", i);
+      for (size_t j = 0; j <= i; j++) {
+        lion_sim_cleanup(&out[j]);
+      }
+      return LION_STATUS_FAILURE;
+    }
+  }
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t lion_sim_fork(lion_sim_t *sim, size_t k, lion_sim_t *out) { LION_RETURN_WITH_LOGGER_I(&sim->logger, _sim_fork(sim, k, out)); }
+
+static lion_status_t _sim_step_adaptive(lion_sim_t *sim, bool inputs_changed, double y[]) {
+  // Inputs are constant over the interval, so it can be integrated with the
+  // error controlled evolution. The step size is kept between intervals, and
+  // the stepper is only reset when the inputs jump, since multistep methods
+  // would otherwise extrapolate their history across the discontinuity
+  gsl_odeiv2_driver *d  = sim->driver;
+  double             t1 = sim->state.time + sim->conf->sim_step_seconds;
+  if (inputs_changed) {
+    gsl_odeiv2_step_reset(d->s);
+  }
+  uint64_t steps = 0;
+  while (sim->state.time < t1) {
+    if (steps++ >= LION_ADAPTIVE_MAXSTEPS) {
+      logi_error("Exceeded %d internal steps at step %" PRIu64 " (t = %f)", LION_ADAPTIVE_MAXSTEPS, sim->state.step, sim->state.time);
+      return LION_STATUS_FAILURE;
+    }
+    int status = gsl_odeiv2_evolve_apply(d->e, d->c, d->s, &sim->sys, &sim->state.time, t1, &d->h, y);
+    if (status != GSL_SUCCESS) {
+      logi_error("Failed at step %" PRIu64 " (t = %f): %s", sim->state.step, sim->state.time, lion_gsl_errno_name(status));
+      return LION_STATUS_FAILURE;
+    }
+  }
+  return LION_STATUS_SUCCESS;
+}
+
+static lion_status_t _sim_step(lion_sim_t *sim, lion_input_mode_t mode, double input, double ambient_temperature) {
   /*
      By using this update logic, at the end of every call sim->state contains the inputs,
      outputs and states at timestep k, and the states at k+1 are stored in placeholder
      variables
+
+     The input is either the power or the current, depending on the input mode
+     of the step, which is kept for the evaluations of the system within it
   */
 
+  // A switch event replaces the input until the events are reset
+  if (sim->_input_switched) {
+    input = sim->_switched_power;
+  }
+
   // sim->state = {x(k - 1), y(k - 1), u(k - 1)}
   sim->state.soc_nominal          = sim->state._next_soc_nominal;
   sim->state.internal_temperature = sim->state._next_internal_temperature;
   // sim->state = {x(k), y(k - 1), u(k - 1)}
-  sim->state.power                = power;
-  sim->state.ambient_temperature  = ambient_temperature;
+  bool inputs_changed             = sim->state.ambient_temperature != ambient_temperature || sim->_input_mode != mode;
+  sim->_input_mode                = mode;
+  if (mode == LION_INPUT_MODE_CURRENT) {
+    inputs_changed     = inputs_changed || sim->state.current != input;
+    sim->state.current = input;
+  } else {
+    inputs_changed   = inputs_changed || sim->state.power != input;
+    sim->state.power = input;
+  }
+  sim->state.ambient_temperature = ambient_temperature;
+  if (inputs_changed) {
+    // The current solved at the end of the last implicit step no longer holds,
+    // and the history is not smooth across the jump
+    lion_dae_reset(sim);
+  }
   // sim->state = {x(k), y(k - 1), u(k)}
   LION_CALL_I(lion_slv_update(sim), "Failed updating state");
   // sim->state = {x(k), y(k), u(k)}
+  double start_time        = sim->state.time;
   double partial_result[2] = {sim->state.soc_nominal, sim->state.internal_temperature};
-  LION_GSL_VCALL_I(
-      gsl_odeiv2_driver_apply_fixed_step(sim->driver, &sim->state.time, sim->conf->sim_step_seconds, 1, partial_result),
-      "Failed at step %" PRIu64 " (t = %f)",
-      sim->state.step,
-      sim->state.time
-  );
+  if (sim->conf->sim_step_mode == LION_STEP_MODE_ADAPTIVE) {
+    LION_CALL_I(_sim_step_adaptive(sim, inputs_changed, partial_result), "Failed integrating input interval");
+  } else if (sim->conf->sim_step_mode == LION_STEP_MODE_DAE) {
+    LION_CALL_I(lion_dae_step(sim, sim->conf->sim_step_seconds, partial_result), "Failed integrating DAE step");
+    sim->state.time += sim->conf->sim_step_seconds;
+  } else if (sim->step_type == NULL) {
+    LION_GSL_VCALL_I(
+        lion_slv_step_native(sim, sim->conf->sim_step_seconds, partial_result),
+        "Failed at step %" PRIu64 " (t = %f)",
+        sim->state.step,
+        sim->state.time
+    );
+    sim->state.time += sim->conf->sim_step_seconds;
+  } else {
+    LION_GSL_VCALL_I(
+        gsl_odeiv2_driver_apply_fixed_step(sim->driver, &sim->state.time, sim->conf->sim_step_seconds, 1, partial_result),
+        "Failed at step %" PRIu64 " (t = %f)",
+        sim->state.step,
+        sim->state.time
+    );
+  }
   sim->state._next_soc_nominal          = partial_result[0];
   sim->state._next_internal_temperature = partial_result[1];
+  if (sim->events_len > 0) {
+    LION_CALL_I(lion_sim_process_events(sim, start_time), "Failed processing events");
+  }
 
   // Update SoC statistics
   sim->state._soc_mean = ((double)sim->state._cycle_step * sim->state._soc_mean + sim->state.soc_nominal) / (double)(sim->state._cycle_step + 1);
@@ -411,8 +813,9 @@ lion_status_t lion_sim_step(lion_sim_t *sim, double power, double ambient_temper
   if (sim->state.soc_nominal < sim->state._soc_min)
     sim->state._soc_min = sim->state.soc_nominal;
 
-  // Update the degradation state of the cell
-  sim->state._acc_discharge += GSL_MAX_DBL(sim->state.current * sim->conf->sim_step_seconds, 0.0);
+  // Update the degradation state of the cell, over the part of the step taken
+  // before any event which cut it
+  sim->state._acc_discharge += GSL_MAX_DBL(sim->state.current * (sim->state.time - start_time), 0.0);
   if (sim->state._acc_discharge >= sim->state.capacity_nominal) {
     // A cycle has been completed so we update the SoH
     sim->state._acc_discharge = fmod(sim->state._acc_discharge, sim->state.capacity_nominal);
@@ -436,10 +839,68 @@ lion_status_t lion_sim_step(lion_sim_t *sim, double power, double ambient_temper
   }
   sim->state.step++;
   // TODO: Add time update
+
+  // Recorded after the step index is updated, so that it matches what is seen
+  // through sim->state once lion_sim_step returns
+  if (sim->recorder != NULL) {
+    LION_CALL_I(lion_recorder_append(sim->recorder, &sim->state), "Failed recording state");
+  }
   return LION_STATUS_SUCCESS;
 }
 
-lion_status_t lion_sim_run(lion_sim_t *sim, lion_vector_t *power, lion_vector_t *ambient_temperature) {
+static lion_status_t _sim_step_mode(lion_sim_t *sim, lion_input_mode_t mode, double input, double ambient_temperature) {
+  if (sim->conf->sim_input_mode != mode) {
+    logi_error("Input does not match the input mode of the sim (%s)", lion_input_mode_name(sim->conf->sim_input_mode));
+    return LION_STATUS_FAILURE;
+  }
+  return _sim_step(sim, mode, input, ambient_temperature);
+}
+
+lion_status_t lion_sim_step(lion_sim_t *sim, double power, double ambient_temperature) {
+  LION_RETURN_WITH_LOGGER_I(&sim->logger, _sim_step_mode(sim, LION_INPUT_MODE_POWER, power, ambient_temperature));
+}
+
+lion_status_t lion_sim_step_current(lion_sim_t *sim, double current, double ambient_temperature) {
+  LION_RETURN_WITH_LOGGER_I(&sim->logger, _sim_step_mode(sim, LION_INPUT_MODE_CURRENT, current, ambient_temperature));
+}
+
+lion_status_t lion_sim_step_input(lion_sim_t *sim, double input, double ambient_temperature) {
+  LION_RETURN_WITH_LOGGER_I(&sim->logger, _sim_step(sim, sim->conf->sim_input_mode, input, ambient_temperature));
+}
+
+lion_status_t lion_sim_step_prescribed(lion_sim_t *sim, lion_input_mode_t mode, double input, double ambient_temperature) {
+  LION_RETURN_WITH_LOGGER_I(&sim->logger, _sim_step(sim, mode, input, ambient_temperature));
+}
+
+static lion_status_t _sim_step_n(
+    lion_sim_t *sim, const double *power, const double *ambient_temperature, size_t n, lion_state_columns_t *out, size_t *taken
+) {
+  // Stops after the step where a stop event triggers, like the running loops
+  lion_status_t status = LION_STATUS_SUCCESS;
+  size_t        i      = 0;
+  for (; i < n && !lion_sim_should_close(sim); i++) {
+    if (_sim_step(sim, sim->conf->sim_input_mode, power[i], ambient_temperature[i]) != LION_STATUS_SUCCESS) {
+      logi_error("Failed at step %zu of %zu", i, n);
+      status = LION_STATUS_FAILURE;
+      break;
+    }
+    if (out != NULL) {
+      lion_state_columns_store(&sim->state, out, i);
+    }
+  }
+  if (taken != NULL) {
+    *taken = i;
+  }
+  return status;
+}
+
+lion_status_t lion_sim_step_n(
+    lion_sim_t *sim, const double *power, const double *ambient_temperature, size_t n, lion_state_columns_t *out, size_t *taken
+) {
+  LION_RETURN_WITH_LOGGER_I(&sim->logger, _sim_step_n(sim, power, ambient_temperature, n, out, taken));
+}
+
+static lion_status_t _sim_run(lion_sim_t *sim, lion_vector_t *power, lion_vector_t *ambient_temperature) {
   logi_info("Simulation start");
 #ifndef NDEBUG
   if (sim->_idebug_heap_head == NULL)
@@ -448,7 +909,7 @@ lion_status_t lion_sim_run(lion_sim_t *sim, lion_vector_t *power, lion_vector_t
 
   if (power != NULL && ambient_temperature != NULL) {
     logi_info("Initializing simulation");
-    LION_CALL_I(lion_sim_init(sim), "Failed initializing sim");
+    LION_CALL_I(lion_sim_rearm(sim, NULL, NULL), "Failed initializing sim");
 
     logi_debug("Running simulation");
     LION_CALL_I(lion_sim_simulate(sim, power, ambient_temperature), "Failed simulating system");
@@ -459,10 +920,23 @@ lion_status_t lion_sim_run(lion_sim_t *sim, lion_vector_t *power, lion_vector_t
   return LION_STATUS_SUCCESS;
 }
 
-lion_status_t lion_sim_cleanup(lion_sim_t *sim) {
+lion_status_t lion_sim_run(lion_sim_t *sim, lion_vector_t *power, lion_vector_t *ambient_temperature) {
+  LION_RETURN_WITH_LOGGER_I(&sim->logger, _sim_run(sim, power, ambient_temperature));
+}
+
+static lion_status_t _sim_cleanup(lion_sim_t *sim) {
+  lion_sim_clear_events(sim);
+
+  if (sim->table != NULL && sim->_owns_table) {
+    lion_free(NULL, sim->table);
+  }
+  sim->table       = NULL;
+  sim->_owns_table = 0;
+
   if (sim->driver != NULL) {
     logi_info("GSL driver detected, freeing it");
     gsl_odeiv2_driver_free(sim->driver);
+    sim->driver = NULL;
   } else {
     logi_warn("No GSL driver detected");
   }
@@ -470,6 +944,7 @@ lion_status_t lion_sim_cleanup(lion_sim_t *sim) {
   if (sim->sys_min != NULL) {
     logi_info("GSL minimizer detected, freeing it");
     gsl_min_fminimizer_free(sim->sys_min);
+    sim->sys_min = NULL;
   } else {
     logi_warn("No GSL minimizer detected");
   }
@@ -499,11 +974,22 @@ lion_status_t lion_sim_cleanup(lion_sim_t *sim) {
     }
   }
   heapinfo_clean(sim);
+  sim->_idebug_heap_head = NULL;
 #endif
 
+  if (sim->log_file != NULL) {
+    // Drop the file sink first so that nothing logs to the closed file
+    log_logger_init(&sim->logger, sim->conf->log_stdlvl);
+    fclose(sim->log_file);
+    sim->log_file = NULL;
+  }
   return LION_STATUS_SUCCESS;
 }
 
+lion_status_t lion_sim_cleanup(lion_sim_t *sim) {
+  LION_RETURN_WITH_LOGGER_I(&sim->logger, _sim_cleanup(sim));
+}
+
 lion_version_t lion_sim_get_version(lion_sim_t *sim) {
   lion_version_t out = {
     .major = LION_ENGINE_VERSION_MAJOR,
@@ -513,6 +999,6 @@ lion_version_t lion_sim_get_version(lion_sim_t *sim) {
   return out;
 }
 
-int lion_sim_should_close(lion_sim_t *sim) { return 0; }
+int lion_sim_should_close(lion_sim_t *sim) { return sim->_should_close; }
 
 uint64_t lion_sim_max_iters(lion_sim_t *sim) { return (uint64_t)(sim->conf->sim_time_seconds / sim->conf->sim_step_seconds); }
@@ -1,10 +1,12 @@
 #include "sim_run.h"
 
 #include <gsl/gsl_odeiv2.h>
+#include <inttypes.h>
 #include <lion/lion.h>
 #include <lion_utils/macros.h>
 #include <lion_utils/vendor/log.h>
 #include <math.h>
+#include <stdbool.h>
 
 #define _SHOW_STATE(sim, f)                                                                                                                          \
   f("Cell state");                                                                                                                                   \
@@ -66,25 +68,35 @@ void _update_progressbar(FILE *buf, int i, int max, int width, int *c, int *last
 
 void _finish_progressbar(FILE *buf) { fprintf(stderr, "\033[EDone\n"); }
 
-lion_status_t lion_sim_simulate(lion_sim_t *sim, lion_vector_t *power, lion_vector_t *amb_temp) {
+static lion_status_t _simulate(lion_sim_t *sim, const lion_vector_t *power, const lion_vector_t *amb_temp, bool progress) {
 
   uint64_t max_iters = fminl(power->len, amb_temp->len);
   logi_debug("Considering %d max iterations", max_iters);
 
   logi_debug("Starting iterations");
-  _template_progressbar(stderr, LION_PROGRESSBAR_WIDTH);
+  if (progress) {
+    _template_progressbar(stderr, LION_PROGRESSBAR_WIDTH);
+  }
   int c      = 0;
   int last_c = 0;
   for (uint64_t i = 1; i < max_iters; i++) {
-    _update_progressbar(stderr, i, max_iters, LION_PROGRESSBAR_WIDTH, &c, &last_c);
+    if (progress) {
+      _update_progressbar(stderr, i, max_iters, LION_PROGRESSBAR_WIDTH, &c, &last_c);
+    }
 
     if (i == power->len || i == amb_temp->len) {
       logi_error("Ran out of inputs before reaching end of simulation");
       break;
     }
-    LION_VCALL_I(lion_sim_step(sim, lion_vector_get_d(sim, power, i), lion_vector_get_d(sim, amb_temp, i)), "Failed at iteration %i", i);
+    LION_VCALL_I(lion_sim_step_input(sim, lion_vector_get_d(sim, power, i), lion_vector_get_d(sim, amb_temp, i)), "Failed at iteration %i", i);
+    if (lion_sim_should_close(sim)) {
+      logi_info("Stopping simulation at iteration %" PRIu64 " of %" PRIu64, i, max_iters);
+      break;
+    }
+  }
+  if (progress) {
+    _finish_progressbar(stderr);
   }
-  _finish_progressbar(stderr);
 
   logi_debug("Finished iterations");
   if (sim->finished_hook != NULL) {
@@ -94,6 +106,14 @@ lion_status_t lion_sim_simulate(lion_sim_t *sim, lion_vector_t *power, lion_vect
   return LION_STATUS_SUCCESS;
 }
 
+lion_status_t lion_sim_simulate(lion_sim_t *sim, lion_vector_t *power, lion_vector_t *amb_temp) {
+  LION_RETURN_WITH_LOGGER_I(&sim->logger, _simulate(sim, power, amb_temp, true));
+}
+
+lion_status_t lion_sim_simulate_silent(lion_sim_t *sim, const lion_vector_t *power, const lion_vector_t *amb_temp) {
+  LION_RETURN_WITH_LOGGER_I(&sim->logger, _simulate(sim, power, amb_temp, false));
+}
+
 #ifndef NDEBUG
 lion_status_t lion_sim_init_debug(lion_sim_t *sim) {
   sim->_idebug_malloced_total = 0;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <lion/recorder.h>
 #include <lion/sim.h>
 #include <lion/status.h>
 #include <stddef.h>
@@ -8,10 +9,24 @@
   #define LION_PROGRESSBAR_WIDTH 100
 #endif
 
+// Maximum number of internal steps taken to integrate a single input interval
+// in the adaptive step mode
+#ifndef LION_ADAPTIVE_MAXSTEPS
+  #define LION_ADAPTIVE_MAXSTEPS 100000
+#endif
+
+void          lion_gsl_setup(void);
+void          lion_state_columns_store(const lion_sim_state_t *state, lion_state_columns_t *out, size_t i);
 lion_status_t lion_sim_show_state_info(lion_sim_t *sim);
 lion_status_t lion_sim_show_state_debug(lion_sim_t *sim);
 lion_status_t lion_sim_show_state_trace(lion_sim_t *sim);
 lion_status_t lion_sim_simulate(lion_sim_t *sim, lion_vector_t *power, lion_vector_t *amb_temp);
+lion_status_t lion_sim_step_input(lion_sim_t *sim, double input, double ambient_temperature);
+lion_status_t lion_sim_step_prescribed(lion_sim_t *sim, lion_input_mode_t mode, double input, double ambient_temperature);
+double        lion_state_field_value(const lion_sim_state_t *state, lion_state_field_t field);
+lion_status_t lion_sim_process_events(lion_sim_t *sim, double t0);
+void          lion_sim_reset_events(lion_sim_t *sim);
+lion_status_t lion_sim_simulate_silent(lion_sim_t *sim, const lion_vector_t *power, const lion_vector_t *amb_temp);
 
 #ifndef NDEBUG
 lion_status_t lion_sim_init_debug(lion_sim_t *sim);
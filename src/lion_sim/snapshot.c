@@ -0,0 +1,191 @@
+#include "mem.h"
+#include "sim_run.h"
+
+#include <gsl/gsl_errno.h>
+#include <gsl/gsl_odeiv2.h>
+#include <lion/event.h>
+#include <lion/names.h>
+#include <lion/snapshot.h>
+#include <lion_utils/macros.h>
+#include <lion_utils/vendor/log.h>
+#include <stdio.h>
+#include <string.h>
+
+// Identifies snapshot files, followed by the version of their layout
+#define _SNAPSHOT_MAGIC   "LIONSNAP"
+#define _SNAPSHOT_VERSION 3
+
+typedef struct _snapshot_header {
+  char     magic[8];
+  uint32_t version;
+  uint32_t state_size;
+  uint64_t events_len;
+} _snapshot_header_t;
+
+static lion_status_t _snapshot_alloc_events(size_t events_len, lion_snapshot_t *out) {
+  out->events_len = events_len;
+  out->events     = NULL;
+  if (events_len == 0) {
+    return LION_STATUS_SUCCESS;
+  }
+  out->events = lion_malloc(NULL, events_len * sizeof(lion_snapshot_event_t));
+  if (out->events == NULL) {
+    logi_error("Failed allocating the state of %zu events", events_len);
+    return LION_STATUS_FAILURE;
+  }
+  return LION_STATUS_SUCCESS;
+}
+
+static lion_status_t _sim_snapshot(lion_sim_t *sim, lion_snapshot_t *out) {
+  lion_snapshot_t snapshot = {
+    .state          = sim->state,
+    .step_size      = (sim->driver != NULL) ? sim->driver->h : sim->conf->sim_step_seconds,
+    .should_close   = sim->_should_close,
+    .input_switched = sim->_input_switched,
+    .switched_power = sim->_switched_power,
+    .input_mode     = sim->_input_mode,
+    .dae_prev       = {sim->_dae_prev[0], sim->_dae_prev[1]},
+    .dae_h          = sim->_dae_h,
+    .dae_current    = sim->_dae_current,
+    .dae_steps      = sim->_dae_steps,
+  };
+  LION_CALL_I(_snapshot_alloc_events(sim->events_len, &snapshot), "Failed allocating snapshot");
+  for (size_t i = 0; i < sim->events_len; i++) {
+    snapshot.events[i].triggered = sim->events[i].triggered;
+    snapshot.events[i].time      = sim->events[i].time;
+    snapshot.events[i].value     = sim->events[i].value;
+  }
+  *out = snapshot;
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t lion_sim_snapshot(lion_sim_t *sim, lion_snapshot_t *out) { LION_RETURN_WITH_LOGGER_I(&sim->logger, _sim_snapshot(sim, out)); }
+
+static lion_status_t _sim_restore(lion_sim_t *sim, const lion_snapshot_t *snapshot) {
+  if (snapshot->events_len != sim->events_len) {
+    logi_error("Snapshot has %zu events but the sim has %zu", snapshot->events_len, sim->events_len);
+    return LION_STATUS_FAILURE;
+  }
+  if (sim->sys_min == NULL) {
+    LION_CALL_I(lion_sim_rearm(sim, NULL, NULL), "Failed initializing sim");
+  }
+
+  sim->state           = snapshot->state;
+  sim->_should_close   = snapshot->should_close;
+  sim->_input_switched = snapshot->input_switched;
+  sim->_switched_power = snapshot->switched_power;
+  sim->_input_mode     = snapshot->input_mode;
+  sim->_dae_prev[0]    = snapshot->dae_prev[0];
+  sim->_dae_prev[1]    = snapshot->dae_prev[1];
+  sim->_dae_h          = snapshot->dae_h;
+  sim->_dae_current    = snapshot->dae_current;
+  sim->_dae_steps      = snapshot->dae_steps;
+  for (size_t i = 0; i < sim->events_len; i++) {
+    sim->events[i].triggered = snapshot->events[i].triggered;
+    sim->events[i].time      = snapshot->events[i].time;
+    sim->events[i].value     = snapshot->events[i].value;
+  }
+  // The history of the GSL stepper belongs to another trajectory, so it is
+  // dropped and rebuilt from the restored state
+  if (sim->driver != NULL) {
+    LION_GSL_VCALL_I(gsl_odeiv2_driver_reset_hstart(sim->driver, snapshot->step_size), "Failed resetting ode driver");
+  }
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t lion_sim_restore(lion_sim_t *sim, const lion_snapshot_t *snapshot) {
+  LION_RETURN_WITH_LOGGER_I(&sim->logger, _sim_restore(sim, snapshot));
+}
+
+static lion_status_t _snapshot_write(FILE *f, const lion_snapshot_t *snapshot) {
+  _snapshot_header_t header = {
+    .version    = _SNAPSHOT_VERSION,
+    .state_size = sizeof(lion_sim_state_t),
+    .events_len = snapshot->events_len,
+  };
+  memcpy(header.magic, _SNAPSHOT_MAGIC, sizeof(header.magic));
+  int32_t flags[3] = {snapshot->should_close, snapshot->input_switched, (int32_t)snapshot->input_mode};
+  double  dae[4]   = {snapshot->dae_prev[0], snapshot->dae_prev[1], snapshot->dae_h, snapshot->dae_current};
+  if (fwrite(&header, sizeof(header), 1, f) != 1 || fwrite(&snapshot->state, sizeof(lion_sim_state_t), 1, f) != 1 ||
+      fwrite(&snapshot->step_size, sizeof(double), 1, f) != 1 || fwrite(flags, sizeof(flags), 1, f) != 1 ||
+      fwrite(&snapshot->switched_power, sizeof(double), 1, f) != 1 || fwrite(dae, sizeof(dae), 1, f) != 1 ||
+      fwrite(&snapshot->dae_steps, sizeof(uint64_t), 1, f) != 1) {
+    return LION_STATUS_FAILURE;
+  }
+  if (snapshot->events_len > 0 && fwrite(snapshot->events, sizeof(lion_snapshot_event_t), snapshot->events_len, f) != snapshot->events_len) {
+    return LION_STATUS_FAILURE;
+  }
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t lion_snapshot_save(const lion_snapshot_t *snapshot, const char *filename) {
+  FILE *f = fopen(filename, "wb");
+  if (f == NULL) {
+    logi_error("Failed opening snapshot file '%s'", filename);
+    return LION_STATUS_FAILURE;
+  }
+  lion_status_t ret = _snapshot_write(f, snapshot);
+  if (fclose(f) != 0) {
+    ret = LION_STATUS_FAILURE;
+  }
+  if (ret != LION_STATUS_SUCCESS) {
+    logi_error("Failed writing snapshot file '%s'", filename);
+  }
+  return ret;
+}
+
+static lion_status_t _snapshot_read(FILE *f, const char *filename, lion_snapshot_t *out) {
+  _snapshot_header_t header;
+  if (fread(&header, sizeof(header), 1, f) != 1 || memcmp(header.magic, _SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) {
+    logi_error("File '%s' is not a snapshot", filename);
+    return LION_STATUS_FAILURE;
+  }
+  if (header.version != _SNAPSHOT_VERSION || header.state_size != sizeof(lion_sim_state_t)) {
+    logi_error("Snapshot '%s' was written by an incompatible version (layout %u, state of %u B)", filename, header.version, header.state_size);
+    return LION_STATUS_FAILURE;
+  }
+
+  lion_snapshot_t snapshot;
+  int32_t         flags[3];
+  double          dae[4];
+  if (fread(&snapshot.state, sizeof(lion_sim_state_t), 1, f) != 1 || fread(&snapshot.step_size, sizeof(double), 1, f) != 1 ||
+      fread(flags, sizeof(flags), 1, f) != 1 || fread(&snapshot.switched_power, sizeof(double), 1, f) != 1 ||
+      fread(dae, sizeof(dae), 1, f) != 1 || fread(&snapshot.dae_steps, sizeof(uint64_t), 1, f) != 1) {
+    logi_error("Snapshot '%s' is truncated", filename);
+    return LION_STATUS_FAILURE;
+  }
+  snapshot.should_close   = flags[0];
+  snapshot.input_switched = flags[1];
+  snapshot.input_mode     = (lion_input_mode_t)flags[2];
+  snapshot.dae_prev[0]    = dae[0];
+  snapshot.dae_prev[1]    = dae[1];
+  snapshot.dae_h          = dae[2];
+  snapshot.dae_current    = dae[3];
+
+  LION_CALL_I(_snapshot_alloc_events((size_t)header.events_len, &snapshot), "Failed allocating snapshot");
+  if (snapshot.events_len > 0 && fread(snapshot.events, sizeof(lion_snapshot_event_t), snapshot.events_len, f) != snapshot.events_len) {
+    logi_error("Snapshot '%s' is truncated", filename);
+    lion_free(NULL, snapshot.events);
+    return LION_STATUS_FAILURE;
+  }
+  *out = snapshot;
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t lion_snapshot_load(const char *filename, lion_snapshot_t *out) {
+  FILE *f = fopen(filename, "rb");
+  if (f == NULL) {
+    logi_error("Failed opening snapshot file '%s'", filename);
+    return LION_STATUS_FAILURE;
+  }
+  lion_status_t ret = _snapshot_read(f, filename, out);
+  fclose(f);
+  return ret;
+}
+
+lion_status_t lion_snapshot_cleanup(lion_snapshot_t *snapshot) {
+  lion_free(NULL, snapshot->events);
+  snapshot->events     = NULL;
+  snapshot->events_len = 0;
+  return LION_STATUS_SUCCESS;
+}
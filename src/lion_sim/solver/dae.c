@@ -0,0 +1,193 @@
+#include "dae.h"
+
+#include <inttypes.h>
+#include <lion/lion.h>
+#include <lion_math/lion_math.h>
+#include <lion_utils/macros.h>
+#include <lion_utils/vendor/log.h>
+#include <math.h>
+#include <stdbool.h>
+
+// Relative perturbation of the forward differences of the Jacobian
+#define _DAE_FD_EPS 1e-7
+
+typedef struct _dae_step {
+  lion_sim_t *sim;
+  double      h;    // Step size
+  double      beta; // Coefficient of the derivative in the BDF formula
+  double      c[2]; // Combination of the past states in the BDF formula
+} _dae_step_t;
+
+static void _dae_residual(const _dae_step_t *step, const double z[], double r[]) {
+  /*
+     z[0] -> state of charge
+     z[1] -> internal temperature
+     z[2] -> current
+
+     The first two residuals are the BDF formula for the states, and the last
+     one the algebraic constraint, which ties the current to the input
+   */
+  lion_sim_t    *sim    = step->sim;
+  lion_params_t *params = sim->params;
+  lion_eval_t    eval;
+  lion_eval_prepare_table(&eval, sim->table, &sim->_rint_packed, sim->conf->sim_fast_math, z[0], z[1], sim->state.capacity_nominal, params);
+  double current = z[2];
+  double rint    = lion_eval_resistance(&eval, current, params, NULL);
+  double heat    = lion_generated_heat(current, z[1], rint / sim->state.soh, eval.ehc, params);
+
+  r[0] = z[0] - step->c[0] - step->beta * step->h * lion_soc_d(current, eval.capacity_use, params);
+  r[1] = z[1] - step->c[1] - step->beta * step->h * lion_internal_temperature_d(z[1], heat, sim->state.ambient_temperature, params);
+  if (sim->_input_mode == LION_INPUT_MODE_CURRENT) {
+    r[2] = current - sim->state.current;
+  } else {
+    r[2] = eval.open_circuit_voltage * current - rint * current * current - sim->state.power;
+  }
+}
+
+static bool _dae_solve(double a[LION_DAE_DIMENSION][LION_DAE_DIMENSION], double b[LION_DAE_DIMENSION]) {
+  // Gaussian elimination with partial pivoting, leaving the solution in b
+  for (int k = 0; k < LION_DAE_DIMENSION; k++) {
+    int p = k;
+    for (int i = k + 1; i < LION_DAE_DIMENSION; i++) {
+      if (fabs(a[i][k]) > fabs(a[p][k])) {
+        p = i;
+      }
+    }
+    if (a[p][k] == 0.0 || !isfinite(a[p][k])) {
+      return false;
+    }
+    if (p != k) {
+      for (int j = 0; j < LION_DAE_DIMENSION; j++) {
+        double tmp = a[k][j];
+        a[k][j]    = a[p][j];
+        a[p][j]    = tmp;
+      }
+      double tmp = b[k];
+      b[k]       = b[p];
+      b[p]       = tmp;
+    }
+    for (int i = k + 1; i < LION_DAE_DIMENSION; i++) {
+      double m = a[i][k] / a[k][k];
+      for (int j = k; j < LION_DAE_DIMENSION; j++) {
+        a[i][j] -= m * a[k][j];
+      }
+      b[i] -= m * b[k];
+    }
+  }
+  for (int k = LION_DAE_DIMENSION - 1; k >= 0; k--) {
+    double s = b[k];
+    for (int j = k + 1; j < LION_DAE_DIMENSION; j++) {
+      s -= a[k][j] * b[j];
+    }
+    b[k] = s / a[k][k];
+  }
+  return true;
+}
+
+static bool _dae_newton(const _dae_step_t *step, double z[]) {
+  // Newton on the states and the current together, with the Jacobian of the
+  // residuals taken by forward differences
+  double epsabs = step->sim->conf->sim_epsabs;
+  double epsrel = step->sim->conf->sim_epsrel;
+  for (int iter = 0; iter < LION_DAE_MAXITER; iter++) {
+    double r[LION_DAE_DIMENSION];
+    double jac[LION_DAE_DIMENSION][LION_DAE_DIMENSION];
+    _dae_residual(step, z, r);
+    for (int j = 0; j < LION_DAE_DIMENSION; j++) {
+      double zj = z[j];
+      double dz = _DAE_FD_EPS * fmax(fabs(zj), 1.0);
+      double rj[LION_DAE_DIMENSION];
+      z[j] = zj + dz;
+      _dae_residual(step, z, rj);
+      z[j] = zj;
+      for (int i = 0; i < LION_DAE_DIMENSION; i++) {
+        jac[i][j] = (rj[i] - r[i]) / dz;
+      }
+    }
+
+    double dx[LION_DAE_DIMENSION] = {-r[0], -r[1], -r[2]};
+    if (!_dae_solve(jac, dx)) {
+      return false;
+    }
+    bool converged = true;
+    for (int j = 0; j < LION_DAE_DIMENSION; j++) {
+      z[j] += dx[j];
+      if (!isfinite(z[j])) {
+        return false;
+      }
+      if (fabs(dx[j]) > epsabs + epsrel * fabs(z[j])) {
+        converged = false;
+      }
+    }
+    if (converged) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool _dae_bdf(lion_sim_t *sim, double h, double y[], double *current) {
+  // BDF2 once the last step taken had the same size, and BDF1 otherwise. The
+  // predictor extrapolates the history when there is one
+  _dae_step_t step = {.sim = sim, .h = h, .beta = 1.0, .c = {y[0], y[1]}};
+  double      z[LION_DAE_DIMENSION] = {y[0], y[1], *current};
+  if (sim->_dae_steps > 0 && sim->_dae_h == h) {
+    step.beta = 2.0 / 3.0;
+    for (int i = 0; i < 2; i++) {
+      step.c[i] = (4.0 * y[i] - sim->_dae_prev[i]) / 3.0;
+      z[i]      = 2.0 * y[i] - sim->_dae_prev[i];
+    }
+  }
+  if (!_dae_newton(&step, z)) {
+    return false;
+  }
+
+  sim->_dae_prev[0] = y[0];
+  sim->_dae_prev[1] = y[1];
+  sim->_dae_h       = h;
+  sim->_dae_steps++;
+  y[0]     = z[0];
+  y[1]     = z[1];
+  *current = z[2];
+  return true;
+}
+
+void lion_dae_reset(lion_sim_t *sim) { sim->_dae_steps = 0; }
+
+lion_status_t lion_dae_step(lion_sim_t *sim, double step, double state[]) {
+  /*
+     state[0] -> state of charge
+     state[1] -> internal temperature
+
+     Takes the step with the inputs held, splitting it into smaller steps when
+     Newton does not converge. The history is restored before each retry, so
+     that a failed attempt leaves no trace
+  */
+  double   prev[2] = {sim->_dae_prev[0], sim->_dae_prev[1]};
+  double   prev_h  = sim->_dae_h;
+  uint64_t steps   = sim->_dae_steps;
+  for (int split = 0; split <= LION_DAE_MAXSPLIT; split++) {
+    uint64_t n       = UINT64_C(1) << split;
+    double   h       = step / (double)n;
+    double   y[2]    = {state[0], state[1]};
+    double   current = sim->state.current;
+    bool     ok      = true;
+    for (uint64_t k = 0; k < n && ok; k++) {
+      ok = _dae_bdf(sim, h, y, &current);
+    }
+    if (ok) {
+      state[0]          = y[0];
+      state[1]          = y[1];
+      sim->_dae_current = current;
+      return LION_STATUS_SUCCESS;
+    }
+
+    sim->_dae_prev[0] = prev[0];
+    sim->_dae_prev[1] = prev[1];
+    sim->_dae_h       = prev_h;
+    sim->_dae_steps   = steps;
+    logi_debug("DAE step did not converge at t = %f, splitting it in %" PRIu64, sim->state.time, 2 * n);
+  }
+  logi_error("DAE step did not converge at t = %f after %d splits", sim->state.time, LION_DAE_MAXSPLIT);
+  return LION_STATUS_FAILURE;
+}
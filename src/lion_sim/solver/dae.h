@@ -0,0 +1,20 @@
+#pragma once
+
+#include <lion/sim.h>
+#include <lion/status.h>
+
+// Unknowns of the DAE: state of charge, internal temperature and current
+#define LION_DAE_DIMENSION 3
+
+// Maximum Newton iterations of a single BDF step
+#ifndef LION_DAE_MAXITER
+  #define LION_DAE_MAXITER 25
+#endif
+
+// Maximum number of times a step is halved when Newton fails to converge
+#ifndef LION_DAE_MAXSPLIT
+  #define LION_DAE_MAXSPLIT 10
+#endif
+
+void          lion_dae_reset(lion_sim_t *sim);
+lion_status_t lion_dae_step(lion_sim_t *sim, double step, double state[]);
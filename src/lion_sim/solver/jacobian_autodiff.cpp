@@ -0,0 +1,58 @@
+#include "sys.h"
+
+#include <cmath>
+#include <gsl/gsl_errno.h>
+#include <gsl/gsl_matrix.h>
+#include <lion/sim.h>
+#include <lion_math/autodiff/models.hpp>
+
+// Directions of the derivatives: state of charge, internal temperature and current
+using Scalar = lion::ad::Dual<3>;
+
+int lion_slv_jac_autodiff(double t, const double state[], double *dfdy, double dfdt[], void *inputs) {
+  /*
+     Jacobian of the model with the current following the states, as in the
+     analytical one, but taken exactly through the templated models.
+
+     In the power input mode the current is tied to the states through
+     g(I, x) = Voc I - R I^2 - P = 0, so its derivatives follow from the
+     implicit function theorem, dI/dx = -(dg/dx) / (dg/dI), with every partial
+     of g taken in a single pass by seeding the current as a third direction
+   */
+  auto             *p          = static_cast<lion_slv_inputs_t *>(inputs);
+  lion_sim_state_t *sys_state  = p->sys_inputs;
+  lion_params_t    *sys_params = p->sys_params;
+  lion_eval_t      *sys_eval   = p->sys_eval;
+
+  (void)t;
+  Scalar soc         = Scalar::variable(state[0], 0);
+  Scalar temperature = Scalar::variable(state[1], 1);
+  auto   eval        = lion::models::prepare(soc, temperature, sys_state->capacity_nominal, sys_params);
+
+  Scalar current(sys_eval->current);
+  if (p->sys_sim->_input_mode == LION_INPUT_MODE_POWER) {
+    Scalar seeded = Scalar::variable(sys_eval->current, 2);
+    Scalar rint   = lion::models::resistance(eval, seeded, sys_params);
+    Scalar g      = eval.open_circuit_voltage * seeded - rint * seeded * seeded;
+    if (g.d[2] == 0.0 || !std::isfinite(g.d[2])) {
+      return GSL_EBADFUNC;
+    }
+    current.d[0] = -g.d[0] / g.d[2];
+    current.d[1] = -g.d[1] / g.d[2];
+  }
+
+  Scalar rint = lion::models::resistance(eval, current, sys_params);
+  Scalar heat = lion::models::generated_heat(current, temperature, rint / sys_state->soh, eval.ehc);
+  Scalar f0   = lion::models::soc_d(current, eval.capacity_use);
+  Scalar f1   = lion::models::internal_temperature_d(temperature, heat, sys_state->ambient_temperature, sys_params);
+
+  gsl_matrix_view dfdy_mat = gsl_matrix_view_array(dfdy, 2, 2);
+  gsl_matrix     *m        = &dfdy_mat.matrix;
+  gsl_matrix_set(m, 0, 0, f0.d[0]);
+  gsl_matrix_set(m, 0, 1, f0.d[1]);
+  gsl_matrix_set(m, 1, 0, f1.d[0]);
+  gsl_matrix_set(m, 1, 1, f1.d[1]);
+  dfdt[0] = 0.0;
+  dfdt[1] = 0.0;
+  return GSL_SUCCESS;
+}
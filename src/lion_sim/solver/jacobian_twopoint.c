@@ -7,14 +7,14 @@
 
 // TODO: Implement the calculation of the numerical Jacobian
 
-double jac_0_0_2point(lion_sim_state_t *state, lion_params_t *params) { return 0.0; }
+double jac_0_0_2point(lion_sim_state_t *state, lion_eval_t *eval, lion_params_t *params) { return 0.0; }
 
-double jac_0_1_2point(lion_sim_state_t *state, lion_params_t *params) { return 0.0; }
+double jac_0_1_2point(lion_sim_state_t *state, lion_eval_t *eval, lion_params_t *params) { return 0.0; }
 
-double jac_1_0_2point(lion_sim_state_t *state, lion_params_t *params) { return 0.0; }
+double jac_1_0_2point(lion_sim_state_t *state, lion_eval_t *eval, lion_params_t *params) { return 0.0; }
 
-double jac_1_1_2point(lion_sim_state_t *state, lion_params_t *params) { return 0.0; }
+double jac_1_1_2point(lion_sim_state_t *state, lion_eval_t *eval, lion_params_t *params) { return 0.0; }
 
-double jac_0_t_2point(lion_sim_state_t *state, lion_params_t *params) { return 0.0; }
+double jac_0_t_2point(lion_sim_state_t *state, lion_eval_t *eval, lion_params_t *params) { return 0.0; }
 
-double jac_1_t_2point(lion_sim_state_t *state, lion_params_t *params) { return 0.0; }
+double jac_1_t_2point(lion_sim_state_t *state, lion_eval_t *eval, lion_params_t *params) { return 0.0; }
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <lion/params.h>
+
+/*
+   Fixed step kernels of the system with its inputs frozen over the step, as in
+   lion_slv_system_continuous. The derivative of the state of charge is then a
+   constant, which every kernel integrates exactly, and the derivative of the
+   internal temperature is affine in it, f(T) = a - b T, so the right hand side
+   reduces to two coefficients computed once per step
+*/
+
+static inline void lion_slv_temperature_coefs(double heat, double ambient_temperature, lion_params_t *params, double *a, double *b) {
+  double rt = params->temp.rin + params->temp.rout;
+  *b        = 1.0 / (params->temp.cp * rt);
+  *a        = (ambient_temperature / rt + heat) / params->temp.cp;
+}
+
+static inline double lion_slv_kernel_rk2(double t, double a, double b, double h) {
+  // Explicit midpoint
+  double k1 = a - b * t;
+  double k2 = a - b * (t + 0.5 * h * k1);
+  return t + h * k2;
+}
+
+static inline double lion_slv_kernel_heun(double t, double a, double b, double h) {
+  // Explicit trapezoidal
+  double k1 = a - b * t;
+  double k2 = a - b * (t + h * k1);
+  return t + 0.5 * h * (k1 + k2);
+}
+
+static inline double lion_slv_kernel_rk4(double t, double a, double b, double h) {
+  double k1 = a - b * t;
+  double k2 = a - b * (t + 0.5 * h * k1);
+  double k3 = a - b * (t + 0.5 * h * k2);
+  double k4 = a - b * (t + h * k3);
+  return t + h * (k1 + 2.0 * k2 + 2.0 * k3 + k4) / 6.0;
+}
@@ -1,6 +1,8 @@
 #include "sys.h"
 
 #include "jacobian.h"
+#include "kernels.h"
+#include "update.h"
 
 #include <gsl/gsl_matrix.h>
 #include <lion/params.h>
@@ -9,9 +11,12 @@
 #include <lion_math/current.h>
 #include <lion_math/dynamics/soc.h>
 #include <lion_math/dynamics/temperature.h>
+#include <lion_math/eval.h>
+#include <lion_math/generated_heat.h>
 #include <lion_math/internal_resistance.h>
 #include <lion_math/open_circuit.h>
 #include <lion_utils/vendor/log.h>
+#include <math.h>
 
 int lion_slv_system_continuous(double t, const double state[], double out[], void *inputs) {
   /*
@@ -20,32 +25,106 @@ int lion_slv_system_continuous(double t, const double state[], double out[], voi
 
      inputs[0] -> *lion_sim_state_t
      inputs[1] -> *lion_params_t
+     inputs[2] -> *lion_eval_t
    */
   lion_slv_inputs_t *p          = inputs;
   lion_sim_state_t  *sys_inputs = p->sys_inputs;
   lion_params_t     *sys_params = p->sys_params;
+  lion_eval_t       *sys_eval   = p->sys_eval;
 
   (void)t;
-  out[0] = lion_soc_d(sys_inputs->current, sys_inputs->capacity_use, sys_params);
+  out[0] = lion_soc_d(sys_eval->current, sys_eval->capacity_use, sys_params);
   out[1] = lion_internal_temperature_d(state[1], sys_inputs->generated_heat, sys_inputs->ambient_temperature, sys_params);
   return GSL_SUCCESS;
 }
 
+int lion_slv_step_native(lion_sim_t *sim, double step, double state[]) {
+  /*
+     state[0] -> state of charge
+     state[1] -> internal temperature
+
+     Fixed step of lion_slv_system_continuous without going through GSL. The
+     current is frozen, so the state of charge changes linearly, and the
+     internal temperature follows a linear ODE, either solved with the decay
+     factor of the step or integrated with the kernels
+   */
+  double heat = sim->state.generated_heat;
+  double amb  = sim->state.ambient_temperature;
+  double a, b;
+  lion_slv_temperature_coefs(heat, amb, sim->params, &a, &b);
+  switch (sim->conf->sim_stepper) {
+  case LION_STEPPER_EXACT:
+    state[1] = lion_internal_temperature_exact(state[1], heat, amb, sim->_exact_decay, sim->params);
+    break;
+  case LION_STEPPER_NATIVE_RK2:
+    state[1] = lion_slv_kernel_rk2(state[1], a, b, step);
+    break;
+  case LION_STEPPER_NATIVE_HEUN:
+    state[1] = lion_slv_kernel_heun(state[1], a, b, step);
+    break;
+  case LION_STEPPER_NATIVE_RK4:
+    state[1] = lion_slv_kernel_rk4(state[1], a, b, step);
+    break;
+  default:
+    return GSL_EINVAL;
+  }
+  state[0] += step * lion_soc_d(sim->eval.current, sim->eval.capacity_use, sim->params);
+  return GSL_SUCCESS;
+}
+
+int lion_slv_system_adaptive(double t, const double state[], double out[], void *inputs) {
+  /*
+     state[0] -> state of charge
+     state[1] -> internal temperature
+
+     Same system as lion_slv_system_continuous, but the current is re-solved
+     at every trial state instead of being frozen at the start of the step,
+     unless it is the prescribed input.
+     Inputs are held constant, and the current at the start of the step is
+     used as the initial guess so that every trial is solved independently
+   */
+  lion_slv_inputs_t *p          = inputs;
+  lion_sim_state_t  *sys_inputs = p->sys_inputs;
+  lion_params_t     *sys_params = p->sys_params;
+  lion_eval_t       *sys_eval   = p->sys_eval;
+
+  (void)t;
+  lion_eval_prepare_table(
+      sys_eval, p->sys_sim->table, &p->sys_sim->_rint_packed, p->sys_sim->conf->sim_fast_math, state[0], state[1], sys_inputs->capacity_nominal, sys_params
+  );
+  double current = sys_inputs->current;
+  if (p->sys_sim->_input_mode == LION_INPUT_MODE_CURRENT) {
+    lion_eval_finish_current(sys_eval, current, sys_params);
+  } else {
+    if (lion_slv_solve_current(p->sys_sim, sys_eval, sys_inputs->power, sys_inputs->current, &current) != LION_STATUS_SUCCESS || !isfinite(current)) {
+      return GSL_EBADFUNC;
+    }
+    lion_eval_finish(sys_eval, sys_inputs->power, current, sys_inputs->soh, sys_params);
+  }
+
+  double internal_resistance = sys_eval->internal_resistance / sys_inputs->soh;
+  double heat                = lion_generated_heat(current, state[1], internal_resistance, sys_eval->ehc, sys_params);
+  out[0]                     = lion_soc_d(current, sys_eval->capacity_use, sys_params);
+  out[1]                     = lion_internal_temperature_d(state[1], heat, sys_inputs->ambient_temperature, sys_params);
+  return GSL_SUCCESS;
+}
+
 int lion_slv_jac_analytical(double t, const double state[], double *dfdy, double dfdt[], void *inputs) {
   lion_slv_inputs_t *p          = inputs;
   lion_sim_state_t  *sys_state  = p->sys_inputs;
   lion_params_t     *sys_params = p->sys_params;
+  lion_eval_t       *sys_eval   = p->sys_eval;
 
   (void)t;
   gsl_matrix_view dfdy_mat = gsl_matrix_view_array(dfdy, 2, 2);
   gsl_matrix     *m        = &dfdy_mat.matrix;
 
-  double jac00 = jac_0_0_analytical(sys_state, sys_params);
-  double jac01 = jac_0_1_analytical(sys_state, sys_params);
-  double jac10 = jac_1_0_analytical(sys_state, sys_params);
-  double jac11 = jac_1_1_analytical(sys_state, sys_params);
-  double jac0t = jac_0_t_analytical(sys_state, sys_params);
-  double jac1t = jac_1_t_analytical(sys_state, sys_params);
+  double jac00 = jac_0_0_analytical(sys_state, sys_eval, sys_params);
+  double jac01 = jac_0_1_analytical(sys_state, sys_eval, sys_params);
+  double jac10 = jac_1_0_analytical(sys_state, sys_eval, sys_params);
+  double jac11 = jac_1_1_analytical(sys_state, sys_eval, sys_params);
+  double jac0t = jac_0_t_analytical(sys_state, sys_eval, sys_params);
+  double jac1t = jac_1_t_analytical(sys_state, sys_eval, sys_params);
 
   gsl_matrix_set(m, 0, 0, jac00);
   gsl_matrix_set(m, 0, 1, jac01);
@@ -61,17 +140,18 @@ int lion_slv_jac_2point(double t, const double state[], double *dfdy, double dfd
   lion_slv_inputs_t *p          = inputs;
   lion_sim_state_t  *sys_state  = p->sys_inputs;
   lion_params_t     *sys_params = p->sys_params;
+  lion_eval_t       *sys_eval   = p->sys_eval;
 
   (void)t;
   gsl_matrix_view dfdy_mat = gsl_matrix_view_array(dfdy, 2, 2);
   gsl_matrix     *m        = &dfdy_mat.matrix;
 
-  double jac00 = jac_0_0_2point(sys_state, sys_params);
-  double jac01 = jac_0_1_2point(sys_state, sys_params);
-  double jac10 = jac_1_0_2point(sys_state, sys_params);
-  double jac11 = jac_1_1_2point(sys_state, sys_params);
-  double jac0t = jac_0_t_2point(sys_state, sys_params);
-  double jac1t = jac_1_t_2point(sys_state, sys_params);
+  double jac00 = jac_0_0_2point(sys_state, sys_eval, sys_params);
+  double jac01 = jac_0_1_2point(sys_state, sys_eval, sys_params);
+  double jac10 = jac_1_0_2point(sys_state, sys_eval, sys_params);
+  double jac11 = jac_1_1_2point(sys_state, sys_eval, sys_params);
+  double jac0t = jac_0_t_2point(sys_state, sys_eval, sys_params);
+  double jac1t = jac_1_t_2point(sys_state, sys_eval, sys_params);
 
   gsl_matrix_set(m, 0, 0, jac00);
   gsl_matrix_set(m, 0, 1, jac01);
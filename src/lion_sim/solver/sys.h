@@ -1,10 +1,22 @@
 #pragma once
 
 #include <lion/params.h>
+#include <lion/sim.h>
 
 #define LION_SLV_DIMENSION 2
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 int lion_slv_system_continuous(double t, const double state[], double out[], void *inputs);
+int lion_slv_system_adaptive(double t, const double state[], double out[], void *inputs);
+int  lion_slv_step_native(lion_sim_t *sim, double step, double state[]);
 
 int lion_slv_jac_analytical(double t, const double state[], double *dfdy, double dfdt[], void *inputs);
 int lion_slv_jac_2point(double t, const double state[], double *dfdy, double dfdt[], void *inputs);
+int lion_slv_jac_autodiff(double t, const double state[], double *dfdy, double dfdt[], void *inputs);
+
+#ifdef __cplusplus
+}
+#endif
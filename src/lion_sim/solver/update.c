@@ -3,37 +3,92 @@
 #include <lion/lion.h>
 #include <lion_math/lion_math.h>
 #include <lion_utils/macros.h>
+#include <stdbool.h>
 
-lion_status_t lion_slv_update(lion_sim_t *sim) {
-  // This function assumes sim->state.{internal_temperature, soc_nominal}
+lion_status_t lion_slv_solve_current(lion_sim_t *sim, lion_eval_t *eval, double power, double initial_guess, double *out) {
+  // Solves the current drawn at some power for a prepared evaluation context,
+  // without touching the state of the sim
+  double current = initial_guess;
+  int    status  = GSL_FAILURE;
+  switch (sim->conf->sim_current_solver) {
+  case LION_CURRENT_SOLVER_NEWTON:
+    status = lion_current_solve_newton(
+        eval, power, initial_guess, sim->conf->sim_epsabs, sim->conf->sim_epsrel, sim->conf->sim_min_maxiter, sim->params, &current
+    );
+    break;
+  case LION_CURRENT_SOLVER_SECANT:
+    status = lion_current_solve_secant(
+        eval, power, initial_guess, sim->conf->sim_epsabs, sim->conf->sim_epsrel, sim->conf->sim_min_maxiter, sim->params, &current
+    );
+    break;
+  case LION_CURRENT_SOLVER_MINIMIZER:
+    break;
+  default:
+    logi_error("Current solver not valid");
+    return LION_STATUS_FAILURE;
+  }
+  if (status != GSL_SUCCESS) {
+    // Root finders warm-start from the previous current and fall back to the
+    // bracketed minimization whenever they fail to converge
+    if (sim->conf->sim_current_solver != LION_CURRENT_SOLVER_MINIMIZER) {
+      logi_debug("Current solver fell back to minimizer (status=%s)", lion_gsl_errno_name(status));
+    }
+    current = lion_current_optimize(
+        sim->sys_min, eval, power, initial_guess, sim->conf->sim_epsabs, sim->conf->sim_epsrel, sim->conf->sim_min_maxiter, sim->params
+    );
+  }
+  *out = current;
+  return LION_STATUS_SUCCESS;
+}
+
+static lion_status_t _update_state(lion_sim_t *sim, lion_sim_state_t *state, lion_eval_t *eval, bool solved) {
+  // This function assumes state->{internal_temperature, soc_nominal}
   // have been properly set, and spreads those initial values, and it also
-  // assumes that sim->state.{power, ambient_temperature} have been filled with
-  // the corresponding input
-  sim->state.kappa            = lion_kappa(sim->state.internal_temperature, sim->params);
-  sim->state.capacity_nominal = sim->state.soh * sim->params->init.capacity;
-  sim->state.soc_use          = lion_soc_usable(sim->state.soc_nominal, sim->state.kappa, sim->params);
-  sim->state.capacity_use     = lion_capacity_usable(sim->state.capacity_nominal, sim->state.kappa, sim->params);
-  sim->state.ehc              = lion_ehc(sim->state.soc_use, sim->params);
-
-  sim->state.ref_open_circuit_voltage = lion_voc(sim->state.soc_use, sim->params);
-  double voc_delta                    = sim->state.ehc * (sim->state.internal_temperature - sim->params->vft.tref);
-  sim->state.open_circuit_voltage     = sim->state.ref_open_circuit_voltage + voc_delta;
-  sim->state.current                  = lion_current_optimize(
-      sim->sys_min,
-      sim->state.power,
-      sim->state.soc_use,
-      sim->state.open_circuit_voltage,
-      sim->state.current,
-      sim->conf->sim_epsabs,
-      sim->conf->sim_epsrel,
-      sim->conf->sim_min_maxiter,
-      sim->params
+  // assumes that state->{power, ambient_temperature} have been filled with
+  // the corresponding input, or state->current in the current input mode
+  state->capacity_nominal = state->soh * sim->_init.capacity;
+  lion_eval_prepare_table(
+      eval, sim->table, &sim->_rint_packed, sim->conf->sim_fast_math, state->soc_nominal, state->internal_temperature, state->capacity_nominal, sim->params
   );
-  sim->state.internal_resistance = lion_resistance(sim->state.soc_use, sim->state.current, sim->params) / sim->state.soh;
-  sim->state.voltage             = lion_voltage_from_current(sim->state.power, sim->state.current, sim->params);
+  state->kappa                    = eval->kappa;
+  state->soc_use                  = eval->soc_use;
+  state->capacity_use             = eval->capacity_use;
+  state->ehc                      = eval->ehc;
+  state->ref_open_circuit_voltage = eval->ref_open_circuit_voltage;
+  state->open_circuit_voltage     = eval->open_circuit_voltage;
+
+  if (sim->_input_mode == LION_INPUT_MODE_CURRENT) {
+    // state->current holds the prescribed input, so the voltage and power
+    // follow directly from it
+    lion_eval_finish_current(eval, state->current, sim->params);
+    state->internal_resistance = eval->internal_resistance / state->soh;
+    state->voltage             = lion_voltage_from_rint(state->current, state->open_circuit_voltage, eval->internal_resistance, sim->params);
+    state->power               = state->voltage * state->current;
+  } else {
+    double current = state->current;
+    if (!solved) {
+      LION_CALL_I(lion_slv_solve_current(sim, eval, state->power, state->current, &current), "Failed solving current");
+    }
+    lion_eval_finish(eval, state->power, current, state->soh, sim->params);
+    state->current = current;
 
-  sim->state.generated_heat =
-      lion_generated_heat(sim->state.current, sim->state.internal_temperature, sim->state.internal_resistance, sim->state.ehc, sim->params);
-  sim->state.surface_temperature = lion_surface_temperature(sim->state.internal_temperature, sim->state.ambient_temperature, sim->params);
+    state->internal_resistance = eval->internal_resistance / state->soh;
+    state->voltage             = lion_voltage_from_current(state->power, state->current, sim->params);
+  }
+
+  state->generated_heat      = lion_generated_heat(state->current, state->internal_temperature, state->internal_resistance, state->ehc, sim->params);
+  state->surface_temperature = lion_surface_temperature(state->internal_temperature, state->ambient_temperature, sim->params);
   return LION_STATUS_SUCCESS;
 }
+
+lion_status_t lion_slv_update_state(lion_sim_t *sim, lion_sim_state_t *state, lion_eval_t *eval) { return _update_state(sim, state, eval, false); }
+
+lion_status_t lion_slv_update(lion_sim_t *sim) {
+  // The implicit steps solve the current together with the states, so as long
+  // as the inputs are unchanged it already holds at the start of the next step
+  bool solved = sim->conf->sim_step_mode == LION_STEP_MODE_DAE && sim->_dae_steps > 0 && sim->_input_mode == LION_INPUT_MODE_POWER;
+  if (solved) {
+    sim->state.current = sim->_dae_current;
+  }
+  return _update_state(sim, &sim->state, &sim->eval, solved);
+}
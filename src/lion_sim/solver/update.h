@@ -4,3 +4,5 @@
 #include <lion/status.h>
 
 lion_status_t lion_slv_update(lion_sim_t *sim);
+lion_status_t lion_slv_update_state(lion_sim_t *sim, lion_sim_state_t *state, lion_eval_t *eval);
+lion_status_t lion_slv_solve_current(lion_sim_t *sim, lion_eval_t *eval, double power, double initial_guess, double *out);
@@ -0,0 +1,224 @@
+#include "mem.h"
+#include "sim_run.h"
+
+#include <lion/lion.h>
+#include <lion/sweep.h>
+#include <lion_utils/macros.h>
+#include <lion_utils/thread.h>
+#include <lion_utils/vendor/log.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Double-ended queue of job indices owned by a worker. The owner takes jobs
+// from the back while thieves take them from the front
+typedef struct _sweep_deque {
+  lion_mutex_t lock;
+  size_t      *jobs;
+  size_t       head;
+  size_t       tail;
+} _sweep_deque_t;
+
+typedef struct _sweep_ctx {
+  lion_sweep_job_t    *jobs;
+  lion_sweep_result_t *results;
+  _sweep_deque_t      *deques;
+  size_t               workers;
+} _sweep_ctx_t;
+
+typedef struct _sweep_worker {
+  _sweep_ctx_t *ctx;
+  size_t        index;
+  lion_thread_t thread;
+  lion_sim_t    sim;   // Sim reused across the jobs of the worker
+  bool          ready; // Whether the sim is set up
+} _sweep_worker_t;
+
+static bool _sweep_pop(_sweep_deque_t *deque, size_t *out) {
+  bool found = false;
+  lion_mutex_lock(&deque->lock);
+  if (deque->head < deque->tail) {
+    *out  = deque->jobs[--deque->tail];
+    found = true;
+  }
+  lion_mutex_unlock(&deque->lock);
+  return found;
+}
+
+static bool _sweep_steal(_sweep_deque_t *deque, size_t *out) {
+  bool found = false;
+  lion_mutex_lock(&deque->lock);
+  if (deque->head < deque->tail) {
+    *out  = deque->jobs[deque->head++];
+    found = true;
+  }
+  lion_mutex_unlock(&deque->lock);
+  return found;
+}
+
+static bool _sweep_next(_sweep_ctx_t *ctx, size_t worker, size_t *out) {
+  if (_sweep_pop(&ctx->deques[worker], out)) {
+    return true;
+  }
+  // Jobs are never added once the sweep starts, so a full pass over the other
+  // workers without finding anything means the sweep is done for this worker
+  for (size_t k = 1; k < ctx->workers; k++) {
+    if (_sweep_steal(&ctx->deques[(worker + k) % ctx->workers], out)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void _sweep_drop_sim(_sweep_worker_t *worker) {
+  if (worker->ready) {
+    lion_sim_cleanup(&worker->sim);
+    worker->ready = false;
+  }
+}
+
+static lion_status_t _sweep_prepare_sim(_sweep_worker_t *worker, lion_sweep_job_t *job) {
+  // Jobs sharing the configuration of the previous one re-arm its sim with
+  // their parameters, so that the sim, its log file and its startup banner are
+  // only set up once per worker and configuration
+  if (worker->ready && worker->sim.conf == job->conf) {
+    worker->sim.update_hook   = job->update_hook;
+    worker->sim.finished_hook = job->finished_hook;
+    if (lion_sim_rearm(&worker->sim, job->params, NULL) != LION_STATUS_SUCCESS) {
+      logi_error("Failed re-arming sim for sweep job");
+      return LION_STATUS_FAILURE;
+    }
+    return LION_STATUS_SUCCESS;
+  }
+  _sweep_drop_sim(worker);
+
+  // Every sim has its own logger, so nothing is shared between the workers
+  if (lion_sim_new(job->conf, job->params, &worker->sim) != LION_STATUS_SUCCESS) {
+    logi_error("Failed creating sim for sweep job");
+    return LION_STATUS_FAILURE;
+  }
+  worker->ready             = true;
+  worker->sim.update_hook   = job->update_hook;
+  worker->sim.finished_hook = job->finished_hook;
+  if (lion_sim_init(&worker->sim) != LION_STATUS_SUCCESS) {
+    logi_error("Failed initializing sim for sweep job");
+    return LION_STATUS_FAILURE;
+  }
+  return LION_STATUS_SUCCESS;
+}
+
+static lion_status_t _sweep_run_job(_sweep_worker_t *worker, lion_sweep_job_t *job, lion_sweep_result_t *result) {
+  lion_status_t status = _sweep_prepare_sim(worker, job);
+  if (status == LION_STATUS_SUCCESS) {
+    status = lion_sim_simulate_silent(&worker->sim, job->power, job->ambient_temperature);
+  }
+  if (worker->ready) {
+    result->state = worker->sim.state;
+  }
+  if (status != LION_STATUS_SUCCESS) {
+    // A sim which failed is set up anew for the next job
+    _sweep_drop_sim(worker);
+  }
+  return status;
+}
+
+static void *_sweep_worker(void *arg) {
+  _sweep_worker_t *worker = arg;
+  _sweep_ctx_t    *ctx    = worker->ctx;
+
+  size_t job;
+  while (_sweep_next(ctx, worker->index, &job)) {
+    lion_sweep_result_t *result = &ctx->results[job];
+    result->worker              = worker->index;
+    result->status              = _sweep_run_job(worker, &ctx->jobs[job], result);
+  }
+  _sweep_drop_sim(worker);
+  return NULL;
+}
+
+size_t lion_sweep_default_threads(void) { return lion_cpu_count(); }
+
+lion_status_t lion_sweep_run(lion_sweep_job_t *jobs, size_t count, size_t threads, lion_sweep_result_t *results) {
+  if (count == 0) {
+    return LION_STATUS_SUCCESS;
+  }
+  if (threads == 0) {
+    threads = lion_sweep_default_threads();
+  }
+  if (threads > count) {
+    threads = count;
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (jobs[i].power == NULL || jobs[i].ambient_temperature == NULL) {
+      logi_error("Sweep job %zu has no inputs", i);
+      return LION_STATUS_FAILURE;
+    }
+    results[i].status = LION_STATUS_FAILURE;
+  }
+
+  _sweep_deque_t  *deques  = lion_calloc(NULL, threads, sizeof(_sweep_deque_t));
+  _sweep_worker_t *workers = lion_calloc(NULL, threads, sizeof(_sweep_worker_t));
+  size_t          *order   = lion_malloc(NULL, count * sizeof(size_t));
+  if (deques == NULL || workers == NULL || order == NULL) {
+    logi_error("Failed allocating sweep of %zu jobs", count);
+    lion_free(NULL, deques);
+    lion_free(NULL, workers);
+    lion_free(NULL, order);
+    return LION_STATUS_FAILURE;
+  }
+
+  _sweep_ctx_t ctx = {
+    .jobs    = jobs,
+    .results = results,
+    .deques  = deques,
+    .workers = threads,
+  };
+
+  // Hand out contiguous ranges of jobs, owners run them in order from the
+  // front of their range while thieves take them from the back
+  for (size_t w = 0; w < threads; w++) {
+    size_t begin = w * count / threads;
+    size_t end   = (w + 1) * count / threads;
+    for (size_t i = begin; i < end; i++) {
+      order[i] = end - 1 - (i - begin);
+    }
+    deques[w].jobs = &order[begin];
+    deques[w].head = 0;
+    deques[w].tail = end - begin;
+    lion_mutex_init(&deques[w].lock);
+  }
+
+  logi_info("Running sweep of %zu jobs on %zu threads", count, threads);
+
+  size_t started = 0;
+  for (size_t w = 0; w < threads; w++) {
+    workers[w].ctx   = &ctx;
+    workers[w].index = w;
+    if (lion_thread_create(&workers[w].thread, _sweep_worker, &workers[w]) != LION_STATUS_SUCCESS) {
+      logi_error("Failed creating sweep worker %zu", w);
+      break;
+    }
+    started++;
+  }
+  if (started == 0) {
+    // Run everything in the calling thread as a last resort, stealing drains
+    // the ranges of the workers that could not be started
+    _sweep_worker(&workers[0]);
+  }
+  for (size_t w = 0; w < started; w++) {
+    lion_thread_join(&workers[w].thread);
+  }
+
+  for (size_t w = 0; w < threads; w++) {
+    lion_mutex_destroy(&deques[w].lock);
+  }
+  lion_free(NULL, deques);
+  lion_free(NULL, workers);
+  lion_free(NULL, order);
+
+  size_t failed = 0;
+  for (size_t i = 0; i < count; i++) {
+    failed += (results[i].status != LION_STATUS_SUCCESS);
+  }
+  logi_info("Finished sweep, %zu of %zu jobs failed", failed, count);
+  return LION_STATUS_SUCCESS;
+}
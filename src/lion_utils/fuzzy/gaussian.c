@@ -7,3 +7,8 @@ double lion_mf_gaussian(double x, lion_mf_gaussian_params_t *params) {
   double den = gsl_pow_2(params->sigma);
   return exp(-num / den);
 }
+
+double lion_mf_gaussian_grad(double x, lion_mf_gaussian_params_t *params) {
+  double coeff = (x - params->mean) / gsl_pow_2(params->sigma);
+  return -coeff * lion_mf_gaussian(x, params);
+}
@@ -6,3 +6,8 @@ double lion_mf_sigmoid(double x, lion_mf_sigmoid_params_t *params) {
   double denominator = 1 + exp(exp_term);
   return 1 / denominator;
 }
+
+double lion_mf_sigmoid_grad(double x, lion_mf_sigmoid_params_t *params) {
+  double mf = lion_mf_sigmoid(x, params);
+  return params->a * mf * (1 - mf);
+}
@@ -0,0 +1,99 @@
+#include "isa.h"
+
+#include "thread.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(LION_SIMD_DISPATCH) && defined(_MSC_VER)
+  #include <immintrin.h>
+  #include <intrin.h>
+#endif
+
+/*
+   The CPU is probed once, on the first call, and the SIMD kernels follow the
+   best level it supports unless LION_ISA_ENV names a lower one. Without
+   LION_SIMD_DISPATCH the kernels are only built once, for the flags of the
+   build, and the level stays at scalar
+*/
+
+static lion_once_t _isa_once      = LION_ONCE_INIT;
+static lion_isa_t  _isa_supported = LION_ISA_SCALAR;
+static lion_isa_t  _isa_active    = LION_ISA_SCALAR;
+
+static const char *_isa_names[LION_ISA_COUNT] = {"scalar", "avx2", "avx512"};
+
+const char *lion_isa_name(lion_isa_t isa) {
+  if ((int)isa < 0 || isa >= LION_ISA_COUNT) {
+    return "unknown";
+  }
+  return _isa_names[isa];
+}
+
+static lion_isa_t _isa_detect(void) {
+#if defined(LION_SIMD_DISPATCH) && (defined(__GNUC__) || defined(__clang__))
+  // Also checks that the OS saves the wide registers
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return LION_ISA_AVX512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return LION_ISA_AVX2;
+  }
+#elif defined(LION_SIMD_DISPATCH) && defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 1);
+  int fma     = (info[2] >> 12) & 1;
+  int osxsave = (info[2] >> 27) & 1;
+  if (!osxsave) {
+    return LION_ISA_SCALAR;
+  }
+  unsigned long long xcr0 = _xgetbv(0);
+  __cpuidex(info, 7, 0);
+  int avx2    = (info[1] >> 5) & 1;
+  int avx512f = (info[1] >> 16) & 1;
+  // The YMM state for AVX2, and the opmask and ZMM states on top for AVX-512
+  if (avx512f && (xcr0 & 0xe6) == 0xe6) {
+    return LION_ISA_AVX512;
+  }
+  if (avx2 && fma && (xcr0 & 0x6) == 0x6) {
+    return LION_ISA_AVX2;
+  }
+#endif
+  return LION_ISA_SCALAR;
+}
+
+static void _isa_init(void) {
+  _isa_supported = _isa_detect();
+  _isa_active    = _isa_supported;
+
+  // Levels above the supported one are ignored, as are unknown names
+  const char *forced = getenv(LION_ISA_ENV);
+  if (forced == NULL) {
+    return;
+  }
+  for (int i = 0; i < LION_ISA_COUNT; i++) {
+    if (strcmp(forced, _isa_names[i]) == 0 && (lion_isa_t)i <= _isa_supported) {
+      _isa_active = (lion_isa_t)i;
+    }
+  }
+}
+
+lion_isa_t lion_isa_supported(void) {
+  lion_call_once(&_isa_once, _isa_init);
+  return _isa_supported;
+}
+
+lion_isa_t lion_isa_active(void) {
+  lion_call_once(&_isa_once, _isa_init);
+  return _isa_active;
+}
+
+lion_status_t lion_isa_force(lion_isa_t isa) {
+  // Meant for reproducibility tests, and not synchronized with running sims
+  if ((int)isa < 0 || isa > lion_isa_supported()) {
+    return LION_STATUS_FAILURE;
+  }
+  _isa_active = isa;
+  return LION_STATUS_SUCCESS;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <lion/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Environment variable forcing the instruction set of the SIMD kernels, by
+// the name of the level
+#define LION_ISA_ENV "LION_ISA"
+
+// Instruction set levels of the SIMD kernels, each one implying the previous
+typedef enum lion_isa {
+  LION_ISA_SCALAR = 0,
+  LION_ISA_AVX2   = 1,
+  LION_ISA_AVX512 = 2,
+} lion_isa_t;
+
+#define LION_ISA_COUNT 3
+
+const char   *lion_isa_name(lion_isa_t isa);
+lion_isa_t    lion_isa_supported(void);
+lion_isa_t    lion_isa_active(void);
+lion_status_t lion_isa_force(lion_isa_t isa);
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,6 +6,13 @@
 #include <lion/status.h>
 #include <lionu/macros.h>
 
+// Evaluate x with the given logger selected for the calling thread and return its status
+#define LION_RETURN_WITH_LOGGER_I(logger, x)                                                                                                         \
+  log_Logger   *_prev_logger = log_set_thread_logger(logger);                                                                                        \
+  lion_status_t _ret         = x;                                                                                                                    \
+  log_set_thread_logger(_prev_logger);                                                                                                               \
+  return _ret
+
 #define LION_CALL_I(x, msg)                                                                                                                          \
   if (x != LION_STATUS_SUCCESS) {                                                                                                                    \
     logi_error(msg);                                                                                                                                 \
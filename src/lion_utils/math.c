@@ -1,4 +1,3 @@
-#include <gsl/gsl_math.h>
 #include <lionu/math.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -25,10 +24,11 @@
   }
 
 #define _POLYVAL_GENERATOR(T, S)                                                                                                                     \
+  /* Horner scheme, from the highest power down */                                                                                                   \
   T lion_polyval_##S(T x, T *coeffs, u32 count) {                                                                                                    \
     T res = 0;                                                                                                                                       \
-    for (u32 i = 0; i < count; i++) {                                                                                                                \
-      res += coeffs[i] * gsl_pow_uint(x, i);                                                                                                         \
+    for (u32 i = count; i-- > 0;) {                                                                                                                  \
+      res = (T)(res * x + coeffs[i]);                                                                                                                \
     }                                                                                                                                                \
     return res;                                                                                                                                      \
   }
@@ -0,0 +1,81 @@
+#include "thread.h"
+
+#ifndef _WIN32
+  #include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+static DWORD WINAPI _thread_trampoline(LPVOID arg) {
+  lion_thread_t *thread = arg;
+  thread->fn(thread->arg);
+  return 0;
+}
+
+lion_status_t lion_thread_create(lion_thread_t *thread, lion_thread_fn fn, void *arg) {
+  thread->fn     = fn;
+  thread->arg    = arg;
+  thread->handle = CreateThread(NULL, 0, _thread_trampoline, thread, 0, NULL);
+  return (thread->handle != NULL) ? LION_STATUS_SUCCESS : LION_STATUS_FAILURE;
+}
+
+lion_status_t lion_thread_join(lion_thread_t *thread) {
+  if (WaitForSingleObject(thread->handle, INFINITE) != WAIT_OBJECT_0) {
+    return LION_STATUS_FAILURE;
+  }
+  CloseHandle(thread->handle);
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t lion_mutex_init(lion_mutex_t *mutex) {
+  InitializeCriticalSection(&mutex->handle);
+  return LION_STATUS_SUCCESS;
+}
+
+void lion_mutex_lock(lion_mutex_t *mutex) { EnterCriticalSection(&mutex->handle); }
+
+void lion_mutex_unlock(lion_mutex_t *mutex) { LeaveCriticalSection(&mutex->handle); }
+
+void lion_mutex_destroy(lion_mutex_t *mutex) { DeleteCriticalSection(&mutex->handle); }
+
+static BOOL CALLBACK _once_trampoline(PINIT_ONCE once, PVOID fn, PVOID *ctx) {
+  ((void (*)(void))fn)();
+  return TRUE;
+}
+
+void lion_call_once(lion_once_t *once, void (*fn)(void)) { InitOnceExecuteOnce(&once->handle, _once_trampoline, (PVOID)fn, NULL); }
+
+size_t lion_cpu_count(void) {
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return (info.dwNumberOfProcessors > 0) ? (size_t)info.dwNumberOfProcessors : 1;
+}
+
+#else
+
+lion_status_t lion_thread_create(lion_thread_t *thread, lion_thread_fn fn, void *arg) {
+  thread->fn  = fn;
+  thread->arg = arg;
+  return (pthread_create(&thread->handle, NULL, fn, arg) == 0) ? LION_STATUS_SUCCESS : LION_STATUS_FAILURE;
+}
+
+lion_status_t lion_thread_join(lion_thread_t *thread) { return (pthread_join(thread->handle, NULL) == 0) ? LION_STATUS_SUCCESS : LION_STATUS_FAILURE; }
+
+lion_status_t lion_mutex_init(lion_mutex_t *mutex) {
+  return (pthread_mutex_init(&mutex->handle, NULL) == 0) ? LION_STATUS_SUCCESS : LION_STATUS_FAILURE;
+}
+
+void lion_mutex_lock(lion_mutex_t *mutex) { pthread_mutex_lock(&mutex->handle); }
+
+void lion_mutex_unlock(lion_mutex_t *mutex) { pthread_mutex_unlock(&mutex->handle); }
+
+void lion_mutex_destroy(lion_mutex_t *mutex) { pthread_mutex_destroy(&mutex->handle); }
+
+void lion_call_once(lion_once_t *once, void (*fn)(void)) { pthread_once(&once->handle, fn); }
+
+size_t lion_cpu_count(void) {
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return (count > 0) ? (size_t)count : 1;
+}
+
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <lion/status.h>
+#include <stddef.h>
+
+#ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #include <windows.h>
+#else
+  #include <pthread.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void *(*lion_thread_fn)(void *arg);
+
+typedef struct lion_thread {
+#ifdef _WIN32
+  HANDLE handle;
+#else
+  pthread_t handle;
+#endif
+  lion_thread_fn fn;
+  void          *arg;
+} lion_thread_t;
+
+typedef struct lion_mutex {
+#ifdef _WIN32
+  CRITICAL_SECTION handle;
+#else
+  pthread_mutex_t handle;
+#endif
+} lion_mutex_t;
+
+typedef struct lion_once {
+#ifdef _WIN32
+  INIT_ONCE handle;
+#else
+  pthread_once_t handle;
+#endif
+} lion_once_t;
+
+#ifdef _WIN32
+  #define LION_ONCE_INIT {INIT_ONCE_STATIC_INIT}
+#else
+  #define LION_ONCE_INIT {PTHREAD_ONCE_INIT}
+#endif
+
+lion_status_t lion_thread_create(lion_thread_t *thread, lion_thread_fn fn, void *arg);
+lion_status_t lion_thread_join(lion_thread_t *thread);
+
+lion_status_t lion_mutex_init(lion_mutex_t *mutex);
+void          lion_mutex_lock(lion_mutex_t *mutex);
+void          lion_mutex_unlock(lion_mutex_t *mutex);
+void          lion_mutex_destroy(lion_mutex_t *mutex);
+
+void lion_call_once(lion_once_t *once, void (*fn)(void));
+
+size_t lion_cpu_count(void);
+
+#ifdef __cplusplus
+}
+#endif
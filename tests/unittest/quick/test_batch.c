@@ -0,0 +1,173 @@
+#include <lion/lion.h>
+#include <lion_math/lion_math.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+#include <math.h>
+
+#define TEST_BATCH_CELLS 6
+#define TEST_BATCH_STEPS 500
+#define TEST_BATCH_TOL   1e-6
+
+static double test_power(size_t cell, uint64_t step) { return 2.0 + (double)cell - 4.0 * (double)((step / 100) % 2); }
+
+static double test_ambient_temperature(size_t cell, uint64_t step) { return 293.15 + (double)cell; }
+
+static lion_params_t test_params(size_t cell) {
+  lion_params_t params = lion_params_default();
+  params.init.soc      = 0.4 + 0.1 * (double)cell;
+  if (cell % 2) {
+    params.rint.model               = LION_RINT_MODEL_POLARIZATION;
+    params.rint.params.polarization = lion_params_default_rint_polarization();
+  }
+  return params;
+}
+
+lion_status_t test_batch_matches_sim(lion_sim_t *sim) {
+  // Every cell of the batch must follow the same trajectory as a standalone sim
+  lion_sim_config_t conf = lion_sim_config_default();
+  conf.log_stdlvl        = LOG_ERROR;
+  conf.sim_stepper       = LION_STEPPER_RK4;
+  conf.sim_step_seconds  = 1.0;
+
+  lion_params_t params[TEST_BATCH_CELLS];
+  lion_sim_t    sims[TEST_BATCH_CELLS];
+  for (size_t i = 0; i < TEST_BATCH_CELLS; i++) {
+    params[i] = test_params(i);
+    LION_CALL(lion_sim_new(&conf, &params[i], &sims[i]), "Failed creating sim");
+    LION_CALL(lion_sim_init(&sims[i]), "Failed initializing sim");
+  }
+
+  lion_batch_t batch;
+  LION_CALL(lion_batch_new(&conf, params, TEST_BATCH_CELLS, TEST_BATCH_CELLS, &batch), "Failed creating batch");
+  LION_CALL(lion_batch_init(&batch), "Failed initializing batch");
+
+  double power[TEST_BATCH_CELLS];
+  double amb_temp[TEST_BATCH_CELLS];
+  for (uint64_t k = 0; k < TEST_BATCH_STEPS; k++) {
+    for (size_t i = 0; i < TEST_BATCH_CELLS; i++) {
+      power[i]    = test_power(i, k);
+      amb_temp[i] = test_ambient_temperature(i, k);
+      LION_CALL(lion_sim_step(&sims[i], power[i], amb_temp[i]), "Failed stepping sim");
+    }
+    LION_CALL(lion_batch_step(&batch, power, amb_temp), "Failed stepping batch");
+  }
+
+  for (size_t i = 0; i < TEST_BATCH_CELLS; i++) {
+    LION_ASSERT(fabs(batch.soc_nominal[i] - sims[i].state.soc_nominal) < TEST_BATCH_TOL);
+    LION_ASSERT(fabs(batch.internal_temperature[i] - sims[i].state.internal_temperature) < TEST_BATCH_TOL);
+    LION_ASSERT(fabs(batch.current[i] - sims[i].state.current) < TEST_BATCH_TOL);
+    LION_ASSERT(fabs(batch.voltage[i] - sims[i].state.voltage) < TEST_BATCH_TOL);
+    LION_CALL(lion_sim_cleanup(&sims[i]), "Failed cleaning up sim");
+  }
+  LION_CALL(lion_batch_cleanup(&batch), "Failed cleaning up batch");
+  return TEST_PASS;
+}
+
+lion_status_t test_batch_shared_params(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_stepper         = LION_STEPPER_EXACT;
+  lion_params_t     params = lion_params_default();
+
+  lion_batch_t batch;
+  LION_ASSERT_FAILS(lion_batch_new(&conf, &params, 2, TEST_BATCH_CELLS, &batch));
+  LION_CALL(lion_batch_new(&conf, &params, 1, TEST_BATCH_CELLS, &batch), "Failed creating batch");
+  LION_CALL(lion_batch_init(&batch), "Failed initializing batch");
+
+  double power[TEST_BATCH_CELLS];
+  double amb_temp[TEST_BATCH_CELLS];
+  for (size_t i = 0; i < TEST_BATCH_CELLS; i++) {
+    power[i]    = 5.0;
+    amb_temp[i] = 298.15;
+  }
+  for (uint64_t k = 0; k < TEST_BATCH_STEPS; k++) {
+    LION_CALL(lion_batch_step(&batch, power, amb_temp), "Failed stepping batch");
+  }
+
+  // Identical inputs and parameters must give identical cells
+  for (size_t i = 1; i < TEST_BATCH_CELLS; i++) {
+    LION_ASSERT_EQF(batch.soc_nominal[i], batch.soc_nominal[0]);
+    LION_ASSERT_EQF(batch.internal_temperature[i], batch.internal_temperature[0]);
+  }
+  LION_ASSERT(batch.soc_nominal[0] < params.init.soc);
+  LION_ASSERT_EQI(batch.step, TEST_BATCH_STEPS);
+  LION_CALL(lion_batch_cleanup(&batch), "Failed cleaning up batch");
+  return TEST_PASS;
+}
+
+lion_status_t test_batch_clamp(lion_sim_t *sim) {
+  // The second cell draws a current past the bracket of the solver, where the
+  // Newton steps stall on the bound. It must go through the same fallback as a
+  // standalone sim instead of being taken as converged on the bound
+  lion_sim_config_t conf = lion_sim_config_default();
+  conf.log_stdlvl        = LOG_ERROR;
+  conf.sim_stepper       = LION_STEPPER_RK4;
+  conf.sim_step_seconds  = 1.0;
+
+  lion_params_t params[2];
+  lion_sim_t    sims[2];
+  double        power[2]    = {5.0, 5e3};
+  double        amb_temp[2] = {298.15, 298.15};
+  for (size_t i = 0; i < 2; i++) {
+    params[i]                                       = lion_params_default();
+    params[i].rint.params.fixed.internal_resistance = 1e-4;
+    LION_CALL(lion_sim_new(&conf, &params[i], &sims[i]), "Failed creating sim");
+    LION_CALL(lion_sim_init(&sims[i]), "Failed initializing sim");
+    LION_CALL(lion_sim_step(&sims[i], power[i], amb_temp[i]), "Failed stepping sim");
+  }
+
+  lion_batch_t batch;
+  LION_CALL(lion_batch_new(&conf, params, 2, 2, &batch), "Failed creating batch");
+  LION_CALL(lion_batch_init(&batch), "Failed initializing batch");
+  LION_CALL(lion_batch_step(&batch, power, amb_temp), "Failed stepping batch");
+
+  LION_ASSERT(sims[1].state.current != LION_CURRENT_OPTMAX);
+  for (size_t i = 0; i < 2; i++) {
+    LION_ASSERT(fabs(batch.current[i] - sims[i].state.current) < TEST_BATCH_TOL);
+    LION_CALL(lion_sim_cleanup(&sims[i]), "Failed cleaning up sim");
+  }
+  LION_CALL(lion_batch_cleanup(&batch), "Failed cleaning up batch");
+  return TEST_PASS;
+}
+
+lion_status_t test_batch_unsupported_config(lion_sim_t *sim) {
+  // Settings the batch does not implement are rejected, both when creating it
+  // and when the shared configuration changes afterwards
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_stepper         = LION_STEPPER_RK4;
+  lion_params_t     params = lion_params_default();
+
+  lion_batch_t batch;
+  conf.sim_step_mode = LION_STEP_MODE_ADAPTIVE;
+  LION_ASSERT_FAILS(lion_batch_new(&conf, &params, 1, 1, &batch));
+  conf.sim_step_mode     = LION_STEP_MODE_FIXED;
+  conf.sim_model_backend = LION_MODEL_BACKEND_TABLE;
+  LION_ASSERT_FAILS(lion_batch_new(&conf, &params, 1, 1, &batch));
+  conf.sim_model_backend = LION_MODEL_BACKEND_ANALYTIC;
+  conf.sim_stepper       = LION_STEPPER_RKF45;
+  LION_ASSERT_FAILS(lion_batch_new(&conf, &params, 1, 1, &batch));
+
+  conf.sim_stepper = LION_STEPPER_NATIVE_HEUN;
+  LION_CALL(lion_batch_new(&conf, &params, 1, 1, &batch), "Failed creating batch");
+  LION_CALL(lion_batch_init(&batch), "Failed initializing batch");
+
+  double power    = 5.0;
+  double amb_temp = 298.15;
+  LION_CALL(lion_batch_step(&batch, &power, &amb_temp), "Failed stepping batch");
+  conf.sim_step_mode = LION_STEP_MODE_DAE;
+  LION_ASSERT_FAILS(lion_batch_step(&batch, &power, &amb_temp));
+  LION_ASSERT_EQI(batch.step, 1);
+  LION_CALL(lion_batch_cleanup(&batch), "Failed cleaning up batch");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_batch_matches_sim);
+  LION_CALL_TEST(NULL, test_batch_shared_params);
+  LION_CALL_TEST(NULL, test_batch_clamp);
+  LION_CALL_TEST(NULL, test_batch_unsupported_config);
+
+  return TEST_PASS;
+}
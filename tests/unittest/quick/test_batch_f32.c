@@ -0,0 +1,154 @@
+#include <lion/batch.h>
+#include <lion/lion.h>
+#include <lion_math/kernels/kernels.h>
+#include <lion_math/lion_math.h>
+#include <lion_utils/isa.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+#include <math.h>
+
+#define TEST_F32_N          97
+#define TEST_F32_KERNEL_TOL 1e-6
+
+// Same cells as examples/lab_240716, over the 7500 s of its run. The measured
+// profiles are not part of the tree, so they are replaced by a charge at
+// constant power, a standby load and a pulsed discharge, with every cell
+// slightly off the others
+#define TEST_LAB_CELLS    16
+#define TEST_LAB_STEPS    7500
+#define TEST_LAB_SOC_TOL  1e-4
+#define TEST_LAB_TEMP_TOL 2e-2
+#define TEST_LAB_REL_TOL  2e-5
+
+static double relative_error(double value, double exact) { return fabs(value - exact) / fmax(fabs(exact), 1e-300); }
+
+static lion_params_t test_lab_params(size_t cell) {
+  lion_params_t params            = lion_params_default();
+  params.init.soc                 = 0.1 + 0.005 * (double)cell;
+  params.init.temp_in             = 296.0;
+  params.init.soh                 = 1.0;
+  params.init.capacity            = 14400.0;
+  params.init.current_guess       = 10.0;
+  params.rint.model               = LION_RINT_MODEL_POLARIZATION;
+  params.rint.params.polarization = lion_params_default_rint_polarization();
+  return params;
+}
+
+static double test_lab_power(size_t cell, uint64_t step) {
+  double scale = 1.0 + 0.02 * (double)cell;
+  if (step < 3600) {
+    return -9.0 * scale;
+  }
+  if (step < 4200) {
+    return 0.5 * scale;
+  }
+  return (((step - 4200) / 60) % 2 ? 3.0 : 12.0) * scale;
+}
+
+static double test_lab_ambient_temperature(size_t cell, uint64_t step) { return 296.0 + 0.25 * (double)cell; }
+
+lion_status_t test_kernels_f32(lion_sim_t *sim) {
+  // Every level the CPU supports matches the double precision models
+  lion_params_t params            = lion_params_default();
+  params.rint.model               = LION_RINT_MODEL_POLARIZATION;
+  params.rint.params.polarization = lion_params_default_rint_polarization();
+  lion_isa_t active               = lion_isa_active();
+  double     ehc_scale            = 0.0;
+
+  lion_rint_packed_f32_t packed;
+  double                 polys[LION_FUZZY_SETS_COUNT];
+  float                  polys_f32[LION_FUZZY_SETS_COUNT];
+  double                 kappa[TEST_F32_N], ehc[TEST_F32_N], voc[TEST_F32_N], rint[TEST_F32_N];
+  float                  temperature[TEST_F32_N], soc[TEST_F32_N], current[TEST_F32_N], out[TEST_F32_N];
+  lion_resistance_pack_f32(&params, &packed);
+  lion_resistance_polarization_polys(0.6, &params, polys);
+  for (size_t i = 0; i < TEST_F32_N; i++) {
+    temperature[i] = (float)(233.15 + 120.0 * (double)i / (TEST_F32_N - 1));
+    soc[i]         = (float)(0.02 + 0.98 * (double)i / (TEST_F32_N - 1));
+    current[i]     = (float)(-60.0 + 120.0 * (double)i / (TEST_F32_N - 1));
+    kappa[i]       = lion_kappa(temperature[i], &params);
+    ehc[i]         = lion_ehc(soc[i], &params);
+    voc[i]         = lion_voc(soc[i], &params);
+    rint[i]        = lion_resistance_polarization_from_polys(polys, current[i], &params, NULL);
+    ehc_scale      = fmax(ehc_scale, fabs(ehc[i]));
+  }
+
+  for (int level = LION_ISA_SCALAR; level <= (int)lion_isa_supported(); level++) {
+    LION_CALL(lion_isa_force((lion_isa_t)level), "Failed forcing instruction set");
+    const lion_kernels_f32_t *kernels = lion_kernels_f32();
+    kernels->kappa_n(temperature, TEST_F32_N, &params, out);
+    for (size_t i = 0; i < TEST_F32_N; i++) {
+      LION_ASSERT(relative_error(out[i], kappa[i]) < TEST_F32_KERNEL_TOL);
+    }
+    kernels->ehc_n(soc, TEST_F32_N, &params, out);
+    for (size_t i = 0; i < TEST_F32_N; i++) {
+      // The entropic heat coefficient crosses zero, so its error is taken
+      // relative to its range
+      LION_ASSERT(fabs(out[i] - ehc[i]) < TEST_F32_KERNEL_TOL * ehc_scale);
+    }
+    kernels->voc_n(soc, TEST_F32_N, &params, out);
+    for (size_t i = 0; i < TEST_F32_N; i++) {
+      LION_ASSERT(relative_error(out[i], voc[i]) < TEST_F32_KERNEL_TOL);
+    }
+    kernels->resistance_packed_polys(&packed, 0.6f, polys_f32);
+    kernels->resistance_packed_n(&packed, polys_f32, current, TEST_F32_N, out, NULL);
+    for (size_t i = 0; i < TEST_F32_N; i++) {
+      LION_ASSERT(relative_error(out[i], rint[i]) < TEST_F32_KERNEL_TOL);
+      LION_ASSERT(relative_error(kernels->resistance_packed(&packed, polys_f32, current[i], NULL), rint[i]) < TEST_F32_KERNEL_TOL);
+    }
+  }
+  LION_CALL(lion_isa_force(active), "Failed restoring instruction set");
+  return TEST_PASS;
+}
+
+lion_status_t test_batch_f32_lab_240716(lion_sim_t *sim) {
+  // The single precision batch follows the double one through the whole run
+  lion_sim_config_t conf = lion_sim_config_default();
+  conf.log_stdlvl        = LOG_ERROR;
+  conf.sim_stepper       = LION_STEPPER_RK4;
+  conf.sim_step_seconds  = 1.0;
+
+  lion_params_t params[TEST_LAB_CELLS];
+  for (size_t i = 0; i < TEST_LAB_CELLS; i++) {
+    params[i] = test_lab_params(i);
+  }
+
+  lion_batch_t     batch;
+  lion_batch_f32_t batch_f32;
+  LION_CALL(lion_batch_new(&conf, params, TEST_LAB_CELLS, TEST_LAB_CELLS, &batch), "Failed creating batch");
+  LION_CALL(lion_batch_init(&batch), "Failed initializing batch");
+  LION_CALL(lion_batch_f32_new(&conf, params, TEST_LAB_CELLS, TEST_LAB_CELLS, &batch_f32), "Failed creating single precision batch");
+  LION_CALL(lion_batch_f32_init(&batch_f32), "Failed initializing single precision batch");
+
+  double power[TEST_LAB_CELLS], amb_temp[TEST_LAB_CELLS];
+  float  power_f32[TEST_LAB_CELLS], amb_temp_f32[TEST_LAB_CELLS];
+  for (uint64_t k = 0; k < TEST_LAB_STEPS; k++) {
+    for (size_t i = 0; i < TEST_LAB_CELLS; i++) {
+      power[i]        = test_lab_power(i, k);
+      amb_temp[i]     = test_lab_ambient_temperature(i, k);
+      power_f32[i]    = (float)power[i];
+      amb_temp_f32[i] = (float)amb_temp[i];
+    }
+    LION_CALL(lion_batch_step(&batch, power, amb_temp), "Failed stepping batch");
+    LION_CALL(lion_batch_f32_step(&batch_f32, power_f32, amb_temp_f32), "Failed stepping single precision batch");
+
+    for (size_t i = 0; i < TEST_LAB_CELLS; i++) {
+      LION_ASSERT(fabs(batch_f32.soc_nominal[i] - batch.soc_nominal[i]) < TEST_LAB_SOC_TOL);
+      LION_ASSERT(fabs(batch_f32.internal_temperature[i] - batch.internal_temperature[i]) < TEST_LAB_TEMP_TOL);
+      LION_ASSERT(relative_error(batch_f32.voltage[i], batch.voltage[i]) < TEST_LAB_REL_TOL);
+      LION_ASSERT(fabs(batch_f32.current[i] - batch.current[i]) < TEST_LAB_REL_TOL * fmax(fabs(batch.current[i]), 1.0));
+    }
+  }
+
+  LION_CALL(lion_batch_cleanup(&batch), "Failed cleaning up batch");
+  LION_CALL(lion_batch_f32_cleanup(&batch_f32), "Failed cleaning up single precision batch");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_kernels_f32);
+  LION_CALL_TEST(NULL, test_batch_f32_lab_240716);
+
+  return TEST_PASS;
+}
@@ -0,0 +1,198 @@
+#include <lion/lion.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+#include <math.h>
+
+#define TEST_EVENT_STEPS  2000
+#define TEST_EVENT_POWER  8.0
+#define TEST_EVENT_CUTOFF 3.6
+#define TEST_EVENT_SOC    0.5
+
+static lion_status_t test_inputs(double power, lion_vector_t *power_vec, lion_vector_t *amb_vec) {
+  LION_CALL(lion_vector_new(NULL, sizeof(double), power_vec), "Failed creating vector");
+  LION_CALL(lion_vector_new(NULL, sizeof(double), amb_vec), "Failed creating vector");
+  for (size_t k = 0; k < TEST_EVENT_STEPS; k++) {
+    LION_CALL(lion_vector_push_d(NULL, power_vec, power), "Failed pushing power");
+    LION_CALL(lion_vector_push_d(NULL, amb_vec, 298.15), "Failed pushing ambient temperature");
+  }
+  return TEST_PASS;
+}
+
+static int notified = 0;
+
+static lion_status_t test_notify_hook(lion_sim_t *sim, lion_event_t *event) {
+  notified++;
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t test_event_voltage_cutoff(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_seconds    = 1.0;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  lion_vector_t power;
+  lion_vector_t amb_temp;
+  LION_CALL(test_inputs(TEST_EVENT_POWER, &power, &amb_temp), "Failed creating inputs");
+
+  lion_sim_t cell;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  lion_event_t cutoff = {
+      .name      = "cutoff",
+      .field     = LION_STATE_VOLTAGE,
+      .threshold = TEST_EVENT_CUTOFF,
+      .direction = LION_EVENT_FALLING,
+      .action    = LION_EVENT_STOP,
+  };
+  LION_CALL(lion_sim_add_event(&cell, &cutoff), "Failed adding event");
+  LION_CALL(lion_sim_run(&cell, &power, &amb_temp), "Failed running sim");
+
+  // The run stops at the event, with the state located at the crossing
+  LION_ASSERT(lion_sim_should_close(&cell));
+  LION_ASSERT_EQI(cell.events[0].triggered, 1);
+  LION_ASSERT(cell.state.step < TEST_EVENT_STEPS - 1);
+  LION_ASSERT(fabs(cell.state.voltage - TEST_EVENT_CUTOFF) < 1e-6);
+  LION_ASSERT(fabs(cell.events[0].value - TEST_EVENT_CUTOFF) < 1e-6);
+  LION_ASSERT_EQF(cell.events[0].time, cell.state.time);
+  LION_ASSERT(cell.state.time > (double)(cell.state.step - 1) * conf.sim_step_seconds);
+  LION_ASSERT(cell.state.time < (double)cell.state.step * conf.sim_step_seconds);
+
+  // Resetting the sim re-arms the events
+  LION_CALL(lion_sim_reset(&cell), "Failed resetting sim");
+  LION_ASSERT(!lion_sim_should_close(&cell));
+  LION_ASSERT_EQI(cell.events[0].triggered, 0);
+
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  LION_CALL(lion_vector_cleanup(NULL, &power), "Failed cleaning up vector");
+  LION_CALL(lion_vector_cleanup(NULL, &amb_temp), "Failed cleaning up vector");
+  return TEST_PASS;
+}
+
+lion_status_t test_event_cut_discharge(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_seconds    = 60.0;
+  conf.sim_input_mode      = LION_INPUT_MODE_CURRENT;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  lion_sim_t cell;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  lion_event_t cutoff = {
+      .name      = "soc",
+      .field     = LION_STATE_SOC_NOMINAL,
+      .threshold = 0.88,
+      .direction = LION_EVENT_FALLING,
+      .action    = LION_EVENT_STOP,
+  };
+  LION_CALL(lion_sim_add_event(&cell, &cutoff), "Failed adding event");
+  LION_CALL(lion_sim_init(&cell), "Failed initializing sim");
+  for (size_t k = 0; k < TEST_EVENT_STEPS && !lion_sim_should_close(&cell); k++) {
+    LION_CALL(lion_sim_step_current(&cell, 2.0, 298.15), "Failed stepping sim");
+  }
+
+  // The charge counted towards the cycles stops at the event, within the step
+  LION_ASSERT(lion_sim_should_close(&cell));
+  LION_ASSERT(fmod(cell.state.time, conf.sim_step_seconds) > 0.0);
+  LION_ASSERT(fabs(cell.state._acc_discharge - 2.0 * cell.state.time) < 1e-9);
+
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_event_notify_and_switch(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_seconds    = 1.0;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  lion_sim_t cell;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  LION_CALL(lion_sim_init(&cell), "Failed initializing sim");
+
+  // Notified once when going below the SoC, then the power is switched off
+  // slightly further down
+  notified                  = 0;
+  lion_event_t notify_event = {
+      .name      = "soc",
+      .field     = LION_STATE_SOC_NOMINAL,
+      .threshold = TEST_EVENT_SOC + 0.01,
+      .direction = LION_EVENT_FALLING,
+      .action    = LION_EVENT_NOTIFY,
+      .hook      = &test_notify_hook,
+  };
+  lion_event_t switch_event = {
+      .name      = "rest",
+      .field     = LION_STATE_SOC_NOMINAL,
+      .threshold = TEST_EVENT_SOC,
+      .direction = LION_EVENT_FALLING,
+      .action    = LION_EVENT_SWITCH_INPUT,
+      .power     = 0.0,
+  };
+  lion_event_t rising_event = {
+      .name      = "never",
+      .field     = LION_STATE_SOC_NOMINAL,
+      .threshold = TEST_EVENT_SOC,
+      .direction = LION_EVENT_RISING,
+      .action    = LION_EVENT_STOP,
+  };
+  LION_CALL(lion_sim_add_event(&cell, &notify_event), "Failed adding event");
+  LION_CALL(lion_sim_add_event(&cell, &switch_event), "Failed adding event");
+  LION_CALL(lion_sim_add_event(&cell, &rising_event), "Failed adding event");
+
+  uint64_t steps = 0;
+  while (cell.events[1].triggered == 0 && steps < 100 * TEST_EVENT_STEPS) {
+    LION_CALL(lion_sim_step(&cell, TEST_EVENT_POWER, 298.15), "Failed stepping sim");
+    steps++;
+  }
+  LION_ASSERT_EQI(cell.events[1].triggered, 1);
+  LION_ASSERT_EQI(notified, 1);
+  LION_ASSERT(fabs(cell.events[1].value - TEST_EVENT_SOC) < 1e-6);
+  LION_ASSERT(!lion_sim_should_close(&cell));
+
+  // The next step starts at the event, with the switched input
+  LION_CALL(lion_sim_step(&cell, TEST_EVENT_POWER, 298.15), "Failed stepping sim");
+  LION_ASSERT_EQF(cell.state.power, 0.0);
+  LION_ASSERT(fabs(cell.state.soc_nominal - TEST_EVENT_SOC) < 1e-6);
+  LION_ASSERT_EQI(cell.events[2].triggered, 0);
+  LION_ASSERT_EQI(notified, 1);
+
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_event_invalid_field(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_FATAL;
+  lion_params_t     params = lion_params_default();
+
+  lion_sim_t cell;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  lion_event_t event = {
+      .field     = LION_STATE_VOLTAGE | LION_STATE_CURRENT,
+      .threshold = 3.0,
+  };
+  LION_ASSERT_FAILS(lion_sim_add_event(&cell, &event));
+
+  // Fields which only change between steps never trigger
+  lion_state_field_t fixed[] = {LION_STATE_STEP, LION_STATE_POWER, LION_STATE_AMBIENT_TEMPERATURE, LION_STATE_CYCLE, LION_STATE_SOH};
+  for (size_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++) {
+    event.field = fixed[i];
+    LION_ASSERT_FAILS(lion_sim_add_event(&cell, &event));
+  }
+  LION_ASSERT_EQI(cell.events_len, 0);
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_event_voltage_cutoff);
+  LION_CALL_TEST(NULL, test_event_cut_discharge);
+  LION_CALL_TEST(NULL, test_event_notify_and_switch);
+  LION_CALL_TEST(NULL, test_event_invalid_field);
+
+  return TEST_PASS;
+}
@@ -0,0 +1,116 @@
+#include <lion/lion.h>
+#include <lion_math/kernels/kernels.h>
+#include <lion_math/lion_math.h>
+#include <lion_utils/isa.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+#include <math.h>
+
+#define TEST_FAST_MATH_N     97
+#define TEST_FAST_MATH_STEPS 300
+
+// Documented bound on the relative error of each tier, with some room for the
+// rounding of the terms around the exponentials
+static const double _bounds[] = {
+    [LION_FAST_MATH_OFF]  = 1e-14,
+    [LION_FAST_MATH_1E12] = 1e-12,
+    [LION_FAST_MATH_1E7]  = 1e-7,
+};
+
+static double relative_error(double value, double exact) { return fabs(value - exact) / fmax(fabs(exact), 1e-300); }
+
+lion_status_t test_fast_math_kernels(lion_sim_t *sim) {
+  // Every tier of every level the CPU supports stays within its bound of the
+  // models evaluated with libm
+  lion_params_t     params        = lion_params_default();
+  params.rint.model               = LION_RINT_MODEL_POLARIZATION;
+  params.rint.params.polarization = lion_params_default_rint_polarization();
+  lion_isa_t active               = lion_isa_active();
+  double     ehc_scale            = 0.0;
+
+  lion_rint_packed_t packed;
+  double             polys[LION_FUZZY_SETS_COUNT];
+  double             temperature[TEST_FAST_MATH_N], soc[TEST_FAST_MATH_N], current[TEST_FAST_MATH_N];
+  double             kappa[TEST_FAST_MATH_N], ehc[TEST_FAST_MATH_N], rint[TEST_FAST_MATH_N], out[TEST_FAST_MATH_N];
+  lion_resistance_pack(&params, &packed);
+  lion_resistance_polarization_polys(0.6, &params, polys);
+  for (size_t i = 0; i < TEST_FAST_MATH_N; i++) {
+    temperature[i] = 233.15 + 120.0 * (double)i / (TEST_FAST_MATH_N - 1);
+    soc[i]         = 0.02 + 0.98 * (double)i / (TEST_FAST_MATH_N - 1);
+    current[i]     = -60.0 + 120.0 * (double)i / (TEST_FAST_MATH_N - 1);
+    kappa[i]       = lion_kappa(temperature[i], &params);
+    ehc[i]         = lion_ehc(soc[i], &params);
+    rint[i]        = lion_resistance_polarization_from_polys(polys, current[i], &params, NULL);
+    ehc_scale      = fmax(ehc_scale, fabs(ehc[i]));
+  }
+
+  for (int level = LION_ISA_SCALAR; level <= (int)lion_isa_supported(); level++) {
+    LION_CALL(lion_isa_force((lion_isa_t)level), "Failed forcing instruction set");
+    for (int tier = LION_FAST_MATH_OFF; tier < LION_FAST_MATH_TIERS; tier++) {
+      const lion_kernels_t *kernels = lion_kernels_fast((lion_fast_math_t)tier);
+      kernels->kappa_n(temperature, TEST_FAST_MATH_N, &params, out);
+      for (size_t i = 0; i < TEST_FAST_MATH_N; i++) {
+        LION_ASSERT(relative_error(out[i], kappa[i]) < _bounds[tier]);
+      }
+      kernels->ehc_n(soc, TEST_FAST_MATH_N, &params, out);
+      for (size_t i = 0; i < TEST_FAST_MATH_N; i++) {
+        // The entropic heat coefficient is the difference of two exponentials
+        // and crosses zero, so its error is taken relative to its range
+        LION_ASSERT(fabs(out[i] - ehc[i]) < _bounds[tier] * ehc_scale);
+      }
+      kernels->resistance_packed_n(&packed, polys, current, TEST_FAST_MATH_N, out, NULL);
+      for (size_t i = 0; i < TEST_FAST_MATH_N; i++) {
+        LION_ASSERT(relative_error(out[i], rint[i]) < _bounds[tier]);
+      }
+    }
+  }
+  LION_CALL(lion_isa_force(active), "Failed restoring instruction set");
+  return TEST_PASS;
+}
+
+lion_status_t test_fast_math_sims(lion_sim_t *sim) {
+  // Full simulations with the approximations track the libm path within the
+  // error of their tier
+  lion_sim_config_t conf          = lion_sim_config_default();
+  conf.log_stdlvl                 = LOG_ERROR;
+  lion_sim_config_t fast_conf     = conf;
+  lion_params_t     params        = lion_params_default();
+  params.init.soc                 = 0.9;
+  params.rint.model               = LION_RINT_MODEL_POLARIZATION;
+  params.rint.params.polarization = lion_params_default_rint_polarization();
+
+  lion_sim_t exact;
+  lion_sim_t fast;
+  LION_CALL(lion_sim_new(&conf, &params, &exact), "Failed creating sim");
+  LION_CALL(lion_sim_init(&exact), "Failed initializing sim");
+  for (size_t k = 0; k < TEST_FAST_MATH_STEPS; k++) {
+    LION_CALL(lion_sim_step(&exact, 8.0, 298.15), "Failed stepping sim");
+  }
+
+  for (int tier = LION_FAST_MATH_1E12; tier < LION_FAST_MATH_TIERS; tier++) {
+    fast_conf.sim_fast_math = (lion_fast_math_t)tier;
+    LION_CALL(lion_sim_new(&fast_conf, &params, &fast), "Failed creating sim");
+    LION_CALL(lion_sim_init(&fast), "Failed initializing sim");
+    for (size_t k = 0; k < TEST_FAST_MATH_STEPS; k++) {
+      LION_CALL(lion_sim_step(&fast, 8.0, 298.15), "Failed stepping sim");
+    }
+
+    double bound = 100.0 * _bounds[tier];
+    LION_ASSERT(relative_error(fast.state.soc_nominal, exact.state.soc_nominal) < bound);
+    LION_ASSERT(relative_error(fast.state.internal_temperature, exact.state.internal_temperature) < bound);
+    LION_ASSERT(relative_error(fast.state.voltage, exact.state.voltage) < bound);
+    LION_ASSERT(relative_error(fast.state.current, exact.state.current) < bound);
+    LION_CALL(lion_sim_cleanup(&fast), "Failed cleaning up sim");
+  }
+
+  LION_CALL(lion_sim_cleanup(&exact), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_fast_math_kernels);
+  LION_CALL_TEST(NULL, test_fast_math_sims);
+
+  return TEST_PASS;
+}
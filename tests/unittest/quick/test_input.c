@@ -0,0 +1,105 @@
+#include <lion/lion.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+
+#define TEST_INPUT_SAMPLES  120
+#define TEST_INPUT_UPSAMPLE 10
+
+lion_status_t test_input_interpolation(lion_sim_t *sim) {
+  double values[]     = {1.0, 3.0, 2.0, 6.0};
+  double timestamps[] = {0.0, 1.0, 1.5, 3.5};
+
+  lion_input_t fixed;
+  LION_CALL(lion_input_fixed_rate(values, 4, 10.0, 2.0, LION_INTERP_LINEAR, &fixed), "Failed creating input");
+  LION_ASSERT_EQF(lion_input_start_time(&fixed), 10.0);
+  LION_ASSERT_EQF(lion_input_end_time(&fixed), 16.0);
+  LION_ASSERT_EQF(lion_input_at(&fixed, 0.0), 1.0);
+  LION_ASSERT_EQF(lion_input_at(&fixed, 11.0), 2.0);
+  LION_ASSERT_EQF(lion_input_at(&fixed, 12.0), 3.0);
+  LION_ASSERT_EQF(lion_input_at(&fixed, 15.0), 4.0);
+  LION_ASSERT_EQF(lion_input_at(&fixed, 20.0), 6.0);
+
+  fixed.interp = LION_INTERP_ZOH;
+  LION_ASSERT_EQF(lion_input_at(&fixed, 11.0), 1.0);
+  LION_ASSERT_EQF(lion_input_at(&fixed, 15.0), 2.0);
+
+  lion_input_t stamped;
+  LION_CALL(lion_input_timestamped(timestamps, values, 4, LION_INTERP_LINEAR, &stamped), "Failed creating input");
+  LION_ASSERT_EQF(lion_input_end_time(&stamped), 3.5);
+  LION_ASSERT_EQF(lion_input_at(&stamped, 0.5), 2.0);
+  LION_ASSERT_EQF(lion_input_at(&stamped, 1.25), 2.5);
+  LION_ASSERT_EQF(lion_input_at(&stamped, 2.5), 4.0);
+  // Queries going back in time must still find the right interval
+  LION_ASSERT_EQF(lion_input_at(&stamped, 0.25), 1.5);
+  LION_ASSERT_EQF(lion_input_at(&stamped, -1.0), 1.0);
+  LION_ASSERT_EQF(lion_input_at(&stamped, 4.0), 6.0);
+
+  stamped.interp = LION_INTERP_ZOH;
+  LION_ASSERT_EQF(lion_input_at(&stamped, 1.25), 3.0);
+  LION_ASSERT_EQF(lion_input_at(&stamped, 1.5), 2.0);
+  return TEST_PASS;
+}
+
+lion_status_t test_input_invalid(lion_sim_t *sim) {
+  double values[]     = {1.0, 2.0, 3.0};
+  double timestamps[] = {0.0, 1.0, 1.0};
+
+  lion_input_t input;
+  LION_ASSERT_FAILS(lion_input_timestamped(timestamps, values, 3, LION_INTERP_ZOH, &input));
+  LION_ASSERT_FAILS(lion_input_fixed_rate(values, 3, 0.0, 0.0, LION_INTERP_ZOH, &input));
+  LION_ASSERT_FAILS(lion_input_fixed_rate(values, 0, 0.0, 1.0, LION_INTERP_ZOH, &input));
+  return TEST_PASS;
+}
+
+lion_status_t test_input_run_matches_upsampled(lion_sim_t *sim) {
+  // Running from 1 Hz samples held between steps must be the same as stepping
+  // through the upsampled profile by hand
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_seconds    = 1.0 / TEST_INPUT_UPSAMPLE;
+  lion_params_t     params = lion_params_default();
+
+  double power[TEST_INPUT_SAMPLES];
+  double amb_temp[TEST_INPUT_SAMPLES];
+  for (size_t k = 0; k < TEST_INPUT_SAMPLES; k++) {
+    power[k]    = 3.0 - 5.0 * (double)((k / 30) % 2);
+    amb_temp[k] = 293.15 + 0.1 * (double)k;
+  }
+
+  lion_input_t power_input;
+  lion_input_t amb_input;
+  LION_CALL(lion_input_fixed_rate(power, TEST_INPUT_SAMPLES, 0.0, 1.0, LION_INTERP_ZOH, &power_input), "Failed creating input");
+  LION_CALL(lion_input_fixed_rate(amb_temp, TEST_INPUT_SAMPLES, 0.0, 1.0, LION_INTERP_ZOH, &amb_input), "Failed creating input");
+
+  lion_sim_t resampled;
+  LION_CALL(lion_sim_new(&conf, &params, &resampled), "Failed creating sim");
+  LION_CALL(lion_sim_run_resampled(&resampled, &power_input, &amb_input), "Failed running sim");
+
+  lion_sim_t manual;
+  LION_CALL(lion_sim_new(&conf, &params, &manual), "Failed creating sim");
+  LION_CALL(lion_sim_init(&manual), "Failed initializing sim");
+  for (size_t k = 0; k < TEST_INPUT_SAMPLES - 1; k++) {
+    for (size_t j = 0; j < TEST_INPUT_UPSAMPLE; j++) {
+      LION_CALL(lion_sim_step(&manual, power[k], amb_temp[k]), "Failed stepping sim");
+    }
+  }
+
+  LION_ASSERT_EQI(resampled.state.step, (TEST_INPUT_SAMPLES - 1) * TEST_INPUT_UPSAMPLE);
+  LION_ASSERT_EQI(resampled.state.step, manual.state.step);
+  LION_ASSERT_EQF(resampled.state.soc_nominal, manual.state.soc_nominal);
+  LION_ASSERT_EQF(resampled.state.internal_temperature, manual.state.internal_temperature);
+  LION_ASSERT_EQF(resampled.state.voltage, manual.state.voltage);
+
+  LION_CALL(lion_sim_cleanup(&resampled), "Failed cleaning up sim");
+  LION_CALL(lion_sim_cleanup(&manual), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_input_interpolation);
+  LION_CALL_TEST(NULL, test_input_invalid);
+  LION_CALL_TEST(NULL, test_input_run_matches_upsampled);
+
+  return TEST_PASS;
+}
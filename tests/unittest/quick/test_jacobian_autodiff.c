@@ -0,0 +1,113 @@
+#include <lion/lion.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+#include <math.h>
+
+static lion_status_t test_jacobian_matches(lion_rint_model_t model, lion_input_mode_t mode, double input) {
+  // The adaptive system re-solves the current at every state, so its central
+  // differences are the reference for the Jacobian with the current following
+  // the states
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_mode       = LION_STEP_MODE_ADAPTIVE;
+  conf.sim_input_mode      = mode;
+  conf.sim_jacobian        = LION_JACOBIAN_AUTODIFF;
+  conf.sim_current_solver  = LION_CURRENT_SOLVER_NEWTON;
+  conf.sim_epsabs          = 1e-12;
+  conf.sim_epsrel          = 1e-12;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.7;
+  params.rint.model        = model;
+  if (model == LION_RINT_MODEL_POLARIZATION) {
+    params.rint.params.polarization = lion_params_default_rint_polarization();
+  }
+
+  lion_sim_t cell;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  LION_CALL(lion_sim_init(&cell), "Failed initializing sim");
+  LION_ASSERT(cell.sys.jacobian != NULL);
+  for (size_t k = 0; k < 10; k++) {
+    if (mode == LION_INPUT_MODE_CURRENT) {
+      LION_CALL(lion_sim_step_current(&cell, input, 298.15), "Failed stepping sim");
+    } else {
+      LION_CALL(lion_sim_step(&cell, input, 298.15), "Failed stepping sim");
+    }
+  }
+
+  double y[2]     = {cell.state.soc_nominal, cell.state.internal_temperature};
+  double deltas[] = {1e-5, 1e-3};
+  double reference[2][2];
+  for (size_t j = 0; j < 2; j++) {
+    double yp[2] = {y[0], y[1]};
+    double ym[2] = {y[0], y[1]};
+    double fp[2], fm[2];
+    yp[j] += deltas[j];
+    ym[j] -= deltas[j];
+    LION_ASSERT(cell.sys.function(0.0, yp, fp, cell.sys.params) == 0);
+    LION_ASSERT(cell.sys.function(0.0, ym, fm, cell.sys.params) == 0);
+    for (size_t i = 0; i < 2; i++) {
+      reference[i][j] = (fp[i] - fm[i]) / (2.0 * deltas[j]);
+    }
+  }
+
+  // The Jacobian linearizes around the current solved at the last evaluation
+  double f[2], dfdy[4], dfdt[2];
+  LION_ASSERT(cell.sys.function(0.0, y, f, cell.sys.params) == 0);
+  LION_ASSERT(cell.sys.jacobian(0.0, y, dfdy, dfdt, cell.sys.params) == 0);
+  for (size_t i = 0; i < 2; i++) {
+    for (size_t j = 0; j < 2; j++) {
+      double found = dfdy[2 * i + j];
+      LION_ASSERT(isfinite(found));
+      LION_ASSERT(fabs(found - reference[i][j]) <= 1e-5 * fabs(reference[i][j]) + 1e-12);
+    }
+    LION_ASSERT_EQF(dfdt[i], 0.0);
+  }
+
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_jacobian_power(lion_sim_t *sim) {
+  LION_CALL(test_jacobian_matches(LION_RINT_MODEL_FIXED, LION_INPUT_MODE_POWER, 8.0), "Failed with the fixed resistance");
+  LION_CALL(test_jacobian_matches(LION_RINT_MODEL_POLARIZATION, LION_INPUT_MODE_POWER, 8.0), "Failed with the polarization resistance");
+  LION_CALL(test_jacobian_matches(LION_RINT_MODEL_POLARIZATION, LION_INPUT_MODE_POWER, -4.0), "Failed while charging");
+  return TEST_PASS;
+}
+
+lion_status_t test_jacobian_current(lion_sim_t *sim) {
+  LION_CALL(test_jacobian_matches(LION_RINT_MODEL_FIXED, LION_INPUT_MODE_CURRENT, 2.0), "Failed with the fixed resistance");
+  LION_CALL(test_jacobian_matches(LION_RINT_MODEL_POLARIZATION, LION_INPUT_MODE_CURRENT, 2.0), "Failed with the polarization resistance");
+  return TEST_PASS;
+}
+
+lion_status_t test_jacobian_implicit_stepper(lion_sim_t *sim) {
+  // Implicit steppers run with the Jacobian
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_stepper         = LION_STEPPER_MSBDF;
+  conf.sim_jacobian        = LION_JACOBIAN_AUTODIFF;
+  lion_params_t     params = lion_params_default();
+  params.init.soc                 = 0.9;
+  params.rint.model               = LION_RINT_MODEL_POLARIZATION;
+  params.rint.params.polarization = lion_params_default_rint_polarization();
+
+  lion_sim_t cell;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  LION_CALL(lion_sim_init(&cell), "Failed initializing sim");
+  for (size_t k = 0; k < 100; k++) {
+    LION_CALL(lion_sim_step(&cell, 8.0, 298.15), "Failed stepping sim");
+  }
+  LION_ASSERT(cell.state.soc_nominal < params.init.soc);
+  LION_ASSERT(isfinite(cell.state.internal_temperature));
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_jacobian_power);
+  LION_CALL_TEST(NULL, test_jacobian_current);
+  LION_CALL_TEST(NULL, test_jacobian_implicit_stepper);
+
+  return TEST_PASS;
+}
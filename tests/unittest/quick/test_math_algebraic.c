@@ -1,5 +1,345 @@
-// TODO: Add tests for algebraic equations
-
+#include <gsl/gsl_errno.h>
+#include <lion/lion.h>
+#include <lion_math/lion_math.h>
+#include <lion_utils/isa.h>
 #include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+#include <math.h>
+#include <string.h>
+
+#define TEST_CURRENT_POWER 3.0
+#define TEST_CURRENT_SOC   0.6
+#define TEST_CURRENT_TEMP  298.15
+#define TEST_CURRENT_EPS   1e-10
+#define TEST_CURRENT_TOL   1e-8
+
+typedef int (*test_current_solver_fn)(lion_eval_t *, double, double, double, double, int, lion_params_t *, double *);
+
+static lion_status_t check_solver_fixed(test_current_solver_fn solver, double initial_guess) {
+  // With a fixed resistance the fixed point is the closed-form current
+  lion_params_t params = lion_params_default();
+  lion_eval_t   eval;
+  lion_eval_prepare(&eval, NULL, TEST_CURRENT_SOC, TEST_CURRENT_TEMP, params.init.capacity, &params);
+  double rint   = lion_resistance(eval.soc_use, 0.0, &params);
+  double expect = lion_current(TEST_CURRENT_POWER, eval.open_circuit_voltage, rint, &params);
+
+  double current;
+  int    status = solver(&eval, TEST_CURRENT_POWER, initial_guess, TEST_CURRENT_EPS, TEST_CURRENT_EPS, 0, &params, &current);
+  LION_ASSERT_EQI(status, GSL_SUCCESS);
+  LION_ASSERT(fabs(current - expect) < TEST_CURRENT_TOL);
+  return LION_STATUS_SUCCESS;
+}
+
+static lion_status_t check_solver_polarization(test_current_solver_fn solver, double power, double initial_guess) {
+  // The polarization model has no closed form, check the fixed-point residual
+  lion_params_t params            = lion_params_default();
+  params.rint.model               = LION_RINT_MODEL_POLARIZATION;
+  params.rint.params.polarization = lion_params_default_rint_polarization();
+  lion_rint_packed_t packed;
+  lion_eval_t        eval;
+  lion_resistance_pack(&params, &packed);
+  lion_eval_prepare(&eval, &packed, TEST_CURRENT_SOC, TEST_CURRENT_TEMP, params.init.capacity, &params);
+
+  double current;
+  int    status = solver(&eval, power, initial_guess, TEST_CURRENT_EPS, TEST_CURRENT_EPS, 0, &params, &current);
+  LION_ASSERT_EQI(status, GSL_SUCCESS);
+
+  double rint     = lion_resistance(eval.soc_use, current, &params);
+  double residual = current - lion_current(power, eval.open_circuit_voltage, rint, &params);
+  LION_ASSERT(fabs(residual) < TEST_CURRENT_TOL);
+  return LION_STATUS_SUCCESS;
+}
+
+static lion_status_t check_solver_out_of_reach(test_current_solver_fn solver) {
+  // Past Voc^2 / 4R the cell cannot deliver the power at all, and a charge
+  // needing more than the bracket stalls on its bound. Neither is a solution
+  lion_params_t params = lion_params_default();
+  lion_eval_t   eval;
+  lion_eval_prepare(&eval, NULL, TEST_CURRENT_SOC, TEST_CURRENT_TEMP, params.init.capacity, &params);
+  double voc      = eval.open_circuit_voltage;
+  double rint     = lion_resistance(eval.soc_use, 0.0, &params);
+  double beyond   = 2.0 * LION_CURRENT_OPTMIN;
+  double powers[] = {1.5 * voc * voc / (4.0 * rint), (voc - rint * beyond) * beyond};
+
+  for (size_t i = 0; i < sizeof(powers) / sizeof(powers[0]); i++) {
+    double current = 0.0;
+    LION_ASSERT(solver(&eval, powers[i], 0.0, TEST_CURRENT_EPS, TEST_CURRENT_EPS, 0, &params, &current) != GSL_SUCCESS);
+    LION_ASSERT(solver(&eval, powers[i], -5.0, TEST_CURRENT_EPS, TEST_CURRENT_EPS, 0, &params, &current) != GSL_SUCCESS);
+  }
+  return LION_STATUS_SUCCESS;
+}
+
+lion_status_t test_current_newton(lion_sim_t *sim) {
+  LION_ASSERT(check_solver_fixed(&lion_current_solve_newton, 0.0) == LION_STATUS_SUCCESS);
+  LION_ASSERT(check_solver_fixed(&lion_current_solve_newton, 5.0) == LION_STATUS_SUCCESS);
+  LION_ASSERT(check_solver_polarization(&lion_current_solve_newton, TEST_CURRENT_POWER, 0.0) == LION_STATUS_SUCCESS);
+  LION_ASSERT(check_solver_polarization(&lion_current_solve_newton, -TEST_CURRENT_POWER, 0.0) == LION_STATUS_SUCCESS);
+  LION_ASSERT(check_solver_out_of_reach(&lion_current_solve_newton) == LION_STATUS_SUCCESS);
+  return TEST_PASS;
+}
+
+lion_status_t test_current_secant(lion_sim_t *sim) {
+  LION_ASSERT(check_solver_fixed(&lion_current_solve_secant, 0.0) == LION_STATUS_SUCCESS);
+  LION_ASSERT(check_solver_fixed(&lion_current_solve_secant, 5.0) == LION_STATUS_SUCCESS);
+  LION_ASSERT(check_solver_polarization(&lion_current_solve_secant, TEST_CURRENT_POWER, 0.0) == LION_STATUS_SUCCESS);
+  LION_ASSERT(check_solver_polarization(&lion_current_solve_secant, -TEST_CURRENT_POWER, 0.0) == LION_STATUS_SUCCESS);
+  LION_ASSERT(check_solver_out_of_reach(&lion_current_solve_secant) == LION_STATUS_SUCCESS);
+  return TEST_PASS;
+}
+
+lion_status_t test_current_closed_form(lion_sim_t *sim) {
+  // The current balances the power at the terminals, where the voltage is the
+  // same whether taken from the power or from the resistance
+  lion_params_t params = lion_params_default();
+  double        voc    = lion_voc(TEST_CURRENT_SOC, &params);
+  double        rint   = lion_resistance(TEST_CURRENT_SOC, 0.0, &params);
+
+  for (double power = -12.0; power <= 12.0; power += 3.0) {
+    double current = lion_current(power, voc, rint, &params);
+    LION_ASSERT(fabs((voc - rint * current) * current - power) < 1e-12);
+    if (power != 0.0) {
+      double voltage = lion_voltage(power, voc, rint, &params);
+      LION_ASSERT(fabs(voltage - lion_voltage_from_rint(current, voc, rint, &params)) < 1e-12);
+      LION_ASSERT(fabs(voltage - lion_voltage_from_current(power, current, &params)) < 1e-12);
+    }
+  }
+  return TEST_PASS;
+}
+
+lion_status_t test_model_grads(lion_sim_t *sim) {
+  // Compare the analytical gradients of the algebraic models against central
+  // differences
+  lion_params_t params = lion_params_default();
+  double        voc    = lion_voc(TEST_CURRENT_SOC, &params);
+  double        rint   = lion_resistance(TEST_CURRENT_SOC, 0.0, &params);
+
+  const double h = 1e-6;
+  for (double power = -12.0; power <= 12.0; power += 3.0) {
+    double fd_voc  = (lion_current(power, voc + h, rint, &params) - lion_current(power, voc - h, rint, &params)) / (2.0 * h);
+    double fd_rint = (lion_current(power, voc, rint + h, &params) - lion_current(power, voc, rint - h, &params)) / (2.0 * h);
+    LION_ASSERT(fabs(lion_current_grad_voc(power, voc, rint, &params) - fd_voc) < 1e-6 * fmax(1.0, fabs(fd_voc)));
+    LION_ASSERT(fabs(lion_current_grad_rint(power, voc, rint, &params) - fd_rint) < 1e-6 * fmax(1.0, fabs(fd_rint)));
+  }
+  for (double soc = 0.1; soc <= 0.9; soc += 0.2) {
+    double fd_voc = (lion_voc(soc + h, &params) - lion_voc(soc - h, &params)) / (2.0 * h);
+    double fd_ehc = (lion_ehc(soc + h, &params) - lion_ehc(soc - h, &params)) / (2.0 * h);
+    LION_ASSERT(fabs(lion_voc_grad(soc, &params) - fd_voc) < 1e-6 * fmax(1.0, fabs(fd_voc)));
+    LION_ASSERT(fabs(lion_ehc_grad(soc, &params) - fd_ehc) < 1e-6 * fmax(1.0, fabs(fd_ehc)));
+  }
+  for (double temperature = 253.15; temperature <= 333.15; temperature += 20.0) {
+    double fd = (lion_kappa(temperature + h, &params) - lion_kappa(temperature - h, &params)) / (2.0 * h);
+    LION_ASSERT(fabs(lion_kappa_grad(temperature, &params) - fd) < 1e-6 * fmax(1.0, fabs(fd)));
+  }
+  return TEST_PASS;
+}
+
+lion_status_t test_resistance_grad_current(lion_sim_t *sim) {
+  // Compare the analytical dR/dI against central differences
+  lion_params_t params            = lion_params_default();
+  params.rint.model               = LION_RINT_MODEL_POLARIZATION;
+  params.rint.params.polarization = lion_params_default_rint_polarization();
+
+  const double h = 1e-5;
+  for (double current = -6.0; current <= 6.0; current += 1.5) {
+    double grad = lion_resistance_grad_current(TEST_CURRENT_SOC, current, &params);
+    double fd   = (lion_resistance(TEST_CURRENT_SOC, current + h, &params) - lion_resistance(TEST_CURRENT_SOC, current - h, &params)) / (2.0 * h);
+    LION_ASSERT(fabs(grad - fd) < 1e-6 * fmax(1.0, fabs(fd)));
+  }
+  return TEST_PASS;
+}
+
+lion_status_t test_eval_context(lion_sim_t *sim) {
+  // The cached terms must match the standalone model functions
+  lion_params_t params            = lion_params_default();
+  params.rint.model               = LION_RINT_MODEL_POLARIZATION;
+  params.rint.params.polarization = lion_params_default_rint_polarization();
+
+  lion_rint_packed_t packed;
+  lion_eval_t        eval;
+  lion_resistance_pack(&params, &packed);
+  lion_eval_prepare(&eval, &packed, TEST_CURRENT_SOC, TEST_CURRENT_TEMP, params.init.capacity, &params);
+  LION_ASSERT(fabs(eval.kappa - lion_kappa(TEST_CURRENT_TEMP, &params)) < 1e-12);
+  LION_ASSERT(fabs(eval.kappa_grad - lion_kappa_grad(TEST_CURRENT_TEMP, &params)) < 1e-12);
+  LION_ASSERT(fabs(eval.ehc - lion_ehc(eval.soc_use, &params)) < 1e-12);
+  LION_ASSERT(fabs(eval.ref_open_circuit_voltage - lion_voc(eval.soc_use, &params)) < 1e-12);
+  LION_ASSERT(fabs(eval.open_circuit_voltage_grad - lion_voc_grad(eval.soc_use, &params)) < 1e-12);
+
+  for (double current = -6.0; current <= 6.0; current += 1.5) {
+    double grad;
+    double rint = lion_eval_resistance(&eval, current, &params, &grad);
+    LION_ASSERT(fabs(rint - lion_resistance(eval.soc_use, current, &params)) < 1e-12);
+    LION_ASSERT(fabs(grad - lion_resistance_grad_current(eval.soc_use, current, &params)) < 1e-12);
+  }
+  return TEST_PASS;
+}
+
+#define TEST_ARRAY_N   13
+#define TEST_ARRAY_TOL 1e-13
+
+static int close_to(double found, double expect) { return fabs(found - expect) <= TEST_ARRAY_TOL * fmax(1.0, fabs(expect)); }
+
+lion_status_t test_array_kernels(lion_sim_t *sim) {
+  // The array kernels must match the scalar models, including the elements
+  // past the last whole register
+  lion_params_t params = lion_params_default();
+  double        soc[TEST_ARRAY_N], temperature[TEST_ARRAY_N], ambient[TEST_ARRAY_N];
+  double        power[TEST_ARRAY_N], voc[TEST_ARRAY_N], rint[TEST_ARRAY_N], current[TEST_ARRAY_N], ehc[TEST_ARRAY_N];
+  for (size_t i = 0; i < TEST_ARRAY_N; i++) {
+    soc[i]         = 0.02 + 0.98 * (double)i / (TEST_ARRAY_N - 1);
+    temperature[i] = 260.0 + 5.0 * (double)i;
+    ambient[i]     = 298.15;
+    power[i]       = -6.0 + (double)i;
+    voc[i]         = lion_voc(soc[i], &params);
+    rint[i]        = 0.01 + 0.001 * (double)i;
+    current[i]     = -3.0 + 0.5 * (double)i;
+    ehc[i]         = lion_ehc(soc[i], &params);
+  }
+
+  double out[TEST_ARRAY_N];
+  lion_voc_n(soc, TEST_ARRAY_N, &params, out);
+  for (size_t i = 0; i < TEST_ARRAY_N; i++) {
+    LION_ASSERT(close_to(out[i], lion_voc(soc[i], &params)));
+  }
+  lion_voc_grad_n(soc, TEST_ARRAY_N, &params, out);
+  for (size_t i = 0; i < TEST_ARRAY_N; i++) {
+    LION_ASSERT(close_to(out[i], lion_voc_grad(soc[i], &params)));
+  }
+  lion_ehc_n(soc, TEST_ARRAY_N, &params, out);
+  for (size_t i = 0; i < TEST_ARRAY_N; i++) {
+    LION_ASSERT(close_to(out[i], lion_ehc(soc[i], &params)));
+  }
+  lion_kappa_n(temperature, TEST_ARRAY_N, &params, out);
+  for (size_t i = 0; i < TEST_ARRAY_N; i++) {
+    LION_ASSERT(close_to(out[i], lion_kappa(temperature[i], &params)));
+  }
+  lion_current_n(power, voc, rint, TEST_ARRAY_N, &params, out);
+  for (size_t i = 0; i < TEST_ARRAY_N; i++) {
+    LION_ASSERT(close_to(out[i], lion_current(power[i], voc[i], rint[i], &params)));
+  }
+  lion_generated_heat_n(current, temperature, rint, ehc, TEST_ARRAY_N, &params, out);
+  for (size_t i = 0; i < TEST_ARRAY_N; i++) {
+    LION_ASSERT(close_to(out[i], lion_generated_heat(current[i], temperature[i], rint[i], ehc[i], &params)));
+  }
+  lion_internal_temperature_d_n(temperature, ehc, ambient, TEST_ARRAY_N, &params, out);
+  for (size_t i = 0; i < TEST_ARRAY_N; i++) {
+    LION_ASSERT(close_to(out[i], lion_internal_temperature_d(temperature[i], ehc[i], ambient[i], &params)));
+  }
+
+  // Outputs may alias the inputs
+  memcpy(out, soc, sizeof(out));
+  lion_voc_n(out, TEST_ARRAY_N, &params, out);
+  for (size_t i = 0; i < TEST_ARRAY_N; i++) {
+    LION_ASSERT(close_to(out[i], voc[i]));
+  }
+  return TEST_PASS;
+}
+
+lion_status_t test_resistance_packed(lion_sim_t *sim) {
+  // The packed kernels must match the polarization model set by set, down to
+  // currents where only the sigmoid sets are left
+  lion_params_t params            = lion_params_default();
+  params.rint.model               = LION_RINT_MODEL_POLARIZATION;
+  params.rint.params.polarization = lion_params_default_rint_polarization();
+
+  lion_rint_packed_t packed;
+  lion_resistance_pack(&params, &packed);
+
+  double polys[LION_FUZZY_SETS_COUNT], packed_polys[LION_FUZZY_SETS_COUNT];
+  lion_resistance_polarization_polys(TEST_CURRENT_SOC, &params, polys);
+  lion_resistance_packed_polys(&packed, TEST_CURRENT_SOC, packed_polys);
+  for (int i = 0; i < LION_FUZZY_SETS_COUNT; i++) {
+    double *coeffs = params.rint.params.polarization.poly[i];
+    double  expect = 0.0;
+    for (int j = 0; j < LION_FUZZY_SETS_DEGREE; j++) {
+      expect += coeffs[j] * pow(TEST_CURRENT_SOC, j);
+    }
+    LION_ASSERT(close_to(polys[i], expect));
+    LION_ASSERT(close_to(packed_polys[i], expect));
+  }
+
+  double current[TEST_ARRAY_N], rint[TEST_ARRAY_N], grad[TEST_ARRAY_N];
+  for (size_t i = 0; i < TEST_ARRAY_N; i++) {
+    current[i] = -60.0 + 120.0 * (double)i / (TEST_ARRAY_N - 1);
+  }
+  lion_resistance_packed_n(&packed, polys, current, TEST_ARRAY_N, rint, grad);
+  for (size_t i = 0; i < TEST_ARRAY_N; i++) {
+    double expect_grad;
+    double expect = lion_resistance_polarization_from_polys(polys, current[i], &params, &expect_grad);
+    double single_grad;
+    double single = lion_resistance_packed(&packed, polys, current[i], &single_grad);
+    LION_ASSERT(close_to(single, expect));
+    LION_ASSERT(close_to(rint[i], expect));
+    LION_ASSERT(fabs(single_grad - expect_grad) < 1e-12);
+    LION_ASSERT(fabs(grad[i] - expect_grad) < 1e-12);
+  }
+
+  // The gradient is optional and the resistances may overwrite the currents
+  lion_resistance_packed_n(&packed, polys, current, TEST_ARRAY_N, current, NULL);
+  for (size_t i = 0; i < TEST_ARRAY_N; i++) {
+    LION_ASSERT(close_to(current[i], rint[i]));
+  }
+  return TEST_PASS;
+}
+
+lion_status_t test_array_dispatch(lion_sim_t *sim) {
+  // Every level the CPU supports can be forced and matches the scalar
+  // kernels, while the levels above it are rejected
+  lion_params_t params            = lion_params_default();
+  params.rint.model               = LION_RINT_MODEL_POLARIZATION;
+  params.rint.params.polarization = lion_params_default_rint_polarization();
+  lion_isa_t active               = lion_isa_active();
+  lion_isa_t supported            = lion_isa_supported();
+  LION_ASSERT(active <= supported);
+
+  lion_rint_packed_t packed;
+  double             polys[LION_FUZZY_SETS_COUNT];
+  double             soc[TEST_ARRAY_N], current[TEST_ARRAY_N];
+  double             voc[TEST_ARRAY_N], rint[TEST_ARRAY_N], out[TEST_ARRAY_N];
+  lion_resistance_pack(&params, &packed);
+  lion_resistance_polarization_polys(TEST_CURRENT_SOC, &params, polys);
+  for (size_t i = 0; i < TEST_ARRAY_N; i++) {
+    soc[i]     = 0.02 + 0.98 * (double)i / (TEST_ARRAY_N - 1);
+    current[i] = -60.0 + 120.0 * (double)i / (TEST_ARRAY_N - 1);
+    voc[i]     = lion_voc(soc[i], &params);
+    rint[i]    = lion_resistance_polarization_from_polys(polys, current[i], &params, NULL);
+  }
+
+  for (int level = LION_ISA_SCALAR; level <= (int)supported; level++) {
+    LION_CALL(lion_isa_force((lion_isa_t)level), "Failed forcing instruction set");
+    LION_ASSERT_EQI(lion_isa_active(), (lion_isa_t)level);
+#if defined(LION_SIMD_DISPATCH)
+    LION_ASSERT_STREQ(lion_array_isa(), lion_isa_name((lion_isa_t)level));
+#endif
+    lion_voc_n(soc, TEST_ARRAY_N, &params, out);
+    for (size_t i = 0; i < TEST_ARRAY_N; i++) {
+      LION_ASSERT(close_to(out[i], voc[i]));
+    }
+    lion_resistance_packed_n(&packed, polys, current, TEST_ARRAY_N, out, NULL);
+    for (size_t i = 0; i < TEST_ARRAY_N; i++) {
+      LION_ASSERT(close_to(out[i], rint[i]));
+      LION_ASSERT(close_to(lion_resistance_packed(&packed, polys, current[i], NULL), rint[i]));
+    }
+  }
+  if (supported < LION_ISA_AVX512) {
+    LION_ASSERT_FAILS(lion_isa_force((lion_isa_t)(supported + 1)));
+  }
+  LION_ASSERT_FAILS(lion_isa_force((lion_isa_t)LION_ISA_COUNT));
+
+  LION_CALL(lion_isa_force(active), "Failed restoring instruction set");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_current_newton);
+  LION_CALL_TEST(NULL, test_current_secant);
+  LION_CALL_TEST(NULL, test_current_closed_form);
+  LION_CALL_TEST(NULL, test_model_grads);
+  LION_CALL_TEST(NULL, test_resistance_grad_current);
+  LION_CALL_TEST(NULL, test_eval_context);
+  LION_CALL_TEST(NULL, test_array_kernels);
+  LION_CALL_TEST(NULL, test_resistance_packed);
+  LION_CALL_TEST(NULL, test_array_dispatch);
 
-int main() { return TEST_PASS; }
+  return TEST_PASS;
+}
@@ -0,0 +1,159 @@
+#include <lion/lion.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+#include <math.h>
+
+// The sims keep pointers to their configuration and parameters
+typedef struct run {
+  lion_sim_config_t conf;
+  lion_params_t     params;
+  lion_sim_t        cell;
+} run_t;
+
+static lion_status_t run_backend(lion_model_backend_t backend, uint64_t points, uint64_t rint_points, run_t *run) {
+  run->conf                            = lion_sim_config_default();
+  run->conf.log_stdlvl                 = LOG_ERROR;
+  run->conf.sim_model_backend          = backend;
+  run->conf.sim_table_points           = points;
+  run->conf.sim_table_rint_points      = rint_points;
+  run->params                          = lion_params_default();
+  run->params.init.soc                 = 0.9;
+  run->params.rint.model               = LION_RINT_MODEL_POLARIZATION;
+  run->params.rint.params.polarization = lion_params_default_rint_polarization();
+
+  lion_sim_t *cell = &run->cell;
+  LION_CALL(lion_sim_new(&run->conf, &run->params, cell), "Failed creating sim");
+  LION_CALL(lion_sim_init(cell), "Failed initializing sim");
+  for (size_t k = 0; k < 300; k++) {
+    LION_CALL(lion_sim_step(cell, 8.0, 298.15), "Failed stepping sim");
+  }
+  return TEST_PASS;
+}
+
+lion_status_t test_table_matches_analytic(lion_sim_t *sim) {
+  static run_t analytic_run, table_run;
+  LION_CALL(run_backend(LION_MODEL_BACKEND_ANALYTIC, 1024, 256, &analytic_run), "Failed running analytic backend");
+  LION_CALL(run_backend(LION_MODEL_BACKEND_TABLE, 1024, 256, &table_run), "Failed running table backend");
+  lion_sim_t *analytic = &analytic_run.cell;
+  lion_sim_t *table    = &table_run.cell;
+
+  LION_ASSERT(analytic->table == NULL);
+  LION_ASSERT(table->table != NULL);
+  LION_ASSERT(table->table->voc_error < 1e-5);
+  LION_ASSERT(table->table->ehc_error < 1e-10);
+  LION_ASSERT(table->table->kappa_error < 1e-10);
+  LION_ASSERT(table->table->rint_error < 1e-2);
+
+  LION_ASSERT(fabs(table->state.soc_nominal - analytic->state.soc_nominal) < 1e-6);
+  LION_ASSERT(fabs(table->state.internal_temperature - analytic->state.internal_temperature) < 1e-4);
+  LION_ASSERT(fabs(table->state.voltage - analytic->state.voltage) < 1e-4);
+  LION_ASSERT(fabs(table->state.current - analytic->state.current) < 1e-4);
+
+  LION_CALL(lion_sim_cleanup(analytic), "Failed cleaning up sim");
+  LION_CALL(lion_sim_cleanup(table), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_table_resolution(lion_sim_t *sim) {
+  // Coarser tables report larger errors
+  static run_t coarse_run, fine_run;
+  LION_CALL(run_backend(LION_MODEL_BACKEND_TABLE, 64, 32, &coarse_run), "Failed running coarse tables");
+  LION_CALL(run_backend(LION_MODEL_BACKEND_TABLE, 1024, 256, &fine_run), "Failed running fine tables");
+  lion_sim_t *coarse = &coarse_run.cell;
+  lion_sim_t *fine   = &fine_run.cell;
+
+  LION_ASSERT_EQI(coarse->table->points, 64);
+  LION_ASSERT_EQI(coarse->table->rint_points, 32);
+  LION_ASSERT(coarse->table->voc_error > fine->table->voc_error);
+  LION_ASSERT(coarse->table->kappa_error > fine->table->kappa_error);
+  LION_ASSERT(coarse->table->rint_error > fine->table->rint_error);
+
+  LION_CALL(lion_sim_cleanup(coarse), "Failed cleaning up sim");
+  LION_CALL(lion_sim_cleanup(fine), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_table_fork(lion_sim_t *sim) {
+  // Branches share the tables of the sim and step like it
+  static run_t run;
+  lion_sim_t    branches[2];
+  LION_CALL(run_backend(LION_MODEL_BACKEND_TABLE, 256, 64, &run), "Failed running table backend");
+  lion_sim_t *cell = &run.cell;
+  LION_CALL(lion_sim_fork(cell, 2, branches), "Failed forking sim");
+  LION_ASSERT(branches[0].table == cell->table && branches[1].table == cell->table);
+
+  for (size_t k = 0; k < 10; k++) {
+    LION_CALL(lion_sim_step(cell, 8.0, 298.15), "Failed stepping sim");
+    LION_CALL(lion_sim_step(&branches[0], 8.0, 298.15), "Failed stepping branch");
+  }
+  LION_ASSERT_EQF(branches[0].state.soc_nominal, cell->state.soc_nominal);
+  LION_ASSERT_EQF(branches[0].state.internal_temperature, cell->state.internal_temperature);
+
+  // Cleaning up a branch leaves the tables to the sim, and re-arming one with
+  // parameters builds its own
+  LION_CALL(lion_sim_cleanup(&branches[0]), "Failed cleaning up branch");
+  LION_CALL(lion_sim_rearm(&branches[1], &run.params, NULL), "Failed re-arming branch");
+  LION_ASSERT(branches[1].table != NULL && branches[1].table != cell->table);
+  LION_ASSERT(branches[1].table->rint == (double *)(branches[1].table + 1) + 6 * branches[1].table->points);
+  LION_CALL(lion_sim_step(cell, 8.0, 298.15), "Failed stepping sim");
+  LION_CALL(lion_sim_cleanup(&branches[1]), "Failed cleaning up branch");
+  LION_CALL(lion_sim_cleanup(cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_table_rearm(lion_sim_t *sim) {
+  // Re-arming keeps the tables unless parameters are passed or the table
+  // settings change, which is seen through an error no build would give
+  static run_t run;
+  LION_CALL(run_backend(LION_MODEL_BACKEND_TABLE, 256, 64, &run), "Failed running table backend");
+  lion_sim_t *cell = &run.cell;
+
+  cell->table->voc_error = -1.0;
+  LION_CALL(lion_sim_rearm(cell, NULL, NULL), "Failed re-arming sim");
+  LION_ASSERT_EQF(cell->table->voc_error, -1.0);
+
+  // The same parameters edited in place are picked up when passed again
+  double voc = cell->table->voc[0];
+  run.params.ocv.v0 += 0.1;
+  LION_CALL(lion_sim_rearm(cell, &run.params, NULL), "Failed re-arming sim");
+  LION_ASSERT(cell->table->voc_error >= 0.0);
+  LION_ASSERT(cell->table->voc[0] != voc);
+
+  cell->table->voc_error    = -1.0;
+  run.conf.sim_table_points = 128;
+  LION_CALL(lion_sim_rearm(cell, NULL, NULL), "Failed re-arming sim");
+  LION_ASSERT_EQI(cell->table->points, 128);
+  LION_ASSERT(cell->table->voc_error >= 0.0);
+
+  run.conf.sim_model_backend = LION_MODEL_BACKEND_ANALYTIC;
+  LION_CALL(lion_sim_rearm(cell, NULL, NULL), "Failed re-arming sim");
+  LION_ASSERT(cell->table == NULL);
+
+  LION_CALL(lion_sim_cleanup(cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_table_invalid(lion_sim_t *sim) {
+  lion_sim_config_t conf = lion_sim_config_default();
+  conf.log_stdlvl        = LOG_FATAL;
+  conf.sim_model_backend = LION_MODEL_BACKEND_TABLE;
+  conf.sim_table_points  = 1;
+  lion_params_t params   = lion_params_default();
+
+  lion_sim_t cell;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  LION_ASSERT_FAILS(lion_sim_init(&cell));
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_table_matches_analytic);
+  LION_CALL_TEST(NULL, test_table_resolution);
+  LION_CALL_TEST(NULL, test_table_fork);
+  LION_CALL_TEST(NULL, test_table_rearm);
+  LION_CALL_TEST(NULL, test_table_invalid);
+
+  return TEST_PASS;
+}
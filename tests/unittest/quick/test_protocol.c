@@ -0,0 +1,189 @@
+#include <lion/lion.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+#include <math.h>
+
+#define TEST_PROTOCOL_TOL 1e-6
+
+static lion_status_t test_new_sim(int log_lvl, lion_sim_config_t *conf, lion_params_t *params, lion_sim_t *out) {
+  *conf                  = lion_sim_config_default();
+  conf->log_stdlvl       = log_lvl;
+  conf->sim_step_seconds = 1.0;
+  *params                = lion_params_default();
+  params->init.soc       = 0.5;
+  LION_CALL(lion_sim_new(conf, params, out), "Failed creating sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_protocol_cc_rest(lion_sim_t *sim) {
+  lion_sim_config_t conf;
+  lion_params_t     params;
+  lion_sim_t        cell;
+  LION_CALL(test_new_sim(LOG_ERROR, &conf, &params, &cell), "Failed creating sim");
+
+  lion_segment_t segments[] = {
+      {.type = LION_SEGMENT_CC, .value = 2.0, .duration = 60.0},
+      {.type = LION_SEGMENT_REST, .duration = 30.0},
+  };
+  lion_protocol_t protocol = {.segments = segments, .len = 2, .cycles = 3};
+  LION_CALL(lion_sim_run_protocol(&cell, &protocol, 298.15), "Failed running protocol");
+  LION_ASSERT_EQI(cell.state.step, 3 * (60 + 30));
+  LION_ASSERT_EQI(protocol.cycle, 3);
+  LION_ASSERT(fabs(protocol.segment_start - (2 * 90 + 60)) < TEST_PROTOCOL_TOL);
+
+  // The last step rests, so the terminals show the open circuit voltage, and
+  // the charge drawn is the one of the constant current
+  LION_ASSERT_EQF(cell.state.current, 0.0);
+  LION_ASSERT_EQF(cell.state.voltage, cell.state.open_circuit_voltage);
+  double drawn = 3 * 60 * 2.0 / params.init.capacity;
+  LION_ASSERT(fabs(params.init.soc - cell.state.soc_nominal - drawn) < 1e-3);
+
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_protocol_cp_until(lion_sim_t *sim) {
+  lion_sim_config_t conf;
+  lion_params_t     params;
+  lion_sim_t        cell;
+  LION_CALL(test_new_sim(LOG_ERROR, &conf, &params, &cell), "Failed creating sim");
+
+  // Discharge at constant power until the state of charge falls to a threshold
+  lion_segment_t segments[] = {
+      {.type            = LION_SEGMENT_CP,
+       .value           = 8.0,
+       .until           = LION_STATE_SOC_NOMINAL,
+       .until_threshold = 0.45,
+       .until_direction = LION_EVENT_FALLING},
+  };
+  lion_protocol_t protocol = {.segments = segments, .len = 1, .cycles = 1};
+  LION_CALL(lion_sim_run_protocol(&cell, &protocol, 298.15), "Failed running protocol");
+  LION_ASSERT(cell.state.soc_nominal <= 0.45);
+  LION_ASSERT(fabs(cell.state.power - 8.0) < TEST_PROTOCOL_TOL);
+  LION_ASSERT(cell.state.step > 1);
+
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_protocol_cccv(lion_sim_t *sim) {
+  lion_sim_config_t conf;
+  lion_params_t     params;
+  lion_sim_t        cell;
+  LION_CALL(test_new_sim(LOG_ERROR, &conf, &params, &cell), "Failed creating sim");
+
+  // Charge at constant current until slightly above the open circuit voltage,
+  // then hold it until the current tapers off
+  LION_CALL(lion_sim_init(&cell), "Failed initializing sim");
+  LION_CALL(lion_sim_step(&cell, 0.0, 298.15), "Failed stepping sim");
+  double limit = cell.state.open_circuit_voltage + 0.02;
+
+  lion_segment_t segments[] = {
+      {.type = LION_SEGMENT_CCCV, .value = -2.0, .voltage = limit, .taper = 0.1, .duration = 36000.0},
+  };
+  lion_protocol_t protocol = {.segments = segments, .len = 1, .cycles = 1};
+  LION_CALL(lion_sim_run_protocol(&cell, &protocol, 298.15), "Failed running protocol");
+  LION_ASSERT(fabs(cell.state.current) <= 0.1);
+  LION_ASSERT(cell.state.current < 0.0);
+  LION_ASSERT(fabs(cell.state.voltage - limit) < 1e-4);
+  LION_ASSERT(cell.state.time < 36000.0);
+  LION_ASSERT(cell.state.soc_nominal > params.init.soc);
+
+  // Holding the voltage from the start gives the same taper
+  lion_segment_t cv[] = {
+      {.type = LION_SEGMENT_CV, .value = limit, .taper = 0.1, .duration = 36000.0},
+  };
+  protocol.segments = cv;
+  LION_CALL(lion_sim_run_protocol(&cell, &protocol, 298.15), "Failed running protocol");
+  LION_ASSERT(fabs(cell.state.current) <= 0.1);
+  LION_ASSERT(fabs(cell.state.voltage - limit) < 1e-4);
+
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_protocol_cv_out_of_reach(lion_sim_t *sim) {
+  lion_sim_config_t conf;
+  lion_params_t     params;
+  lion_sim_t        cell;
+  LION_CALL(test_new_sim(LOG_FATAL, &conf, &params, &cell), "Failed creating sim");
+
+  // Holding a voltage that would take more current than the solver allows
+  // fails instead of charging at the bound of the current
+  lion_segment_t segments[] = {
+      {.type = LION_SEGMENT_CV, .value = 500.0, .taper = 0.1, .duration = 60.0},
+  };
+  lion_protocol_t protocol = {.segments = segments, .len = 1, .cycles = 1};
+  LION_ASSERT_FAILS(lion_sim_run_protocol(&cell, &protocol, 298.15));
+  LION_ASSERT_EQI(cell.state.step, 0);
+
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_protocol_stop_event(lion_sim_t *sim) {
+  lion_sim_config_t conf;
+  lion_params_t     params;
+  lion_sim_t        cell;
+  LION_CALL(test_new_sim(LOG_ERROR, &conf, &params, &cell), "Failed creating sim");
+
+  lion_event_t cutoff = {
+      .name      = "cutoff",
+      .field     = LION_STATE_SOC_NOMINAL,
+      .threshold = 0.48,
+      .direction = LION_EVENT_FALLING,
+      .action    = LION_EVENT_STOP,
+  };
+  LION_CALL(lion_sim_add_event(&cell, &cutoff), "Failed adding event");
+
+  lion_segment_t segments[] = {
+      {.type = LION_SEGMENT_CC, .value = 4.0, .duration = 36000.0},
+      {.type = LION_SEGMENT_REST, .duration = 60.0},
+  };
+  lion_protocol_t protocol = {.segments = segments, .len = 2, .cycles = 1};
+  LION_CALL(lion_sim_run_protocol(&cell, &protocol, 298.15), "Failed running protocol");
+  LION_ASSERT(lion_sim_should_close(&cell));
+  LION_ASSERT_EQI(protocol.segment, 0);
+  LION_ASSERT_EQI(cell.events[0].triggered, 1);
+
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_protocol_invalid(lion_sim_t *sim) {
+  lion_sim_config_t conf;
+  lion_params_t     params;
+  lion_sim_t        cell;
+  LION_CALL(test_new_sim(LOG_FATAL, &conf, &params, &cell), "Failed creating sim");
+
+  // Segments without any condition to end on are rejected before running
+  lion_segment_t  endless[]  = {{.type = LION_SEGMENT_CC, .value = 1.0}};
+  lion_protocol_t protocol   = {.segments = endless, .len = 1, .cycles = 1};
+  LION_ASSERT_FAILS(lion_sim_run_protocol(&cell, &protocol, 298.15));
+  lion_segment_t taperless[] = {{.type = LION_SEGMENT_CC, .value = 1.0, .taper = 0.1}};
+  protocol.segments          = taperless;
+  LION_ASSERT_FAILS(lion_sim_run_protocol(&cell, &protocol, 298.15));
+  lion_segment_t fields[]    = {{.type = LION_SEGMENT_REST, .until = LION_STATE_VOLTAGE | LION_STATE_CURRENT}};
+  protocol.segments          = fields;
+  LION_ASSERT_FAILS(lion_sim_run_protocol(&cell, &protocol, 298.15));
+  lion_segment_t rest[]      = {{.type = LION_SEGMENT_REST, .duration = 1.0}};
+  protocol.segments          = rest;
+  protocol.cycles            = 0;
+  LION_ASSERT_FAILS(lion_sim_run_protocol(&cell, &protocol, 298.15));
+  LION_ASSERT_EQI(cell.state.step, 0);
+
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_protocol_cc_rest);
+  LION_CALL_TEST(NULL, test_protocol_cp_until);
+  LION_CALL_TEST(NULL, test_protocol_cccv);
+  LION_CALL_TEST(NULL, test_protocol_cv_out_of_reach);
+  LION_CALL_TEST(NULL, test_protocol_stop_event);
+  LION_CALL_TEST(NULL, test_protocol_invalid);
+
+  return TEST_PASS;
+}
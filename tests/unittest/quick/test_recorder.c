@@ -0,0 +1,72 @@
+#include <lion/lion.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+
+#define TEST_RECORDER_STEPS 700
+
+static double test_power(uint64_t k) { return 4.0 - 6.0 * (double)((k / 100) % 2); }
+
+lion_status_t test_recorder_matches_state(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  lion_params_t     params = lion_params_default();
+
+  lion_sim_t rec_sim;
+  LION_CALL(lion_sim_new(&conf, &params, &rec_sim), "Failed creating sim");
+  LION_CALL(lion_sim_init(&rec_sim), "Failed initializing sim");
+
+  // A tiny capacity forces the columns to grow several times
+  lion_recorder_t recorder;
+  LION_CALL(lion_recorder_new(LION_STATE_STEP | LION_STATE_VOLTAGE | LION_STATE_SOC_NOMINAL, 16, &recorder), "Failed creating recorder");
+  rec_sim.recorder = &recorder;
+
+  lion_sim_t ref_sim;
+  LION_CALL(lion_sim_new(&conf, &params, &ref_sim), "Failed creating sim");
+  LION_CALL(lion_sim_init(&ref_sim), "Failed initializing sim");
+
+  for (uint64_t k = 0; k < TEST_RECORDER_STEPS; k++) {
+    LION_CALL(lion_sim_step(&rec_sim, test_power(k), 298.15), "Failed stepping sim");
+    LION_CALL(lion_sim_step(&ref_sim, test_power(k), 298.15), "Failed stepping sim");
+    // Earlier values must survive the columns growing
+    LION_ASSERT_EQF(recorder.columns.voltage[k], ref_sim.state.voltage);
+    LION_ASSERT_EQF(recorder.columns.soc_nominal[k], ref_sim.state.soc_nominal);
+    LION_ASSERT_EQI(recorder.columns.step[k], ref_sim.state.step);
+  }
+  LION_ASSERT_EQI(recorder.len, TEST_RECORDER_STEPS);
+  LION_ASSERT(recorder.capacity >= TEST_RECORDER_STEPS);
+  LION_ASSERT(recorder.columns.current == NULL);
+  LION_ASSERT(recorder.columns.time == NULL);
+
+  // Clearing keeps the columns around for the next run
+  size_t capacity = recorder.capacity;
+  lion_recorder_clear(&recorder);
+  LION_CALL(lion_sim_step(&rec_sim, 1.0, 298.15), "Failed stepping sim");
+  LION_ASSERT_EQI(recorder.len, 1);
+  LION_ASSERT_EQI(recorder.capacity, capacity);
+  LION_ASSERT_EQF(recorder.columns.voltage[0], rec_sim.state.voltage);
+
+  rec_sim.recorder = NULL;
+  LION_CALL(lion_recorder_cleanup(&recorder), "Failed cleaning up recorder");
+  LION_ASSERT(recorder.columns.voltage == NULL);
+  LION_CALL(lion_sim_cleanup(&rec_sim), "Failed cleaning up sim");
+  LION_CALL(lion_sim_cleanup(&ref_sim), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_recorder_rejects_unknown_fields(lion_sim_t *sim) {
+  lion_recorder_t recorder;
+  LION_ASSERT_FAILS(lion_recorder_new(LION_STATE_ALL + 1, 0, &recorder));
+  LION_CALL(lion_recorder_new(LION_STATE_ALL, 0, &recorder), "Failed creating recorder");
+  LION_ASSERT(recorder.capacity > 0);
+  LION_ASSERT(recorder.columns.capacity_use != NULL);
+  LION_CALL(lion_recorder_cleanup(&recorder), "Failed cleaning up recorder");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_recorder_matches_state);
+  LION_CALL_TEST(NULL, test_recorder_rejects_unknown_fields);
+
+  return TEST_PASS;
+}
@@ -0,0 +1,83 @@
+#include <lion/lion.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+#include <math.h>
+
+#define TEST_ADAPTIVE_SECONDS   600
+#define TEST_ADAPTIVE_FINE_STEP 1e-2
+#define TEST_ADAPTIVE_TOL_SOC   1e-5
+#define TEST_ADAPTIVE_TOL_TEMP  1e-4
+
+// Piecewise constant duty cycle, with the inputs changing once a minute
+static double test_power(double t) { return 4.0 - 7.0 * (double)(((uint64_t)t / 60) % 2); }
+
+static double test_ambient_temperature(double t) { return 293.15 + 2.0 * (double)((uint64_t)t / 120); }
+
+lion_status_t test_adaptive_matches_fixed(lion_sim_t *sim) {
+  lion_params_t params = lion_params_default();
+
+  // Reference with a fine fixed step, repeating each input sample
+  lion_sim_config_t fixed_conf = lion_sim_config_default();
+  fixed_conf.log_stdlvl        = LOG_ERROR;
+  fixed_conf.sim_step_seconds  = TEST_ADAPTIVE_FINE_STEP;
+
+  lion_sim_t fixed;
+  LION_CALL(lion_sim_new(&fixed_conf, &params, &fixed), "Failed creating fixed sim");
+  LION_CALL(lion_sim_init(&fixed), "Failed initializing fixed sim");
+  uint64_t fixed_steps = (uint64_t)llround(TEST_ADAPTIVE_SECONDS / TEST_ADAPTIVE_FINE_STEP);
+  for (uint64_t k = 0; k < fixed_steps; k++) {
+    double t = (double)k * TEST_ADAPTIVE_FINE_STEP;
+    LION_CALL(lion_sim_step(&fixed, test_power(t), test_ambient_temperature(t)), "Failed stepping fixed sim");
+  }
+
+  // Adaptive sim sampling the inputs once a second
+  lion_sim_config_t adaptive_conf = lion_sim_config_default();
+  adaptive_conf.log_stdlvl        = LOG_ERROR;
+  adaptive_conf.sim_step_mode     = LION_STEP_MODE_ADAPTIVE;
+  adaptive_conf.sim_step_seconds  = 1.0;
+  adaptive_conf.sim_epsabs        = 1e-10;
+  adaptive_conf.sim_epsrel        = 1e-10;
+
+  lion_sim_t adaptive;
+  LION_CALL(lion_sim_new(&adaptive_conf, &params, &adaptive), "Failed creating adaptive sim");
+  LION_CALL(lion_sim_init(&adaptive), "Failed initializing adaptive sim");
+  for (uint64_t k = 0; k < TEST_ADAPTIVE_SECONDS; k++) {
+    double t = (double)k;
+    LION_CALL(lion_sim_step(&adaptive, test_power(t), test_ambient_temperature(t)), "Failed stepping adaptive sim");
+  }
+
+  LION_ASSERT(fabs(adaptive.state.time - fixed.state.time) < 1e-6);
+  LION_ASSERT(fabs(adaptive.state._next_soc_nominal - fixed.state._next_soc_nominal) < TEST_ADAPTIVE_TOL_SOC);
+  LION_ASSERT(fabs(adaptive.state._next_internal_temperature - fixed.state._next_internal_temperature) < TEST_ADAPTIVE_TOL_TEMP);
+  LION_ASSERT(fabs(adaptive.state.voltage - fixed.state.voltage) < 1e-3);
+
+  // Every input interval takes at least one internal step, but far fewer than
+  // the fixed step needs
+  LION_ASSERT(adaptive.driver->e->count >= TEST_ADAPTIVE_SECONDS);
+  LION_ASSERT(adaptive.driver->e->count < fixed_steps / 10);
+
+  LION_CALL(lion_sim_cleanup(&fixed), "Failed cleaning up fixed sim");
+  LION_CALL(lion_sim_cleanup(&adaptive), "Failed cleaning up adaptive sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_adaptive_invalid_mode(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_FATAL;
+  conf.sim_step_mode       = (lion_step_mode_t)42;
+  lion_params_t     params = lion_params_default();
+
+  lion_sim_t bad;
+  LION_CALL(lion_sim_new(&conf, &params, &bad), "Failed creating sim");
+  LION_ASSERT_FAILS(lion_sim_init(&bad));
+  LION_CALL(lion_sim_cleanup(&bad), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_adaptive_matches_fixed);
+  LION_CALL_TEST(NULL, test_adaptive_invalid_mode);
+
+  return TEST_PASS;
+}
@@ -0,0 +1,104 @@
+#include <lion/lion.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+#include <math.h>
+
+#define TEST_CURRENT_STEPS 300
+#define TEST_CURRENT_POWER 8.0
+
+lion_status_t test_current_matches_power(lion_sim_t *sim) {
+  // Prescribing the currents solved by a power driven sim must give back the
+  // same power and trajectory
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_seconds    = 1.0;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  lion_sim_t by_power;
+  LION_CALL(lion_sim_new(&conf, &params, &by_power), "Failed creating sim");
+  LION_CALL(lion_sim_init(&by_power), "Failed initializing sim");
+
+  lion_sim_config_t current_conf = conf;
+  current_conf.sim_input_mode    = LION_INPUT_MODE_CURRENT;
+  lion_sim_t by_current;
+  LION_CALL(lion_sim_new(&current_conf, &params, &by_current), "Failed creating sim");
+  LION_CALL(lion_sim_init(&by_current), "Failed initializing sim");
+
+  for (size_t k = 0; k < TEST_CURRENT_STEPS; k++) {
+    LION_CALL(lion_sim_step(&by_power, TEST_CURRENT_POWER, 298.15), "Failed stepping sim");
+    LION_CALL(lion_sim_step_current(&by_current, by_power.state.current, 298.15), "Failed stepping sim");
+    LION_ASSERT_EQF(by_current.state.current, by_power.state.current);
+    LION_ASSERT(fabs(by_current.state.power - TEST_CURRENT_POWER) < 1e-6);
+    LION_ASSERT(fabs(by_current.state.voltage - by_power.state.voltage) < 1e-6);
+  }
+  LION_ASSERT(fabs(by_current.state.soc_nominal - by_power.state.soc_nominal) < 1e-9);
+  LION_ASSERT(fabs(by_current.state.internal_temperature - by_power.state.internal_temperature) < 1e-9);
+
+  LION_CALL(lion_sim_cleanup(&by_power), "Failed cleaning up sim");
+  LION_CALL(lion_sim_cleanup(&by_current), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_current_run(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_seconds    = 1.0;
+  conf.sim_input_mode      = LION_INPUT_MODE_CURRENT;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  lion_vector_t current;
+  lion_vector_t amb_temp;
+  LION_CALL(lion_vector_new(NULL, sizeof(double), &current), "Failed creating vector");
+  LION_CALL(lion_vector_new(NULL, sizeof(double), &amb_temp), "Failed creating vector");
+  for (size_t k = 0; k < TEST_CURRENT_STEPS; k++) {
+    LION_CALL(lion_vector_push_d(NULL, &current, 2.0), "Failed pushing current");
+    LION_CALL(lion_vector_push_d(NULL, &amb_temp, 298.15), "Failed pushing ambient temperature");
+  }
+
+  // Vectors given to the running functions are read as currents
+  lion_sim_t cell;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  LION_CALL(lion_sim_run(&cell, &current, &amb_temp), "Failed running sim");
+  LION_ASSERT_EQI(cell.state.step, TEST_CURRENT_STEPS - 1);
+  LION_ASSERT_EQF(cell.state.current, 2.0);
+  LION_ASSERT_EQF(cell.state.power, cell.state.voltage * cell.state.current);
+  LION_ASSERT(cell.state.voltage < cell.state.open_circuit_voltage);
+  LION_ASSERT(cell.state.soc_nominal < params.init.soc);
+
+  // At rest the terminals show the open circuit voltage
+  LION_CALL(lion_sim_step_current(&cell, 0.0, 298.15), "Failed stepping sim");
+  LION_ASSERT_EQF(cell.state.voltage, cell.state.open_circuit_voltage);
+  LION_ASSERT_EQF(cell.state.power, 0.0);
+
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  LION_CALL(lion_vector_cleanup(NULL, &current), "Failed cleaning up vector");
+  LION_CALL(lion_vector_cleanup(NULL, &amb_temp), "Failed cleaning up vector");
+  return TEST_PASS;
+}
+
+lion_status_t test_current_mode_mismatch(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_FATAL;
+  lion_params_t     params = lion_params_default();
+
+  lion_sim_t cell;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  LION_CALL(lion_sim_init(&cell), "Failed initializing sim");
+  LION_ASSERT_FAILS(lion_sim_step_current(&cell, 1.0, 298.15));
+  conf.sim_input_mode = LION_INPUT_MODE_CURRENT;
+  LION_ASSERT_FAILS(lion_sim_step(&cell, 1.0, 298.15));
+  LION_ASSERT_EQI(cell.state.step, 0);
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_current_matches_power);
+  LION_CALL_TEST(NULL, test_current_run);
+  LION_CALL_TEST(NULL, test_current_mode_mismatch);
+
+  return TEST_PASS;
+}
@@ -0,0 +1,143 @@
+#include <lion/lion.h>
+#include <lion_utils/test.h>
+#include <lion_utils/thread.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+
+#define TEST_FORK_BRANCHES 4
+#define TEST_FORK_PREFIX   100
+#define TEST_FORK_STEPS    200
+
+typedef struct test_branch {
+  lion_sim_t   *sim;
+  double        power;
+  lion_status_t status;
+} test_branch_t;
+
+static lion_status_t test_steps(lion_sim_t *sim, double power, size_t steps) {
+  for (size_t k = 0; k < steps; k++) {
+    LION_CALL(lion_sim_step(sim, power, 298.15), "Failed stepping sim");
+  }
+  return TEST_PASS;
+}
+
+static void *test_branch_run(void *arg) {
+  test_branch_t *branch = arg;
+  branch->status        = test_steps(branch->sim, branch->power, TEST_FORK_STEPS);
+  return NULL;
+}
+
+static double test_power(size_t i) { return 2.0 * (double)(i + 1); }
+
+lion_status_t test_fork_parallel_branches(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_seconds    = 1.0;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  lion_sim_t cell;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  LION_CALL(lion_sim_init(&cell), "Failed initializing sim");
+  LION_CALL(test_steps(&cell, 4.0, TEST_FORK_PREFIX), "Failed stepping sim");
+
+  lion_sim_t branches[TEST_FORK_BRANCHES];
+  LION_CALL(lion_sim_fork(&cell, TEST_FORK_BRANCHES, branches), "Failed forking sim");
+  for (size_t i = 0; i < TEST_FORK_BRANCHES; i++) {
+    LION_ASSERT(branches[i].driver != cell.driver);
+    LION_ASSERT(branches[i].params == cell.params);
+    LION_ASSERT_EQI(branches[i].state.step, TEST_FORK_PREFIX);
+  }
+
+  test_branch_t runs[TEST_FORK_BRANCHES];
+  lion_thread_t threads[TEST_FORK_BRANCHES];
+  for (size_t i = 0; i < TEST_FORK_BRANCHES; i++) {
+    runs[i].sim   = &branches[i];
+    runs[i].power = test_power(i);
+    LION_CALL(lion_thread_create(&threads[i], &test_branch_run, &runs[i]), "Failed creating thread");
+  }
+  for (size_t i = 0; i < TEST_FORK_BRANCHES; i++) {
+    LION_CALL(lion_thread_join(&threads[i]), "Failed joining thread");
+    LION_CALL(runs[i].status, "Failed running branch");
+  }
+
+  // The sim itself is left where it was forked, and each branch matches the
+  // sim stepped with the same input
+  LION_ASSERT_EQI(cell.state.step, TEST_FORK_PREFIX);
+  for (size_t i = 0; i < TEST_FORK_BRANCHES; i++) {
+    lion_sim_t reference;
+    LION_CALL(lion_sim_fork(&cell, 1, &reference), "Failed forking sim");
+    LION_CALL(test_steps(&reference, test_power(i), TEST_FORK_STEPS), "Failed stepping sim");
+    LION_ASSERT_EQI(branches[i].state.step, reference.state.step);
+    LION_ASSERT_EQF(branches[i].state.soc_nominal, reference.state.soc_nominal);
+    LION_ASSERT_EQF(branches[i].state.internal_temperature, reference.state.internal_temperature);
+    LION_ASSERT_EQF(branches[i].state.voltage, reference.state.voltage);
+    LION_CALL(lion_sim_cleanup(&reference), "Failed cleaning up sim");
+  }
+  LION_ASSERT(branches[0].state.soc_nominal > branches[TEST_FORK_BRANCHES - 1].state.soc_nominal);
+
+  LION_CALL(test_steps(&cell, test_power(0), TEST_FORK_STEPS), "Failed stepping sim");
+  LION_ASSERT_EQF(cell.state.soc_nominal, branches[0].state.soc_nominal);
+  LION_ASSERT_EQF(cell.state.voltage, branches[0].state.voltage);
+
+  for (size_t i = 0; i < TEST_FORK_BRANCHES; i++) {
+    LION_CALL(lion_sim_cleanup(&branches[i]), "Failed cleaning up sim");
+  }
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_fork_current_mode(lion_sim_t *sim) {
+  // Branches keep the input mode of the sim, so their first step does not drop
+  // the history of the implicit steps
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_mode       = LION_STEP_MODE_DAE;
+  conf.sim_input_mode      = LION_INPUT_MODE_CURRENT;
+  conf.sim_step_seconds    = 10.0;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  lion_sim_t cell;
+  lion_sim_t branch;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  LION_CALL(lion_sim_init(&cell), "Failed initializing sim");
+  for (size_t k = 0; k < 10; k++) {
+    LION_CALL(lion_sim_step_current(&cell, 2.0, 298.15), "Failed stepping sim");
+  }
+
+  LION_CALL(lion_sim_fork(&cell, 1, &branch), "Failed forking sim");
+  LION_ASSERT_EQI(branch._input_mode, LION_INPUT_MODE_CURRENT);
+  for (size_t k = 0; k < 10; k++) {
+    LION_CALL(lion_sim_step_current(&cell, 2.0, 298.15), "Failed stepping sim");
+    LION_CALL(lion_sim_step_current(&branch, 2.0, 298.15), "Failed stepping sim");
+  }
+  LION_ASSERT_EQF(branch.state.soc_nominal, cell.state.soc_nominal);
+  LION_ASSERT_EQF(branch.state.internal_temperature, cell.state.internal_temperature);
+  LION_ASSERT_EQF(branch.state.voltage, cell.state.voltage);
+
+  LION_CALL(lion_sim_cleanup(&branch), "Failed cleaning up sim");
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_fork_uninitialized(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_FATAL;
+  lion_params_t     params = lion_params_default();
+
+  lion_sim_t cell;
+  lion_sim_t branch;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  LION_ASSERT_FAILS(lion_sim_fork(&cell, 1, &branch));
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_fork_parallel_branches);
+  LION_CALL_TEST(NULL, test_fork_current_mode);
+  LION_CALL_TEST(NULL, test_fork_uninitialized);
+
+  return TEST_PASS;
+}
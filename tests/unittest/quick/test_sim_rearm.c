@@ -0,0 +1,113 @@
+#include <gsl/gsl_odeiv2.h>
+#include <lion/lion.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+
+#define TEST_REARM_STEPS 200
+#define TEST_REARM_POWER 8.0
+
+static lion_status_t test_steps(lion_sim_t *sim) {
+  for (size_t k = 0; k < TEST_REARM_STEPS; k++) {
+    LION_CALL(lion_sim_step(sim, TEST_REARM_POWER, 298.15), "Failed stepping sim");
+  }
+  return TEST_PASS;
+}
+
+lion_status_t test_rearm_matches_fresh(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_seconds    = 1.0;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  lion_sim_t cell;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  LION_CALL(lion_sim_init(&cell), "Failed initializing sim");
+  gsl_odeiv2_driver  *driver  = cell.driver;
+  gsl_min_fminimizer *sys_min = cell.sys_min;
+  LION_CALL(test_steps(&cell), "Failed stepping sim");
+
+  // Re-armed with other initial conditions, the sim must follow a fresh one
+  // while keeping its driver and minimizer, and leaving its parameters alone
+  lion_params_init_t init = params.init;
+  init.soc                = 0.6;
+  LION_CALL(lion_sim_rearm(&cell, NULL, &init), "Failed re-arming sim");
+  LION_ASSERT_EQF(params.init.soc, 0.9);
+  LION_ASSERT(cell.driver == driver);
+  LION_ASSERT(cell.sys_min == sys_min);
+  LION_ASSERT_EQI(cell.state.step, 0);
+  LION_ASSERT_EQF(cell.state.time, 0.0);
+  LION_CALL(test_steps(&cell), "Failed stepping sim");
+
+  lion_params_t fresh_params = lion_params_default();
+  fresh_params.init.soc      = 0.6;
+  lion_sim_t fresh;
+  LION_CALL(lion_sim_new(&conf, &fresh_params, &fresh), "Failed creating sim");
+  LION_CALL(lion_sim_init(&fresh), "Failed initializing sim");
+  LION_CALL(test_steps(&fresh), "Failed stepping sim");
+
+  LION_ASSERT_EQI(cell.state.step, fresh.state.step);
+  LION_ASSERT_EQF(cell.state.soc_nominal, fresh.state.soc_nominal);
+  LION_ASSERT_EQF(cell.state.internal_temperature, fresh.state.internal_temperature);
+  LION_ASSERT_EQF(cell.state.voltage, fresh.state.voltage);
+
+  // Swapping the parameters as a whole works the same way, and without
+  // initial conditions the ones of the parameters are taken again
+  LION_CALL(lion_sim_rearm(&fresh, &params, NULL), "Failed re-arming sim");
+  LION_CALL(lion_sim_rearm(&cell, NULL, NULL), "Failed re-arming sim");
+  LION_ASSERT(fresh.params == &params);
+  LION_ASSERT_EQF(fresh.state._next_soc_nominal, 0.9);
+  LION_CALL(test_steps(&fresh), "Failed stepping sim");
+  LION_CALL(test_steps(&cell), "Failed stepping sim");
+  LION_ASSERT_EQF(cell.state.soc_nominal, fresh.state.soc_nominal);
+  LION_ASSERT_EQF(cell.state.voltage, fresh.state.voltage);
+
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  LION_CALL(lion_sim_cleanup(&fresh), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_rearm_run_reuses_driver(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_seconds    = 1.0;
+  lion_params_t     params = lion_params_default();
+
+  lion_vector_t power;
+  lion_vector_t amb_temp;
+  LION_CALL(lion_vector_new(NULL, sizeof(double), &power), "Failed creating vector");
+  LION_CALL(lion_vector_new(NULL, sizeof(double), &amb_temp), "Failed creating vector");
+  for (size_t k = 0; k < TEST_REARM_STEPS; k++) {
+    LION_CALL(lion_vector_push_d(NULL, &power, TEST_REARM_POWER), "Failed pushing power");
+    LION_CALL(lion_vector_push_d(NULL, &amb_temp, 298.15), "Failed pushing ambient temperature");
+  }
+
+  lion_sim_t cell;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  LION_CALL(lion_sim_run(&cell, &power, &amb_temp), "Failed running sim");
+  gsl_odeiv2_driver *driver  = cell.driver;
+  double             voltage = cell.state.voltage;
+
+  // Running again starts over from the initial conditions with the same driver
+  LION_CALL(lion_sim_run(&cell, &power, &amb_temp), "Failed running sim");
+  LION_ASSERT(cell.driver == driver);
+  LION_ASSERT_EQF(cell.state.voltage, voltage);
+
+  // Changing the stepper replaces the driver
+  conf.sim_stepper = LION_STEPPER_RK4;
+  LION_CALL(lion_sim_rearm(&cell, NULL, NULL), "Failed re-arming sim");
+  LION_ASSERT(cell.driver->s->type == gsl_odeiv2_step_rk4);
+
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  LION_CALL(lion_vector_cleanup(NULL, &power), "Failed cleaning up vector");
+  LION_CALL(lion_vector_cleanup(NULL, &amb_temp), "Failed cleaning up vector");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_rearm_matches_fresh);
+  LION_CALL_TEST(NULL, test_rearm_run_reuses_driver);
+
+  return TEST_PASS;
+}
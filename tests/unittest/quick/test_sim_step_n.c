@@ -0,0 +1,124 @@
+#include <lion/lion.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+
+#define TEST_STEP_N_STEPS 1000
+
+static void test_inputs(double *power, double *amb_temp) {
+  for (size_t k = 0; k < TEST_STEP_N_STEPS; k++) {
+    power[k]    = 3.0 - 5.0 * (double)((k / 200) % 2);
+    amb_temp[k] = 293.15 + 0.01 * (double)k;
+  }
+}
+
+lion_status_t test_step_n_matches_step(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  lion_params_t     params = lion_params_default();
+
+  double power[TEST_STEP_N_STEPS];
+  double amb_temp[TEST_STEP_N_STEPS];
+  test_inputs(power, amb_temp);
+
+  lion_sim_t single;
+  LION_CALL(lion_sim_new(&conf, &params, &single), "Failed creating sim");
+  LION_CALL(lion_sim_init(&single), "Failed initializing sim");
+
+  lion_sim_t bulk;
+  LION_CALL(lion_sim_new(&conf, &params, &bulk), "Failed creating sim");
+  LION_CALL(lion_sim_init(&bulk), "Failed initializing sim");
+
+  // Only some of the columns are requested, the rest must be left alone
+  double               voltage[TEST_STEP_N_STEPS];
+  double               soc[TEST_STEP_N_STEPS];
+  uint64_t             step[TEST_STEP_N_STEPS];
+  lion_state_columns_t columns = {
+      .voltage     = voltage,
+      .soc_nominal = soc,
+      .step        = step,
+  };
+  size_t taken = 0;
+  LION_CALL(lion_sim_step_n(&bulk, power, amb_temp, TEST_STEP_N_STEPS, &columns, &taken), "Failed bulk stepping");
+  LION_ASSERT_EQI(taken, TEST_STEP_N_STEPS);
+
+  for (size_t k = 0; k < TEST_STEP_N_STEPS; k++) {
+    LION_CALL(lion_sim_step(&single, power[k], amb_temp[k]), "Failed stepping sim");
+    LION_ASSERT_EQF(voltage[k], single.state.voltage);
+    LION_ASSERT_EQF(soc[k], single.state.soc_nominal);
+    LION_ASSERT_EQI(step[k], single.state.step);
+  }
+  LION_ASSERT_EQF(bulk.state.internal_temperature, single.state.internal_temperature);
+  LION_ASSERT(columns.current == NULL);
+
+  LION_CALL(lion_sim_cleanup(&single), "Failed cleaning up sim");
+  LION_CALL(lion_sim_cleanup(&bulk), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_step_n_without_columns(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  lion_params_t     params = lion_params_default();
+
+  double power[TEST_STEP_N_STEPS];
+  double amb_temp[TEST_STEP_N_STEPS];
+  test_inputs(power, amb_temp);
+
+  lion_sim_t bulk;
+  LION_CALL(lion_sim_new(&conf, &params, &bulk), "Failed creating sim");
+  LION_CALL(lion_sim_init(&bulk), "Failed initializing sim");
+  LION_CALL(lion_sim_step_n(&bulk, power, amb_temp, TEST_STEP_N_STEPS / 2, NULL, NULL), "Failed bulk stepping");
+  LION_CALL(lion_sim_step_n(&bulk, power + TEST_STEP_N_STEPS / 2, amb_temp + TEST_STEP_N_STEPS / 2, TEST_STEP_N_STEPS / 2, NULL, NULL), "Failed bulk stepping");
+  LION_ASSERT_EQI(bulk.state.step, TEST_STEP_N_STEPS);
+  LION_CALL(lion_sim_step_n(&bulk, power, amb_temp, 0, NULL, NULL), "Failed stepping zero times");
+  LION_ASSERT_EQI(bulk.state.step, TEST_STEP_N_STEPS);
+  LION_CALL(lion_sim_cleanup(&bulk), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_step_n_stop(lion_sim_t *sim) {
+  // A stop event ends the steps early, and the columns only hold those taken
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  lion_params_t     params = lion_params_default();
+
+  double power[TEST_STEP_N_STEPS];
+  double amb_temp[TEST_STEP_N_STEPS];
+  test_inputs(power, amb_temp);
+
+  lion_sim_t bulk;
+  LION_CALL(lion_sim_new(&conf, &params, &bulk), "Failed creating sim");
+  lion_event_t stop = {
+      .name      = "stop",
+      .field     = LION_STATE_SOC_NOMINAL,
+      .threshold = params.init.soc - 1e-5,
+      .direction = LION_EVENT_FALLING,
+      .action    = LION_EVENT_STOP,
+  };
+  LION_CALL(lion_sim_add_event(&bulk, &stop), "Failed adding event");
+  LION_CALL(lion_sim_init(&bulk), "Failed initializing sim");
+
+  uint64_t             step[TEST_STEP_N_STEPS];
+  lion_state_columns_t columns = {.step = step};
+  size_t               taken   = 0;
+  LION_CALL(lion_sim_step_n(&bulk, power, amb_temp, TEST_STEP_N_STEPS, &columns, &taken), "Failed bulk stepping");
+  LION_ASSERT(lion_sim_should_close(&bulk));
+  LION_ASSERT(taken > 0 && taken < TEST_STEP_N_STEPS);
+  LION_ASSERT_EQI(bulk.state.step, taken);
+  LION_ASSERT_EQI(step[taken - 1], bulk.state.step);
+
+  // Once stopped no more steps are taken
+  LION_CALL(lion_sim_step_n(&bulk, power, amb_temp, TEST_STEP_N_STEPS, NULL, &taken), "Failed bulk stepping");
+  LION_ASSERT_EQI(taken, 0);
+  LION_CALL(lion_sim_cleanup(&bulk), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_step_n_matches_step);
+  LION_CALL_TEST(NULL, test_step_n_without_columns);
+  LION_CALL_TEST(NULL, test_step_n_stop);
+
+  return TEST_PASS;
+}
@@ -0,0 +1,125 @@
+#include <lion/lion.h>
+#include <lion_utils/test.h>
+#include <lion_utils/thread.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_THREADS_COUNT 8
+#define TEST_THREADS_STEPS 2000
+
+typedef struct test_job {
+  lion_sim_config_t conf;
+  lion_params_t     params;
+  lion_sim_state_t  state;
+  uint64_t          messages;
+  lion_status_t     status;
+} test_job_t;
+
+static void test_count_messages(log_Event *ev) { (*(uint64_t *)ev->udata)++; }
+
+static void test_job_setup(test_job_t *job, size_t index) {
+  job->conf                = lion_sim_config_default();
+  // Mix levels so that a sim picking up the level of another one would be noticed
+  job->conf.log_stdlvl     = (index % 2) ? LOG_FATAL : LOG_ERROR;
+  job->conf.sim_stepper    = (index % 3) ? LION_STEPPER_RKF45 : LION_STEPPER_RK4;
+  job->params              = lion_params_default();
+  job->params.init.soc     = 0.2 + 0.07 * (double)index;
+  job->params.init.temp_in = 293.15 + (double)index;
+  job->messages            = 0;
+  job->status              = LION_STATUS_FAILURE;
+}
+
+static lion_status_t test_job_run(test_job_t *job, size_t index) {
+  lion_sim_t sim;
+  LION_CALL(lion_sim_new(&job->conf, &job->params, &sim), "Failed creating sim");
+  // Every message of this sim, whatever its level, ends up in this counter
+  log_logger_add_callback(&sim.logger, test_count_messages, &job->messages, LOG_TRACE);
+  LION_CALL(lion_sim_init(&sim), "Failed initializing sim");
+  for (uint64_t k = 0; k < TEST_THREADS_STEPS; k++) {
+    double power = 1.5 + 0.5 * (double)index - 4.0 * (double)((k / 250) % 2);
+    LION_CALL(lion_sim_step(&sim, power, 298.15), "Failed stepping sim");
+  }
+  job->state = sim.state;
+  LION_CALL(lion_sim_cleanup(&sim), "Failed cleaning up sim");
+  return LION_STATUS_SUCCESS;
+}
+
+typedef struct test_worker {
+  test_job_t *job;
+  size_t      index;
+} test_worker_t;
+
+static void *test_worker_fn(void *arg) {
+  test_worker_t *worker = arg;
+  worker->job->status   = test_job_run(worker->job, worker->index);
+  return NULL;
+}
+
+lion_status_t test_sim_threads(lion_sim_t *sim) {
+  int default_level = log_get_logger()->level;
+
+  test_job_t    serial[TEST_THREADS_COUNT];
+  test_job_t    parallel[TEST_THREADS_COUNT];
+  test_worker_t workers[TEST_THREADS_COUNT];
+  lion_thread_t threads[TEST_THREADS_COUNT];
+  for (size_t i = 0; i < TEST_THREADS_COUNT; i++) {
+    test_job_setup(&serial[i], i);
+    test_job_setup(&parallel[i], i);
+    LION_CALL(test_job_run(&serial[i], i), "Failed running serial sim");
+  }
+
+  for (size_t i = 0; i < TEST_THREADS_COUNT; i++) {
+    workers[i] = (test_worker_t){.job = &parallel[i], .index = i};
+    LION_CALL(lion_thread_create(&threads[i], test_worker_fn, &workers[i]), "Failed creating thread");
+  }
+  for (size_t i = 0; i < TEST_THREADS_COUNT; i++) {
+    LION_CALL(lion_thread_join(&threads[i]), "Failed joining thread");
+  }
+
+  for (size_t i = 0; i < TEST_THREADS_COUNT; i++) {
+    LION_ASSERT_EQI(parallel[i].status, LION_STATUS_SUCCESS);
+    LION_ASSERT_EQI(parallel[i].state.step, serial[i].state.step);
+    LION_ASSERT_EQF(parallel[i].state.soc_nominal, serial[i].state.soc_nominal);
+    LION_ASSERT_EQF(parallel[i].state.internal_temperature, serial[i].state.internal_temperature);
+    LION_ASSERT_EQF(parallel[i].state.current, serial[i].state.current);
+    LION_ASSERT_EQF(parallel[i].state.soh, serial[i].state.soh);
+    // Messages of other sims leaking into this logger would change the count
+    LION_ASSERT(serial[i].messages > 0);
+    LION_ASSERT_EQI(parallel[i].messages, serial[i].messages);
+  }
+
+  // Creating sims must not touch the logger shared by the rest of the process
+  LION_ASSERT_EQI(log_get_logger()->level, default_level);
+  return TEST_PASS;
+}
+
+lion_status_t test_sim_log_files(lion_sim_t *sim) {
+  // Sims created within the same second must not share, nor truncate, a log file
+  lion_sim_config_t conf = lion_sim_config_default();
+  conf.log_stdlvl        = LOG_ERROR;
+  conf.log_dir           = "logs";
+  lion_params_t params   = lion_params_default();
+
+  lion_sim_t sims[TEST_THREADS_COUNT];
+  for (size_t i = 0; i < TEST_THREADS_COUNT; i++) {
+    LION_CALL(lion_sim_new(&conf, &params, &sims[i]), "Failed creating sim");
+    LION_ASSERT(sims[i].log_file != NULL);
+    for (size_t j = 0; j < i; j++) {
+      LION_ASSERT(strcmp(sims[i].log_filename, sims[j].log_filename) != 0);
+    }
+  }
+  for (size_t i = 0; i < TEST_THREADS_COUNT; i++) {
+    LION_CALL(lion_sim_cleanup(&sims[i]), "Failed cleaning up sim");
+    remove(sims[i].log_filename);
+  }
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_sim_threads);
+  LION_CALL_TEST(NULL, test_sim_log_files);
+
+  return TEST_PASS;
+}
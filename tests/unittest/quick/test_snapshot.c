@@ -0,0 +1,234 @@
+#include <gsl/gsl_odeiv2.h>
+#include <lion/lion.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+#include <stdio.h>
+
+#define TEST_SNAPSHOT_STEPS 300
+#define TEST_SNAPSHOT_POWER 8.0
+#define TEST_SNAPSHOT_FILE  "test_snapshot.bin"
+
+static lion_status_t test_steps(lion_sim_t *sim) {
+  for (size_t k = 0; k < TEST_SNAPSHOT_STEPS; k++) {
+    LION_CALL(lion_sim_step(sim, TEST_SNAPSHOT_POWER, 298.15), "Failed stepping sim");
+  }
+  return TEST_PASS;
+}
+
+static lion_status_t test_assert_same_state(const lion_sim_t *a, const lion_sim_t *b) {
+  LION_ASSERT_EQI(a->state.step, b->state.step);
+  LION_ASSERT_EQF(a->state.time, b->state.time);
+  LION_ASSERT_EQF(a->state.soc_nominal, b->state.soc_nominal);
+  LION_ASSERT_EQF(a->state.internal_temperature, b->state.internal_temperature);
+  LION_ASSERT_EQF(a->state.voltage, b->state.voltage);
+  LION_ASSERT_EQF(a->state.soh, b->state.soh);
+  return TEST_PASS;
+}
+
+lion_status_t test_snapshot_restore(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_seconds    = 1.0;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  lion_sim_t prefix;
+  LION_CALL(lion_sim_new(&conf, &params, &prefix), "Failed creating sim");
+  LION_CALL(lion_sim_init(&prefix), "Failed initializing sim");
+  LION_CALL(test_steps(&prefix), "Failed stepping sim");
+
+  lion_snapshot_t snapshot;
+  LION_CALL(lion_sim_snapshot(&prefix, &snapshot), "Failed taking snapshot");
+  LION_CALL(lion_snapshot_save(&snapshot, TEST_SNAPSHOT_FILE), "Failed saving snapshot");
+  LION_CALL(test_steps(&prefix), "Failed stepping sim");
+
+  // Restored in memory, into a sim which was never initialized
+  lion_sim_t branch;
+  LION_CALL(lion_sim_new(&conf, &params, &branch), "Failed creating sim");
+  LION_CALL(lion_sim_restore(&branch, &snapshot), "Failed restoring snapshot");
+  LION_ASSERT_EQI(branch.state.step, TEST_SNAPSHOT_STEPS);
+  LION_CALL(test_steps(&branch), "Failed stepping sim");
+  LION_CALL(test_assert_same_state(&prefix, &branch), "Restored sim diverged");
+
+  // Restored from the file, into a sim which already ran
+  lion_snapshot_t loaded;
+  LION_CALL(lion_snapshot_load(TEST_SNAPSHOT_FILE, &loaded), "Failed loading snapshot");
+  LION_ASSERT_EQF(loaded.state.voltage, snapshot.state.voltage);
+  LION_ASSERT_EQF(loaded.step_size, snapshot.step_size);
+  LION_CALL(lion_sim_restore(&branch, &loaded), "Failed restoring snapshot");
+  LION_CALL(test_steps(&branch), "Failed stepping sim");
+  LION_CALL(test_assert_same_state(&prefix, &branch), "Loaded sim diverged");
+
+  LION_CALL(lion_snapshot_cleanup(&snapshot), "Failed cleaning up snapshot");
+  LION_CALL(lion_snapshot_cleanup(&loaded), "Failed cleaning up snapshot");
+  LION_CALL(lion_sim_cleanup(&prefix), "Failed cleaning up sim");
+  LION_CALL(lion_sim_cleanup(&branch), "Failed cleaning up sim");
+  remove(TEST_SNAPSHOT_FILE);
+  return TEST_PASS;
+}
+
+lion_status_t test_snapshot_adaptive_events(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_seconds    = 1.0;
+  conf.sim_step_mode       = LION_STEP_MODE_ADAPTIVE;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  lion_event_t notify = {
+      .name      = "soc",
+      .field     = LION_STATE_SOC_NOMINAL,
+      .threshold = 0.89,
+      .direction = LION_EVENT_FALLING,
+      .action    = LION_EVENT_NOTIFY,
+  };
+
+  lion_sim_t prefix;
+  LION_CALL(lion_sim_new(&conf, &params, &prefix), "Failed creating sim");
+  LION_CALL(lion_sim_add_event(&prefix, &notify), "Failed adding event");
+  LION_CALL(lion_sim_init(&prefix), "Failed initializing sim");
+  LION_CALL(test_steps(&prefix), "Failed stepping sim");
+  LION_ASSERT_EQI(prefix.events[0].triggered, 1);
+
+  lion_snapshot_t snapshot;
+  LION_CALL(lion_sim_snapshot(&prefix, &snapshot), "Failed taking snapshot");
+  LION_ASSERT_EQI(snapshot.events_len, 1);
+  LION_ASSERT_EQF(snapshot.step_size, prefix.driver->h);
+
+  // The events of the sim restored into must match the snapshot
+  lion_sim_t branch;
+  LION_CALL(lion_sim_new(&conf, &params, &branch), "Failed creating sim");
+  branch.conf->log_stdlvl = LOG_FATAL;
+  LION_ASSERT_FAILS(lion_sim_restore(&branch, &snapshot));
+  LION_CALL(lion_sim_add_event(&branch, &notify), "Failed adding event");
+  LION_CALL(lion_sim_restore(&branch, &snapshot), "Failed restoring snapshot");
+  LION_ASSERT_EQI(branch.events[0].triggered, 1);
+  LION_ASSERT_EQF(branch.events[0].time, prefix.events[0].time);
+  LION_ASSERT_EQF(branch.driver->h, snapshot.step_size);
+
+  LION_CALL(test_steps(&prefix), "Failed stepping sim");
+  LION_CALL(test_steps(&branch), "Failed stepping sim");
+  LION_CALL(test_assert_same_state(&prefix, &branch), "Restored sim diverged");
+  LION_ASSERT_EQI(branch.events[0].triggered, 1);
+
+  LION_CALL(lion_snapshot_cleanup(&snapshot), "Failed cleaning up snapshot");
+  LION_CALL(lion_sim_cleanup(&prefix), "Failed cleaning up sim");
+  LION_CALL(lion_sim_cleanup(&branch), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_snapshot_current_mode(lion_sim_t *sim) {
+  // The input mode of the last step is restored along with the state, both in
+  // memory and from the file
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_seconds    = 1.0;
+  conf.sim_input_mode      = LION_INPUT_MODE_CURRENT;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  lion_sim_t prefix;
+  LION_CALL(lion_sim_new(&conf, &params, &prefix), "Failed creating sim");
+  LION_CALL(lion_sim_init(&prefix), "Failed initializing sim");
+  for (size_t k = 0; k < TEST_SNAPSHOT_STEPS; k++) {
+    LION_CALL(lion_sim_step_current(&prefix, 2.0, 298.15), "Failed stepping sim");
+  }
+
+  lion_snapshot_t snapshot;
+  lion_snapshot_t loaded;
+  LION_CALL(lion_sim_snapshot(&prefix, &snapshot), "Failed taking snapshot");
+  LION_ASSERT_EQI(snapshot.input_mode, LION_INPUT_MODE_CURRENT);
+  LION_CALL(lion_snapshot_save(&snapshot, TEST_SNAPSHOT_FILE), "Failed saving snapshot");
+  LION_CALL(lion_snapshot_load(TEST_SNAPSHOT_FILE, &loaded), "Failed loading snapshot");
+  LION_ASSERT_EQI(loaded.input_mode, LION_INPUT_MODE_CURRENT);
+
+  lion_sim_t branch;
+  LION_CALL(lion_sim_new(&conf, &params, &branch), "Failed creating sim");
+  LION_CALL(lion_sim_restore(&branch, &loaded), "Failed restoring snapshot");
+  LION_ASSERT_EQI(branch._input_mode, LION_INPUT_MODE_CURRENT);
+  for (size_t k = 0; k < TEST_SNAPSHOT_STEPS; k++) {
+    LION_CALL(lion_sim_step_current(&prefix, 2.0, 298.15), "Failed stepping sim");
+    LION_CALL(lion_sim_step_current(&branch, 2.0, 298.15), "Failed stepping sim");
+  }
+  LION_CALL(test_assert_same_state(&prefix, &branch), "Restored sim diverged");
+
+  LION_CALL(lion_snapshot_cleanup(&snapshot), "Failed cleaning up snapshot");
+  LION_CALL(lion_snapshot_cleanup(&loaded), "Failed cleaning up snapshot");
+  LION_CALL(lion_sim_cleanup(&prefix), "Failed cleaning up sim");
+  LION_CALL(lion_sim_cleanup(&branch), "Failed cleaning up sim");
+  remove(TEST_SNAPSHOT_FILE);
+  return TEST_PASS;
+}
+
+lion_status_t test_snapshot_dae(lion_sim_t *sim) {
+  // The BDF history is restored along with the state, so that the restored sim
+  // takes the same BDF2 steps as the original one instead of restarting on BDF1
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_seconds    = 1.0;
+  conf.sim_step_mode       = LION_STEP_MODE_DAE;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  lion_sim_t prefix;
+  LION_CALL(lion_sim_new(&conf, &params, &prefix), "Failed creating sim");
+  LION_CALL(lion_sim_init(&prefix), "Failed initializing sim");
+  LION_CALL(test_steps(&prefix), "Failed stepping sim");
+
+  lion_snapshot_t snapshot;
+  lion_snapshot_t loaded;
+  LION_CALL(lion_sim_snapshot(&prefix, &snapshot), "Failed taking snapshot");
+  LION_ASSERT_EQI(snapshot.dae_steps, TEST_SNAPSHOT_STEPS);
+  LION_CALL(lion_snapshot_save(&snapshot, TEST_SNAPSHOT_FILE), "Failed saving snapshot");
+  LION_CALL(lion_snapshot_load(TEST_SNAPSHOT_FILE, &loaded), "Failed loading snapshot");
+  LION_ASSERT_EQF(loaded.dae_prev[0], snapshot.dae_prev[0]);
+  LION_ASSERT_EQF(loaded.dae_prev[1], snapshot.dae_prev[1]);
+  LION_ASSERT_EQF(loaded.dae_h, snapshot.dae_h);
+  LION_ASSERT_EQF(loaded.dae_current, snapshot.dae_current);
+  LION_ASSERT_EQI(loaded.dae_steps, snapshot.dae_steps);
+
+  lion_sim_t memory, file;
+  LION_CALL(lion_sim_new(&conf, &params, &memory), "Failed creating sim");
+  LION_CALL(lion_sim_new(&conf, &params, &file), "Failed creating sim");
+  LION_CALL(lion_sim_restore(&memory, &snapshot), "Failed restoring snapshot");
+  LION_CALL(lion_sim_restore(&file, &loaded), "Failed restoring snapshot");
+  LION_CALL(test_steps(&prefix), "Failed stepping sim");
+  LION_CALL(test_steps(&memory), "Failed stepping sim");
+  LION_CALL(test_steps(&file), "Failed stepping sim");
+  LION_CALL(test_assert_same_state(&prefix, &memory), "Restored sim diverged");
+  LION_CALL(test_assert_same_state(&prefix, &file), "Loaded sim diverged");
+  LION_ASSERT_EQF(memory.state.current, prefix.state.current);
+  LION_ASSERT_EQF(file.state.current, prefix.state.current);
+
+  LION_CALL(lion_snapshot_cleanup(&snapshot), "Failed cleaning up snapshot");
+  LION_CALL(lion_snapshot_cleanup(&loaded), "Failed cleaning up snapshot");
+  LION_CALL(lion_sim_cleanup(&prefix), "Failed cleaning up sim");
+  LION_CALL(lion_sim_cleanup(&memory), "Failed cleaning up sim");
+  LION_CALL(lion_sim_cleanup(&file), "Failed cleaning up sim");
+  remove(TEST_SNAPSHOT_FILE);
+  return TEST_PASS;
+}
+
+lion_status_t test_snapshot_invalid_file(lion_sim_t *sim) {
+  FILE *f = fopen(TEST_SNAPSHOT_FILE, "wb");
+  LION_ASSERT(f != NULL);
+  fputs("not a snapshot", f);
+  fclose(f);
+
+  lion_snapshot_t snapshot;
+  LION_ASSERT_FAILS(lion_snapshot_load(TEST_SNAPSHOT_FILE, &snapshot));
+  LION_ASSERT_FAILS(lion_snapshot_load("missing_" TEST_SNAPSHOT_FILE, &snapshot));
+  remove(TEST_SNAPSHOT_FILE);
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_snapshot_restore);
+  LION_CALL_TEST(NULL, test_snapshot_adaptive_events);
+  LION_CALL_TEST(NULL, test_snapshot_current_mode);
+  LION_CALL_TEST(NULL, test_snapshot_dae);
+  LION_CALL_TEST(NULL, test_snapshot_invalid_file);
+
+  return TEST_PASS;
+}
@@ -0,0 +1,165 @@
+#include <lion/lion.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+#include <math.h>
+
+#define TEST_DAE_STEPS 300
+#define TEST_DAE_POWER 8.0
+#define TEST_DAE_SPAN  2400.0
+
+static lion_status_t test_dae_sim(lion_sim_config_t *conf, lion_params_t *params, lion_sim_t *out) {
+  LION_CALL(lion_sim_new(conf, params, out), "Failed creating sim");
+  LION_CALL(lion_sim_init(out), "Failed initializing sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_dae_matches_fixed(lion_sim_t *sim) {
+  // At small steps the implicit steps agree with the fixed ones
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_seconds    = 1.0;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  lion_sim_config_t dae_conf = conf;
+  dae_conf.sim_step_mode     = LION_STEP_MODE_DAE;
+  lion_sim_t reference, dae;
+  LION_CALL(test_dae_sim(&conf, &params, &reference), "Failed creating reference sim");
+  LION_CALL(test_dae_sim(&dae_conf, &params, &dae), "Failed creating DAE sim");
+  LION_ASSERT(dae.driver == NULL);
+
+  for (size_t k = 0; k < TEST_DAE_STEPS; k++) {
+    LION_CALL(lion_sim_step(&reference, TEST_DAE_POWER, 298.15), "Failed stepping sim");
+    LION_CALL(lion_sim_step(&dae, TEST_DAE_POWER, 298.15), "Failed stepping sim");
+  }
+  LION_ASSERT_EQF(dae.state.time, reference.state.time);
+  LION_ASSERT(fabs(dae.state.soc_nominal - reference.state.soc_nominal) < 1e-6);
+  LION_ASSERT(fabs(dae.state.internal_temperature - reference.state.internal_temperature) < 1e-3);
+  LION_ASSERT(fabs(dae.state.current - reference.state.current) < 1e-4);
+
+  LION_CALL(lion_sim_cleanup(&reference), "Failed cleaning up sim");
+  LION_CALL(lion_sim_cleanup(&dae), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_dae_constraint(lion_sim_t *sim) {
+  // The current carried over from the last step satisfies the power constraint
+  // at the start of the next one, also across a change of the input
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_mode       = LION_STEP_MODE_DAE;
+  conf.sim_step_seconds    = 30.0;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  lion_sim_t cell;
+  LION_CALL(test_dae_sim(&conf, &params, &cell), "Failed creating sim");
+  for (size_t k = 0; k < 60; k++) {
+    double power = k < 30 ? TEST_DAE_POWER : -TEST_DAE_POWER / 2.0;
+    LION_CALL(lion_sim_step(&cell, power, 298.15), "Failed stepping sim");
+    double current  = cell.state.current;
+    double residual = cell.state.open_circuit_voltage * current - cell.state.internal_resistance * cell.state.soh * current * current - power;
+    LION_ASSERT(fabs(residual) < 1e-6);
+  }
+  LION_ASSERT(cell.state.current < 0.0);
+
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+static lion_status_t test_cooling_error(double step, double *out) {
+  // Resting cells cool down exponentially towards the ambient temperature
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_mode       = LION_STEP_MODE_DAE;
+  conf.sim_input_mode      = LION_INPUT_MODE_CURRENT;
+  conf.sim_step_seconds    = step;
+  lion_params_t     params = lion_params_default();
+  params.init.temp_in      = 318.15;
+
+  lion_sim_t cell;
+  LION_CALL(test_dae_sim(&conf, &params, &cell), "Failed creating sim");
+  size_t steps = (size_t)(TEST_DAE_SPAN / step);
+  for (size_t k = 0; k < steps; k++) {
+    LION_CALL(lion_sim_step_current(&cell, 0.0, 298.15), "Failed stepping sim");
+  }
+  double tau = params.temp.cp * (params.temp.rin + params.temp.rout);
+  *out       = fabs(cell.state._next_internal_temperature - (298.15 + 20.0 * exp(-cell.state.time / tau)));
+  LION_ASSERT(fabs(cell.state._next_soc_nominal - params.init.soc) < 1e-12);
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_dae_order(lion_sim_t *sim) {
+  // BDF2 is second order, so halving the step divides the error by about 4
+  double coarse, fine;
+  LION_CALL(test_cooling_error(40.0, &coarse), "Failed running coarse steps");
+  LION_CALL(test_cooling_error(20.0, &fine), "Failed running fine steps");
+  LION_ASSERT(coarse > 0.0 && fine > 0.0);
+  LION_ASSERT(fabs(coarse / fine / 4.0 - 1.0) < 0.25);
+  return TEST_PASS;
+}
+
+lion_status_t test_dae_large_steps(lion_sim_t *sim) {
+  // Steps far above the thermal time constant stay stable, where explicit
+  // steppers would blow up
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_mode       = LION_STEP_MODE_DAE;
+  conf.sim_input_mode      = LION_INPUT_MODE_CURRENT;
+  conf.sim_step_seconds    = 6000.0;
+  lion_params_t     params = lion_params_default();
+  params.init.temp_in      = 318.15;
+
+  lion_sim_t cell;
+  LION_CALL(test_dae_sim(&conf, &params, &cell), "Failed creating sim");
+  for (size_t k = 0; k < 10; k++) {
+    LION_CALL(lion_sim_step_current(&cell, 0.0, 298.15), "Failed stepping sim");
+    LION_ASSERT(isfinite(cell.state._next_internal_temperature));
+    LION_ASSERT(fabs(cell.state._next_internal_temperature - 298.15) < 20.0);
+  }
+  LION_ASSERT(fabs(cell.state._next_internal_temperature - 298.15) < 1e-3);
+
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_dae_fork(lion_sim_t *sim) {
+  // Forks carry the history of the implicit steps, so they step the same
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_mode       = LION_STEP_MODE_DAE;
+  conf.sim_step_seconds    = 10.0;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  lion_sim_t cell;
+  LION_CALL(test_dae_sim(&conf, &params, &cell), "Failed creating sim");
+  for (size_t k = 0; k < 5; k++) {
+    LION_CALL(lion_sim_step(&cell, TEST_DAE_POWER, 298.15), "Failed stepping sim");
+  }
+  lion_sim_t branch;
+  LION_CALL(lion_sim_fork(&cell, 1, &branch), "Failed forking sim");
+  for (size_t k = 0; k < 10; k++) {
+    LION_CALL(lion_sim_step(&cell, TEST_DAE_POWER, 298.15), "Failed stepping sim");
+    LION_CALL(lion_sim_step(&branch, TEST_DAE_POWER, 298.15), "Failed stepping sim");
+  }
+  LION_ASSERT_EQF(branch.state.soc_nominal, cell.state.soc_nominal);
+  LION_ASSERT_EQF(branch.state.internal_temperature, cell.state.internal_temperature);
+  LION_ASSERT_EQF(branch.state.current, cell.state.current);
+
+  LION_CALL(lion_sim_cleanup(&branch), "Failed cleaning up sim");
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_dae_matches_fixed);
+  LION_CALL_TEST(NULL, test_dae_constraint);
+  LION_CALL_TEST(NULL, test_dae_order);
+  LION_CALL_TEST(NULL, test_dae_large_steps);
+  LION_CALL_TEST(NULL, test_dae_fork);
+
+  return TEST_PASS;
+}
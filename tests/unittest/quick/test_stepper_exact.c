@@ -0,0 +1,123 @@
+#include <lion/lion.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+#include <math.h>
+
+#define TEST_EXACT_STEPS 300
+#define TEST_EXACT_POWER 8.0
+
+lion_status_t test_exact_matches_rk(lion_sim_t *sim) {
+  // At small steps the closed form agrees with the generic steppers
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_seconds    = 1.0;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  lion_sim_t reference;
+  LION_CALL(lion_sim_new(&conf, &params, &reference), "Failed creating sim");
+  LION_CALL(lion_sim_init(&reference), "Failed initializing sim");
+
+  lion_sim_config_t exact_conf = conf;
+  exact_conf.sim_stepper       = LION_STEPPER_EXACT;
+  lion_sim_t exact;
+  LION_CALL(lion_sim_new(&exact_conf, &params, &exact), "Failed creating sim");
+  LION_CALL(lion_sim_init(&exact), "Failed initializing sim");
+  LION_ASSERT(exact.driver == NULL);
+
+  for (size_t k = 0; k < TEST_EXACT_STEPS; k++) {
+    LION_CALL(lion_sim_step(&reference, TEST_EXACT_POWER, 298.15), "Failed stepping sim");
+    LION_CALL(lion_sim_step(&exact, TEST_EXACT_POWER, 298.15), "Failed stepping sim");
+  }
+  LION_ASSERT_EQF(exact.state.time, reference.state.time);
+  LION_ASSERT(fabs(exact.state.soc_nominal - reference.state.soc_nominal) < 1e-9);
+  LION_ASSERT(fabs(exact.state.internal_temperature - reference.state.internal_temperature) < 1e-6);
+
+  LION_CALL(lion_sim_cleanup(&reference), "Failed cleaning up sim");
+  LION_CALL(lion_sim_cleanup(&exact), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_exact_large_steps(lion_sim_t *sim) {
+  // Resting cells cool down exponentially towards the ambient temperature, which
+  // the exact stepper follows at any step size
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_stepper         = LION_STEPPER_EXACT;
+  conf.sim_input_mode      = LION_INPUT_MODE_CURRENT;
+  conf.sim_step_seconds    = 1000.0;
+  lion_params_t     params = lion_params_default();
+  params.init.temp_in      = 318.15;
+
+  lion_sim_t cell;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  LION_CALL(lion_sim_init(&cell), "Failed initializing sim");
+  double tau = params.temp.cp * (params.temp.rin + params.temp.rout);
+  for (size_t k = 0; k < 10; k++) {
+    LION_CALL(lion_sim_step_current(&cell, 0.0, 298.15), "Failed stepping sim");
+  }
+  double expected = 298.15 + 20.0 * exp(-cell.state.time / tau);
+  LION_ASSERT(fabs(cell.state._next_internal_temperature - expected) < 1e-9);
+  LION_ASSERT_EQF(cell.state._next_soc_nominal, params.init.soc);
+
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_exact_rearm_fork(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_seconds    = 1.0;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  // Switching to the exact stepper drops the driver, and forks step the same
+  lion_sim_t cell;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  LION_CALL(lion_sim_init(&cell), "Failed initializing sim");
+  LION_ASSERT(cell.driver != NULL);
+  conf.sim_stepper = LION_STEPPER_EXACT;
+  LION_CALL(lion_sim_rearm(&cell, NULL, NULL), "Failed rearming sim");
+  LION_ASSERT(cell.driver == NULL);
+  LION_CALL(lion_sim_step(&cell, TEST_EXACT_POWER, 298.15), "Failed stepping sim");
+
+  lion_sim_t branch;
+  LION_CALL(lion_sim_fork(&cell, 1, &branch), "Failed forking sim");
+  for (size_t k = 0; k < 10; k++) {
+    LION_CALL(lion_sim_step(&cell, TEST_EXACT_POWER, 298.15), "Failed stepping sim");
+    LION_CALL(lion_sim_step(&branch, TEST_EXACT_POWER, 298.15), "Failed stepping sim");
+  }
+  LION_ASSERT_EQF(branch.state.soc_nominal, cell.state.soc_nominal);
+  LION_ASSERT_EQF(branch.state.internal_temperature, cell.state.internal_temperature);
+  LION_CALL(lion_sim_cleanup(&branch), "Failed cleaning up sim");
+
+  conf.sim_stepper = LION_STEPPER_RKF45;
+  LION_CALL(lion_sim_rearm(&cell, NULL, NULL), "Failed rearming sim");
+  LION_ASSERT(cell.driver != NULL);
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_exact_adaptive(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_FATAL;
+  conf.sim_stepper         = LION_STEPPER_EXACT;
+  conf.sim_step_mode       = LION_STEP_MODE_ADAPTIVE;
+  lion_params_t     params = lion_params_default();
+
+  lion_sim_t cell;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  LION_ASSERT_FAILS(lion_sim_init(&cell));
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_exact_matches_rk);
+  LION_CALL_TEST(NULL, test_exact_large_steps);
+  LION_CALL_TEST(NULL, test_exact_rearm_fork);
+  LION_CALL_TEST(NULL, test_exact_adaptive);
+
+  return TEST_PASS;
+}
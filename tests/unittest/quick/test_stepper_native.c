@@ -0,0 +1,105 @@
+#include <lion/lion.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+#include <math.h>
+
+#define TEST_NATIVE_STEPS 300
+#define TEST_NATIVE_POWER 8.0
+#define TEST_NATIVE_SPAN  2400.0
+
+lion_status_t test_native_matches_gsl(lion_sim_t *sim) {
+  // At small steps every native stepper agrees with the GSL one
+  lion_stepper_t steppers[] = {LION_STEPPER_NATIVE_RK2, LION_STEPPER_NATIVE_HEUN, LION_STEPPER_NATIVE_RK4};
+
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_step_seconds    = 1.0;
+  lion_params_t     params = lion_params_default();
+  params.init.soc          = 0.9;
+
+  lion_sim_t reference;
+  LION_CALL(lion_sim_new(&conf, &params, &reference), "Failed creating sim");
+  LION_CALL(lion_sim_init(&reference), "Failed initializing sim");
+  for (size_t k = 0; k < TEST_NATIVE_STEPS; k++) {
+    LION_CALL(lion_sim_step(&reference, TEST_NATIVE_POWER, 298.15), "Failed stepping sim");
+  }
+
+  for (size_t i = 0; i < sizeof(steppers) / sizeof(steppers[0]); i++) {
+    lion_sim_config_t native_conf = conf;
+    native_conf.sim_stepper       = steppers[i];
+    lion_sim_t native;
+    LION_CALL(lion_sim_new(&native_conf, &params, &native), "Failed creating sim");
+    LION_CALL(lion_sim_init(&native), "Failed initializing sim");
+    LION_ASSERT(native.driver == NULL);
+    for (size_t k = 0; k < TEST_NATIVE_STEPS; k++) {
+      LION_CALL(lion_sim_step(&native, TEST_NATIVE_POWER, 298.15), "Failed stepping sim");
+    }
+    LION_ASSERT_EQF(native.state.time, reference.state.time);
+    LION_ASSERT(fabs(native.state.soc_nominal - reference.state.soc_nominal) < 1e-9);
+    LION_ASSERT(fabs(native.state.internal_temperature - reference.state.internal_temperature) < 1e-5);
+    LION_CALL(lion_sim_cleanup(&native), "Failed cleaning up sim");
+  }
+
+  LION_CALL(lion_sim_cleanup(&reference), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+static lion_status_t test_cooling_error(lion_stepper_t stepper, double step, double *out) {
+  // Resting cells cool down exponentially towards the ambient temperature
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_ERROR;
+  conf.sim_stepper         = stepper;
+  conf.sim_input_mode      = LION_INPUT_MODE_CURRENT;
+  conf.sim_step_seconds    = step;
+  lion_params_t     params = lion_params_default();
+  params.init.temp_in      = 318.15;
+
+  lion_sim_t cell;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  LION_CALL(lion_sim_init(&cell), "Failed initializing sim");
+  size_t steps = (size_t)(TEST_NATIVE_SPAN / step);
+  for (size_t k = 0; k < steps; k++) {
+    LION_CALL(lion_sim_step_current(&cell, 0.0, 298.15), "Failed stepping sim");
+  }
+  double tau = params.temp.cp * (params.temp.rin + params.temp.rout);
+  *out       = fabs(cell.state._next_internal_temperature - (298.15 + 20.0 * exp(-cell.state.time / tau)));
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+lion_status_t test_native_order(lion_sim_t *sim) {
+  // Halving the step divides the error by 2^p for a method of order p
+  lion_stepper_t steppers[] = {LION_STEPPER_NATIVE_RK2, LION_STEPPER_NATIVE_HEUN, LION_STEPPER_NATIVE_RK4};
+  double         ratios[]   = {4.0, 4.0, 16.0};
+  for (size_t i = 0; i < sizeof(steppers) / sizeof(steppers[0]); i++) {
+    double coarse, fine;
+    LION_CALL(test_cooling_error(steppers[i], 40.0, &coarse), "Failed running coarse steps");
+    LION_CALL(test_cooling_error(steppers[i], 20.0, &fine), "Failed running fine steps");
+    LION_ASSERT(coarse > 0.0 && fine > 0.0);
+    LION_ASSERT(fabs(coarse / fine / ratios[i] - 1.0) < 0.15);
+  }
+  return TEST_PASS;
+}
+
+lion_status_t test_native_adaptive(lion_sim_t *sim) {
+  lion_sim_config_t conf   = lion_sim_config_default();
+  conf.log_stdlvl          = LOG_FATAL;
+  conf.sim_stepper         = LION_STEPPER_NATIVE_RK4;
+  conf.sim_step_mode       = LION_STEP_MODE_ADAPTIVE;
+  lion_params_t     params = lion_params_default();
+
+  lion_sim_t cell;
+  LION_CALL(lion_sim_new(&conf, &params, &cell), "Failed creating sim");
+  LION_ASSERT_FAILS(lion_sim_init(&cell));
+  LION_CALL(lion_sim_cleanup(&cell), "Failed cleaning up sim");
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_native_matches_gsl);
+  LION_CALL_TEST(NULL, test_native_order);
+  LION_CALL_TEST(NULL, test_native_adaptive);
+
+  return TEST_PASS;
+}
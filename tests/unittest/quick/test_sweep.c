@@ -0,0 +1,93 @@
+#include <lion/lion.h>
+#include <lion_utils/test.h>
+#include <lionu/log.h>
+#include <lionu/macros.h>
+
+#define TEST_SWEEP_JOBS    12
+#define TEST_SWEEP_THREADS 4
+
+static lion_params_t test_params(size_t job) {
+  lion_params_t params = lion_params_default();
+  params.init.soc      = 0.3 + 0.05 * (double)job;
+  if (job % 3 == 0) {
+    params.rint.model               = LION_RINT_MODEL_POLARIZATION;
+    params.rint.params.polarization = lion_params_default_rint_polarization();
+  }
+  return params;
+}
+
+lion_status_t test_sweep_matches_serial(lion_sim_t *sim) {
+  lion_sim_config_t conf = lion_sim_config_default();
+  conf.log_stdlvl        = LOG_ERROR;
+  // Workers re-arm their sim between jobs sharing a configuration, and set up
+  // a new one when it changes
+  lion_sim_config_t other = conf;
+  other.sim_stepper       = LION_STEPPER_RK4;
+
+  // Inputs of different lengths so that some workers run out of work early
+  // and have to steal from the others
+  lion_vector_t power[TEST_SWEEP_JOBS];
+  lion_vector_t amb_temp[TEST_SWEEP_JOBS];
+  lion_params_t params[TEST_SWEEP_JOBS];
+  for (size_t i = 0; i < TEST_SWEEP_JOBS; i++) {
+    size_t len = 100 + 150 * (i % 4);
+    LION_CALL(lion_vector_new(NULL, sizeof(double), &power[i]), "Failed creating power vector");
+    LION_CALL(lion_vector_new(NULL, sizeof(double), &amb_temp[i]), "Failed creating temperature vector");
+    for (size_t k = 0; k < len; k++) {
+      double p = 1.25 + 0.5 * (double)i - 4.0 * (double)((k / 50) % 2);
+      double t = 293.15 + (double)i;
+      LION_CALL(lion_vector_push_d(NULL, &power[i], p), "Failed pushing power");
+      LION_CALL(lion_vector_push_d(NULL, &amb_temp[i], t), "Failed pushing temperature");
+    }
+    params[i] = test_params(i);
+  }
+
+  lion_sweep_job_t    jobs[TEST_SWEEP_JOBS];
+  lion_sweep_result_t results[TEST_SWEEP_JOBS];
+  for (size_t i = 0; i < TEST_SWEEP_JOBS; i++) {
+    jobs[i] = (lion_sweep_job_t){
+        .conf                = (i % 4 == 1) ? &other : &conf,
+        .params              = &params[i],
+        .power               = &power[i],
+        .ambient_temperature = &amb_temp[i],
+    };
+  }
+  LION_CALL(lion_sweep_run(jobs, TEST_SWEEP_JOBS, TEST_SWEEP_THREADS, results), "Failed running sweep");
+
+  // Each job must give exactly the same result as running it on its own
+  for (size_t i = 0; i < TEST_SWEEP_JOBS; i++) {
+    LION_ASSERT_EQI(results[i].status, LION_STATUS_SUCCESS);
+    LION_ASSERT(results[i].worker < TEST_SWEEP_THREADS);
+
+    lion_sim_t serial;
+    LION_CALL(lion_sim_new(jobs[i].conf, &params[i], &serial), "Failed creating sim");
+    LION_CALL(lion_sim_run(&serial, &power[i], &amb_temp[i]), "Failed running sim");
+    LION_ASSERT_EQI(results[i].state.step, serial.state.step);
+    LION_ASSERT_EQF(results[i].state.soc_nominal, serial.state.soc_nominal);
+    LION_ASSERT_EQF(results[i].state.internal_temperature, serial.state.internal_temperature);
+    LION_ASSERT_EQF(results[i].state.current, serial.state.current);
+    LION_ASSERT_EQF(results[i].state.voltage, serial.state.voltage);
+    LION_CALL(lion_sim_cleanup(&serial), "Failed cleaning up sim");
+
+    LION_CALL(lion_vector_cleanup(NULL, &power[i]), "Failed cleaning up power vector");
+    LION_CALL(lion_vector_cleanup(NULL, &amb_temp[i]), "Failed cleaning up temperature vector");
+  }
+  return TEST_PASS;
+}
+
+lion_status_t test_sweep_rejects_missing_inputs(lion_sim_t *sim) {
+  lion_sim_config_t   conf   = lion_sim_config_default();
+  lion_params_t       params = lion_params_default();
+  lion_sweep_job_t    job    = {.conf = &conf, .params = &params};
+  lion_sweep_result_t result;
+  LION_ASSERT_FAILS(lion_sweep_run(&job, 1, 1, &result));
+  LION_ASSERT_EQI(lion_sweep_run(&job, 0, 1, &result), LION_STATUS_SUCCESS);
+  return TEST_PASS;
+}
+
+int main() {
+  LION_CALL_TEST(NULL, test_sweep_matches_serial);
+  LION_CALL_TEST(NULL, test_sweep_rejects_missing_inputs);
+
+  return TEST_PASS;
+}